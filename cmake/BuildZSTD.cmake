@@ -24,6 +24,10 @@ macro(zstd_build)
         third_party/zstd/lib/compress/zstd_compress_superblock.c
         third_party/zstd/lib/compress/zstd_compress_sequences.c
         third_party/zstd/lib/compress/zstd_compress_literals.c
+        third_party/zstd/lib/dictBuilder/cover.c
+        third_party/zstd/lib/dictBuilder/divsufsort.c
+        third_party/zstd/lib/dictBuilder/fastcover.c
+        third_party/zstd/lib/dictBuilder/zdict.c
     )
 
     if (CC_HAS_WNO_IMPLICIT_FALLTHROUGH)
@@ -0,0 +1,126 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Element of a memtx tree index: a tuple pointer and a comparison hint.
+struct elem {
+	uint64_t value;
+	uint64_t hint;
+};
+
+// Comparison function is called indirectly, like tuple_compare().
+typedef int (*elem_cmp_f)(uint64_t a, uint64_t b);
+
+static int
+elem_cmp(uint64_t a, uint64_t b)
+{
+	return a < b ? -1 : a > b;
+}
+
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE (16 * 1024)
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a).value == (b).value)
+#define BPS_TREE_COMPARE(a, b, arg) (arg)((a).value, (b).value)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) (arg)((a).value, b)
+#define bps_tree_elem_t struct elem
+#define bps_tree_key_t uint64_t
+#define bps_tree_arg_t elem_cmp_f
+
+#define BPS_TREE_NAME plain_tree
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+
+#define BPS_TREE_NAME hinted_tree
+#define BPS_TREE_ELEM_HINT(elem) ((elem).hint)
+#define BPS_TREE_KEY_HINT(key, arg) (key)
+#define BPS_TREE_SEARCH_ELEM_HINT(elem, arg) ((elem).hint)
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_ELEM_HINT
+#undef BPS_TREE_KEY_HINT
+#undef BPS_TREE_SEARCH_ELEM_HINT
+
+static void *
+extent_alloc(void *ctx)
+{
+	(void)ctx;
+	return malloc(BPS_TREE_EXTENT_SIZE);
+}
+
+static void
+extent_free(void *ctx, void *extent)
+{
+	(void)ctx;
+	free(extent);
+}
+
+// Sorted array of elements and a shuffled array of keys to look up.
+class TreeData {
+public:
+	static TreeData &instance()
+	{
+		static TreeData instance;
+		return instance;
+	}
+	std::vector<elem> elems;
+	std::vector<uint64_t> keys;
+private:
+	TreeData()
+	{
+		const size_t count = 1000000;
+		std::mt19937_64 gen(0);
+		for (size_t i = 0; i < count; i++) {
+			uint64_t value = i * 3;
+			elems.push_back({value, value});
+			keys.push_back(value);
+		}
+		std::shuffle(keys.begin(), keys.end(), gen);
+	}
+};
+
+template <class tree_t, void create(tree_t *, elem_cmp_f,
+				    bps_tree_extent_alloc_f,
+				    bps_tree_extent_free_f, void *),
+	  int build(tree_t *, struct elem *, size_t),
+	  struct elem *find(const tree_t *, uint64_t),
+	  void destroy(tree_t *)>
+static void
+bench_find(benchmark::State &state)
+{
+	TreeData &data = TreeData::instance();
+	tree_t tree;
+	create(&tree, elem_cmp, extent_alloc, extent_free, NULL);
+	if (build(&tree, data.elems.data(), data.elems.size()) != 0)
+		abort();
+	size_t i = 0;
+	for (auto _ : state) {
+		uint64_t key = data.keys[i++ % data.keys.size()];
+		benchmark::DoNotOptimize(find(&tree, key));
+	}
+	destroy(&tree);
+}
+
+// Lookups in a tree without hints.
+static void
+plain_find(benchmark::State &state)
+{
+	bench_find<plain_tree, plain_tree_create, plain_tree_build,
+		   plain_tree_find, plain_tree_destroy>(state);
+}
+BENCHMARK(plain_find);
+
+// Lookups in a tree that narrows the block search by hints.
+static void
+hinted_find(benchmark::State &state)
+{
+	bench_find<hinted_tree, hinted_tree_create, hinted_tree_build,
+		   hinted_tree_find, hinted_tree_destroy>(state);
+}
+BENCHMARK(hinted_find);
+
+BENCHMARK_MAIN();
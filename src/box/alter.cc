@@ -244,6 +244,17 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->bloom_type == bloom_type_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "bloom_type must be either 'classic' or 'blocked'");
+		return -1;
+	}
+	if (opts->compaction_policy == compaction_policy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_policy must be one of 'tiered', "
+			 "'leveled', 'lazy'");
+		return -1;
+	}
 	return 0;
 }
 
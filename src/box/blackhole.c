@@ -127,6 +127,8 @@ static const struct space_vtab blackhole_space_vtab = {
 	/* .swap_index = */ generic_space_swap_index,
 	/* .prepare_alter = */ generic_space_prepare_alter,
 	/* .invalidate = */ generic_space_invalidate,
+	/* .begin_bulk_insert = */ generic_space_begin_bulk_insert,
+	/* .end_bulk_insert = */ generic_space_end_bulk_insert,
 };
 
 static void
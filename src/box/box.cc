@@ -1160,6 +1160,30 @@ box_check_wal_queue_max_size(void)
 	return size;
 }
 
+static double
+box_check_wal_batch_window(void)
+{
+	double value = cfg_getd("wal_batch_window");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "wal_batch_window",
+			 "value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
+static int64_t
+box_check_wal_batch_max_size(void)
+{
+	int64_t size = cfg_geti64("wal_batch_max_size");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "wal_batch_max_size",
+			 "value must be >= 0");
+		return -1;
+	}
+	return size;
+}
+
 static double
 box_check_wal_cleanup_delay(void)
 {
@@ -1184,6 +1208,18 @@ box_check_readahead(int readahead)
 	}
 }
 
+static int64_t
+box_check_readahead_budget(void)
+{
+	int64_t budget = cfg_geti64("readahead_budget");
+	if (budget < 0) {
+		diag_set(ClientError, ER_CFG, "readahead_budget",
+			 "value must be >= 0");
+		return -1;
+	}
+	return budget;
+}
+
 static void
 box_check_checkpoint_count(int checkpoint_count)
 {
@@ -1216,6 +1252,32 @@ box_check_memory_quota(const char *quota_name)
 	return -1;
 }
 
+static int
+box_check_vinyl_prefetch_pages(int pages)
+{
+	if (pages < 0 || pages > VY_RUN_PREFETCH_MAX) {
+		diag_set(ClientError, ER_CFG, "vinyl_prefetch_pages",
+			 tt_sprintf("must be greater than or equal to 0,"
+				    " less than or equal to %d",
+				    VY_RUN_PREFETCH_MAX));
+		return -1;
+	}
+	return 0;
+}
+
+static int
+box_check_vinyl_regulator_mode(const char *mode)
+{
+	if (mode == NULL ||
+	    (strcmp(mode, "static") != 0 && strcmp(mode, "adaptive") != 0)) {
+		diag_set(ClientError, ER_CFG, "vinyl_regulator_mode",
+			 "the value must be one of the following strings: "
+			 "'static', 'adaptive'");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -1255,6 +1317,11 @@ box_check_vinyl_options(void)
 		tnt_raise(ClientError, ER_CFG, "vinyl_bloom_fpr",
 			  "must be greater than 0 and less than or equal to 1");
 	}
+	if (box_check_vinyl_prefetch_pages(cfg_geti("vinyl_prefetch_pages")) != 0)
+		diag_raise();
+	if (box_check_vinyl_regulator_mode(
+			cfg_gets("vinyl_regulator_mode")) != 0)
+		diag_raise();
 }
 
 static int
@@ -1281,6 +1348,46 @@ box_check_allocator(void)
 	return 0;
 }
 
+static int
+box_check_memtx_index_build_threads(void)
+{
+	int threads = cfg_geti("memtx_index_build_threads");
+	if (threads < 0 || threads > MEMTX_INDEX_BUILD_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_index_build_threads",
+			 tt_sprintf("must be greater than or equal to 0,"
+				    " less than or equal to %d",
+				    MEMTX_INDEX_BUILD_THREADS_MAX));
+		return -1;
+	}
+	return threads;
+}
+
+static double
+box_check_memtx_read_view_interval(void)
+{
+	double interval = cfg_getd("memtx_read_view_interval");
+	if (interval < 0) {
+		diag_set(ClientError, ER_CFG, "memtx_read_view_interval",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return interval;
+}
+
+static int
+box_check_memtx_checkpoint_threads(void)
+{
+	int threads = cfg_geti("memtx_checkpoint_threads");
+	if (threads < 1 || threads > MEMTX_CHECKPOINT_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_checkpoint_threads",
+			 tt_sprintf("must be greater than or equal to 1,"
+				    " less than or equal to %d",
+				    MEMTX_CHECKPOINT_THREADS_MAX));
+		return -1;
+	}
+	return threads;
+}
+
 static void
 box_check_small_alloc_options(void)
 {
@@ -1305,6 +1412,36 @@ box_check_small_alloc_options(void)
 			  " to 1024 * 16 and exponent of two");
 }
 
+/**
+ * Parse iproto_cpu_affinity to @a cpus, which must have room for
+ * IPROTO_THREADS_MAX elements. Returns the number of CPUs or -1 on
+ * error (diag is set).
+ */
+static int
+box_check_iproto_cpu_affinity(int *cpus)
+{
+	int count = cfg_getarr_size("iproto_cpu_affinity");
+	if (count > IPROTO_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "iproto_cpu_affinity",
+			 tt_sprintf("must contain at most %d CPUs",
+				    IPROTO_THREADS_MAX));
+		return -1;
+	}
+	for (int i = 0; i < count; i++) {
+		const char *value = cfg_getarr_elem("iproto_cpu_affinity", i);
+		char *end;
+		long cpu = value != NULL ? strtol(value, &end, 10) : -1;
+		if (cpu < 0 || cpu > INT32_MAX || *end != '\0') {
+			diag_set(ClientError, ER_CFG, "iproto_cpu_affinity",
+				 "must be a CPU number or an array of CPU "
+				 "numbers");
+			return -1;
+		}
+		cpus[i] = cpu;
+	}
+	return count;
+}
+
 static int
 box_check_iproto_options(void)
 {
@@ -1316,6 +1453,9 @@ box_check_iproto_options(void)
 				     IPROTO_THREADS_MAX));
 		return -1;
 	}
+	int cpus[IPROTO_THREADS_MAX];
+	if (box_check_iproto_cpu_affinity(cpus) < 0)
+		return -1;
 	return 0;
 }
 
@@ -1396,11 +1536,17 @@ box_check_config(void)
 		diag_raise();
 	box_check_replication_sync_timeout();
 	box_check_readahead(cfg_geti("readahead"));
+	if (box_check_readahead_budget() < 0)
+		diag_raise();
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
+	if (box_check_wal_batch_window() < 0)
+		diag_raise();
+	if (box_check_wal_batch_max_size() < 0)
+		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
@@ -1409,6 +1555,12 @@ box_check_config(void)
 	if (box_check_allocator() != 0)
 		diag_raise();
 	box_check_small_alloc_options();
+	if (box_check_memtx_index_build_threads() < 0)
+		diag_raise();
+	if (box_check_memtx_read_view_interval() < 0)
+		diag_raise();
+	if (box_check_memtx_checkpoint_threads() < 0)
+		diag_raise();
 	box_check_vinyl_options();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
@@ -2102,7 +2254,7 @@ box_listen(void)
 	struct uri_set uri_set;
 	int rc = cfg_get_uri_set("listen", &uri_set);
 	assert(rc == 0);
-	rc = iproto_listen(&uri_set);
+	rc = iproto_listen(&uri_set, cfg_getb("iproto_reuseport") == 1);
 	uri_set_destroy(&uri_set);
 	return rc;
 }
@@ -2149,6 +2301,30 @@ box_set_memtx_max_tuple_size(void)
 			cfg_geti("memtx_max_tuple_size"));
 }
 
+void
+box_set_memtx_read_view_interval(void)
+{
+	double interval = box_check_memtx_read_view_interval();
+	if (interval < 0)
+		diag_raise();
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_read_view_interval(memtx, interval);
+}
+
+void
+box_set_memtx_checkpoint_threads(void)
+{
+	int threads = box_check_memtx_checkpoint_threads();
+	if (threads < 0)
+		diag_raise();
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_checkpoint_threads(memtx, threads);
+}
+
 void
 box_set_too_long_threshold(void)
 {
@@ -2167,6 +2343,16 @@ box_set_readahead(void)
 	iproto_readahead = readahead;
 }
 
+int
+box_set_readahead_budget(void)
+{
+	int64_t budget = box_check_readahead_budget();
+	if (budget < 0)
+		return -1;
+	iproto_readahead_budget = budget;
+	return 0;
+}
+
 void
 box_set_checkpoint_count(void)
 {
@@ -2199,6 +2385,26 @@ box_set_wal_queue_max_size(void)
 	return 0;
 }
 
+int
+box_set_wal_batch_window(void)
+{
+	double window = box_check_wal_batch_window();
+	if (window < 0)
+		return -1;
+	wal_set_batch_window(window);
+	return 0;
+}
+
+int
+box_set_wal_batch_max_size(void)
+{
+	int64_t size = box_check_wal_batch_max_size();
+	if (size < 0)
+		return -1;
+	wal_set_batch_max_size(size);
+	return 0;
+}
+
 int
 box_set_wal_cleanup_delay(void)
 {
@@ -2244,6 +2450,36 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
+void
+box_set_vinyl_prefetch_pages(void)
+{
+	int pages = cfg_geti("vinyl_prefetch_pages");
+	if (box_check_vinyl_prefetch_pages(pages) != 0)
+		diag_raise();
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_prefetch_pages(vinyl, pages);
+}
+
+void
+box_set_vinyl_regulator_mode(void)
+{
+	const char *mode = cfg_gets("vinyl_regulator_mode");
+	if (box_check_vinyl_regulator_mode(mode) != 0)
+		diag_raise();
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_regulator_mode(vinyl, mode);
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -2516,8 +2752,8 @@ box_select(uint32_t space_id, uint32_t index_id,
 	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
 
-	struct iterator *it = index_create_iterator(index, type,
-						    key, part_count);
+	struct iterator *it = index_create_iterator_with_offset(
+		index, type, key, part_count, offset);
 	if (it == NULL) {
 		txn_rollback_stmt(txn);
 		return -1;
@@ -2534,10 +2770,6 @@ box_select(uint32_t space_id, uint32_t index_id,
 		result_process_perform(&res_proc, &rc, &tuple);
 		if (rc != 0 || tuple == NULL)
 			break;
-		if (offset > 0) {
-			offset--;
-			continue;
-		}
 		rc = port_c_add_tuple(port, tuple);
 		if (rc != 0)
 			break;
@@ -2643,6 +2875,56 @@ box_upsert(uint32_t space_id, uint32_t index_id, const char *tuple,
 	return box_process1(&request, result);
 }
 
+int
+box_bulk_load(uint32_t space_id, const char *tuples, const char *tuples_end)
+{
+	(void)tuples_end;
+	assert(mp_typeof(*tuples) == MP_ARRAY);
+	if (box_txn_begin() != 0)
+		return -1;
+	bool is_bulk = false;
+	int csw = 0;
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		goto rollback;
+	/*
+	 * In the bulk insert mode, the space indexes lack the tuples
+	 * inserted so far. The engine enables the mode only if inserts
+	 * don't yield, so no other fiber may access or alter the space
+	 * until the mode is left.
+	 */
+	is_bulk = space_begin_bulk_insert(space);
+	csw = fiber()->csw;
+	for (uint32_t i = mp_decode_array(&tuples); i > 0; i--) {
+		if (mp_typeof(*tuples) != MP_ARRAY) {
+			diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+			goto rollback;
+		}
+		struct request request;
+		memset(&request, 0, sizeof(request));
+		request.type = IPROTO_INSERT;
+		request.space_id = space_id;
+		request.tuple = tuples;
+		mp_next(&tuples);
+		request.tuple_end = tuples;
+		if (box_process1(&request, NULL) != 0)
+			goto rollback;
+	}
+	assert(tuples == tuples_end);
+	assert(!is_bulk || fiber()->csw == csw);
+	(void)csw;
+	if (is_bulk && space_end_bulk_insert(space) != 0)
+		goto rollback;
+	return box_txn_commit();
+rollback:
+	assert(!is_bulk || fiber()->csw == csw);
+	box_txn_rollback();
+	/* Leave the bulk insert mode. Rollback emptied the batch. */
+	if (is_bulk && space_end_bulk_insert(space) != 0)
+		unreachable();
+	return -1;
+}
+
 /**
  * Trigger space truncation by bumping a counter
  * in _truncate space.
@@ -3378,6 +3660,10 @@ engine_init()
 				    cfg_getd("slab_alloc_factor"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
+	box_set_memtx_read_view_interval();
+	box_set_memtx_checkpoint_threads();
+	memtx_engine_set_index_build_threads(memtx,
+			cfg_geti("memtx_index_build_threads"));
 
 	struct sysview_engine *sysview = sysview_engine_new_xc();
 	engine_register((struct engine *)sysview);
@@ -3397,6 +3683,9 @@ engine_init()
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_prefetch_pages();
+	box_set_vinyl_regulator_mode();
 	box_set_vinyl_timeout();
 }
 
@@ -3670,7 +3959,7 @@ local_recovery(const struct tt_uuid *instance_uuid,
 	memtx_engine_recover_snapshot_xc(memtx, checkpoint_vclock);
 
 	engine_begin_final_recovery_xc();
-	recover_remaining_wals(recovery, &wal_stream.base, NULL, false);
+	recover_remaining_wals(recovery, &wal_stream.base, NULL, NULL, false);
 	if (wal_stream_has_tx(&wal_stream)) {
 		diag_set(XlogError, "found a not finished transaction "
 			 "in the log");
@@ -3697,7 +3986,8 @@ local_recovery(const struct tt_uuid *instance_uuid,
 			fiber_sleep(0.1);
 		}
 		recovery_stop_local(recovery);
-		recover_remaining_wals(recovery, &wal_stream.base, NULL, true);
+		recover_remaining_wals(recovery, &wal_stream.base, NULL, NULL,
+				       true);
 		if (wal_stream_has_tx(&wal_stream)) {
 			diag_set(XlogError, "found a not finished transaction "
 				 "in the log in hot standby mode");
@@ -3862,6 +4152,11 @@ box_cfg_xc(void)
 	replication_init(cfg_geti_default("replication_threads", 1));
 	port_init();
 	iproto_init(cfg_geti("iproto_threads"));
+	int cpus[IPROTO_THREADS_MAX];
+	int cpu_count = box_check_iproto_cpu_affinity(cpus);
+	assert(cpu_count >= 0);
+	if (cpu_count > 0 && iproto_set_cpu_affinity(cpus, cpu_count) != 0)
+		diag_raise();
 	sql_init();
 	audit_log_init(cfg_gets("audit_log"), cfg_geti("audit_nonblock"),
 		       cfg_gets("audit_format"), cfg_gets("audit_filter"));
@@ -3884,6 +4179,8 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_net_msg_max();
 	box_set_readahead();
+	if (box_set_readahead_budget() != 0)
+		diag_raise();
 	box_set_too_long_threshold();
 	box_set_replication_timeout();
 	box_set_replication_connect_timeout();
@@ -4142,6 +4439,7 @@ box_reset_stat(void)
 	rmean_cleanup(rmean_box);
 	rmean_cleanup(rmean_error);
 	engine_reset_stat();
+	wal_reset_stat();
 	space_foreach(box_reset_space_stat, NULL);
 }
 
@@ -251,16 +251,24 @@ void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
 void box_set_too_long_threshold(void);
 void box_set_readahead(void);
+int box_set_readahead_budget(void);
 void box_set_checkpoint_count(void);
 void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
+int box_set_wal_batch_window(void);
+int box_set_wal_batch_max_size(void);
 int box_set_wal_cleanup_delay(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
+void box_set_memtx_read_view_interval(void);
+void box_set_memtx_checkpoint_threads(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
+void box_set_vinyl_prefetch_pages(void);
+void box_set_vinyl_regulator_mode(void);
 void box_set_vinyl_timeout(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
@@ -565,6 +573,24 @@ int
 box_process_rw(struct request *request, struct space *space,
 	       struct tuple **result);
 
+/**
+ * Insert a batch of tuples into a space in one transaction. The batch
+ * is a MsgPack array of tuples. The engine may defer index updates
+ * until the whole batch is inserted, see space_vtab::begin_bulk_insert.
+ * Fails if there's an active transaction.
+ *
+ * The batch isn't split: all its statements are kept in memory until
+ * the transaction is committed and are written to WAL as one
+ * transaction, so the batch size should be limited by the caller.
+ *
+ * \param space_id Space identifier
+ * \param tuples Encoded array of tuples
+ * \param tuples_end End of \a tuples
+ * \retval 0 in success, -1 otherwise
+ */
+int
+box_bulk_load(uint32_t space_id, const char *tuples, const char *tuples_end);
+
 int
 boxk(int type, uint32_t space_id, const char *format, ...);
 
@@ -751,6 +751,29 @@ generic_index_create_iterator(struct index *base, enum iterator_type type,
 	return NULL;
 }
 
+struct iterator *
+generic_index_create_iterator_with_offset(struct index *base,
+					  enum iterator_type type,
+					  const char *key, uint32_t part_count,
+					  uint32_t offset)
+{
+	struct iterator *it = index_create_iterator(base, type, key,
+						    part_count);
+	if (it == NULL)
+		return NULL;
+	struct tuple *tuple;
+	while (offset > 0) {
+		if (iterator_next(it, &tuple) != 0) {
+			iterator_delete(it);
+			return NULL;
+		}
+		if (tuple == NULL)
+			break;
+		offset--;
+	}
+	return it;
+}
+
 
 struct snapshot_iterator *
 generic_index_create_snapshot_iterator(struct index *index)
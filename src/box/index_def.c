@@ -39,6 +39,8 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *compaction_policy_strs[] = { "tiered", "leveled", "lazy" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -48,6 +50,11 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .bloom_type          = */ BLOOM_TYPE_CLASSIC,
+	/* .compaction_policy   = */ COMPACTION_POLICY_TIERED,
+	/* .compression_dict    = */ false,
+	/* .covering            = */ false,
+	/* .cache_hot_ranges    = */ false,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
@@ -64,6 +71,15 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF_ENUM("bloom_type", bloom_type, struct index_opts, bloom_type,
+		     NULL),
+	OPT_DEF_ENUM("compaction_policy", compaction_policy, struct index_opts,
+		     compaction_policy, NULL),
+	OPT_DEF("compression_dict", OPT_BOOL, struct index_opts,
+		compression_dict),
+	OPT_DEF("covering", OPT_BOOL, struct index_opts, covering),
+	OPT_DEF("cache_hot_ranges", OPT_BOOL, struct index_opts,
+		cache_hot_ranges),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
@@ -33,6 +33,7 @@
 
 #include "key_def.h"
 #include "opt_def.h"
+#include "salad/bloom.h"
 #include "small/rlist.h"
 
 #if defined(__cplusplus)
@@ -58,6 +59,21 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl LSM tree compaction policy. */
+enum compaction_policy {
+	/*
+	 * Keep up to run_count_per_level runs per level, but
+	 * only one run at the last level.
+	 */
+	COMPACTION_POLICY_TIERED,
+	/* Keep one run per level. */
+	COMPACTION_POLICY_LEVELED,
+	/* Keep up to run_count_per_level runs at every level. */
+	COMPACTION_POLICY_LAZY,
+	compaction_policy_MAX
+};
+extern const char *compaction_policy_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -153,6 +169,25 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Bloom filter implementation used for new runs. */
+	enum bloom_type bloom_type;
+	/** Vinyl compaction policy. */
+	enum compaction_policy compaction_policy;
+	/**
+	 * Compress vinyl run pages with a zstd dictionary trained
+	 * on the index data.
+	 */
+	bool compression_dict;
+	/**
+	 * Store full tuples in a vinyl secondary index so that
+	 * reads from it don't need primary index lookups.
+	 */
+	bool covering;
+	/**
+	 * Give tuples and pages of vinyl ranges that get much more
+	 * reads than others priority in the cache.
+	 */
+	bool cache_hot_ranges;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -213,6 +248,16 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->bloom_type != o2->bloom_type)
+		return o1->bloom_type < o2->bloom_type ? -1 : 1;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy < o2->compaction_policy ? -1 : 1;
+	if (o1->compression_dict != o2->compression_dict)
+		return o1->compression_dict - o2->compression_dict;
+	if (o1->covering != o2->covering)
+		return o1->covering - o2->covering;
+	if (o1->cache_hot_ranges != o2->cache_hot_ranges)
+		return o1->cache_hot_ranges - o2->cache_hot_ranges;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
@@ -55,6 +55,7 @@
 #include "port.h"
 #include "box.h"
 #include "call.h"
+#include "tuple.h"
 #include "tuple_convert.h"
 #include "session.h"
 #include "xrow.h"
@@ -71,6 +72,7 @@
 #include "txn.h"
 #include "on_shutdown.h"
 #include "flightrec.h"
+#include "memtx_read_view.h"
 
 enum {
 	IPROTO_SALT_SIZE = 32,
@@ -81,6 +83,28 @@ enum {
 	 ENDPOINT_NAME_MAX = 10
 };
 
+enum {
+	/**
+	 * SELECT response tuples of this size or larger are sent to
+	 * the client directly from the tuple memory instead of being
+	 * copied to the connection output buffer.
+	 */
+	IPROTO_OBUF_REF_SIZE_MIN = 1024,
+	/** Max number of iovecs written to the socket at once. */
+	IPROTO_FLUSH_IOV_MAX = 64,
+	/**
+	 * Max readahead of a connection, in units of the configured
+	 * readahead, see iproto_connection_grow_readahead().
+	 */
+	IPROTO_READAHEAD_GROWTH_MAX = 16,
+};
+
+/**
+ * Period of checking connections for idleness, in seconds, see
+ * iproto_thread_check_idle_cb().
+ */
+static const double IPROTO_IDLE_CHECK_PERIOD = 1;
+
 struct iproto_connection;
 struct iproto_msg;
 
@@ -118,6 +142,12 @@ struct iproto_stream {
 struct iproto_wpos {
 	struct obuf *obuf;
 	struct obuf_svp svp;
+	/**
+	 * The last data reference appended to the obuf before
+	 * the position or NULL if the position doesn't publish
+	 * new references, see struct iproto_obuf_ref.
+	 */
+	struct iproto_obuf_ref *ref;
 };
 
 static void
@@ -125,8 +155,39 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 {
 	wpos->obuf = out;
 	wpos->svp = obuf_create_svp(out);
+	wpos->ref = NULL;
 }
 
+/**
+ * A reference to data that logically belongs to a connection
+ * output buffer, but is stored outside it. It is used to send
+ * large tuples to the client without copying them to the obuf:
+ * the tx thread references the tuple and appends the reference
+ * to the list of the obuf, the iproto thread writes the tuple
+ * data to the socket right from the tuple memory, and the tx
+ * thread unreferences the tuple when it resets the obuf.
+ *
+ * References of an obuf are linked in the order they were
+ * appended. The iproto thread only follows the links up to the
+ * last reference published with a write position, so it never
+ * reads a link that is being updated by the tx thread.
+ */
+struct iproto_obuf_ref {
+	/** Next reference of the same obuf. */
+	struct iproto_obuf_ref *next;
+	/** Referenced tuple. */
+	struct tuple *tuple;
+	/** Referenced data. */
+	const char *data;
+	/** Size of the referenced data. */
+	uint32_t size;
+	/**
+	 * Size of the obuf at the time the reference was appended.
+	 * The data is sent after this many bytes of the obuf.
+	 */
+	size_t used;
+};
+
 struct iproto_thread {
 	/**
 	 * Slab cache used for allocating memory for output network buffers
@@ -163,6 +224,7 @@ struct iproto_thread {
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
 	struct cmsg_hop process1_route[2];
+	struct cmsg_hop bulk_load_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
 	struct cmsg_hop subscribe_route[2];
@@ -192,6 +254,17 @@ struct iproto_thread {
 	struct evio_service binary;
 	/** Requests count currently pending in stream queue. */
 	size_t requests_in_stream_queue;
+	/** All connections of this thread, linked by in_connections. */
+	struct rlist connections;
+	/** Timer that adapts readahead of idle connections. */
+	struct ev_timer idle_timer;
+	/** Total size of input buffers of connections of this thread. */
+	size_t input_buffers_size;
+	/**
+	 * Reader used to serve SELECT requests from memtx read views
+	 * right in the iproto thread, see iproto_serve_select().
+	 */
+	struct memtx_read_view_reader read_view_reader;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -202,6 +275,8 @@ struct iproto_thread {
 		size_t requests_in_progress;
 		/** Iproto thread stat collected in tx thread. */
 		struct rmean *rmean;
+		/** Pool of struct iproto_obuf_ref. */
+		struct mempool obuf_ref_pool;
 	} tx;
 };
 
@@ -255,6 +330,20 @@ struct iproto_kharon {
  */
 unsigned iproto_readahead = 16320;
 
+/**
+ * Max total size of input buffers of all connections. Readahead
+ * of a connection may grow above iproto_readahead only while the
+ * total size of input buffers is below this limit. Assigned in tx
+ * thread without locks, same as iproto_readahead.
+ */
+size_t iproto_readahead_budget = 128 * 1024 * 1024;
+
+/**
+ * Total size of input buffers of all connections in all iproto
+ * threads. Updated atomically.
+ */
+static size_t iproto_input_buffers_size;
+
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
@@ -273,33 +362,6 @@ iproto_addr_str(char *buf, int idx)
 	return buf;
 }
 
-/**
- * How big is a buffer which needs to be shrunk before
- * it is put back into buffer cache.
- */
-static inline unsigned
-iproto_max_input_size(void)
-{
-	return 18 * iproto_readahead;
-}
-
-void
-iproto_reset_input(struct ibuf *ibuf)
-{
-	/*
-	 * If we happen to have fully processed the input,
-	 * move the pos to the start of the input buffer.
-	 */
-	assert(ibuf_used(ibuf) == 0);
-	if (ibuf_capacity(ibuf) < iproto_max_input_size()) {
-		ibuf_reset(ibuf);
-	} else {
-		struct slab_cache *slabc = ibuf->slabc;
-		ibuf_destroy(ibuf);
-		ibuf_create(ibuf, slabc, iproto_readahead);
-	}
-}
-
 /* {{{ iproto_msg - declaration */
 
 /**
@@ -565,6 +627,46 @@ struct iproto_connection
 	 * output is available (see iproto_msg::wpos).
 	 */
 	struct iproto_wpos wend;
+	/**
+	 * Heads of the lists of data references of the output buffers,
+	 * see struct iproto_obuf_ref.
+	 */
+	struct iproto_obuf_ref obuf_ref[2];
+	/**
+	 * The last data reference of each output buffer published
+	 * to the iproto thread with wend. Accessed only by the iproto
+	 * thread.
+	 */
+	struct iproto_obuf_ref *obuf_ref_last[2];
+	/**
+	 * The last data reference of the output buffer pointed to by
+	 * wpos that has been completely written to the socket, and
+	 * the number of bytes of the next reference written to the
+	 * socket. Accessed only by the iproto thread.
+	 */
+	struct iproto_obuf_ref *obuf_ref_sent;
+	size_t obuf_ref_sent_offset;
+	/**
+	 * Output buffer for replies to requests served right in the
+	 * iproto thread, see iproto_serve_select(). It's flushed
+	 * before the output buffers filled by the tx thread so it's
+	 * only written to while there's no pending tx output.
+	 */
+	struct obuf net_obuf;
+	/** Position of the data in net_obuf to be flushed next. */
+	struct obuf_svp net_obuf_sent;
+	/**
+	 * Authentication token and id of the session user. Set by
+	 * the tx thread on completion of each request.
+	 */
+	uint8_t auth_token;
+	uint32_t uid;
+	/**
+	 * Minimal sequence number of a memtx read view that reflects
+	 * all requests completed by the tx thread on this connection.
+	 * Set by the tx thread on completion of each request.
+	 */
+	uint64_t min_view_seq;
 	/*
 	 * Size of readahead which is not parsed yet, i.e. size of
 	 * a piece of request which is not fully read. Is always
@@ -577,6 +679,18 @@ struct iproto_connection
 	 * meaningless.
 	 */
 	size_t parse_size;
+	/**
+	 * Start capacity of the input buffers of this connection.
+	 * Grows while the client sends data faster than it is read
+	 * and shrinks back to iproto_readahead when it slows down.
+	 */
+	size_t readahead;
+	/** Set if any data was read since the last idle check. */
+	bool has_input;
+	/** Set if a read filled the input buffer since the last idle check. */
+	bool is_input_saturated;
+	/** Link in iproto_thread::connections. */
+	struct rlist in_connections;
 	/**
 	 * Nubmer of active long polling requests that have already
 	 * discarded their arguments in order not to stall other
@@ -661,6 +775,8 @@ struct iproto_connection
 		alignas(CACHELINE_SIZE)
 		/** Pointer to the current output buffer. */
 		struct obuf *p_obuf;
+		/** Tails of the output buffer data reference lists. */
+		struct iproto_obuf_ref *obuf_ref_tail[2];
 		/** True if Kharon is in use/travelling. */
 		bool is_push_sent;
 		/**
@@ -945,6 +1061,113 @@ iproto_connection_close(struct iproto_connection *con)
 	rlist_del(&con->in_stop_list);
 }
 
+/** Account a change of the capacity of a connection input buffer. */
+static inline void
+iproto_connection_account_input(struct iproto_connection *con,
+				ssize_t delta)
+{
+	con->iproto_thread->input_buffers_size += delta;
+	__atomic_add_fetch(&iproto_input_buffers_size, delta,
+			   __ATOMIC_RELAXED);
+}
+
+/** ibuf_reserve_xc() for a connection input buffer. */
+static inline void
+iproto_connection_reserve_input(struct iproto_connection *con,
+				struct ibuf *ibuf, size_t size)
+{
+	size_t capacity = ibuf_capacity(ibuf);
+	ibuf_reserve_xc(ibuf, size);
+	iproto_connection_account_input(con, ibuf_capacity(ibuf) - capacity);
+}
+
+/**
+ * Free the memory of an empty connection input buffer. The next
+ * reserve allocates a buffer of the current connection readahead.
+ */
+static void
+iproto_connection_free_input(struct iproto_connection *con,
+			     struct ibuf *ibuf)
+{
+	assert(ibuf_used(ibuf) == 0);
+	struct slab_cache *slabc = ibuf->slabc;
+	iproto_connection_account_input(con, -(ssize_t)ibuf_capacity(ibuf));
+	ibuf_destroy(ibuf);
+	ibuf_create(ibuf, slabc, con->readahead);
+}
+
+/**
+ * Called when the input buffer has been fully processed. Move the
+ * read position to the start of the buffer, or reallocate the
+ * buffer if its size doesn't match the connection readahead: it
+ * is either too small after the readahead has grown or too big
+ * after a large request.
+ */
+static void
+iproto_connection_reset_input(struct iproto_connection *con,
+			      struct ibuf *ibuf)
+{
+	assert(ibuf_used(ibuf) == 0);
+	size_t capacity = ibuf_capacity(ibuf);
+	if (capacity != 0 &&
+	    (capacity < con->readahead || capacity >= 18 * con->readahead))
+		iproto_connection_free_input(con, ibuf);
+	else
+		ibuf_reset(ibuf);
+}
+
+/**
+ * Called when a read fills the whole input buffer, i.e. the client
+ * sends data faster than it is read. Double the readahead of the
+ * connection unless the total size of input buffers exceeds the
+ * budget.
+ */
+static void
+iproto_connection_grow_readahead(struct iproto_connection *con)
+{
+	con->is_input_saturated = true;
+	size_t max = IPROTO_READAHEAD_GROWTH_MAX * (size_t)iproto_readahead;
+	if (con->readahead >= max)
+		return;
+	if (__atomic_load_n(&iproto_input_buffers_size, __ATOMIC_RELAXED) >=
+	    iproto_readahead_budget)
+		return;
+	con->readahead = MIN(2 * con->readahead, max);
+}
+
+/**
+ * Periodically called in an iproto thread. Shrink readahead of
+ * connections that haven't filled their input buffers since the
+ * last check and free input buffers of connections that haven't
+ * received any data, so that idle connections don't hold memory.
+ */
+static void
+iproto_thread_check_idle_cb(ev_loop *loop, struct ev_timer *timer,
+			    int events)
+{
+	(void)loop;
+	(void)events;
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *)timer->data;
+	struct iproto_connection *con;
+	rlist_foreach_entry(con, &iproto_thread->connections,
+			    in_connections) {
+		if (!con->is_input_saturated)
+			con->readahead = MAX(con->readahead / 2,
+					     (size_t)iproto_readahead);
+		if (!con->has_input && con->parse_size == 0) {
+			for (int i = 0; i < 2; i++) {
+				struct ibuf *ibuf = &con->ibuf[i];
+				if (ibuf_used(ibuf) == 0 &&
+				    ibuf_capacity(ibuf) != 0)
+					iproto_connection_free_input(con, ibuf);
+			}
+		}
+		con->has_input = false;
+		con->is_input_saturated = false;
+	}
+}
+
 static inline struct ibuf *
 iproto_connection_next_input(struct iproto_connection *con)
 {
@@ -995,8 +1218,13 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		 * buffer as read position is shifted to the
 		 * end of the buffer.
 		 */
-		if (ibuf_used(old_ibuf) == 0)
-			ibuf_reset(old_ibuf);
+		if (ibuf_used(old_ibuf) == 0) {
+			iproto_connection_reset_input(con, old_ibuf);
+			if (ibuf_unused(old_ibuf) < to_read) {
+				iproto_connection_reserve_input(con, old_ibuf,
+								to_read);
+			}
+		}
 		return old_ibuf;
 	}
 
@@ -1005,7 +1233,7 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 	 * (in only has unparsed content).
 	 */
 	if (ibuf_used(old_ibuf) == con->parse_size) {
-		ibuf_reserve_xc(old_ibuf, to_read);
+		iproto_connection_reserve_input(con, old_ibuf, to_read);
 		return old_ibuf;
 	}
 
@@ -1018,12 +1246,11 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		return NULL;
 	}
 	/* Update buffer size if readahead has changed. */
-	if (new_ibuf->start_capacity != iproto_readahead) {
-		ibuf_destroy(new_ibuf);
-		ibuf_create(new_ibuf, cord_slab_cache(), iproto_readahead);
-	}
+	if (new_ibuf->start_capacity != con->readahead)
+		iproto_connection_free_input(con, new_ibuf);
 
-	ibuf_reserve_xc(new_ibuf, to_read + con->parse_size);
+	iproto_connection_reserve_input(con, new_ibuf,
+					to_read + con->parse_size);
 	/*
 	 * Discard unparsed data in the old buffer, otherwise it
 	 * won't be recycled when all parsed requests are processed.
@@ -1039,7 +1266,7 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		 * them.
 		 */
 		if (ibuf_used(old_ibuf) == 0)
-			iproto_reset_input(old_ibuf);
+			iproto_connection_reset_input(con, old_ibuf);
 	}
 	/*
 	 * Rotate buffers. Not strictly necessary, but
@@ -1092,6 +1319,80 @@ iproto_msg_start_processing_in_stream(struct iproto_msg *msg)
 	return 1;
 }
 
+/** Check if the tx thread output is completely flushed. */
+static inline bool
+iproto_connection_tx_output_is_flushed(struct iproto_connection *con)
+{
+	return con->wpos.obuf == con->wend.obuf &&
+	       con->wpos.svp.used == con->wend.svp.used &&
+	       con->obuf_ref_sent ==
+			con->obuf_ref_last[con->wpos.obuf - con->obuf];
+}
+
+/** Append a tuple selected from a memtx read view to the output. */
+static int
+iproto_serve_select_cb(struct tuple *tuple, void *arg)
+{
+	struct obuf *out = (struct obuf *)arg;
+	uint32_t size = tuple_bsize(tuple);
+	if (obuf_dup(out, tuple_data(tuple), size) != size) {
+		diag_set(OutOfMemory, size, "obuf_dup", "data");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Try to serve a SELECT request from a memtx read view right in the
+ * iproto thread, without a round trip to tx (see memtx_read_view.h).
+ * This is only possible if all previous requests of the connection
+ * have been completed and their replies flushed so that the reply
+ * is sent in order and reflects all changes made by the connection.
+ *
+ * Returns true if the reply was written to the connection output,
+ * false if the request must be processed by tx.
+ */
+static bool
+iproto_serve_select(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct ibuf *other_ibuf = con->p_ibuf == &con->ibuf[0] ?
+				  &con->ibuf[1] : &con->ibuf[0];
+	if (msg->header.type != IPROTO_SELECT ||
+	    msg->header.stream_id != 0 ||
+	    msg->base.route != iproto_thread->dml_route[IPROTO_SELECT] ||
+	    con->state != IPROTO_CONNECTION_ALIVE ||
+	    con->long_poll_count != 0 ||
+	    msg->p_ibuf != con->p_ibuf ||
+	    msg->reqstart != con->p_ibuf->rpos ||
+	    ibuf_used(other_ibuf) != 0 ||
+	    !iproto_connection_tx_output_is_flushed(con))
+		return false;
+	struct obuf *out = &con->net_obuf;
+	struct obuf_svp svp;
+	if (iproto_prepare_select(out, &svp) != 0)
+		goto fail;
+	{
+		uint32_t schema_version = msg->header.schema_version;
+		ssize_t count = memtx_read_view_select(
+			&iproto_thread->read_view_reader, con->auth_token,
+			con->uid, con->min_view_seq, &msg->dml, &schema_version,
+			iproto_serve_select_cb, out);
+		if (count < 0) {
+			obuf_rollback_to_svp(out, &svp);
+			goto fail;
+		}
+		iproto_reply_select(out, &svp, msg->header.sync,
+				    schema_version, count);
+	}
+	return true;
+fail:
+	/* The request will be retried in tx, which will set diag. */
+	diag_clear(diag_get());
+	return false;
+}
+
 /**
  * Enqueue all requests which were read up. If a request limit is
  * reached - stop the connection input even if not the whole batch
@@ -1156,6 +1457,17 @@ err_msgpack:
 
 		iproto_msg_decode(msg, &pos, reqend, &stop_input);
 
+		if (iproto_serve_select(msg)) {
+			/* Discard the request, the reply is ready. */
+			msg->p_ibuf->rpos += msg->len;
+			iproto_msg_delete(msg);
+			iproto_connection_feed_output(con);
+			n_requests++;
+			assert(con->parse_size >= (size_t)(reqend - reqstart));
+			con->parse_size -= reqend - reqstart;
+			continue;
+		}
+
 		int rc = iproto_msg_start_processing_in_stream(msg);
 		if (rc < 0) {
 			iproto_msg_delete(msg);
@@ -1290,7 +1602,8 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			return;
 		}
 		/* Read input. */
-		ssize_t nrd = iostream_read(io, in->wpos, ibuf_unused(in));
+		size_t unused = ibuf_unused(in);
+		ssize_t nrd = iostream_read(io, in->wpos, unused);
 		if (nrd < 0) {                  /* Socket is not ready. */
 			if (nrd == IOSTREAM_ERROR)
 				diag_raise();
@@ -1309,6 +1622,9 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 		/* Count statistics */
 		rmean_collect(con->iproto_thread->rmean,
 			      IPROTO_RECEIVED, nrd);
+		con->has_input = true;
+		if ((size_t)nrd == unused)
+			iproto_connection_grow_readahead(con);
 
 		/* Update the read position and connection state. */
 		in->wpos += nrd;
@@ -1324,64 +1640,138 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
-/** writev() to the socket and handle the result. */
+/**
+ * Advance the end of the data awaiting to be flushed to
+ * a position received from the tx thread.
+ */
+static inline void
+iproto_connection_set_wend(struct iproto_connection *con,
+			   const struct iproto_wpos *wpos)
+{
+	con->wend = *wpos;
+	if (wpos->ref != NULL)
+		con->obuf_ref_last[wpos->obuf - con->obuf] = wpos->ref;
+}
+
+/** writev() the tx thread output to the socket and handle the result. */
 static int
-iproto_flush(struct iproto_connection *con)
+iproto_flush_tx(struct iproto_connection *con)
 {
 	struct obuf *obuf = con->wpos.obuf;
 	struct obuf_svp obuf_end = obuf_create_svp(obuf);
 	struct obuf_svp *begin = &con->wpos.svp;
 	struct obuf_svp *end = &con->wend.svp;
+	struct iproto_obuf_ref *end_ref = con->obuf_ref_last[obuf - con->obuf];
 	if (con->wend.obuf != obuf) {
 		/*
 		 * Flush the current buffer before
 		 * advancing to the next one.
 		 */
-		if (begin->used == obuf_end.used) {
+		if (begin->used == obuf_end.used &&
+		    con->obuf_ref_sent == end_ref) {
+			int i = obuf - con->obuf;
+			con->obuf_ref_last[i] = &con->obuf_ref[i];
 			obuf = con->wpos.obuf = con->wend.obuf;
 			obuf_svp_reset(begin);
+			i = obuf - con->obuf;
+			end_ref = con->obuf_ref_last[i];
+			con->obuf_ref_sent = &con->obuf_ref[i];
+			con->obuf_ref_sent_offset = 0;
 		} else {
 			end = &obuf_end;
 		}
 	}
-	if (begin->used == end->used) {
+	if (begin->used == end->used && con->obuf_ref_sent == end_ref) {
 		/* Nothing to do. */
 		return 1;
 	}
 	if (!con->can_write) {
 		/* Receiving end was closed. Discard the output. */
 		*begin = *end;
+		con->obuf_ref_sent = end_ref;
+		con->obuf_ref_sent_offset = 0;
 		return 0;
 	}
-	assert(begin->used < end->used);
-	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
-	struct iovec *src = obuf->iov;
-	int iovcnt = end->pos - begin->pos + 1;
+	assert(begin->used <= end->used);
 	/*
-	 * iov[i].iov_len may be concurrently modified in tx thread,
-	 * but only for the last position.
+	 * Interleave the obuf data with the referenced data. For
+	 * each iovec remember where it starts so that the write
+	 * position can be advanced after a partial write.
 	 */
-	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
-	sio_add_to_iov(iov, -begin->iov_len);
-	/* *Overwrite* iov_len of the last pos as it may be garbage. */
-	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+	struct iovec iov[IPROTO_FLUSH_IOV_MAX];
+	struct {
+		/** Reference the iovec points to, NULL for obuf data. */
+		struct iproto_obuf_ref *ref;
+		/** Obuf position the iovec starts at. */
+		struct obuf_svp svp;
+	} seg[IPROTO_FLUSH_IOV_MAX];
+	int iovcnt = 0;
+	size_t size = 0;
+	struct obuf_svp pos = *begin;
+	struct iproto_obuf_ref *ref = con->obuf_ref_sent;
+	size_t ref_offset = con->obuf_ref_sent_offset;
+	while (iovcnt < IPROTO_FLUSH_IOV_MAX) {
+		struct iproto_obuf_ref *next = ref != end_ref ? ref->next : NULL;
+		if (next != NULL && next->used == pos.used) {
+			iov[iovcnt].iov_base = (char *)next->data + ref_offset;
+			iov[iovcnt].iov_len = next->size - ref_offset;
+			seg[iovcnt].ref = next;
+			size += iov[iovcnt].iov_len;
+			iovcnt++;
+			ref = next;
+			ref_offset = 0;
+			continue;
+		}
+		size_t limit = next != NULL ? next->used : end->used;
+		if (pos.used == limit)
+			break;
+		/*
+		 * iov[i].iov_len may be concurrently modified in tx
+		 * thread, but only for the last position.
+		 */
+		size_t chunk_len = pos.pos < end->pos ?
+				   obuf->iov[pos.pos].iov_len : end->iov_len;
+		if (pos.iov_len == chunk_len) {
+			assert(pos.pos < end->pos);
+			pos.pos++;
+			pos.iov_len = 0;
+			continue;
+		}
+		size_t len = MIN(chunk_len - pos.iov_len, limit - pos.used);
+		iov[iovcnt].iov_base =
+			(char *)obuf->iov[pos.pos].iov_base + pos.iov_len;
+		iov[iovcnt].iov_len = len;
+		seg[iovcnt].ref = NULL;
+		seg[iovcnt].svp = pos;
+		size += len;
+		iovcnt++;
+		pos.iov_len += len;
+		pos.used += len;
+	}
+	assert(iovcnt > 0);
 
 	ssize_t nwr = iostream_writev(&con->io, iov, iovcnt);
 	if (nwr >= 0) {
 		/* Count statistics */
 		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
-		if (begin->used + nwr == end->used) {
-			*begin = *end;
-			return 0;
+		size_t left = nwr;
+		for (int i = 0; i < iovcnt && left > 0; i++) {
+			size_t len = MIN(iov[i].iov_len, left);
+			left -= len;
+			if (seg[i].ref == NULL) {
+				/* Advance the write position. */
+				*begin = seg[i].svp;
+				begin->iov_len += len;
+				begin->used += len;
+			} else if (len == iov[i].iov_len) {
+				con->obuf_ref_sent = seg[i].ref;
+				con->obuf_ref_sent_offset = 0;
+			} else {
+				con->obuf_ref_sent_offset += len;
+			}
 		}
-		size_t offset = 0;
-		int advance = 0;
-		advance = sio_move_iov(iov, nwr, &offset);
-		begin->used += nwr;             /* advance write position */
-		begin->iov_len = advance == 0 ? begin->iov_len + offset: offset;
-		begin->pos += advance;
 		assert(begin->pos <= end->pos);
-		return IOSTREAM_WANT_WRITE;
+		return (size_t)nwr == size ? 0 : IOSTREAM_WANT_WRITE;
 	} else if (nwr == IOSTREAM_ERROR) {
 		/*
 		 * Don't close the connection on write error. Log the error and
@@ -1392,11 +1782,91 @@ iproto_flush(struct iproto_connection *con)
 		diag_log();
 		con->can_write = false;
 		*begin = *end;
+		con->obuf_ref_sent = end_ref;
+		con->obuf_ref_sent_offset = 0;
 		return 0;
 	}
 	return nwr;
 }
 
+/** writev() the iproto thread output to the socket. */
+static int
+iproto_flush_net_obuf(struct iproto_connection *con)
+{
+	struct obuf *obuf = &con->net_obuf;
+	struct obuf_svp *begin = &con->net_obuf_sent;
+	if (!con->can_write) {
+		/* Receiving end was closed. Discard the output. */
+		obuf_reset(obuf);
+		obuf_svp_reset(begin);
+		return 0;
+	}
+	struct iovec iov[IPROTO_FLUSH_IOV_MAX];
+	int iovcnt = 0;
+	size_t size = 0;
+	for (int i = begin->pos;
+	     i <= obuf->pos && iovcnt < IPROTO_FLUSH_IOV_MAX; i++) {
+		size_t offset = i == begin->pos ? begin->iov_len : 0;
+		if (obuf->iov[i].iov_len == offset)
+			continue;
+		iov[iovcnt].iov_base = (char *)obuf->iov[i].iov_base + offset;
+		iov[iovcnt].iov_len = obuf->iov[i].iov_len - offset;
+		size += iov[iovcnt].iov_len;
+		iovcnt++;
+	}
+	assert(iovcnt > 0);
+
+	ssize_t nwr = iostream_writev(&con->io, iov, iovcnt);
+	if (nwr >= 0) {
+		/* Count statistics */
+		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+		if (begin->used + nwr == obuf_size(obuf)) {
+			/* All output is flushed, recycle the buffer. */
+			obuf_reset(obuf);
+			obuf_svp_reset(begin);
+			return 0;
+		}
+		/* Advance the write position. */
+		size_t left = nwr;
+		while (left > 0) {
+			size_t avail = obuf->iov[begin->pos].iov_len -
+				       begin->iov_len;
+			if (avail == 0) {
+				assert(begin->pos < obuf->pos);
+				begin->pos++;
+				begin->iov_len = 0;
+				continue;
+			}
+			size_t len = MIN(avail, left);
+			begin->iov_len += len;
+			begin->used += len;
+			left -= len;
+		}
+		return (size_t)nwr == size ? 0 : IOSTREAM_WANT_WRITE;
+	} else if (nwr == IOSTREAM_ERROR) {
+		/* See the comment in iproto_flush_tx(). */
+		diag_log();
+		con->can_write = false;
+		obuf_reset(obuf);
+		obuf_svp_reset(begin);
+		return 0;
+	}
+	return nwr;
+}
+
+/**
+ * writev() to the socket and handle the result. Replies to requests
+ * served in the iproto thread are written first, because they were
+ * generated while there was no pending tx output.
+ */
+static int
+iproto_flush(struct iproto_connection *con)
+{
+	if (obuf_size(&con->net_obuf) != 0)
+		return iproto_flush_net_obuf(con);
+	return iproto_flush_tx(con);
+}
+
 static void
 iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 			    int /* revents */)
@@ -1442,16 +1912,35 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	iostream_clear(&con->io);
 	ev_io_init(&con->input, iproto_connection_on_input, -1, EV_NONE);
 	ev_io_init(&con->output, iproto_connection_on_output, -1, EV_NONE);
-	ibuf_create(&con->ibuf[0], cord_slab_cache(), iproto_readahead);
-	ibuf_create(&con->ibuf[1], cord_slab_cache(), iproto_readahead);
+	con->readahead = iproto_readahead;
+	con->has_input = false;
+	con->is_input_saturated = false;
+	ibuf_create(&con->ibuf[0], cord_slab_cache(), con->readahead);
+	ibuf_create(&con->ibuf[1], cord_slab_cache(), con->readahead);
 	obuf_create(&con->obuf[0], &con->iproto_thread->net_slabc,
 		    iproto_readahead);
 	obuf_create(&con->obuf[1], &con->iproto_thread->net_slabc,
 		    iproto_readahead);
+	/*
+	 * Unlike obuf[], net_obuf is used only by the iproto thread
+	 * so it may use the thread's slab cache.
+	 */
+	obuf_create(&con->net_obuf, cord_slab_cache(), iproto_readahead);
+	obuf_svp_reset(&con->net_obuf_sent);
+	con->auth_token = BOX_USER_MAX;
+	con->uid = BOX_ID_NIL;
+	con->min_view_seq = 0;
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
+	for (int i = 0; i < 2; i++) {
+		con->obuf_ref[i].next = NULL;
+		con->obuf_ref_last[i] = &con->obuf_ref[i];
+		con->tx.obuf_ref_tail[i] = &con->obuf_ref[i];
+	}
+	con->obuf_ref_sent = &con->obuf_ref[0];
+	con->obuf_ref_sent_offset = 0;
 	con->parse_size = 0;
 	con->can_write = true;
 	con->long_poll_count = 0;
@@ -1461,6 +1950,7 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	cmsg_init(&con->destroy_msg, con->iproto_thread->destroy_route);
 	cmsg_init(&con->disconnect_msg, con->iproto_thread->disconnect_route);
 	con->state = IPROTO_CONNECTION_ALIVE;
+	rlist_add_entry(&iproto_thread->connections, con, in_connections);
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
 	rmean_collect(iproto_thread->rmean, IPROTO_CONNECTIONS, 1);
@@ -1479,8 +1969,13 @@ iproto_connection_delete(struct iproto_connection *con)
 	 * The output buffers must have been deleted
 	 * in tx thread.
 	 */
+	iproto_connection_account_input(con,
+		-(ssize_t)(ibuf_capacity(&con->ibuf[0]) +
+			   ibuf_capacity(&con->ibuf[1])));
 	ibuf_destroy(&con->ibuf[0]);
 	ibuf_destroy(&con->ibuf[1]);
+	obuf_destroy(&con->net_obuf);
+	rlist_del_entry(con, in_connections);
 	assert(con->obuf[0].pos == 0 &&
 	       con->obuf[0].iov[0].iov_base == NULL);
 	assert(con->obuf[1].pos == 0 &&
@@ -1590,6 +2085,14 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		              sizeof(*(iproto_thread->dml_route)));
 		cmsg_init(&msg->base, iproto_thread->dml_route[type]);
 		break;
+	case IPROTO_BULK_LOAD:
+		/* Same body as INSERT, but the tuple is an array of tuples. */
+		if (xrow_decode_dml(&msg->header, &msg->dml,
+				    dml_request_key_map(IPROTO_INSERT)))
+			goto error;
+		msg->dml.header = NULL;
+		cmsg_init(&msg->base, iproto_thread->bulk_load_route);
+		break;
 	case IPROTO_BEGIN:
 		if (xrow_decode_begin(&msg->header, &msg->begin) != 0)
 			goto error;
@@ -1756,6 +2259,58 @@ net_finish_disconnect(struct cmsg *m)
 	iproto_connection_try_to_start_destroy(con);
 }
 
+/**
+ * Append a reference to @a tuple data to the output buffer @a out.
+ * The tuple is referenced until the buffer is reset.
+ */
+static int
+tx_obuf_add_ref(struct iproto_connection *con, struct obuf *out,
+		struct tuple *tuple)
+{
+	struct iproto_obuf_ref *ref = (struct iproto_obuf_ref *)
+		mempool_alloc(&con->iproto_thread->tx.obuf_ref_pool);
+	if (ref == NULL) {
+		diag_set(OutOfMemory, sizeof(*ref), "mempool_alloc",
+			 "struct iproto_obuf_ref");
+		return -1;
+	}
+	ref->next = NULL;
+	ref->tuple = tuple;
+	ref->data = tuple_data_range(tuple, &ref->size);
+	ref->used = obuf_size(out);
+	tuple_ref(tuple);
+	struct iproto_obuf_ref **tail = &con->tx.obuf_ref_tail[out - con->obuf];
+	(*tail)->next = ref;
+	*tail = ref;
+	return 0;
+}
+
+/**
+ * Release the data references of the output buffer @a out
+ * appended after @a last.
+ */
+static void
+tx_obuf_release_refs_after(struct iproto_connection *con, struct obuf *out,
+			   struct iproto_obuf_ref *last)
+{
+	struct iproto_obuf_ref *ref = last->next;
+	while (ref != NULL) {
+		struct iproto_obuf_ref *next = ref->next;
+		tuple_unref(ref->tuple);
+		mempool_free(&con->iproto_thread->tx.obuf_ref_pool, ref);
+		ref = next;
+	}
+	last->next = NULL;
+	con->tx.obuf_ref_tail[out - con->obuf] = last;
+}
+
+/** Release all data references of the output buffer @a out. */
+static inline void
+tx_obuf_release_refs(struct iproto_connection *con, struct obuf *out)
+{
+	tx_obuf_release_refs_after(con, out, &con->obuf_ref[out - con->obuf]);
+}
+
 /**
  * Destroy the session object, as well as output buffers of the
  * connection.
@@ -1774,6 +2329,8 @@ tx_process_destroy(struct cmsg *m)
 	 * obuf is being destroyed in tx thread cause it is where
 	 * it was allocated.
 	 */
+	tx_obuf_release_refs(con, &con->obuf[0]);
+	tx_obuf_release_refs(con, &con->obuf[1]);
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
 }
@@ -1853,8 +2410,10 @@ tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 		 * guaranteed to have been flushed first, since
 		 * buffers are never flushed out of order.
 		 */
-		if (obuf_size(prev) != 0)
+		if (obuf_size(prev) != 0) {
+			tx_obuf_release_refs(con, prev);
 			obuf_reset(prev);
+		}
 	}
 	if (obuf_size(con->tx.p_obuf) != 0 && obuf_size(prev) == 0) {
 		/*
@@ -1898,6 +2457,18 @@ tx_accept_msg(struct cmsg *m)
 	return msg;
 }
 
+/**
+ * Update the state the iproto thread uses to check if it may serve
+ * requests of the connection from memtx read views.
+ */
+static inline void
+tx_update_read_view_state(struct iproto_connection *con)
+{
+	con->auth_token = con->session->credentials.auth_token;
+	con->uid = con->session->credentials.uid;
+	con->min_view_seq = memtx_read_view_next_seq();
+}
+
 static inline void
 tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 {
@@ -1905,6 +2476,7 @@ tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 		assert(msg->stream->txn == NULL);
 		msg->stream->txn = txn_detach();
 	}
+	tx_update_read_view_state(msg->connection);
 	msg->connection->iproto_thread->tx.requests_in_progress--;
 	/* Log response to the flight recorder. */
 	struct obuf *out = msg->connection->tx.p_obuf;
@@ -2072,6 +2644,76 @@ error:
 	tx_end_msg(msg, &svp);
 }
 
+static void
+tx_process_bulk_load(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct obuf *out;
+	struct obuf_svp header;
+
+	if (tx_check_schema(msg->header.schema_version))
+		goto error;
+
+	tx_inject_delay();
+	if (box_bulk_load(msg->dml.space_id, msg->dml.tuple,
+			  msg->dml.tuple_end) != 0)
+		goto error;
+
+	out = msg->connection->tx.p_obuf;
+	header = obuf_create_svp(out);
+	iproto_reply_ok(out, msg->header.sync, ::schema_version);
+	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, &header);
+	return;
+error:
+	out = msg->connection->tx.p_obuf;
+	header = obuf_create_svp(out);
+	tx_reply_error(msg);
+	tx_end_msg(msg, &header);
+}
+
+/**
+ * Dump SELECT result tuples to the output buffer. Large tuples
+ * aren't copied, they are referenced by the buffer instead, see
+ * struct iproto_obuf_ref. Returns the number of tuples and the
+ * total size of referenced data in @a ref_size on success, -1 on
+ * error (diag is set).
+ */
+static int
+tx_dump_select(struct iproto_connection *con, struct port *base,
+	       struct obuf *out, size_t *ref_size)
+{
+	struct port_c *port = (struct port_c *)base;
+	struct iproto_obuf_ref *last = con->tx.obuf_ref_tail[out - con->obuf];
+	*ref_size = 0;
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		uint32_t size = pe->mp_size;
+		if (size != 0) {
+			if (obuf_dup(out, pe->mp, size) != size) {
+				diag_set(OutOfMemory, size, "obuf_dup", "data");
+				goto error;
+			}
+		} else if (tuple_bsize(pe->tuple) >= IPROTO_OBUF_REF_SIZE_MIN) {
+			if (tx_obuf_add_ref(con, out, pe->tuple) != 0)
+				goto error;
+			*ref_size += tuple_bsize(pe->tuple);
+		} else if (tuple_to_obuf(pe->tuple, out) != 0) {
+			goto error;
+		}
+		ERROR_INJECT(ERRINJ_PORT_DUMP, {
+			diag_set(OutOfMemory,
+				 size == 0 ? tuple_size(pe->tuple) : size,
+				 "obuf_dup", "data");
+			goto error;
+		});
+	}
+	return port->size;
+error:
+	tx_obuf_release_refs_after(con, out, last);
+	return -1;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -2081,6 +2723,7 @@ tx_process_select(struct cmsg *m)
 	struct port port;
 	int count;
 	int rc;
+	size_t ref_size;
 	struct request *req = &msg->dml;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
@@ -2100,16 +2743,19 @@ tx_process_select(struct cmsg *m)
 	/*
 	 * SELECT output format has not changed since Tarantool 1.6
 	 */
-	count = port_dump_msgpack_16(&port, out);
+	count = tx_dump_select(msg->connection, &port, out, &ref_size);
 	port_destroy(&port);
 	if (count < 0) {
 		/* Discard the prepared select. */
 		obuf_rollback_to_svp(out, &svp);
 		goto error;
 	}
-	iproto_reply_select(out, &svp, msg->header.sync,
-			    ::schema_version, count);
+	iproto_reply_select_ext(out, &svp, msg->header.sync,
+				::schema_version, count, ref_size);
 	iproto_wpos_create(&msg->wpos, out);
+	if (ref_size != 0)
+		msg->wpos.ref = msg->connection->tx.obuf_ref_tail[
+			out - msg->connection->obuf];
 	tx_end_msg(msg, &svp);
 	return;
 error:
@@ -2511,7 +3157,7 @@ net_send_msg(struct cmsg *m)
 		assert(con->long_poll_count > 0);
 		con->long_poll_count--;
 	}
-	con->wend = msg->wpos;
+	iproto_connection_set_wend(con, &msg->wpos);
 
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
 		iproto_connection_feed_output(con);
@@ -2595,6 +3241,7 @@ tx_process_connect(struct cmsg *m)
 			if (session_run_on_connect_triggers(con->session) != 0)
 				diag_raise();
 		}
+		tx_update_read_view_state(con);
 		iproto_wpos_create(&msg->wpos, out);
 	} catch (Exception *e) {
 		tx_reply_error(msg);
@@ -2627,7 +3274,7 @@ net_send_greeting(struct cmsg *m)
 		iproto_msg_delete(msg);
 		return;
 	}
-	con->wend = msg->wpos;
+	iproto_connection_set_wend(con, &msg->wpos);
 	/*
 	 * Connect is synchronous, so no one could have been
 	 * messing up with the connection while it was in
@@ -2694,6 +3341,11 @@ net_cord_f(va_list  ap)
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept, iproto_thread);
 
+	ev_timer_init(&iproto_thread->idle_timer, iproto_thread_check_idle_cb,
+		      IPROTO_IDLE_CHECK_PERIOD, IPROTO_IDLE_CHECK_PERIOD);
+	iproto_thread->idle_timer.data = iproto_thread;
+	ev_timer_start(loop(), &iproto_thread->idle_timer);
+
 	char endpoint_name[ENDPOINT_NAME_MAX];
 	snprintf(endpoint_name, ENDPOINT_NAME_MAX, "net%u",
 		 iproto_thread->id);
@@ -2709,6 +3361,7 @@ net_cord_f(va_list  ap)
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
+	ev_timer_stop(loop(), &iproto_thread->idle_timer);
 	cpipe_destroy(&iproto_thread->tx_pipe);
 	/*
 	 * Nothing to do in the fiber so far, the service
@@ -2743,7 +3396,7 @@ iproto_process_push(struct cmsg *m)
 	struct iproto_kharon *kharon = (struct iproto_kharon *) m;
 	struct iproto_connection *con =
 		container_of(kharon, struct iproto_connection, kharon);
-	con->wend = kharon->wpos;
+	iproto_connection_set_wend(con, &kharon->wpos);
 	kharon->wpos = con->wpos;
 	if (con->state == IPROTO_CONNECTION_ALIVE)
 		iproto_connection_feed_output(con);
@@ -2893,6 +3546,9 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
+	iproto_thread->bulk_load_route[0] =
+		{ tx_process_bulk_load, &iproto_thread->net_pipe };
+	iproto_thread->bulk_load_route[1] = { net_send_msg, NULL };
 	iproto_thread->sql_route[0] =
 		{ tx_process_sql, &iproto_thread->net_pipe };
 	iproto_thread->sql_route[1] = { net_send_msg, NULL };
@@ -2946,6 +3602,9 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 {
 	iproto_thread_init_routes(iproto_thread);
 	slab_cache_create(&iproto_thread->net_slabc, &runtime);
+	mempool_create(&iproto_thread->tx.obuf_ref_pool,
+		       &iproto_thread->net_slabc,
+		       sizeof(struct iproto_obuf_ref));
 	/* Init statistics counter */
 	iproto_thread->rmean = rmean_new(rmean_net_strings, RMEAN_NET_LAST);
 	if (iproto_thread->rmean == NULL)
@@ -2954,12 +3613,15 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 	if (iproto_thread->tx.rmean == NULL)
 		goto fail;
 	rlist_create(&iproto_thread->stopped_connections);
+	rlist_create(&iproto_thread->connections);
+	iproto_thread->input_buffers_size = 0;
 	iproto_thread->tx.requests_in_progress = 0;
 	iproto_thread->requests_in_stream_queue = 0;
 	return 0;
 fail:
 	if (iproto_thread->rmean != NULL)
 		rmean_delete(iproto_thread->rmean);
+	mempool_destroy(&iproto_thread->tx.obuf_ref_pool);
 	slab_cache_destroy(&iproto_thread->net_slabc);
 	diag_set(OutOfMemory, sizeof(struct rmean),
 		 "rmean_new", "struct rmean");
@@ -2991,11 +3653,16 @@ iproto_init(int threads_count)
 		iproto_thread->id = i;
 		if (iproto_thread_init(iproto_thread) != 0)
 			goto fail;
+		memtx_read_view_reader_register(
+			&iproto_thread->read_view_reader);
 
 		if (cord_costart(&iproto_thread->net_cord, "iproto",
 				 net_cord_f, iproto_thread)) {
+			memtx_read_view_reader_unregister(
+				&iproto_thread->read_view_reader);
 			rmean_delete(iproto_thread->rmean);
 			rmean_delete(iproto_thread->tx.rmean);
+			mempool_destroy(&iproto_thread->tx.obuf_ref_pool);
 			slab_cache_destroy(&iproto_thread->net_slabc);
 			goto fail;
 		}
@@ -3085,6 +3752,7 @@ iproto_fill_stat(struct iproto_thread *iproto_thread,
 		mempool_count(&iproto_thread->iproto_msg_pool);
 	cfg_msg->stats->requests_in_stream_queue =
 		iproto_thread->requests_in_stream_queue;
+	cfg_msg->stats->input_buffers = iproto_thread->input_buffers_size;
 }
 
 static int
@@ -3121,7 +3789,13 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 			}
 			evio_service_create(loop(), binary, "binary",
 					    iproto_on_accept, iproto_thread);
-			evio_service_attach(binary, cfg_msg->binary);
+			if (cfg_msg->binary->reuseport) {
+				if (evio_service_bind_reuseport(
+					binary, cfg_msg->binary) != 0)
+					diag_raise();
+			} else {
+				evio_service_attach(binary, cfg_msg->binary);
+			}
 			if (evio_service_listen(binary) != 0)
 				diag_raise();
 			break;
@@ -3181,7 +3855,7 @@ iproto_send_listen_msg(struct evio_service *binary)
 }
 
 int
-iproto_listen(const struct uri_set *uri_set)
+iproto_listen(const struct uri_set *uri_set, bool reuseport)
 {
 	iproto_send_stop_msg();
 	evio_service_stop(&tx_binary);
@@ -3191,7 +3865,14 @@ iproto_listen(const struct uri_set *uri_set)
 	 * listen these sockets in all iproto threads! With this
 	 * implementation, we rely on the Linux kernel to distribute
 	 * incoming connections across iproto threads.
+	 *
+	 * With reuseport, the sockets bound in the main thread only
+	 * hold the addresses, while each iproto thread binds and
+	 * listens on its own socket. The kernel then balances
+	 * connections between the threads evenly instead of waking
+	 * up all of them on each connection.
 	 */
+	tx_binary.reuseport = reuseport && iproto_threads_count > 1;
 	if (evio_service_bind(&tx_binary, uri_set) != 0)
 		return -1;
 	if (iproto_send_listen_msg(&tx_binary) != 0)
@@ -3199,6 +3880,39 @@ iproto_listen(const struct uri_set *uri_set)
 	return 0;
 }
 
+int
+iproto_set_cpu_affinity(const int *cpus, int cpu_count)
+{
+	assert(cpu_count > 0);
+#if defined(TARGET_OS_LINUX)
+	for (int i = 0; i < iproto_threads_count; i++) {
+		int cpu = cpus[i % cpu_count];
+		if (cpu < 0 || cpu >= CPU_SETSIZE) {
+			diag_set(ClientError, ER_CFG, "iproto_cpu_affinity",
+				 tt_sprintf("CPU %d is out of range", cpu));
+			return -1;
+		}
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		int rc = pthread_setaffinity_np(iproto_threads[i].net_cord.id,
+						sizeof(set), &set);
+		if (rc != 0) {
+			errno = rc;
+			diag_set(SystemError, "failed to bind iproto thread "
+				 "%d to CPU %d", i, cpu);
+			return -1;
+		}
+	}
+	return 0;
+#else
+	(void)cpus;
+	diag_set(ClientError, ER_UNSUPPORTED, "This platform",
+		 "iproto thread CPU affinity");
+	return -1;
+#endif
+}
+
 static void
 iproto_stats_add(struct iproto_stats *total_stats,
 		 struct iproto_stats *thread_stats)
@@ -3211,6 +3925,8 @@ iproto_stats_add(struct iproto_stats *total_stats,
 		thread_stats->requests_in_stream_queue;
 	total_stats->requests_in_progress +=
 		thread_stats->requests_in_progress;
+	total_stats->input_buffers += thread_stats->input_buffers;
+	total_stats->output_buffers += thread_stats->output_buffers;
 }
 
 void
@@ -3235,6 +3951,9 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id)
 	iproto_do_cfg_crit(&iproto_threads[thread_id], &cfg_msg);
 	stats->requests_in_progress =
 		iproto_threads[thread_id].tx.requests_in_progress;
+	/* Output buffers are allocated by tx, so account them here. */
+	stats->output_buffers =
+		slab_cache_used(&iproto_threads[thread_id].net_slabc);
 }
 
 void
@@ -3276,8 +3995,11 @@ iproto_free(void)
 		 * is closed by OS.
 		 */
 		evio_service_detach(&iproto_threads[i].binary);
+		memtx_read_view_reader_unregister(
+			&iproto_threads[i].read_view_reader);
 		rmean_delete(iproto_threads[i].rmean);
 		rmean_delete(iproto_threads[i].tx.rmean);
+		mempool_destroy(&iproto_threads[i].tx.obuf_ref_pool);
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
 	}
 	free(iproto_threads);
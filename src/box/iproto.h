@@ -71,9 +71,14 @@ struct iproto_stats {
 	size_t requests_in_progress;
 	/** Count of requests currently pending in stream queue. */
 	size_t requests_in_stream_queue;
+	/** Size of memory used by connection input buffers. */
+	size_t input_buffers;
+	/** Size of memory used by connection output buffers. */
+	size_t output_buffers;
 };
 
 extern unsigned iproto_readahead;
+extern size_t iproto_readahead_budget;
 extern int iproto_threads_count;
 
 /**
@@ -125,8 +130,21 @@ iproto_thread_rmean_foreach(int thread_id, void *cb, void *cb_ctx);
 void
 iproto_init(int threads_count);
 
+/**
+ * Start listening on the given URIs. If @a reuseport is set, each
+ * iproto thread listens on its own SO_REUSEPORT socket, so that
+ * the kernel balances incoming connections between the threads.
+ * Otherwise all threads accept connections on shared sockets.
+ */
+int
+iproto_listen(const struct uri_set *uri_set, bool reuseport);
+
+/**
+ * Bind iproto thread i to CPU cpus[i % cpu_count].
+ * Returns 0 on success, -1 on error (diag is set).
+ */
 int
-iproto_listen(const struct uri_set *uri_set);
+iproto_set_cpu_affinity(const int *cpus, int cpu_count);
 
 void
 iproto_set_msg_max(int iproto_msg_max);
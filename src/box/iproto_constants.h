@@ -288,6 +288,13 @@ enum iproto_type {
 	IPROTO_WATCH = 74,
 	IPROTO_UNWATCH = 75,
 	IPROTO_EVENT = 76,
+	/**
+	 * Insert a batch of tuples (IPROTO_TUPLE is an array of tuples)
+	 * into a space in one transaction, see box_bulk_load(). Outside
+	 * the DML range, because it isn't written to WAL as is: each
+	 * tuple is logged as a separate IPROTO_INSERT.
+	 */
+	IPROTO_BULK_LOAD = 77,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -345,6 +352,8 @@ iproto_type_name(uint16_t type)
 		return "CONFIRM";
 	case IPROTO_RAFT_ROLLBACK:
 		return "ROLLBACK";
+	case IPROTO_BULK_LOAD:
+		return "BULK_LOAD";
 	case VY_INDEX_RUN_INFO:
 		return "RUNINFO";
 	case VY_INDEX_PAGE_INFO:
@@ -459,6 +468,14 @@ enum vy_run_info_key {
 	VY_RUN_INFO_BLOOM = 7,
 	/** Number of statements of each type (map). */
 	VY_RUN_INFO_STMT_STAT = 8,
+	/**
+	 * Bloom filter for keys prefixed with its version and type.
+	 * Used for filters that can't be stored in the old format so
+	 * that older versions ignore them instead of misreading.
+	 */
+	VY_RUN_INFO_BLOOM_VERSIONED = 9,
+	/** Zstd dictionary the run pages are compressed with. */
+	VY_RUN_INFO_COMPRESSION_DICT = 10,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
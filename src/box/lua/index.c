@@ -74,6 +74,21 @@ lbox_replace(lua_State *L)
 	return luaT_pushtupleornil(L, result);
 }
 
+static int
+lbox_bulk_load(lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1))
+		return luaL_error(L, "Usage space:bulk_load(tuples)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	size_t tuples_len;
+	const char *tuples = lbox_encode_tuple_on_gc(L, 2, &tuples_len);
+
+	if (box_bulk_load(space_id, tuples, tuples + tuples_len) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_index_update(lua_State *L)
 {
@@ -352,6 +367,7 @@ box_lua_index_init(struct lua_State *L)
 	static const struct luaL_Reg boxlib_internal[] = {
 		{"insert", lbox_insert},
 		{"replace",  lbox_replace},
+		{"bulk_load", lbox_bulk_load},
 		{"update", lbox_index_update},
 		{"upsert",  lbox_upsert},
 		{"delete",  lbox_index_delete},
@@ -46,7 +46,12 @@ local default_cfg = {
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
+    iproto_reuseport    = false,
+    iproto_cpu_affinity = nil,
     memtx_allocator     = "small",
+    memtx_checkpoint_threads = 1,
+    memtx_index_build_threads = 0,
+    memtx_read_view_interval = 0,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -54,6 +59,9 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_prefetch_pages = 0,
+    vinyl_regulator_mode = 'static',
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
@@ -86,12 +94,15 @@ local default_cfg = {
 
     io_collect_interval = nil,
     readahead           = 16320,
+    readahead_budget    = 128 * 1024 * 1024,
     snap_io_rate_limit  = nil, -- no limit
     too_long_threshold  = 0.5,
     wal_mode            = "write",
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_batch_window    = 0,
+    wal_batch_max_size  = 0,
     wal_cleanup_delay   = 4 * 3600,
     wal_ext             = nil,
     force_recovery      = false,
@@ -173,13 +184,21 @@ local template_cfg = {
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
+    iproto_reuseport    = 'boolean',
+    iproto_cpu_affinity = 'number, table',
     memtx_allocator     = 'string',
+    memtx_checkpoint_threads = 'number',
+    memtx_index_build_threads = 'number',
+    memtx_read_view_interval = 'number',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_prefetch_pages      = 'number',
+    vinyl_regulator_mode      = 'string',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -213,6 +232,7 @@ local template_cfg = {
 
     io_collect_interval = 'number',
     readahead           = 'number',
+    readahead_budget    = 'number',
     snap_io_rate_limit  = 'number',
     too_long_threshold  = 'number',
     wal_mode            = 'string',
@@ -232,6 +252,8 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_batch_window    = 'number',
+    wal_batch_max_size  = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -335,20 +357,28 @@ local dynamic_cfg = {
     log_format              = log.box_api.cfg_set_log_format,
     io_collect_interval     = private.cfg_set_io_collect_interval,
     readahead               = private.cfg_set_readahead,
+    readahead_budget        = private.cfg_set_readahead_budget,
     too_long_threshold      = private.cfg_set_too_long_threshold,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
+    memtx_read_view_interval = private.cfg_set_memtx_read_view_interval,
+    memtx_checkpoint_threads = private.cfg_set_memtx_checkpoint_threads,
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_prefetch_pages    = private.cfg_set_vinyl_prefetch_pages,
+    vinyl_regulator_mode    = private.cfg_set_vinyl_regulator_mode,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     vinyl_defer_deletes     = function() end,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
     wal_queue_max_size      = private.cfg_set_wal_queue_max_size,
+    wal_batch_window        = private.cfg_set_wal_batch_window,
+    wal_batch_max_size      = private.cfg_set_wal_batch_max_size,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     feedback_enabled        = ifdef_feedback_set_params,
     feedback_crashinfo      = ifdef_feedback_set_params,
@@ -454,9 +484,14 @@ local dynamic_cfg_skip_at_load = {
     listen                  = true,
     memtx_memory            = true,
     memtx_max_tuple_size    = true,
+    memtx_read_view_interval = true,
+    memtx_checkpoint_threads = true,
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
+    vinyl_prefetch_pages    = true,
+    vinyl_regulator_mode    = true,
     vinyl_timeout           = true,
     too_long_threshold      = true,
     election_mode           = true,
@@ -479,6 +514,7 @@ local dynamic_cfg_skip_at_load = {
     replicaset_uuid         = true,
     net_msg_max             = true,
     readahead               = true,
+    readahead_budget        = true,
 }
 
 local function convert_gb(size)
@@ -112,6 +112,7 @@ enum netbox_method {
 	NETBOX_COMMIT      = 18,
 	NETBOX_ROLLBACK    = 19,
 	NETBOX_INJECT      = 20,
+	NETBOX_BULK_LOAD   = 21,
 	netbox_method_MAX
 };
 
@@ -865,6 +866,15 @@ netbox_encode_replace(lua_State *L, int idx, struct mpstream *stream,
 					IPROTO_REPLACE, stream_id);
 }
 
+static void
+netbox_encode_bulk_load(lua_State *L, int idx, struct mpstream *stream,
+			uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: space_id, array of tuples */
+	netbox_encode_insert_or_replace(L, idx, stream, sync,
+					IPROTO_BULK_LOAD, stream_id);
+}
+
 static void
 netbox_encode_delete(lua_State *L, int idx, struct mpstream *stream,
 		     uint64_t sync, uint64_t stream_id)
@@ -1296,6 +1306,7 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_encode_commit,
 		[NETBOX_ROLLBACK]       = netbox_encode_rollback,
 		[NETBOX_INJECT]		= netbox_encode_inject,
+		[NETBOX_BULK_LOAD]	= netbox_encode_bulk_load,
 	};
 	struct mpstream stream;
 	mpstream_init(&stream, ibuf, ibuf_reserve_cb, ibuf_alloc_cb,
@@ -1720,6 +1731,7 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_decode_nil,
 		[NETBOX_ROLLBACK]       = netbox_decode_nil,
 		[NETBOX_INJECT]		= netbox_decode_table,
+		[NETBOX_BULK_LOAD]	= netbox_decode_nil,
 	};
 	method_decoder[method](L, data, data_end, return_raw, format);
 }
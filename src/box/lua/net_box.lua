@@ -49,6 +49,7 @@ local M_COMMIT      = 18
 local M_ROLLBACK    = 19
 -- Injects raw data into connection. Used by tests.
 local M_INJECT      = 20
+local M_BULK_LOAD   = 21
 
 -- IPROTO feature id -> name
 local IPROTO_FEATURE_NAMES = {
@@ -1053,6 +1054,14 @@ space_metatable = function(remote)
                                self._stream_id, self.id, tuple)
     end
 
+    function methods:bulk_load(tuples, opts)
+        check_space_arg(self, 'bulk_load')
+        check_param_table(opts, REQUEST_OPTION_TYPES)
+        return nothing_or_data(remote:_request(M_BULK_LOAD, opts, nil,
+                                               self._stream_id, self.id,
+                                               tuples))
+    end
+
     function methods:select(key, opts)
         check_space_arg(self, 'select')
         return check_primary_index(self):select(key, opts)
@@ -1203,6 +1212,7 @@ this_module = {
         commit      = M_COMMIT,
         rollback    = M_ROLLBACK,
         inject      = M_INJECT,
+        bulk_load   = M_BULK_LOAD,
     }
 }
 
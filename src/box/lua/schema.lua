@@ -1456,6 +1456,11 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    bloom_type = 'string',
+    compaction_policy = 'string',
+    compression_dict = 'boolean',
+    covering = 'boolean',
+    cache_hot_ranges = 'boolean',
     func = 'number, string',
     hint = 'boolean',
 }
@@ -1604,6 +1609,11 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            bloom_type = options.bloom_type,
+            compaction_policy = options.compaction_policy,
+            compression_dict = options.compression_dict,
+            covering = options.covering,
+            cache_hot_ranges = options.cache_hot_ranges,
             func = options.func,
             hint = options.hint,
     }
@@ -2582,6 +2592,35 @@ space_mt.replace = function(space, tuple)
     return internal.replace(space.id, tuple);
 end
 space_mt.put = space_mt.replace; -- put is an alias for replace
+-- Number of tuples space:bulk_load() inserts in one transaction
+-- when the tuples are produced by an iterator.
+local BULK_LOAD_BATCH_SIZE = 10000
+-- Inserts an array of tuples in one transaction or tuples produced
+-- by an iterator (gen, param, state), e.g. space:pairs() or a luafun
+-- chain, in transactions of BULK_LOAD_BATCH_SIZE tuples each. The
+-- iterator must return tuples as the second value, like ipairs().
+-- An array isn't split, because it's atomic by contract, so the whole
+-- array is kept in memory and written to WAL as one transaction. Pass
+-- an iterator, e.g. ipairs(tuples), to load a huge array in batches.
+space_mt.bulk_load = function(space, gen, param, state)
+    check_space_arg(space, 'bulk_load')
+    local mt = type(gen) == 'table' and getmetatable(gen) or nil
+    if type(gen) == 'table' and (mt == nil or mt.__call == nil) then
+        internal.bulk_load(space.id, gen)
+        return
+    end
+    local batch = {}
+    for _, tuple in gen, param, state do
+        table.insert(batch, tuple)
+        if #batch == BULK_LOAD_BATCH_SIZE then
+            internal.bulk_load(space.id, batch)
+            batch = {}
+        end
+    end
+    if #batch > 0 then
+        internal.bulk_load(space.id, batch)
+    end
+end
 space_mt.update = function(space, key, ops)
     check_space_arg(space, 'update')
     return check_primary_index(space):update(key, ops)
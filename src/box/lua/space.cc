@@ -562,6 +562,34 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->bloom_type != BLOOM_TYPE_CLASSIC) {
+				lua_pushstring(L, bloom_type_strs[
+					index_opts->bloom_type]);
+				lua_setfield(L, -2, "bloom_type");
+			}
+
+			if (index_opts->compaction_policy !=
+			    COMPACTION_POLICY_TIERED) {
+				lua_pushstring(L, compaction_policy_strs[
+					index_opts->compaction_policy]);
+				lua_setfield(L, -2, "compaction_policy");
+			}
+
+			if (index_opts->compression_dict) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "compression_dict");
+			}
+
+			if (index_opts->covering) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "covering");
+			}
+
+			if (index_opts->cache_hot_ranges) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "cache_hot_ranges");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
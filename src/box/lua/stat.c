@@ -42,8 +42,10 @@
 #include "box/iproto.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/wal.h"
 #include "box/sql.h"
 #include "box/memtx_tx.h"
+#include "box/memtx_tuple_compression.h"
 #include "info/info.h"
 #include "lua/info.h"
 #include "lua/utils.h"
@@ -68,9 +70,26 @@ inject_current_stat(struct lua_State *L, const char *name, size_t val)
 	lua_pop(L, 1);
 }
 
+/**
+ * Add a table with the 'current' field only to the table which is
+ * located at the top of the lua stack.
+ */
+static void
+push_current_stat(struct lua_State *L, const char *name, size_t val)
+{
+	lua_pushstring(L, name);
+	lua_newtable(L);
+	lua_pushstring(L, "current");
+	lua_pushnumber(L, val);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+}
+
 static void
 inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 {
+	push_current_stat(L, "INPUT_BUFFERS", stats->input_buffers);
+	push_current_stat(L, "OUTPUT_BUFFERS", stats->output_buffers);
 	inject_current_stat(L, "CONNECTIONS", stats->connections);
 	inject_current_stat(L, "STREAMS", stats->streams);
 	inject_current_stat(L, "REQUESTS", stats->requests);
@@ -154,6 +173,15 @@ lbox_stat_vinyl(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	wal_stat(&h);
+	return 1;
+}
+
 static int
 lbox_stat_reset(struct lua_State *L)
 {
@@ -175,10 +203,25 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	const char *key = luaL_checkstring(L, -1);
+	struct iproto_stats stats;
+	if (strcmp(key, "INPUT_BUFFERS") == 0) {
+		iproto_stats_get(&stats);
+		lua_newtable(L);
+		lua_pushstring(L, "current");
+		lua_pushnumber(L, stats.input_buffers);
+		lua_rawset(L, -3);
+		return 1;
+	} else if (strcmp(key, "OUTPUT_BUFFERS") == 0) {
+		iproto_stats_get(&stats);
+		lua_newtable(L);
+		lua_pushstring(L, "current");
+		lua_pushnumber(L, stats.output_buffers);
+		lua_rawset(L, -3);
+		return 1;
+	}
 	if (iproto_rmean_foreach(seek_stat_item, L) == 0)
 		return 0;
 
-	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	if (strcmp(key, "CONNECTIONS") == 0) {
 		lua_pushstring(L, "current");
@@ -215,7 +258,9 @@ lbox_stat_net_index(struct lua_State *L)
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - INPUT_BUFFERS (bytes): current;
+ * - OUTPUT_BUFFERS (bytes): current.
  *
  * These fields have the following meaning:
  *
@@ -280,6 +325,28 @@ lbox_stat_sql(struct lua_State *L)
 	return 1;
 }
 
+/** Memtx tuple compression statistics, box.stat.memtx.compression(). */
+static int
+lbox_stat_memtx_compression(struct lua_State *L)
+{
+	const struct memtx_tuple_compression_stat *stat =
+		&memtx_tuple_compression_stat;
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	info_begin(&info);
+	info_append_int(&info, "tuples", stat->tuples);
+	info_append_int(&info, "fields", stat->fields);
+	info_append_int(&info, "bytes_raw", stat->bytes_raw);
+	info_append_int(&info, "bytes_compressed", stat->bytes_compressed);
+	info_append_int(&info, "decompressions", stat->decompressions);
+	info_table_begin(&info, "cache");
+	info_append_int(&info, "count", stat->cache_count);
+	info_append_int(&info, "hits", stat->cache_hits);
+	info_table_end(&info);
+	info_end(&info);
+	return 1;
+}
+
 /**
  * Push total, max and avg table onto lua stack.
  */
@@ -447,6 +514,7 @@ box_lua_stat_init(struct lua_State *L)
 {
 	static const struct luaL_Reg statlib [] = {
 		{"vinyl", lbox_stat_vinyl},
+		{"wal", lbox_stat_wal},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
 		{NULL, NULL}
@@ -477,6 +545,14 @@ box_lua_stat_init(struct lua_State *L)
 	lua_setmetatable(L, -2);
 	lua_pop(L, 1); /* stat net module */
 
+	static const struct luaL_Reg memtx_statlib[] = {
+		{"compression", lbox_stat_memtx_compression},
+		{NULL, NULL}
+	};
+
+	luaL_register_module(L, "box.stat.memtx", memtx_statlib);
+	lua_pop(L, 1); /* stat memtx module */
+
 	static const struct luaL_Reg memtx_mvcc_statlib[] = {
 		{NULL, NULL}
 	};
@@ -31,6 +31,8 @@
  */
 #include "allocator.h"
 #include "salad/stailq.h"
+#include "small/rlist.h"
+#include "trivia/util.h"
 #include "tuple.h"
 
 /**
@@ -69,15 +71,29 @@ public:
 	 * Opening a read view pins tuples that were allocated before
 	 * the read view was created. See open_read_view().
 	 */
-	struct ReadView {};
+	struct ReadView {
+		/**
+		 * Tuples freed while this read view was the most recent
+		 * one. They may be accessed from this read view and older
+		 * ones, but not from newer ones, because they had been
+		 * freed by the time newer read views were created.
+		 */
+		struct stailq gc;
+		/** Link in the list of open read views. */
+		struct rlist in_read_views;
+	};
 
 	static void create()
 	{
 		stailq_create(&gc);
+		rlist_create(&read_views);
 	}
 
 	static void destroy()
 	{
+		ReadView *rv;
+		rlist_foreach_entry(rv, &read_views, in_read_views)
+			stailq_concat(&gc, &rv->gc);
 		while (!stailq_empty(&gc)) {
 			struct memtx_tuple *memtx_tuple = stailq_shift_entry(
 					&gc, struct memtx_tuple, in_gc);
@@ -93,20 +109,33 @@ public:
 	static ReadView *open_read_view(struct memtx_read_view_opts opts)
 	{
 		(void)opts;
+		ReadView *rv = (ReadView *)xmalloc(sizeof(*rv));
+		stailq_create(&rv->gc);
+		rlist_add_tail_entry(&read_views, rv, in_read_views);
 		snapshot_version++;
-		delayed_free_mode++;
-		return nullptr;
+		return rv;
 	}
 
 	/**
 	 * Closes a tuple read view opened with open_read_view().
+	 *
+	 * Read views may be closed in any order. Tuples pinned only by
+	 * the closed read view are queued for freeing while those that
+	 * may still be accessed from an older read view are handed over
+	 * to it.
 	 */
 	static void close_read_view(ReadView *rv)
 	{
-		assert(rv == nullptr);
-		(void)rv;
-		assert(delayed_free_mode > 0);
-		--delayed_free_mode;
+		assert(rv != nullptr);
+		if (rv != rlist_first_entry(&read_views, ReadView,
+					    in_read_views)) {
+			ReadView *prev = rlist_prev_entry(rv, in_read_views);
+			stailq_concat(&prev->gc, &rv->gc);
+		} else {
+			stailq_concat(&gc, &rv->gc);
+		}
+		rlist_del_entry(rv, in_read_views);
+		free(rv);
 	}
 
 	/**
@@ -127,14 +156,15 @@ public:
 	 * Free a tuple allocated with alloc_tuple().
 	 *
 	 * The tuple is freed immediately if there's no snapshot that may use
-	 * it. Otherwise, it's put in the garbage collection list to be free as
-	 * soon as the last snapshot using it is destroyed.
+	 * it. Otherwise, it's put in the garbage collection list of the most
+	 * recent snapshot to be freed as soon as the last snapshot using it
+	 * is destroyed.
 	 */
 	static void free_tuple(struct tuple *tuple)
 	{
 		struct memtx_tuple *memtx_tuple = container_of(
 			tuple, struct memtx_tuple, base);
-		if (delayed_free_mode == 0 ||
+		if (rlist_empty(&read_views) ||
 		    memtx_tuple->version == snapshot_version ||
 		    tuple_has_flag(tuple, TUPLE_IS_TEMPORARY)) {
 			immediate_free_tuple(memtx_tuple);
@@ -166,13 +196,13 @@ private:
 
 	static void delayed_free_tuple(struct memtx_tuple *memtx_tuple)
 	{
-		stailq_add_entry(&gc, memtx_tuple, in_gc);
+		ReadView *rv = rlist_last_entry(&read_views, ReadView,
+						in_read_views);
+		stailq_add_entry(&rv->gc, memtx_tuple, in_gc);
 	}
 
 	static void collect_garbage()
 	{
-		if (delayed_free_mode > 0)
-			return;
 		for (int i = 0; !stailq_empty(&gc) && i < GC_BATCH_SIZE; i++) {
 			struct memtx_tuple *memtx_tuple = stailq_shift_entry(
 					&gc, struct memtx_tuple, in_gc);
@@ -182,14 +212,15 @@ private:
 
 	/**
 	 * Tuple garbage collection list. Contains tuples that were not freed
-	 * immediately because they are currently in use by a snapshot.
+	 * immediately because they were in use by a snapshot, which has been
+	 * destroyed since then. The tuples are freed in batches on allocation.
 	 */
 	static struct stailq gc;
 	/**
-	 * Unless zero, freeing of tuples allocated before the last call to
-	 * open_read_view() is delayed until close_read_view() is called.
+	 * List of open read views, ordered by creation time: the most
+	 * recent read view is the last one.
 	 */
-	static uint32_t delayed_free_mode;
+	static struct rlist read_views;
 	/** Incremented with each next snapshot. */
 	static uint32_t snapshot_version;
 };
@@ -198,7 +229,7 @@ template<class Allocator>
 struct stailq MemtxAllocator<Allocator>::gc;
 
 template<class Allocator>
-uint32_t MemtxAllocator<Allocator>::delayed_free_mode;
+struct rlist MemtxAllocator<Allocator>::read_views;
 
 template<class Allocator>
 uint32_t MemtxAllocator<Allocator>::snapshot_version;
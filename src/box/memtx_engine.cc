@@ -38,10 +38,13 @@
 #include "fiber.h"
 #include "errinj.h"
 #include "coio_file.h"
+#include "coio_task.h"
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tx.h"
 #include "memtx_tree.h"
+#include "memtx_read_view.h"
+#include "memtx_snap_reader.h"
 #include "iproto_constants.h"
 #include "xrow.h"
 #include "xstream.h"
@@ -189,14 +192,307 @@ memtx_build_secondary_keys(struct space *space, void *param)
 	return 0;
 }
 
+/**
+ * A secondary index build job executed by one of the cords of
+ * a parallel index build, see memtx_build_secondary_keys_parallel().
+ */
+struct memtx_index_build_job {
+	/** Index to build. */
+	struct index *index;
+	/**
+	 * Tuples of the space, in the primary key order. The array
+	 * is shared by all jobs building indexes of the same space.
+	 */
+	struct tuple **tuples;
+	/** Number of tuples in the array. */
+	size_t tuple_count;
+	/** Set if this job is responsible for freeing the array. */
+	bool owns_tuples;
+};
+
+/** Parallel secondary index build state shared by all build cords. */
+struct memtx_index_build {
+	/** Engine whose spaces are built. */
+	struct memtx_engine *memtx;
+	/** Array of jobs. */
+	struct memtx_index_build_job *jobs;
+	/** Number of jobs. */
+	uint32_t job_count;
+	/** Number of jobs allocated in the array. */
+	uint32_t job_capacity;
+	/** Number of the next job to execute, updated atomically. */
+	uint32_t next_job;
+	/** Set by a cord that failed to execute a job, updated atomically. */
+	bool is_failed;
+	/**
+	 * Spaces whose indexes are built by the jobs. Switched to
+	 * memtx_space_replace_all_keys() when the build is done.
+	 */
+	struct space **spaces;
+	/** Number of spaces in the array. */
+	uint32_t space_count;
+	/** Number of spaces allocated in the array. */
+	uint32_t space_capacity;
+};
+
+/**
+ * Make room for one more element in a dynamic array of
+ * the memtx_index_build structure.
+ */
+static int
+memtx_index_build_reserve(void **array, uint32_t count, uint32_t *capacity,
+			  size_t elem_size)
+{
+	if (count < *capacity)
+		return 0;
+	uint32_t new_capacity = MAX(*capacity * 2, 16U);
+	void *new_array = realloc(*array, new_capacity * elem_size);
+	if (new_array == NULL) {
+		diag_set(OutOfMemory, new_capacity * elem_size,
+			 "realloc", "memtx_index_build");
+		return -1;
+	}
+	*array = new_array;
+	*capacity = new_capacity;
+	return 0;
+}
+
+/**
+ * Collect pointers to all tuples stored in the primary key so that
+ * the build cords don't need to iterate over it.
+ */
+static struct tuple **
+memtx_index_build_collect_tuples(struct index *pk, size_t n_tuples)
+{
+	struct tuple **tuples = (struct tuple **)
+		malloc(n_tuples * sizeof(*tuples));
+	if (tuples == NULL) {
+		diag_set(OutOfMemory, n_tuples * sizeof(*tuples),
+			 "malloc", "tuples");
+		return NULL;
+	}
+	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		goto fail;
+	for (size_t i = 0; i < n_tuples; i++) {
+		if (iterator_next_raw(it, &tuples[i]) != 0) {
+			iterator_delete(it);
+			goto fail;
+		}
+		assert(tuples[i] != NULL);
+	}
+	iterator_delete(it);
+	return tuples;
+fail:
+	free(tuples);
+	return NULL;
+}
+
+/**
+ * Add jobs building secondary indexes of the given space.
+ * Indexes that can't be built outside the tx thread are built
+ * right away.
+ */
+static int
+memtx_index_build_add_space(struct space *space, void *param)
+{
+	struct memtx_index_build *build = (struct memtx_index_build *)param;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (space->engine != (struct engine *)build->memtx ||
+	    space_index(space, 0) == NULL ||
+	    memtx_space->replace == memtx_space_replace_all_keys)
+		return 0;
+
+	if (space->index_id_max == 0 || index_size(space->index[0]) == 0) {
+		/* Nothing to do in parallel. */
+		return memtx_build_secondary_keys(space, build->memtx);
+	}
+	if (memtx_index_build_reserve((void **)&build->spaces,
+				      build->space_count,
+				      &build->space_capacity,
+				      sizeof(*build->spaces)) != 0)
+		return -1;
+	build->spaces[build->space_count++] = space;
+
+	struct index *pk = space->index[0];
+	ssize_t n_tuples = index_size(pk);
+	assert(n_tuples > 0);
+	uint32_t estimated_tuples = n_tuples * 1.2;
+	say_info("Building secondary indexes in space '%s'...",
+		 space_name(space));
+
+	struct tuple **tuples = NULL;
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		struct index *index = space->index[j];
+		if (!memtx_tree_index_supports_parallel_build(index)) {
+			if (memtx_build_secondary_index(index, pk) != 0)
+				return -1;
+			continue;
+		}
+		if (memtx_index_build_reserve((void **)&build->jobs,
+					      build->job_count,
+					      &build->job_capacity,
+					      sizeof(*build->jobs)) != 0)
+			return -1;
+		struct memtx_index_build_job *job =
+			&build->jobs[build->job_count];
+		job->owns_tuples = false;
+		if (tuples == NULL) {
+			tuples = memtx_index_build_collect_tuples(pk,
+								  n_tuples);
+			if (tuples == NULL)
+				return -1;
+			job->owns_tuples = true;
+		}
+		job->index = index;
+		job->tuples = tuples;
+		job->tuple_count = n_tuples;
+		build->job_count++;
+
+		index_begin_build(index);
+		if (index_reserve(index, estimated_tuples) != 0)
+			return -1;
+		say_info("Adding %zd keys to %s index '%s' ...",
+			 n_tuples, index_type_strs[index->def->type],
+			 index->def->name);
+	}
+	return 0;
+}
+
+/**
+ * Executes secondary index build jobs until there are no jobs left.
+ * Runs in a separate cord. Extracts keys and computes hints of all
+ * tuples and sorts them, leaving only the tree construction, which
+ * allocates memtx index extents, to the tx thread.
+ */
+static int
+memtx_index_build_f(va_list ap)
+{
+	struct memtx_index_build *build = va_arg(ap, struct memtx_index_build *);
+	while (!__atomic_load_n(&build->is_failed, __ATOMIC_RELAXED)) {
+		uint32_t i = __atomic_fetch_add(&build->next_job, 1,
+						__ATOMIC_RELAXED);
+		if (i >= build->job_count)
+			break;
+		struct memtx_index_build_job *job = &build->jobs[i];
+		for (size_t j = 0; j < job->tuple_count; j++) {
+			if (index_build_next(job->index,
+					     job->tuples[j]) != 0) {
+				__atomic_store_n(&build->is_failed, true,
+						 __ATOMIC_RELAXED);
+				return -1;
+			}
+		}
+		memtx_tree_index_sort_build_array(job->index);
+	}
+	return 0;
+}
+
+/**
+ * Build secondary indexes of all memtx spaces using a pool of
+ * box.cfg.memtx_index_build_threads cords. Indexes of the same
+ * space as well as indexes of different spaces are built in
+ * parallel.
+ */
+static int
+memtx_build_secondary_keys_parallel(struct memtx_engine *memtx)
+{
+	struct memtx_index_build build;
+	memset(&build, 0, sizeof(build));
+	build.memtx = memtx;
+	int rc = space_foreach(memtx_index_build_add_space, &build);
+
+	uint32_t cord_count = MIN((uint32_t)memtx->index_build_threads,
+				  build.job_count);
+	struct cord *cords = NULL;
+	uint32_t started = 0;
+	if (rc == 0 && cord_count > 0) {
+		cords = (struct cord *)calloc(cord_count, sizeof(*cords));
+		if (cords == NULL) {
+			diag_set(OutOfMemory, cord_count * sizeof(*cords),
+				 "calloc", "cords");
+			rc = -1;
+		}
+	}
+	while (rc == 0 && started < cord_count) {
+		if (cord_costart(&cords[started], "index_build",
+				 memtx_index_build_f, &build) != 0) {
+			__atomic_store_n(&build.is_failed, true,
+					 __ATOMIC_RELAXED);
+			rc = -1;
+			break;
+		}
+		started++;
+	}
+	/*
+	 * cord_cojoin() clears the diagnostics area on success so
+	 * remember the first error to report it to the caller.
+	 */
+	struct error *error = NULL;
+	if (rc != 0) {
+		error = diag_last_error(diag_get());
+		error_ref(error);
+	}
+	for (uint32_t i = 0; i < started; i++) {
+		if (cord_cojoin(&cords[i]) != 0) {
+			rc = -1;
+			if (error == NULL) {
+				error = diag_last_error(diag_get());
+				error_ref(error);
+			}
+		}
+	}
+	free(cords);
+
+	for (uint32_t i = 0; i < build.job_count; i++) {
+		struct memtx_index_build_job *job = &build.jobs[i];
+		if (rc == 0)
+			index_end_build(job->index);
+		if (job->owns_tuples)
+			free(job->tuples);
+	}
+	free(build.jobs);
+
+	if (rc == 0) {
+		for (uint32_t i = 0; i < build.space_count; i++) {
+			struct space *space = build.spaces[i];
+			struct memtx_space *memtx_space =
+				(struct memtx_space *)space;
+			memtx_space->replace = memtx_space_replace_all_keys;
+			say_info("Space '%s': done", space_name(space));
+		}
+	}
+	free(build.spaces);
+
+	if (error != NULL) {
+		diag_set_error(diag_get(), error);
+		error_unref(error);
+	}
+	return rc;
+}
+
+/**
+ * Build secondary indexes of all memtx spaces at the end of
+ * recovery and make the spaces fully functional.
+ */
+static int
+memtx_engine_build_secondary_keys(struct memtx_engine *memtx)
+{
+	if (memtx->index_build_threads > 0)
+		return memtx_build_secondary_keys_parallel(memtx);
+	return space_foreach(memtx_build_secondary_keys, memtx);
+}
+
 static void
 memtx_engine_shutdown(struct engine *engine)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	memtx_read_view_free();
 	if (memtx->checkpoint != NULL)
 		checkpoint_cancel(memtx->checkpoint);
 	if (memtx->replica_join_cord != NULL)
 		replica_join_cancel(memtx->replica_join_cord);
+	memtx_tuple_compression_free();
 	mempool_destroy(&memtx->iterator_pool);
 	if (mempool_is_initialized(&memtx->rtree_iterator_pool))
 		mempool_destroy(&memtx->rtree_iterator_pool);
@@ -217,52 +513,95 @@ memtx_engine_shutdown(struct engine *engine)
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system);
+				  struct memtx_snap_row *snap_row,
+				  int *is_space_system);
 
-int
-memtx_engine_recover_snapshot(struct memtx_engine *memtx,
-			      const struct vclock *vclock)
+/**
+ * Read the number of files the snapshot with the given signature
+ * consists of from the snapshot header, see struct checkpoint_shard.
+ * Runs in a coio thread.
+ */
+static ssize_t
+memtx_snapshot_shard_count_f(va_list ap)
 {
-	/* Process existing snapshot */
-	say_info("recovery start");
-	int64_t signature = vclock_sum(vclock);
-	const char *filename = xdir_format_filename(&memtx->snap_dir,
-						    signature, NONE);
+	const char *filename = va_arg(ap, const char *);
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, filename) != 0)
+		return -1;
+	ssize_t shard_count = MAX(cursor.meta.shard_count, 1U);
+	xlog_cursor_close(&cursor, false);
+	return shard_count;
+}
+
+static int
+memtx_engine_snapshot_shard_count(struct memtx_engine *memtx,
+				  int64_t signature)
+{
+	char filename[PATH_MAX];
+	strlcpy(filename, xdir_format_filename(&memtx->snap_dir, signature,
+					       NONE), sizeof(filename));
+	return coio_call(memtx_snapshot_shard_count_f, filename);
+}
 
+/** Load a file of the snapshot with the given signature. */
+static int
+memtx_engine_recover_snapshot_shard(struct memtx_engine *memtx,
+				    int64_t signature, uint32_t shard)
+{
+	const char *filename = xdir_format_shard_filename(&memtx->snap_dir,
+							  signature, shard,
+							  NONE);
 	say_info("recovering from `%s'", filename);
-	struct xlog_cursor cursor;
-	if (xlog_cursor_open(&cursor, filename) < 0)
+	/*
+	 * The snapshot is read, decompressed and decoded by a separate
+	 * cord while we are applying rows it has already read.
+	 */
+	struct memtx_snap_reader reader;
+	const char *name = shard == 0 ? "snapshot_reader" :
+			   tt_sprintf("snapshot_reader_%u", (unsigned)shard);
+	if (memtx_snap_reader_start(&reader, name, filename,
+				    memtx->force_recovery) != 0)
 		return -1;
 
-	int rc;
-	struct xrow_header row;
+	int rc = 0;
 	uint64_t row_count = 0;
 	int is_space_system = -1;
-	bool force_recovery = false;
-	/*
-	 * In case when we read system space, we can't ignore errors.
-	 */
-	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
-		row.lsn = signature;
-		rc = memtx_engine_recover_snapshot_row(memtx, &row,
-						       &is_space_system);
-		force_recovery = is_space_system == 0 ?
-				 memtx->force_recovery : false;
-		if (rc < 0) {
-			if (!force_recovery)
-				break;
-			say_error("can't apply row: ");
-			diag_log();
+	struct memtx_snap_batch *batch = NULL;
+	do {
+		batch = memtx_snap_reader_next(&reader);
+		for (int i = 0; i < batch->row_count; i++) {
+			struct memtx_snap_row *snap_row = &batch->rows[i];
+			snap_row->row.lsn = signature;
+			rc = memtx_engine_recover_snapshot_row(
+				memtx, snap_row, &is_space_system);
+			bool force_recovery = is_space_system == 0 ?
+					      memtx->force_recovery : false;
+			if (rc < 0) {
+				if (!force_recovery)
+					break;
+				say_error("can't apply row: ");
+				diag_log();
+				rc = 0;
+			}
+			++row_count;
+			if (row_count % 100000 == 0) {
+				say_info_ratelimited("%.1fM rows processed",
+						     row_count / 1e6);
+				fiber_yield_timeout(0);
+			}
 		}
-		++row_count;
-		if (row_count % 100000 == 0) {
-			say_info_ratelimited("%.1fM rows processed",
-					     row_count / 1e6);
-			fiber_yield_timeout(0);
+		if (rc == 0 && batch->is_failed) {
+			diag_move(&batch->diag, diag_get());
+			rc = -1;
 		}
-	}
-	xlog_cursor_close(&cursor, false);
-	if (rc < 0 || is_space_system < 0)
+		if (rc == 0 && batch->is_eof)
+			break;
+		memtx_snap_reader_release(&reader, batch);
+	} while (rc == 0);
+	bool has_eof_marker = rc == 0 && batch->has_eof_marker;
+	memtx_snap_reader_stop(&reader);
+	/* Only the first file stores system spaces, others may be empty. */
+	if (rc < 0 || (shard == 0 && is_space_system < 0))
 		return -1;
 
 	/**
@@ -270,16 +609,74 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 * marker - such snapshots are very likely corrupted and
 	 * should not be trusted.
 	 */
-	if (!xlog_cursor_is_eof(&cursor)) {
+	if (!has_eof_marker) {
 		if (!memtx->force_recovery)
-			panic("snapshot `%s' has no EOF marker", cursor.name);
+			panic("snapshot `%s' has no EOF marker", reader.filename);
 		else
-			say_error("snapshot `%s' has no EOF marker", cursor.name);
+			say_error("snapshot `%s' has no EOF marker",
+				  reader.filename);
 	}
 
 	return 0;
 }
 
+static int
+memtx_engine_recover_snapshot_shard_f(va_list ap)
+{
+	struct memtx_engine *memtx = va_arg(ap, struct memtx_engine *);
+	int64_t signature = va_arg(ap, int64_t);
+	uint32_t shard = va_arg(ap, uint32_t);
+	return memtx_engine_recover_snapshot_shard(memtx, signature, shard);
+}
+
+int
+memtx_engine_recover_snapshot(struct memtx_engine *memtx,
+			      const struct vclock *vclock)
+{
+	/* Process existing snapshot */
+	say_info("recovery start");
+	int64_t signature = vclock_sum(vclock);
+	int shard_count = memtx_engine_snapshot_shard_count(memtx, signature);
+	if (shard_count < 0)
+		return -1;
+	/*
+	 * The first file of the snapshot stores system spaces, which
+	 * define user spaces, so it's loaded first. The other files
+	 * store only user spaces, each space in one file, and are
+	 * loaded concurrently, each by its own reader and fiber.
+	 */
+	if (memtx_engine_recover_snapshot_shard(memtx, signature, 0) != 0)
+		return -1;
+	if (shard_count == 1)
+		return 0;
+	size_t size = (shard_count - 1) * sizeof(struct fiber *);
+	struct fiber **fibers = (struct fiber **)malloc(size);
+	if (fibers == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "fibers");
+		return -1;
+	}
+	int rc = 0;
+	uint32_t started = 0;
+	for (uint32_t shard = 1; shard < (uint32_t)shard_count; shard++) {
+		struct fiber *f = fiber_new(
+			tt_sprintf("snapshot_shard_%u", (unsigned)shard),
+			memtx_engine_recover_snapshot_shard_f);
+		if (f == NULL) {
+			rc = -1;
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fiber_start(f, memtx, signature, shard);
+		fibers[started++] = f;
+	}
+	for (uint32_t i = 0; i < started; i++) {
+		if (fiber_join(fibers[i]) != 0)
+			rc = -1;
+	}
+	free(fibers);
+	return rc;
+}
+
 static int
 memtx_engine_recover_raft(const struct xrow_header *row)
 {
@@ -309,8 +706,10 @@ memtx_engine_recover_synchro(const struct xrow_header *row)
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system)
+				  struct memtx_snap_row *snap_row,
+				  int *is_space_system)
 {
+	struct xrow_header *row = &snap_row->row;
 	assert(row->bodycnt == 1); /* always 1 for read */
 	if (row->type != IPROTO_INSERT) {
 		if (row->type == IPROTO_RAFT)
@@ -322,11 +721,13 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 		return -1;
 	}
 	int rc;
-	struct request request;
-	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
+	/* The request is usually decoded by the snapshot reader. */
+	struct request *request = &snap_row->request;
+	if (!snap_row->is_decoded &&
+	    xrow_decode_dml(row, request, dml_request_key_map(row->type)) != 0)
 		return -1;
-	*is_space_system = (request.space_id < BOX_SYSTEM_ID_MAX);
-	struct space *space = space_cache_find(request.space_id);
+	*is_space_system = (request->space_id < BOX_SYSTEM_ID_MAX);
+	struct space *space = space_cache_find(request->space_id);
 	if (space == NULL)
 		return -1;
 	/* memtx snapshot must contain only memtx spaces */
@@ -337,13 +738,13 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 	struct txn *txn = txn_begin();
 	if (txn == NULL)
 		return -1;
-	if (txn_begin_stmt(txn, space, request.type) != 0)
+	if (txn_begin_stmt(txn, space, request->type) != 0)
 		goto rollback;
 	/* no access checks here - applier always works with admin privs */
 	struct tuple *unused;
-	if (space_execute_dml(space, txn, &request, &unused) != 0)
+	if (space_execute_dml(space, txn, request, &unused) != 0)
 		goto rollback_stmt;
-	if (txn_commit_stmt(txn, &request) != 0)
+	if (txn_commit_stmt(txn, request) != 0)
 		goto rollback;
 	/*
 	 * Snapshot rows are confirmed by definition. They don't need to go to
@@ -423,7 +824,7 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 		 * unique keys.
 		 */
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_engine_build_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	return 0;
@@ -441,7 +842,7 @@ memtx_engine_begin_hot_standby(struct engine *engine)
 	if (memtx->state != MEMTX_OK) {
 		assert(memtx->state == MEMTX_FINAL_RECOVERY);
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_engine_build_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	return 0;
@@ -460,7 +861,7 @@ memtx_engine_end_recovery(struct engine *engine)
 	if (memtx->state != MEMTX_OK) {
 		assert(memtx->state == MEMTX_FINAL_RECOVERY);
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_engine_build_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	xdir_collect_inprogress(&memtx->snap_dir);
@@ -545,12 +946,17 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 	if (memtx_tx_manager_use_mvcc_engine)
 		return memtx_tx_history_rollback_stmt(stmt);
 
-	if (memtx_space->replace == memtx_space_replace_all_keys)
+	if (memtx_space->replace == memtx_space_replace_all_keys) {
 		index_count = space->index_count;
-	else if (memtx_space->replace == memtx_space_replace_primary_key)
+	} else if (memtx_space->replace == memtx_space_replace_primary_key) {
 		index_count = 1;
-	else
+	} else if (memtx_space->replace == memtx_space_replace_bulk_insert) {
+		/* The tuple hasn't been added to indexes yet. */
+		memtx_space_rollback_bulk_insert(space, new_tuple);
+		index_count = 0;
+	} else {
 		panic("transaction rolled back during snapshot recovery");
+	}
 
 	for (uint32_t i = 0; i < index_count; i++) {
 		struct tuple *unused;
@@ -587,9 +993,12 @@ memtx_engine_bootstrap(struct engine *engine)
 		return -1;
 
 	int rc, is_space_system;
-	struct xrow_header row;
-	while ((rc = xlog_cursor_next(&cursor, &row, true)) == 0) {
-		rc = memtx_engine_recover_snapshot_row(memtx, &row, &is_space_system);
+	struct memtx_snap_row row;
+	/* Bootstrap rows are decoded by memtx_engine_recover_snapshot_row. */
+	row.is_decoded = false;
+	while ((rc = xlog_cursor_next(&cursor, &row.row, true)) == 0) {
+		rc = memtx_engine_recover_snapshot_row(memtx, &row,
+						       &is_space_system);
 		if (rc < 0)
 			break;
 	}
@@ -654,10 +1063,46 @@ checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
 struct checkpoint_entry {
 	uint32_t space_id;
 	uint32_t group_id;
+	/**
+	 * Snapshot iterator. Freed by tx as soon as the checkpoint
+	 * thread is done with the space, set to NULL after that.
+	 */
 	struct snapshot_iterator *iterator;
+	/** Set if the space may store tuples with compressed fields. */
+	bool is_compressed;
+	/** Size of the space data, see space_bsize(). */
+	size_t bsize;
+	/** Number of the shard the space is written to. */
+	uint32_t shard;
+	/**
+	 * Set by the checkpoint thread when it's done with the space.
+	 * Accessed atomically, because it is read by tx.
+	 */
+	bool is_written;
 	struct rlist link;
 };
 
+/**
+ * A file of a checkpoint and the thread that writes it. With
+ * box.cfg.memtx_checkpoint_threads > 1, user spaces are split
+ * among several files written in parallel. Shard 0 is the usual
+ * snapshot file <signature>.snap: it stores system spaces, the
+ * Raft and synchro state and, in its header, the number of shards.
+ * Shard N > 0 is <signature>.N.snap and stores only user spaces.
+ * xdir_scan() doesn't see shards, so the snapshot directory index
+ * lists checkpoints as before.
+ */
+struct checkpoint_shard {
+	/** Shard number. */
+	uint32_t id;
+	/** Total size of the spaces written to the shard. */
+	size_t bsize;
+	/** The checkpoint the shard belongs to. */
+	struct checkpoint *ckpt;
+	/** Thread writing the shard. */
+	struct cord cord;
+};
+
 struct checkpoint {
 	/**
 	 * List of MemTX spaces to snapshot, with consistent
@@ -669,8 +1114,22 @@ struct checkpoint {
 	 * the snapshot iterators from being freed.
 	 */
 	memtx_allocators_read_view rv;
-	struct cord cord;
+	/** Snapshot shards. */
+	struct checkpoint_shard *shards;
+	/** Number of snapshot shards. */
+	uint32_t shard_count;
+	/** Number of started checkpoint threads. */
+	uint32_t thread_count;
 	bool waiting_for_snap_thread;
+	/**
+	 * Sent by a checkpoint thread to tx after a space has been
+	 * written, so that tx can free the snapshot iterator and
+	 * stop maintaining the index read view early instead of
+	 * keeping all of them until the checkpoint ends.
+	 */
+	struct ev_async entry_written;
+	/** Tx event loop, the target of entry_written. */
+	struct ev_loop *tx_loop;
 	/** The vclock of the snapshot file. */
 	struct vclock vclock;
 	struct xdir dir;
@@ -683,8 +1142,34 @@ struct checkpoint {
 	bool touch;
 };
 
+/**
+ * Free the snapshot iterators of the spaces that have already been
+ * written by the checkpoint threads. Called in tx.
+ */
+static void
+checkpoint_release_entries(struct checkpoint *ckpt)
+{
+	struct checkpoint_entry *entry;
+	rlist_foreach_entry(entry, &ckpt->entries, link) {
+		if (entry->iterator == NULL ||
+		    !__atomic_load_n(&entry->is_written, __ATOMIC_ACQUIRE))
+			continue;
+		entry->iterator->free(entry->iterator);
+		entry->iterator = NULL;
+	}
+}
+
+static void
+checkpoint_release_entries_cb(ev_loop *loop, ev_async *watcher, int revents)
+{
+	(void)loop;
+	(void)revents;
+	checkpoint_release_entries((struct checkpoint *)watcher->data);
+}
+
 static struct checkpoint *
-checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
+checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit,
+	       uint32_t shard_count)
 {
 	struct checkpoint *ckpt = (struct checkpoint *)malloc(sizeof(*ckpt));
 	if (ckpt == NULL) {
@@ -692,8 +1177,25 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 			 "struct checkpoint");
 		return NULL;
 	}
+	ckpt->shards = (struct checkpoint_shard *)
+		calloc(shard_count, sizeof(*ckpt->shards));
+	if (ckpt->shards == NULL) {
+		diag_set(OutOfMemory, shard_count * sizeof(*ckpt->shards),
+			 "calloc", "checkpoint shards");
+		free(ckpt);
+		return NULL;
+	}
+	for (uint32_t i = 0; i < shard_count; i++) {
+		ckpt->shards[i].id = i;
+		ckpt->shards[i].ckpt = ckpt;
+	}
+	ckpt->shard_count = shard_count;
+	ckpt->thread_count = 0;
 	rlist_create(&ckpt->entries);
 	ckpt->waiting_for_snap_thread = false;
+	ev_async_init(&ckpt->entry_written, checkpoint_release_entries_cb);
+	ckpt->entry_written.data = ckpt;
+	ckpt->tx_loop = loop();
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = snap_io_rate_limit;
 	opts.sync_interval = SNAP_SYNC_INTERVAL;
@@ -709,13 +1211,16 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 static void
 checkpoint_delete(struct checkpoint *ckpt)
 {
+	ev_async_stop(ckpt->tx_loop, &ckpt->entry_written);
 	struct checkpoint_entry *entry, *tmp;
 	rlist_foreach_entry_safe(entry, &ckpt->entries, link, tmp) {
-		entry->iterator->free(entry->iterator);
+		if (entry->iterator != NULL)
+			entry->iterator->free(entry->iterator);
 		free(entry);
 	}
 	memtx_allocators_close_read_view(ckpt->rv);
 	xdir_destroy(&ckpt->dir);
+	free(ckpt->shards);
 	free(ckpt);
 }
 
@@ -723,13 +1228,15 @@ static void
 checkpoint_cancel(struct checkpoint *ckpt)
 {
 	/*
-	 * Cancel the checkpoint thread if it's running and wait
-	 * for it to terminate so as to eliminate the possibility
+	 * Cancel the checkpoint threads if they're running and wait
+	 * for them to terminate so as to eliminate the possibility
 	 * of use-after-free.
 	 */
 	if (ckpt->waiting_for_snap_thread) {
-		tt_pthread_cancel(ckpt->cord.id);
-		tt_pthread_join(ckpt->cord.id, NULL);
+		for (uint32_t i = 0; i < ckpt->thread_count; i++)
+			tt_pthread_cancel(ckpt->shards[i].cord.id);
+		for (uint32_t i = 0; i < ckpt->thread_count; i++)
+			tt_pthread_join(ckpt->shards[i].cord.id, NULL);
 	}
 	checkpoint_delete(ckpt);
 }
@@ -768,6 +1275,11 @@ checkpoint_add_space(struct space *sp, void *data)
 
 	entry->space_id = space_id(sp);
 	entry->group_id = space_group_id(sp);
+	entry->is_compressed =
+		((struct memtx_space *)sp)->has_compressed_tuples;
+	entry->bsize = space_bsize(sp);
+	entry->shard = 0;
+	entry->is_written = false;
 	entry->iterator = index_create_snapshot_iterator(pk);
 	if (entry->iterator == NULL)
 		return -1;
@@ -775,6 +1287,87 @@ checkpoint_add_space(struct space *sp, void *data)
 	return 0;
 };
 
+static int
+checkpoint_entry_cmp_bsize(const void *a, const void *b)
+{
+	const struct checkpoint_entry *entry_a =
+		*(const struct checkpoint_entry **)a;
+	const struct checkpoint_entry *entry_b =
+		*(const struct checkpoint_entry **)b;
+	if (entry_a->bsize > entry_b->bsize)
+		return -1;
+	if (entry_a->bsize < entry_b->bsize)
+		return 1;
+	return 0;
+}
+
+/**
+ * Distribute spaces among checkpoint shards so that the shards are
+ * about the same size: take user spaces in the descending order of
+ * size and assign each to the smallest shard so far. System spaces
+ * always go to shard 0, because they're loaded first on recovery.
+ * Shards that would be left without spaces aren't created.
+ */
+static int
+checkpoint_assign_shards(struct checkpoint *ckpt)
+{
+	uint32_t count = 0;
+	struct checkpoint_entry *entry;
+	rlist_foreach_entry(entry, &ckpt->entries, link) {
+		if (entry->space_id < BOX_SYSTEM_ID_MAX)
+			ckpt->shards[0].bsize += entry->bsize;
+		else
+			count++;
+	}
+	ckpt->shard_count = MIN(ckpt->shard_count, count + 1);
+	if (ckpt->shard_count == 1)
+		return 0;
+	size_t size = count * sizeof(struct checkpoint_entry *);
+	struct checkpoint_entry **entries =
+		(struct checkpoint_entry **)malloc(size);
+	if (entries == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "checkpoint entries");
+		return -1;
+	}
+	uint32_t i = 0;
+	rlist_foreach_entry(entry, &ckpt->entries, link) {
+		if (entry->space_id >= BOX_SYSTEM_ID_MAX)
+			entries[i++] = entry;
+	}
+	qsort(entries, count, sizeof(*entries), checkpoint_entry_cmp_bsize);
+	for (i = 0; i < count; i++) {
+		struct checkpoint_shard *shard = &ckpt->shards[0];
+		for (uint32_t j = 1; j < ckpt->shard_count; j++) {
+			if (ckpt->shards[j].bsize < shard->bsize)
+				shard = &ckpt->shards[j];
+		}
+		entries[i]->shard = shard->id;
+		shard->bsize += entries[i]->bsize;
+	}
+	free(entries);
+	return 0;
+}
+
+/** Create the file of a checkpoint shard. */
+static int
+checkpoint_create_shard(struct checkpoint *ckpt,
+			struct checkpoint_shard *shard, struct xlog *snap)
+{
+	struct xdir *dir = &ckpt->dir;
+	struct xlog_meta meta;
+	xlog_meta_create(&meta, dir->filetype, dir->instance_uuid,
+			 &ckpt->vclock, NULL);
+	if (shard->id == 0)
+		meta.shard_count = ckpt->shard_count;
+	/* The shards share the checkpoint I/O rate limit. */
+	struct xlog_opts opts = dir->opts;
+	opts.rate_limit /= ckpt->shard_count;
+	const char *filename =
+		xdir_format_shard_filename(dir, vclock_sum(&ckpt->vclock),
+					   shard->id, NONE);
+	return xlog_create(snap, filename, dir->open_wflags, &meta, &opts);
+}
+
 static int
 checkpoint_write_raft(struct xlog *l, const struct raft_request *req)
 {
@@ -804,9 +1397,11 @@ checkpoint_write_synchro(struct xlog *l, const struct synchro_request *req)
 static int
 checkpoint_f(va_list ap)
 {
-	struct checkpoint *ckpt = va_arg(ap, struct checkpoint *);
+	struct checkpoint_shard *shard = va_arg(ap, struct checkpoint_shard *);
+	struct checkpoint *ckpt = shard->ckpt;
 
 	if (ckpt->touch) {
+		assert(ckpt->shard_count == 1);
 		if (xdir_touch_xlog(&ckpt->dir, &ckpt->vclock) == 0)
 			return 0;
 		/*
@@ -817,28 +1412,57 @@ checkpoint_f(va_list ap)
 	}
 
 	struct xlog snap;
-	if (xdir_create_xlog(&ckpt->dir, &snap, &ckpt->vclock) != 0)
+	if (checkpoint_create_shard(ckpt, shard, &snap) != 0)
 		return -1;
 
 	say_info("saving snapshot `%s'", snap.filename);
 	ERROR_INJECT_SLEEP(ERRINJ_SNAP_WRITE_DELAY);
 	struct checkpoint_entry *entry;
 	rlist_foreach_entry(entry, &ckpt->entries, link) {
+		if (entry->shard != shard->id)
+			continue;
 		int rc;
 		uint32_t size;
 		const char *data;
 		struct snapshot_iterator *it = entry->iterator;
 		while ((rc = it->next(it, &data, &size)) == 0 && data != NULL) {
-			if (checkpoint_write_tuple(&snap, entry->space_id,
-					entry->group_id, data, size) != 0)
+			struct region *region = &fiber()->gc;
+			size_t region_svp = region_used(region);
+			/*
+			 * Compression is a property of the in-memory
+			 * representation, snapshots store raw data.
+			 */
+			if (entry->is_compressed &&
+			    memtx_tuple_data_decompress(&data, &size,
+							region) != 0)
+				goto fail;
+			rc = checkpoint_write_tuple(&snap, entry->space_id,
+						    entry->group_id, data, size);
+			region_truncate(region, region_svp);
+			if (rc != 0)
 				goto fail;
 		}
 		if (rc != 0)
 			goto fail;
+		/*
+		 * The iterator isn't used anymore: let tx free it.
+		 * Note that the entry itself stays valid until the
+		 * checkpoint is deleted.
+		 */
+		__atomic_store_n(&entry->is_written, true, __ATOMIC_RELEASE);
+		ev_async_send(ckpt->tx_loop, &ckpt->entry_written);
+		ERROR_INJECT_COUNTDOWN(ERRINJ_SNAP_WRITE_DELAY_COUNTDOWN, {
+			struct errinj *e = errinj(ERRINJ_SNAP_WRITE_DELAY,
+						  ERRINJ_BOOL);
+			e->bparam = true;
+		});
+		ERROR_INJECT_SLEEP(ERRINJ_SNAP_WRITE_DELAY);
 	}
-	if (checkpoint_write_raft(&snap, &ckpt->raft) != 0)
+	if (shard->id == 0 &&
+	    checkpoint_write_raft(&snap, &ckpt->raft) != 0)
 		goto fail;
-	if (checkpoint_write_synchro(&snap, &ckpt->synchro_state) != 0)
+	if (shard->id == 0 &&
+	    checkpoint_write_synchro(&snap, &ckpt->synchro_state) != 0)
 		goto fail;
 	if (xlog_flush(&snap) < 0)
 		goto fail;
@@ -859,11 +1483,13 @@ memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 
 	assert(memtx->checkpoint == NULL);
 	memtx->checkpoint = checkpoint_new(memtx->snap_dir.dirname,
-					   memtx->snap_io_rate_limit);
+					   memtx->snap_io_rate_limit,
+					   memtx->checkpoint_threads);
 	if (memtx->checkpoint == NULL)
 		return -1;
 
-	if (space_foreach(checkpoint_add_space, memtx->checkpoint) != 0) {
+	if (space_foreach(checkpoint_add_space, memtx->checkpoint) != 0 ||
+	    checkpoint_assign_shards(memtx->checkpoint) != 0) {
 		checkpoint_delete(memtx->checkpoint);
 		memtx->checkpoint = NULL;
 		return -1;
@@ -877,30 +1503,69 @@ memtx_engine_wait_checkpoint(struct engine *engine,
 			     const struct vclock *vclock)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	struct checkpoint *ckpt = memtx->checkpoint;
 
-	assert(memtx->checkpoint != NULL);
+	assert(ckpt != NULL);
 	/*
 	 * If a snapshot already exists, do not create a new one.
 	 */
 	struct vclock last;
 	if (xdir_last_vclock(&memtx->snap_dir, &last) >= 0 &&
 	    vclock_compare(&last, vclock) == 0) {
-		memtx->checkpoint->touch = true;
+		ckpt->touch = true;
+		/*
+		 * Touching is done by one thread. If it fails,
+		 * the thread writes the whole snapshot to one file.
+		 */
+		ckpt->shard_count = 1;
+		struct checkpoint_entry *entry;
+		rlist_foreach_entry(entry, &ckpt->entries, link)
+			entry->shard = 0;
 	}
-	vclock_copy(&memtx->checkpoint->vclock, vclock);
-
-	if (cord_costart(&memtx->checkpoint->cord, "snapshot",
-			 checkpoint_f, memtx->checkpoint)) {
-		return -1;
+	vclock_copy(&ckpt->vclock, vclock);
+
+	ev_async_start(loop(), &ckpt->entry_written);
+	int result = 0;
+	while (ckpt->thread_count < ckpt->shard_count) {
+		uint32_t id = ckpt->thread_count;
+		const char *name = id == 0 ? "snapshot" :
+				   tt_sprintf("snapshot_%u", (unsigned)id);
+		if (cord_costart(&ckpt->shards[id].cord, name,
+				 checkpoint_f, &ckpt->shards[id]) != 0) {
+			diag_log();
+			result = -1;
+			break;
+		}
+		ckpt->thread_count++;
 	}
-	memtx->checkpoint->waiting_for_snap_thread = true;
+	ckpt->waiting_for_snap_thread = true;
 
-	/* wait for memtx-part snapshot completion */
-	int result = cord_cojoin(&memtx->checkpoint->cord);
-	if (result != 0)
-		diag_log();
+	/*
+	 * Wait for memtx-part snapshot completion. cord_cojoin()
+	 * clears the diagnostics area on success so remember the
+	 * first error to report it to the caller.
+	 */
+	struct error *error = NULL;
+	if (result != 0) {
+		error = diag_last_error(diag_get());
+		error_ref(error);
+	}
+	for (uint32_t i = 0; i < ckpt->thread_count; i++) {
+		if (cord_cojoin(&ckpt->shards[i].cord) != 0) {
+			diag_log();
+			result = -1;
+			if (error == NULL) {
+				error = diag_last_error(diag_get());
+				error_ref(error);
+			}
+		}
+	}
+	if (error != NULL) {
+		diag_set_error(diag_get(), error);
+		error_unref(error);
+	}
 
-	memtx->checkpoint->waiting_for_snap_thread = false;
+	ckpt->waiting_for_snap_thread = false;
 	return result;
 }
 
@@ -920,15 +1585,24 @@ memtx_engine_commit_checkpoint(struct engine *engine,
 	if (!memtx->checkpoint->touch) {
 		int64_t lsn = vclock_sum(&memtx->checkpoint->vclock);
 		struct xdir *dir = &memtx->checkpoint->dir;
-		/* rename snapshot on completion */
-		char to[PATH_MAX];
-		snprintf(to, sizeof(to), "%s",
-			 xdir_format_filename(dir, lsn, NONE));
-		const char *from = xdir_format_filename(dir, lsn, INPROGRESS);
 		ERROR_INJECT_YIELD(ERRINJ_SNAP_COMMIT_DELAY);
-		int rc = coio_rename(from, to);
-		if (rc != 0)
-			panic("can't rename .snap.inprogress");
+		/*
+		 * Rename snapshot on completion. Shard 0 goes last,
+		 * because it's the file that makes the snapshot
+		 * visible to recovery.
+		 */
+		for (uint32_t i = memtx->checkpoint->shard_count; i-- > 0; ) {
+			char to[PATH_MAX];
+			snprintf(to, sizeof(to), "%s",
+				 xdir_format_shard_filename(dir, lsn, i,
+							    NONE));
+			const char *from =
+				xdir_format_shard_filename(dir, lsn, i,
+							   INPROGRESS);
+			int rc = coio_rename(from, to);
+			if (rc != 0)
+				panic("can't rename .snap.inprogress");
+		}
 	}
 
 	struct vclock last;
@@ -946,34 +1620,73 @@ static void
 memtx_engine_abort_checkpoint(struct engine *engine)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	struct checkpoint *ckpt = memtx->checkpoint;
 
 	/**
 	 * An error in the other engine's first phase.
 	 */
-	if (memtx->checkpoint->waiting_for_snap_thread) {
+	if (ckpt->waiting_for_snap_thread) {
 		/* wait for memtx-part snapshot completion */
-		if (cord_cojoin(&memtx->checkpoint->cord) != 0)
-			diag_log();
-		memtx->checkpoint->waiting_for_snap_thread = false;
+		for (uint32_t i = 0; i < ckpt->thread_count; i++) {
+			if (cord_cojoin(&ckpt->shards[i].cord) != 0)
+				diag_log();
+		}
+		ckpt->waiting_for_snap_thread = false;
 	}
 
-	/** Remove garbage .inprogress file. */
-	const char *filename =
-		xdir_format_filename(&memtx->checkpoint->dir,
-				     vclock_sum(&memtx->checkpoint->vclock),
-				     INPROGRESS);
-	(void) coio_unlink(filename);
+	/** Remove garbage .inprogress files. */
+	for (uint32_t i = 0; i < ckpt->shard_count; i++) {
+		const char *filename =
+			xdir_format_shard_filename(&ckpt->dir,
+						   vclock_sum(&ckpt->vclock),
+						   i, INPROGRESS);
+		(void) coio_unlink(filename);
+	}
 
-	checkpoint_delete(memtx->checkpoint);
+	checkpoint_delete(ckpt);
 	memtx->checkpoint = NULL;
 }
 
+/** Remove the shards of the snapshot with the given signature. */
+static void
+memtx_engine_remove_snapshot_shards(struct memtx_engine *memtx,
+				    int64_t signature)
+{
+	int shard_count = memtx_engine_snapshot_shard_count(memtx, signature);
+	if (shard_count < 0) {
+		say_error("failed to read the number of shards of "
+			  "snapshot %lld", (long long)signature);
+		diag_log();
+		return;
+	}
+	for (int i = shard_count - 1; i > 0; i--) {
+		char filename[PATH_MAX];
+		strlcpy(filename,
+			xdir_format_shard_filename(&memtx->snap_dir,
+						   signature, i, NONE),
+			sizeof(filename));
+		if (coio_unlink(filename) == 0)
+			say_info("removed %s", filename);
+		else if (errno != ENOENT)
+			say_syserror("error while removing %s", filename);
+	}
+}
+
 static void
 memtx_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-	xdir_collect_garbage(&memtx->snap_dir, vclock_sum(vclock),
-			     XDIR_GC_ASYNC);
+	int64_t signature = vclock_sum(vclock);
+	/*
+	 * Remove snapshot shards before the snapshot files, which
+	 * store the number of shards.
+	 */
+	vclockset_t *index = &memtx->snap_dir.index;
+	for (struct vclock *it = vclockset_first(index);
+	     it != NULL && vclock_sum(it) < signature;
+	     it = vclockset_next(index, it))
+		memtx_engine_remove_snapshot_shards(memtx, vclock_sum(it));
+	xdir_collect_garbage(&memtx->snap_dir, signature, XDIR_GC_ASYNC);
 }
 
 static int
@@ -981,14 +1694,25 @@ memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
 		    engine_backup_cb cb, void *cb_arg)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-	const char *filename = xdir_format_filename(&memtx->snap_dir,
-						    vclock_sum(vclock), NONE);
-	return cb(filename, cb_arg);
+	int64_t signature = vclock_sum(vclock);
+	int shard_count = memtx_engine_snapshot_shard_count(memtx, signature);
+	if (shard_count < 0)
+		return -1;
+	for (int i = 0; i < shard_count; i++) {
+		const char *filename =
+			xdir_format_shard_filename(&memtx->snap_dir,
+						   signature, i, NONE);
+		if (cb(filename, cb_arg) != 0)
+			return -1;
+	}
+	return 0;
 }
 
 struct memtx_join_entry {
 	struct rlist in_ctx;
 	uint32_t space_id;
+	/** Set if the space may store tuples with compressed fields. */
+	bool is_compressed;
 	struct snapshot_iterator *iterator;
 };
 
@@ -1027,6 +1751,8 @@ memtx_join_add_space(struct space *space, void *arg)
 		return -1;
 	}
 	entry->space_id = space_id(space);
+	entry->is_compressed =
+		((struct memtx_space *)space)->has_compressed_tuples;
 	entry->iterator = index_create_snapshot_iterator(pk);
 	if (entry->iterator == NULL) {
 		free(entry);
@@ -1088,8 +1814,16 @@ memtx_join_f(va_list ap)
 		uint32_t size;
 		const char *data;
 		while ((rc = it->next(it, &data, &size)) == 0 && data != NULL) {
-			if (memtx_join_send_tuple(ctx->stream, entry->space_id,
-						  data, size) != 0)
+			struct region *region = &fiber()->gc;
+			size_t region_svp = region_used(region);
+			if (entry->is_compressed &&
+			    memtx_tuple_data_decompress(&data, &size,
+							region) != 0)
+				return -1;
+			rc = memtx_join_send_tuple(ctx->stream, entry->space_id,
+						   data, size);
+			region_truncate(region, region_svp);
+			if (rc != 0)
 				return -1;
 		}
 		if (rc != 0)
@@ -1148,6 +1882,13 @@ memtx_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->index += index_stats.totals.used;
 }
 
+static void
+memtx_engine_reset_stat(struct engine *engine)
+{
+	(void)engine;
+	memtx_tuple_compression_reset_stat();
+}
+
 static const struct engine_vtab memtx_engine_vtab = {
 	/* .shutdown = */ memtx_engine_shutdown,
 	/* .create_space = */ memtx_engine_create_space,
@@ -1173,7 +1914,7 @@ static const struct engine_vtab memtx_engine_vtab = {
 	/* .collect_garbage = */ memtx_engine_collect_garbage,
 	/* .backup = */ memtx_engine_backup,
 	/* .memory_stat = */ memtx_engine_memory_stat,
-	/* .reset_stat = */ generic_engine_reset_stat,
+	/* .reset_stat = */ memtx_engine_reset_stat,
 	/* .check_space_def = */ generic_engine_check_space_def,
 };
 
@@ -1312,6 +2053,8 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->gc_fiber = fiber_new("memtx.gc", memtx_engine_gc_f);
 	if (memtx->gc_fiber == NULL)
 		goto fail;
+	if (memtx_read_view_init(memtx) != 0)
+		goto fail;
 
 	/* Apply lowest allowed objsize bound. */
 	if (objsize_min < OBJSIZE_MIN)
@@ -1354,6 +2097,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
+	memtx->checkpoint_threads = 1;
 	memtx->force_recovery = force_recovery;
 
 	memtx->replica_join_cord = NULL;
@@ -1409,6 +2153,32 @@ memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 	memtx->max_tuple_size = max_size;
 }
 
+void
+memtx_engine_set_read_view_interval(struct memtx_engine *memtx,
+				    double interval)
+{
+	(void)memtx;
+	memtx_read_view_set_interval(interval);
+}
+
+void
+memtx_engine_set_checkpoint_threads(struct memtx_engine *memtx,
+				    int thread_count)
+{
+	assert(thread_count >= 1 &&
+	       thread_count <= MEMTX_CHECKPOINT_THREADS_MAX);
+	memtx->checkpoint_threads = thread_count;
+}
+
+void
+memtx_engine_set_index_build_threads(struct memtx_engine *memtx,
+				     int thread_count)
+{
+	assert(thread_count >= 0 &&
+	       thread_count <= MEMTX_INDEX_BUILD_THREADS_MAX);
+	memtx->index_build_threads = thread_count;
+}
+
 template<class ALLOC>
 static struct tuple *
 memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
@@ -1469,6 +2239,8 @@ memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
 	raw = (char *) tuple + data_offset;
 	field_map_build(&builder, raw - field_map_size);
 	memcpy(raw, data, tuple_len);
+	if (format->is_compressed)
+		memtx_tuple_compression_account(tuple, 1);
 	say_debug("%s(%zu) = %p", __func__, tuple_len, tuple);
 end:
 	region_truncate(region, region_svp);
@@ -1488,6 +2260,8 @@ memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 {
 	assert(tuple_is_unreferenced(tuple));
 	say_debug("%s(%p)", __func__, tuple);
+	if (format->is_compressed)
+		memtx_tuple_compression_forget(tuple);
 	MemtxAllocator<ALLOC>::free_tuple(tuple);
 	tuple_format_unref(format);
 }
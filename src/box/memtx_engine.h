@@ -88,6 +88,13 @@ enum memtx_recovery_state {
 /** Memtx extents pool, available to statistics. */
 extern struct mempool memtx_index_extent_pool;
 
+enum {
+	/** Max value of box.cfg.memtx_index_build_threads. */
+	MEMTX_INDEX_BUILD_THREADS_MAX = 256,
+	/** Max value of box.cfg.memtx_checkpoint_threads. */
+	MEMTX_CHECKPOINT_THREADS_MAX = 64,
+};
+
 enum memtx_reserve_extents_num {
 	/**
 	 * This number is calculated based on the
@@ -118,6 +125,13 @@ struct memtx_engine {
 	struct xdir snap_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * Number of threads writing a checkpoint concurrently,
+	 * box.cfg.memtx_checkpoint_threads. If greater than 1,
+	 * user spaces are distributed among that many snapshot
+	 * files (shards), each written by its own thread.
+	 */
+	int checkpoint_threads;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/**
@@ -151,6 +165,14 @@ struct memtx_engine {
 	void *reserved_extents;
 	/** Maximal allowed tuple size, box.cfg.memtx_max_tuple_size. */
 	size_t max_tuple_size;
+	/**
+	 * Number of threads used for building secondary indexes at
+	 * the end of recovery, box.cfg.memtx_index_build_threads.
+	 * If 0, indexes are built in the tx thread one by one. If
+	 * positive, a secondary index created on a non-empty space
+	 * is also built by a worker thread, see memtx_space.c.
+	 */
+	int index_build_threads;
 	/** Memory pool for rtree index iterator. */
 	struct mempool rtree_iterator_pool;
 	/**
@@ -223,6 +245,23 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+/**
+ * Set the interval at which read views used for serving SELECT
+ * requests in iproto threads are refreshed, in seconds. Zero
+ * disables serving requests from read views.
+ */
+void
+memtx_engine_set_read_view_interval(struct memtx_engine *memtx,
+				    double interval);
+
+void
+memtx_engine_set_checkpoint_threads(struct memtx_engine *memtx,
+				    int thread_count);
+
+void
+memtx_engine_set_index_build_threads(struct memtx_engine *memtx,
+				     int thread_count);
+
 /** Tuple format vtab for memtx engine. */
 extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
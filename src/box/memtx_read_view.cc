@@ -0,0 +1,434 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_read_view.h"
+
+#include <stdlib.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "index.h"
+#include "memtx_allocator.h"
+#include "memtx_engine.h"
+#include "memtx_space.h"
+#include "memtx_tx.h"
+#include "msgpuck.h"
+#include "schema.h"
+#include "space.h"
+#include "space_cache.h"
+#include "trivia/util.h"
+#include "user.h"
+#include "xrow.h"
+
+/**
+ * How often to check if replaced read views may be deleted if there
+ * are readers still accessing them, in seconds.
+ */
+static const double MEMTX_READ_VIEW_RECLAIM_DELAY = 0.01;
+
+static_assert(BOX_USER_MAX <= 32, "readable mask must fit in uint32_t");
+
+/** Read view of a memtx index. */
+struct memtx_read_view_index {
+	/** Space identifier. */
+	uint32_t space_id;
+	/** Index identifier. */
+	uint32_t index_id;
+	/**
+	 * Bit mask of authentication tokens of users allowed to read
+	 * the space, see memtx_read_view_readable_mask().
+	 */
+	uint32_t readable_mask;
+	/** Frozen index. */
+	struct memtx_tree_index_view *view;
+};
+
+/** Read view of all eligible memtx indexes. */
+struct memtx_read_view {
+	/** Sequence number, see memtx_read_view_next_seq(). */
+	uint64_t seq;
+	/** Schema version at the time the read view was created. */
+	uint32_t schema_version;
+	/**
+	 * Ids of users by authentication token at the time the read
+	 * view was created. Used to make sure that a token wasn't
+	 * reassigned to another user since then.
+	 */
+	uint32_t token_uid[BOX_USER_MAX];
+	/**
+	 * Epoch at which the read view was replaced by a newer one.
+	 * Readers that entered an older epoch may still access it.
+	 */
+	uint64_t retire_epoch;
+	/** Tuple allocator read view pinning tuples of the indexes. */
+	memtx_allocators_read_view allocators_rv;
+	/** Index read views sorted by space id, index id. */
+	struct memtx_read_view_index *indexes;
+	/** Number of index read views. */
+	uint32_t index_count;
+	/** Allocated size of the indexes array. */
+	uint32_t index_capacity;
+	/** Link in the list of replaced read views. */
+	struct rlist in_retired;
+};
+
+/** Memtx engine. */
+static struct memtx_engine *memtx_read_view_engine;
+/** Fiber refreshing read views. */
+static struct fiber *memtx_read_view_fiber;
+/** Refresh interval, box.cfg.memtx_read_view_interval. */
+static double memtx_read_view_interval;
+/** Time when the read view should be refreshed next. */
+static double memtx_read_view_refresh_time;
+/** Most recent read view. Accessed by readers. */
+static struct memtx_read_view *memtx_read_view_current;
+/** Current epoch. Incremented when a read view is replaced. */
+static uint64_t memtx_read_view_epoch = 1;
+/** Sequence number of the next created read view. */
+static uint64_t memtx_read_view_seq = 1;
+/** Replaced read views ordered by retire_epoch. */
+static RLIST_HEAD(memtx_read_view_retired);
+/** Registered readers. */
+static RLIST_HEAD(memtx_read_view_readers);
+
+/**
+ * Return the bit mask of authentication tokens of users allowed to
+ * read the given space. The check is the same as in
+ * access_check_space() except it looks up the cached user privileges
+ * instead of session credentials.
+ */
+static uint32_t
+memtx_read_view_readable_mask(struct space *space)
+{
+	uint32_t mask = 0;
+	struct access *entity_access = entity_access_get(SC_SPACE);
+	for (uint8_t token = 0; token < BOX_USER_MAX; token++) {
+		struct user *user = user_find_by_token(token);
+		if (user->def == NULL)
+			continue;
+		user_access_t access = (PRIV_R | PRIV_U) &
+				       ~universe.access[token].effective &
+				       ~entity_access[token].effective;
+		if (access == 0 ||
+		    ((access & PRIV_U) == 0 &&
+		     (space->def->uid == user->def->uid ||
+		      (access & ~space->access[token].effective) == 0)))
+			mask |= 1u << token;
+	}
+	return mask;
+}
+
+/**
+ * Return true if indexes of the given space may be included in
+ * read views.
+ */
+static bool
+memtx_read_view_space_is_eligible(struct space *space)
+{
+	/*
+	 * Tuples of data-temporary spaces aren't pinned by read views
+	 * (see MemtxAllocator::free_tuple()) while compressed tuples
+	 * and tuples of spaces being upgraded must be converted before
+	 * sending them to the client.
+	 */
+	return space_is_memtx(space) && !space_is_system(space) &&
+	       !space_is_temporary(space) && space->upgrade == NULL &&
+	       !((struct memtx_space *)space)->has_compressed_tuples;
+}
+
+static void
+memtx_read_view_add_index(struct memtx_read_view *rv, struct index *index,
+			  struct memtx_tree_index_view *view,
+			  uint32_t readable_mask)
+{
+	if (rv->index_count == rv->index_capacity) {
+		rv->index_capacity = MAX(rv->index_capacity * 2, 16);
+		rv->indexes = (struct memtx_read_view_index *)xrealloc(
+			rv->indexes,
+			rv->index_capacity * sizeof(*rv->indexes));
+	}
+	struct memtx_read_view_index *entry = &rv->indexes[rv->index_count++];
+	entry->space_id = index->def->space_id;
+	entry->index_id = index->def->iid;
+	entry->readable_mask = readable_mask;
+	entry->view = view;
+}
+
+static int
+memtx_read_view_add_space(struct space *space, void *arg)
+{
+	struct memtx_read_view *rv = (struct memtx_read_view *)arg;
+	if (!memtx_read_view_space_is_eligible(space))
+		return 0;
+	uint32_t readable_mask = memtx_read_view_readable_mask(space);
+	if (readable_mask == 0)
+		return 0;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index *index = space->index[i];
+		if (!memtx_tree_index_supports_view(index))
+			continue;
+		struct memtx_tree_index_view *view =
+			memtx_tree_index_view_new(index);
+		if (view == NULL)
+			return -1;
+		memtx_read_view_add_index(rv, index, view, readable_mask);
+	}
+	return 0;
+}
+
+static int
+memtx_read_view_index_cmp(const void *a_ptr, const void *b_ptr)
+{
+	const struct memtx_read_view_index *a =
+		(const struct memtx_read_view_index *)a_ptr;
+	const struct memtx_read_view_index *b =
+		(const struct memtx_read_view_index *)b_ptr;
+	if (a->space_id != b->space_id)
+		return a->space_id < b->space_id ? -1 : 1;
+	if (a->index_id != b->index_id)
+		return a->index_id < b->index_id ? -1 : 1;
+	return 0;
+}
+
+/** Find an index in a read view. Returns NULL if not found. */
+static struct memtx_read_view_index *
+memtx_read_view_find_index(struct memtx_read_view *rv, uint32_t space_id,
+			   uint32_t index_id)
+{
+	struct memtx_read_view_index key;
+	key.space_id = space_id;
+	key.index_id = index_id;
+	return (struct memtx_read_view_index *)bsearch(
+		&key, rv->indexes, rv->index_count, sizeof(*rv->indexes),
+		memtx_read_view_index_cmp);
+}
+
+static void
+memtx_read_view_delete(struct memtx_read_view *rv)
+{
+	for (uint32_t i = 0; i < rv->index_count; i++)
+		memtx_tree_index_view_delete(rv->indexes[i].view);
+	free(rv->indexes);
+	/* Close the allocator read view after the indexes are released. */
+	memtx_allocators_close_read_view(rv->allocators_rv);
+	free(rv);
+}
+
+/**
+ * Create a read view of all eligible memtx indexes.
+ * Returns NULL on error (diag is set).
+ */
+static struct memtx_read_view *
+memtx_read_view_new(void)
+{
+	struct memtx_read_view *rv =
+		(struct memtx_read_view *)xcalloc(1, sizeof(*rv));
+	rv->seq = memtx_read_view_seq++;
+	rv->schema_version = schema_version;
+	for (uint8_t token = 0; token < BOX_USER_MAX; token++) {
+		struct user *user = user_find_by_token(token);
+		rv->token_uid[token] = user->def != NULL ?
+				       user->def->uid : BOX_ID_NIL;
+	}
+	/*
+	 * Tuples stored in the index read views must be pinned
+	 * before the index read views are created.
+	 */
+	rv->allocators_rv = memtx_allocators_open_read_view({});
+	if (space_foreach(memtx_read_view_add_space, rv) != 0) {
+		memtx_read_view_delete(rv);
+		return NULL;
+	}
+	qsort(rv->indexes, rv->index_count, sizeof(*rv->indexes),
+	      memtx_read_view_index_cmp);
+	return rv;
+}
+
+/**
+ * Publish a new read view (may be NULL) and put the current one to
+ * the list of replaced read views.
+ */
+static void
+memtx_read_view_publish(struct memtx_read_view *rv)
+{
+	struct memtx_read_view *old = memtx_read_view_current;
+	if (old == NULL && rv == NULL)
+		return;
+	__atomic_store_n(&memtx_read_view_current, rv, __ATOMIC_SEQ_CST);
+	if (old == NULL)
+		return;
+	old->retire_epoch = __atomic_add_fetch(&memtx_read_view_epoch, 1,
+					       __ATOMIC_SEQ_CST);
+	rlist_add_tail_entry(&memtx_read_view_retired, old, in_retired);
+}
+
+/** Delete replaced read views that aren't accessed by any reader. */
+static void
+memtx_read_view_reclaim(void)
+{
+	uint64_t min_epoch = UINT64_MAX;
+	struct memtx_read_view_reader *reader;
+	rlist_foreach_entry(reader, &memtx_read_view_readers, in_readers) {
+		uint64_t epoch = __atomic_load_n(&reader->epoch,
+						 __ATOMIC_SEQ_CST);
+		if (epoch != 0)
+			min_epoch = MIN(min_epoch, epoch);
+	}
+	struct memtx_read_view *rv, *tmp;
+	rlist_foreach_entry_safe(rv, &memtx_read_view_retired,
+				 in_retired, tmp) {
+		if (rv->retire_epoch > min_epoch)
+			break;
+		rlist_del_entry(rv, in_retired);
+		memtx_read_view_delete(rv);
+	}
+}
+
+/** Replace the current read view with a new one. */
+static void
+memtx_read_view_refresh(void)
+{
+	struct memtx_read_view *rv = NULL;
+	/*
+	 * Read views don't track transactions so they can't be used
+	 * with MVCC. Neither can they be used if there are on_select
+	 * triggers, which must be run in tx.
+	 */
+	if (memtx_read_view_engine->state == MEMTX_OK &&
+	    !memtx_tx_manager_use_mvcc_engine &&
+	    rlist_empty(&box_on_select)) {
+		rv = memtx_read_view_new();
+		if (rv == NULL)
+			diag_log();
+	}
+	memtx_read_view_publish(rv);
+}
+
+static int
+memtx_read_view_f(va_list ap)
+{
+	(void)ap;
+	while (!fiber_is_cancelled()) {
+		double now = ev_monotonic_now(loop());
+		if (memtx_read_view_interval == 0) {
+			memtx_read_view_publish(NULL);
+		} else if (now >= memtx_read_view_refresh_time) {
+			memtx_read_view_refresh();
+			memtx_read_view_refresh_time =
+				now + memtx_read_view_interval;
+		}
+		memtx_read_view_reclaim();
+		double timeout = TIMEOUT_INFINITY;
+		if (memtx_read_view_interval > 0)
+			timeout = memtx_read_view_refresh_time - now;
+		if (!rlist_empty(&memtx_read_view_retired))
+			timeout = MIN(timeout, MEMTX_READ_VIEW_RECLAIM_DELAY);
+		fiber_yield_timeout(timeout);
+	}
+	return 0;
+}
+
+int
+memtx_read_view_init(struct memtx_engine *memtx)
+{
+	memtx_read_view_engine = memtx;
+	memtx_read_view_fiber = fiber_new("memtx.read_view",
+					  memtx_read_view_f);
+	if (memtx_read_view_fiber == NULL)
+		return -1;
+	fiber_start(memtx_read_view_fiber);
+	return 0;
+}
+
+void
+memtx_read_view_free(void)
+{
+	memtx_read_view_interval = 0;
+	memtx_read_view_publish(NULL);
+	struct memtx_read_view *rv, *tmp;
+	rlist_foreach_entry_safe(rv, &memtx_read_view_retired,
+				 in_retired, tmp) {
+		rlist_del_entry(rv, in_retired);
+		memtx_read_view_delete(rv);
+	}
+}
+
+void
+memtx_read_view_set_interval(double interval)
+{
+	assert(interval >= 0);
+	memtx_read_view_interval = interval;
+	memtx_read_view_refresh_time = 0;
+	fiber_wakeup(memtx_read_view_fiber);
+}
+
+uint64_t
+memtx_read_view_next_seq(void)
+{
+	return memtx_read_view_seq;
+}
+
+void
+memtx_read_view_reader_register(struct memtx_read_view_reader *reader)
+{
+	reader->epoch = 0;
+	rlist_add_tail_entry(&memtx_read_view_readers, reader, in_readers);
+}
+
+void
+memtx_read_view_reader_unregister(struct memtx_read_view_reader *reader)
+{
+	rlist_del_entry(reader, in_readers);
+	/* Replaced read views may have been waiting for this reader. */
+	if (!rlist_empty(&memtx_read_view_retired))
+		fiber_wakeup(memtx_read_view_fiber);
+}
+
+ssize_t
+memtx_read_view_select(struct memtx_read_view_reader *reader,
+		       uint8_t auth_token, uint32_t uid, uint64_t min_seq,
+		       const struct request *request,
+		       uint32_t *schema_version,
+		       memtx_tree_index_view_select_cb cb, void *arg)
+{
+	if (request->iterator > ITER_GT || auth_token >= BOX_USER_MAX)
+		return -1;
+	/*
+	 * Enter the current epoch before loading the read view so that
+	 * the tx thread doesn't delete it, see memtx_read_view_reclaim().
+	 */
+	__atomic_store_n(&reader->epoch,
+			 __atomic_load_n(&memtx_read_view_epoch,
+					 __ATOMIC_SEQ_CST),
+			 __ATOMIC_SEQ_CST);
+	struct memtx_read_view *rv = __atomic_load_n(&memtx_read_view_current,
+						     __ATOMIC_SEQ_CST);
+	ssize_t rc = -1;
+	if (rv == NULL || rv->seq < min_seq ||
+	    rv->token_uid[auth_token] != uid ||
+	    rv->schema_version != __atomic_load_n(&::schema_version,
+						  __ATOMIC_RELAXED) ||
+	    (*schema_version != 0 && *schema_version != rv->schema_version))
+		goto out;
+	{
+		struct memtx_read_view_index *entry =
+			memtx_read_view_find_index(rv, request->space_id,
+						   request->index_id);
+		if (entry == NULL ||
+		    (entry->readable_mask & (1u << auth_token)) == 0)
+			goto out;
+		const char *key = request->key;
+		uint32_t part_count = key != NULL ? mp_decode_array(&key) : 0;
+		rc = memtx_tree_index_view_select(
+			entry->view, (enum iterator_type)request->iterator,
+			key, part_count, request->offset, request->limit,
+			cb, arg);
+		if (rc >= 0)
+			*schema_version = rv->schema_version;
+	}
+out:
+	__atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+	return rc;
+}
@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "memtx_tree.h"
+#include "small/rlist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Periodically refreshed read views of memtx spaces that may be
+ * accessed from threads other than tx, e.g. to serve SELECT requests
+ * right in iproto threads.
+ *
+ * When enabled with box.cfg.memtx_read_view_interval, a tx fiber
+ * creates a read view of all eligible memtx indexes (see
+ * memtx_tree_index_supports_view()) every interval and publishes it.
+ * Readers always use the most recent published read view so their
+ * results may be up to one interval stale.
+ *
+ * Read views replaced by a newer one are reclaimed in tx as soon as
+ * no reader accesses them, which is tracked with epochs: a reader
+ * announces the current epoch before accessing the published read
+ * view and clears it when done. A replaced read view is tagged with
+ * the epoch that was current at the moment it was replaced, and it
+ * is safe to delete it once all readers have either left or entered
+ * a later epoch.
+ */
+
+struct memtx_engine;
+struct request;
+
+/**
+ * A thread that accesses memtx read views. Must be registered with
+ * memtx_read_view_reader_register() before use.
+ */
+struct memtx_read_view_reader {
+	/**
+	 * The epoch at which the reader entered a read view or 0 if it
+	 * doesn't access any read view. Written by the reader, read by
+	 * the tx thread.
+	 */
+	uint64_t epoch;
+	/** Link in the list of registered readers. Used only in tx. */
+	struct rlist in_readers;
+};
+
+/**
+ * Initialize the read view subsystem and start the fiber that
+ * refreshes read views. Called in tx on memtx engine creation.
+ * Returns 0 on success, -1 on error (diag is set).
+ */
+int
+memtx_read_view_init(struct memtx_engine *memtx);
+
+/**
+ * Delete all read views. Called in tx on memtx engine shutdown,
+ * after all readers have been stopped.
+ */
+void
+memtx_read_view_free(void);
+
+/**
+ * Set the read view refresh interval, in seconds. Zero disables
+ * read views. Called in tx.
+ */
+void
+memtx_read_view_set_interval(double interval);
+
+/**
+ * Return the sequence number the next created read view will have.
+ * A request processed in tx is visible in all read views with the
+ * sequence number greater than or equal to the value returned after
+ * the request is complete. Called in tx.
+ */
+uint64_t
+memtx_read_view_next_seq(void);
+
+/** Register a read view reader. Called in tx. */
+void
+memtx_read_view_reader_register(struct memtx_read_view_reader *reader);
+
+/**
+ * Unregister a read view reader. Called in tx after the reader has
+ * stopped accessing read views.
+ */
+void
+memtx_read_view_reader_unregister(struct memtx_read_view_reader *reader);
+
+/**
+ * Execute a SELECT request against the most recent read view and
+ * invoke the callback for each selected tuple (see
+ * memtx_tree_index_view_select() for restrictions).
+ *
+ * The request is executed only if the read view was created after
+ * the schema was last changed, at or after the read view with the
+ * sequence number @a min_seq was created, and if the user with the
+ * given authentication token and id is allowed to read the space.
+ * The schema version of the request, if not zero, must match the
+ * schema version of the read view, otherwise the request is not
+ * executed so that it can be served by tx, which replies with the
+ * appropriate error.
+ *
+ * May be called from any thread by a registered reader. On success
+ * returns the number of selected tuples and sets @a schema_version to
+ * the schema version of the read view. Returns -1 if the request
+ * wasn't executed or failed, in which case it must be retried in tx
+ * (diag may be set).
+ */
+ssize_t
+memtx_read_view_select(struct memtx_read_view_reader *reader,
+		       uint8_t auth_token, uint32_t uid, uint64_t min_seq,
+		       const struct request *request,
+		       uint32_t *schema_version,
+		       memtx_tree_index_view_select_cb cb, void *arg);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -0,0 +1,251 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_snap_reader.h"
+
+#include <string.h>
+
+#include "iproto_constants.h"
+#include "schema_def.h"
+#include "trivia/util.h"
+
+static void
+memtx_snap_reader_fill(struct cmsg *base);
+
+static void
+memtx_snap_reader_deliver(struct cmsg *base);
+
+static const struct cmsg_hop memtx_snap_reader_fill_route[] = {
+	{memtx_snap_reader_fill, NULL},
+};
+
+static const struct cmsg_hop memtx_snap_reader_deliver_route[] = {
+	{memtx_snap_reader_deliver, NULL},
+};
+
+/**
+ * Read the next row from the snapshot and stash its body in
+ * the batch region. Returns 0 on success, 1 on EOF, -1 on error.
+ */
+static int
+memtx_snap_reader_read_row(struct memtx_snap_reader *reader,
+			   struct memtx_snap_batch *batch,
+			   struct memtx_snap_row *row)
+{
+	bool force_recovery = reader->force_recovery &&
+			      !reader->is_space_system;
+	int rc = xlog_cursor_next(&reader->cursor, &row->row, force_recovery);
+	if (rc != 0)
+		return rc;
+	/*
+	 * The row body points to the cursor read buffer, which is
+	 * reused for the next transaction, so copy it.
+	 */
+	assert(row->row.bodycnt == 1);
+	size_t size = row->row.body[0].iov_len;
+	void *body = region_alloc(&batch->region, size);
+	if (body == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "row body");
+		return -1;
+	}
+	memcpy(body, row->row.body[0].iov_base, size);
+	row->row.body[0].iov_base = body;
+	/*
+	 * Decode DML requests here to offload tx. If decoding fails,
+	 * let tx decode the row again and handle the error, because
+	 * it may be ignored in the force recovery mode.
+	 */
+	row->is_decoded = false;
+	if (row->row.type == IPROTO_INSERT) {
+		if (xrow_decode_dml(&row->row, &row->request,
+				    dml_request_key_map(row->row.type)) == 0) {
+			row->is_decoded = true;
+			reader->is_space_system =
+				row->request.space_id < BOX_SYSTEM_ID_MAX;
+		} else {
+			diag_clear(diag_get());
+		}
+	}
+	return 0;
+}
+
+/** Fill a batch with rows. Called in the reader cord. */
+static void
+memtx_snap_reader_fill(struct cmsg *base)
+{
+	struct memtx_snap_batch *batch = (struct memtx_snap_batch *)base;
+	struct memtx_snap_reader *reader = batch->reader;
+	if (!batch->region_is_created) {
+		region_create(&batch->region, cord_slab_cache());
+		batch->region_is_created = true;
+	} else {
+		region_free(&batch->region);
+	}
+	batch->row_count = 0;
+	batch->is_eof = false;
+	batch->has_eof_marker = false;
+	batch->is_failed = false;
+	/*
+	 * The reader is done, but tx had sent the batch before it
+	 * learned about it. Return the batch empty.
+	 */
+	if (reader->is_exhausted)
+		goto deliver;
+	if (!xlog_cursor_is_open(&reader->cursor) &&
+	    xlog_cursor_open(&reader->cursor, reader->filename) != 0)
+		goto fail;
+	while (batch->row_count < MEMTX_SNAP_READER_BATCH_ROWS &&
+	       region_used(&batch->region) < MEMTX_SNAP_READER_BATCH_SIZE) {
+		struct memtx_snap_row *row = &batch->rows[batch->row_count];
+		int rc = memtx_snap_reader_read_row(reader, batch, row);
+		if (rc < 0)
+			goto fail;
+		if (rc > 0) {
+			batch->is_eof = true;
+			batch->has_eof_marker =
+				xlog_cursor_is_eof(&reader->cursor);
+			reader->is_exhausted = true;
+			break;
+		}
+		batch->row_count++;
+	}
+	goto deliver;
+fail:
+	batch->is_failed = true;
+	diag_move(diag_get(), &batch->diag);
+	reader->is_exhausted = true;
+deliver:
+	cmsg_init(&batch->base, memtx_snap_reader_deliver_route);
+	cpipe_push(&reader->tx_pipe, &batch->base);
+}
+
+/** Deliver a filled batch to the recovery fiber. Called in tx. */
+static void
+memtx_snap_reader_deliver(struct cmsg *base)
+{
+	struct memtx_snap_batch *batch = (struct memtx_snap_batch *)base;
+	struct memtx_snap_reader *reader = batch->reader;
+	assert(reader->in_flight > 0);
+	reader->in_flight--;
+	stailq_add_tail_entry(&reader->ready, batch, in_ready);
+	fiber_cond_signal(&reader->ready_cond);
+}
+
+/** Reader cord function. */
+static int
+memtx_snap_reader_f(va_list ap)
+{
+	struct memtx_snap_reader *reader =
+		va_arg(ap, struct memtx_snap_reader *);
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, reader->name,
+			     fiber_schedule_cb, fiber());
+	cpipe_create(&reader->tx_pipe, "tx_prio");
+	cbus_loop(&endpoint);
+	if (xlog_cursor_is_open(&reader->cursor))
+		xlog_cursor_close(&reader->cursor, false);
+	for (int i = 0; i < MEMTX_SNAP_READER_BATCH_COUNT; i++) {
+		struct memtx_snap_batch *batch = &reader->batches[i];
+		if (batch->region_is_created)
+			region_destroy(&batch->region);
+	}
+	cpipe_destroy(&reader->tx_pipe);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
+/** Send a batch to the reader cord to be filled. */
+static void
+memtx_snap_reader_push(struct memtx_snap_reader *reader,
+		       struct memtx_snap_batch *batch)
+{
+	reader->in_flight++;
+	cmsg_init(&batch->base, memtx_snap_reader_fill_route);
+	cpipe_push(&reader->reader_pipe, &batch->base);
+}
+
+int
+memtx_snap_reader_start(struct memtx_snap_reader *reader, const char *name,
+			const char *filename, bool force_recovery)
+{
+	memset(reader, 0, sizeof(*reader));
+	strlcpy(reader->name, name, sizeof(reader->name));
+	strlcpy(reader->filename, filename, sizeof(reader->filename));
+	reader->force_recovery = force_recovery;
+	reader->is_space_system = true;
+	stailq_create(&reader->ready);
+	fiber_cond_create(&reader->ready_cond);
+	reader->batches = (struct memtx_snap_batch *)
+		calloc(MEMTX_SNAP_READER_BATCH_COUNT,
+		       sizeof(*reader->batches));
+	if (reader->batches == NULL) {
+		diag_set(OutOfMemory, MEMTX_SNAP_READER_BATCH_COUNT *
+			 sizeof(*reader->batches), "calloc", "batches");
+		goto fail;
+	}
+	if (cord_costart(&reader->cord, reader->name,
+			 memtx_snap_reader_f, reader) != 0)
+		goto fail_free;
+	cpipe_create(&reader->reader_pipe, reader->name);
+	for (int i = 0; i < MEMTX_SNAP_READER_BATCH_COUNT; i++) {
+		struct memtx_snap_batch *batch = &reader->batches[i];
+		batch->reader = reader;
+		diag_create(&batch->diag);
+		memtx_snap_reader_push(reader, batch);
+	}
+	return 0;
+fail_free:
+	free(reader->batches);
+fail:
+	fiber_cond_destroy(&reader->ready_cond);
+	return -1;
+}
+
+struct memtx_snap_batch *
+memtx_snap_reader_next(struct memtx_snap_reader *reader)
+{
+	assert(!reader->is_done);
+	while (stailq_empty(&reader->ready))
+		fiber_cond_wait(&reader->ready_cond);
+	struct memtx_snap_batch *batch =
+		stailq_shift_entry(&reader->ready, struct memtx_snap_batch,
+				   in_ready);
+	if (batch->is_eof || batch->is_failed)
+		reader->is_done = true;
+	return batch;
+}
+
+void
+memtx_snap_reader_release(struct memtx_snap_reader *reader,
+			  struct memtx_snap_batch *batch)
+{
+	/* Don't bother the reader if it has nothing more to read. */
+	if (!reader->is_done)
+		memtx_snap_reader_push(reader, batch);
+}
+
+void
+memtx_snap_reader_stop(struct memtx_snap_reader *reader)
+{
+	while (reader->in_flight > 0)
+		fiber_cond_wait(&reader->ready_cond);
+	cbus_stop_loop(&reader->reader_pipe);
+	cpipe_destroy(&reader->reader_pipe);
+	/*
+	 * cord_cojoin() clears the diagnostics area, but the caller
+	 * may need the error that made it stop the reader.
+	 */
+	struct diag diag;
+	diag_create(&diag);
+	diag_move(diag_get(), &diag);
+	if (cord_cojoin(&reader->cord) != 0)
+		diag_log();
+	diag_move(&diag, diag_get());
+	diag_destroy(&diag);
+	for (int i = 0; i < MEMTX_SNAP_READER_BATCH_COUNT; i++)
+		diag_destroy(&reader->batches[i].diag);
+	free(reader->batches);
+	fiber_cond_destroy(&reader->ready_cond);
+}
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cbus.h"
+#include "diag.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "salad/stailq.h"
+#include "small/region.h"
+#include "xlog.h"
+#include "xrow.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+	/** Number of batches travelling between the reader and tx. */
+	MEMTX_SNAP_READER_BATCH_COUNT = 4,
+	/** Max number of rows in a batch. */
+	MEMTX_SNAP_READER_BATCH_ROWS = 1024,
+	/** Max size of row bodies stored in a batch. */
+	MEMTX_SNAP_READER_BATCH_SIZE = 1024 * 1024,
+};
+
+/** A snapshot row read and decoded by the snapshot reader. */
+struct memtx_snap_row {
+	/** Row header. The row body is stored in the batch region. */
+	struct xrow_header row;
+	/** Decoded DML request, valid if is_decoded is set. */
+	struct request request;
+	/**
+	 * Set if the row is an INSERT that was successfully decoded
+	 * by the reader. Other rows are decoded by the tx thread.
+	 */
+	bool is_decoded;
+};
+
+struct memtx_snap_reader;
+
+/** A batch of snapshot rows sent from the reader cord to tx. */
+struct memtx_snap_batch {
+	/** Base message. */
+	struct cmsg base;
+	/** The reader this batch belongs to. */
+	struct memtx_snap_reader *reader;
+	/** Link in memtx_snap_reader::ready. */
+	struct stailq_entry in_ready;
+	/** Rows read from the snapshot. */
+	struct memtx_snap_row rows[MEMTX_SNAP_READER_BATCH_ROWS];
+	/** Number of rows in the batch. */
+	int row_count;
+	/**
+	 * Region storing row bodies. Owned by the reader cord, which
+	 * creates it on the first use and destroys it on exit.
+	 */
+	struct region region;
+	/** Set if the region was created. */
+	bool region_is_created;
+	/** Set if the end of the snapshot file has been reached. */
+	bool is_eof;
+	/** Set if the snapshot file has the EOF marker. */
+	bool has_eof_marker;
+	/** Set if the reader failed, the error is stored in diag. */
+	bool is_failed;
+	/** Reader error. */
+	struct diag diag;
+};
+
+/**
+ * Snapshot reader. Reads a snapshot file in a separate cord:
+ * performs file I/O, decompresses and checks xlog transactions,
+ * decodes row headers and DML requests, and passes the result to
+ * tx in batches, so that the tx thread only has to apply the rows.
+ * The number of batches in flight is limited, which bounds the
+ * amount of memory used by the reader.
+ */
+struct memtx_snap_reader {
+	/**
+	 * Name of the reader cord and its cbus endpoint. Must be
+	 * unique among the readers running at the same time.
+	 */
+	char name[FIBER_NAME_INLINE];
+	/** Snapshot file name. */
+	char filename[PATH_MAX];
+	/** Skip invalid rows of non-system spaces. */
+	bool force_recovery;
+	/** Reader cord. */
+	struct cord cord;
+	/** Pipe from tx to the reader cord. */
+	struct cpipe reader_pipe;
+	/** Pipe from the reader cord to tx. */
+	struct cpipe tx_pipe;
+	/** Batches. */
+	struct memtx_snap_batch *batches;
+	/** Batches delivered to tx, in the read order. */
+	struct stailq ready;
+	/** Signalled when a batch is delivered to tx. */
+	struct fiber_cond ready_cond;
+	/** Number of batches sent to the reader and not yet delivered. */
+	int in_flight;
+	/**
+	 * Set when tx has received the last batch. Accessed only by
+	 * the tx thread.
+	 */
+	bool is_done;
+	/**
+	 * Set when the reader has read the whole file or failed.
+	 * Accessed only by the reader cord.
+	 */
+	bool is_exhausted;
+	/** Snapshot cursor, used only by the reader cord. */
+	struct xlog_cursor cursor;
+	/**
+	 * Set if the last decoded INSERT row was for a system space
+	 * or no INSERT row has been decoded yet. Invalid data can't
+	 * be skipped in this case even if force_recovery is set.
+	 */
+	bool is_space_system;
+};
+
+/**
+ * Start reading the given snapshot file in a new cord with the
+ * given name. Returns 0 on success, -1 on error (diag is set).
+ */
+int
+memtx_snap_reader_start(struct memtx_snap_reader *reader, const char *name,
+			const char *filename, bool force_recovery);
+
+/**
+ * Wait for the next batch of rows. Never returns NULL: if the reader
+ * fails, the returned batch has is_failed set and the error stored in
+ * batch->diag, and it may still contain rows read before the failure.
+ * A batch with is_eof or is_failed set is the last one. The batch must
+ * be returned to the reader with memtx_snap_reader_release().
+ */
+struct memtx_snap_batch *
+memtx_snap_reader_next(struct memtx_snap_reader *reader);
+
+/**
+ * Return a processed batch to the reader so that it can be
+ * filled with new rows.
+ */
+void
+memtx_snap_reader_release(struct memtx_snap_reader *reader,
+			  struct memtx_snap_batch *batch);
+
+/** Wait for all batches in flight, stop the reader cord, free memory. */
+void
+memtx_snap_reader_stop(struct memtx_snap_reader *reader);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -46,6 +46,9 @@
 #include "memtx_tuple_compression.h"
 #include "schema.h"
 #include "result.h"
+#include "txn_limbo.h"
+#include "wal.h"
+#include <qsort_arg.h>
 
 /*
  * Yield every 1K tuples while building a new index or checking
@@ -326,6 +329,53 @@ rollback:
 	return -1;
 }
 
+/**
+ * A version of replace() used in the bulk insert mode, see
+ * memtx_space_begin_bulk_insert(). The new tuple isn't added to
+ * indexes: it's only remembered to be added to all of them at once
+ * by memtx_space_end_bulk_insert().
+ */
+int
+memtx_space_replace_bulk_insert(struct space *space, struct tuple *old_tuple,
+				struct tuple *new_tuple,
+				enum dup_replace_mode mode,
+				struct tuple **result)
+{
+	assert(old_tuple == NULL && new_tuple != NULL && mode == DUP_INSERT);
+	(void)old_tuple;
+	(void)mode;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (memtx_space->bulk_tuple_count == memtx_space->bulk_tuple_capacity) {
+		uint32_t capacity = MAX(memtx_space->bulk_tuple_capacity * 2,
+					1024);
+		size_t size = capacity * sizeof(*memtx_space->bulk_tuples);
+		struct tuple **tuples = realloc(memtx_space->bulk_tuples, size);
+		if (tuples == NULL) {
+			diag_set(OutOfMemory, size, "realloc", "bulk_tuples");
+			return -1;
+		}
+		memtx_space->bulk_tuples = tuples;
+		memtx_space->bulk_tuple_capacity = capacity;
+	}
+	memtx_space->bulk_tuples[memtx_space->bulk_tuple_count++] = new_tuple;
+	memtx_space_update_bsize(space, NULL, new_tuple);
+	tuple_ref(new_tuple);
+	*result = NULL;
+	return 0;
+}
+
+void
+memtx_space_rollback_bulk_insert(struct space *space, struct tuple *tuple)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	assert(memtx_space->replace == memtx_space_replace_bulk_insert);
+	assert(memtx_space->bulk_tuple_count > 0);
+	assert(memtx_space->bulk_tuples[
+			memtx_space->bulk_tuple_count - 1] == tuple);
+	(void)tuple;
+	memtx_space->bulk_tuple_count--;
+}
+
 static inline enum dup_replace_mode
 dup_replace_mode(uint16_t op)
 {
@@ -352,6 +402,8 @@ memtx_space_replace_tuple(struct space *space, struct txn_stmt *stmt,
 			return -1;
 		tuple_ref(new_tuple);
 		was_referenced = true;
+		if (new_tuple != orig_new_tuple)
+			memtx_space->has_compressed_tuples = true;
 	}
 	int rc = memtx_space->replace(space, old_tuple, new_tuple,
 				      mode, &result);
@@ -702,6 +754,188 @@ memtx_space_ephemeral_rowid_next(struct space *space, uint64_t *rowid)
 
 /* }}} DML */
 
+/* {{{ Bulk insert */
+
+/**
+ * Switch the space to the bulk insert mode unless other parties may
+ * need to see the inserted tuples in indexes before the batch ends:
+ * space triggers, foreign key checks, the space upgrade, or the MVCC
+ * engine, which tracks each statement individually. Without them
+ * memtx inserts never yield so no other fiber can access the space
+ * until memtx_space_end_bulk_insert().
+ */
+static bool
+memtx_space_begin_bulk_insert(struct space *space)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	assert(memtx_space->bulk_tuple_count == 0);
+	if (memtx_space->replace != memtx_space_replace_all_keys ||
+	    memtx_tx_manager_use_mvcc_engine ||
+	    !rlist_empty(&space->before_replace) ||
+	    !rlist_empty(&space->on_replace) ||
+	    space->has_foreign_keys || space->upgrade != NULL)
+		return false;
+	memtx_space->replace = memtx_space_replace_bulk_insert;
+	return true;
+}
+
+static int
+memtx_space_bulk_insert_cmp(const void *a, const void *b, void *arg)
+{
+	struct tuple *tuple_a = *(struct tuple **)a;
+	struct tuple *tuple_b = *(struct tuple **)b;
+	struct key_def *cmp_def = (struct key_def *)arg;
+	return tuple_compare(tuple_a, HINT_NONE, tuple_b, HINT_NONE, cmp_def);
+}
+
+/** Delete tuples added by memtx_space_bulk_insert_index() from an index. */
+static void
+memtx_space_bulk_insert_undo(struct index *index, struct tuple **tuples,
+			     uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		struct tuple *unused;
+		/* Rollback must not fail. */
+		if (index_replace(index, tuples[i], NULL, DUP_INSERT,
+				  &unused, &unused) != 0) {
+			panic("failed to rollback bulk insert");
+		}
+	}
+}
+
+/**
+ * Build an empty tree index bottom-up from tuples sorted in the index
+ * order. The unique constraint is checked by comparing adjacent tuples
+ * the same way the tree does it, see memtx_tree_index_new_tpl().
+ * On failure the index is left empty.
+ */
+static int
+memtx_space_bulk_build_index(struct space *space, struct index *index,
+			     struct tuple **tuples, uint32_t count)
+{
+	struct index_def *def = index->def;
+	if (def->opts.is_unique) {
+		struct key_def *unique_def = def->key_def->is_nullable ?
+					     def->cmp_def : def->key_def;
+		for (uint32_t i = 1; i < count; i++) {
+			if (tuple_compare(tuples[i - 1], HINT_NONE, tuples[i],
+					  HINT_NONE, unique_def) == 0) {
+				diag_set(ClientError, ER_TUPLE_FOUND, def->name,
+					 space_name(space),
+					 tuple_str(tuples[i - 1]),
+					 tuple_str(tuples[i]));
+				return -1;
+			}
+		}
+	}
+	/*
+	 * With the build array reserved in advance, index_build_next()
+	 * can't fail for a non-multikey tree. The tree sorts the build
+	 * array again, which takes linear time for presorted input.
+	 */
+	index_begin_build(index);
+	if (index_reserve(index, count) != 0)
+		return -1;
+	uint32_t build_count = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!tuple_key_is_excluded(tuples[i], def->key_def,
+					   MULTIKEY_NONE))
+			build_count++;
+		if (index_build_next(index, tuples[i]) != 0)
+			unreachable();
+	}
+	index_end_build(index);
+	/* A tree that failed to allocate blocks is left empty. */
+	if (index_size(index) != build_count) {
+		assert(index_size(index) == 0);
+		diag_set(OutOfMemory, build_count * sizeof(struct tuple *),
+			 "memtx_tree_index", "build");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Add tuples inserted in the bulk insert mode to an index. The tuples
+ * are sorted in the order of a tree index so that an empty tree can be
+ * built bottom-up, while consecutive insertions into a non-empty tree
+ * go to the same or adjacent blocks, which are likely to be cached.
+ * On failure the index is left unchanged.
+ */
+static int
+memtx_space_bulk_insert_index(struct space *space, struct index *index,
+			      struct tuple **tuples, uint32_t count)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	struct index_def *def = index->def;
+	if (def->type == TREE && !def->key_def->is_multikey &&
+	    !def->key_def->for_func_index) {
+		qsort_arg(tuples, count, sizeof(*tuples),
+			  memtx_space_bulk_insert_cmp, def->cmp_def);
+		if (index_size(index) == 0)
+			return memtx_space_bulk_build_index(space, index,
+							    tuples, count);
+	}
+	uint32_t i;
+	for (i = 0; i < count; i++) {
+		struct tuple *unused;
+		if (memtx_index_extent_reserve(memtx,
+				RESERVE_EXTENTS_BEFORE_REPLACE) != 0 ||
+		    index_replace(index, NULL, tuples[i], DUP_INSERT,
+				  &unused, &unused) != 0) {
+			memtx_space_bulk_insert_undo(index, tuples, i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Add the tuples inserted since memtx_space_begin_bulk_insert() to
+ * all indexes, one index at a time, and leave the bulk insert mode.
+ */
+static int
+memtx_space_end_bulk_insert(struct space *space)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (memtx_space->replace != memtx_space_replace_bulk_insert)
+		return 0;
+	uint32_t count = memtx_space->bulk_tuple_count;
+	if (count > 0) {
+		size_t size = count * sizeof(*memtx_space->bulk_tuples);
+		struct tuple **tuples = malloc(size);
+		if (tuples == NULL) {
+			diag_set(OutOfMemory, size, "malloc", "tuples");
+			return -1;
+		}
+		uint32_t i;
+		for (i = 0; i < space->index_count; i++) {
+			memcpy(tuples, memtx_space->bulk_tuples, size);
+			if (memtx_space_bulk_insert_index(space,
+							  space->index[i],
+							  tuples, count) != 0)
+				break;
+		}
+		free(tuples);
+		if (i < space->index_count) {
+			for (; i > 0; i--) {
+				memtx_space_bulk_insert_undo(
+					space->index[i - 1],
+					memtx_space->bulk_tuples, count);
+			}
+			return -1;
+		}
+	}
+	free(memtx_space->bulk_tuples);
+	memtx_space->bulk_tuples = NULL;
+	memtx_space->bulk_tuple_count = 0;
+	memtx_space->bulk_tuple_capacity = 0;
+	memtx_space->replace = memtx_space_replace_all_keys;
+	return 0;
+}
+
+/* }}} Bulk insert */
+
 /* {{{ DDL */
 
 static int
@@ -1049,6 +1283,7 @@ memtx_space_drop_primary_key(struct space *space)
 	 */
 	memtx_space->replace = memtx_space_replace_no_keys;
 	memtx_space->bsize = 0;
+	memtx_space->has_compressed_tuples = false;
 }
 
 static void
@@ -1202,6 +1437,353 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 	return 0;
 }
 
+/* {{{ Background index build */
+
+/**
+ * A change made to a space while its secondary index is being built
+ * by a worker cord, see memtx_space_build_index_in_background().
+ */
+struct memtx_bg_build_change {
+	/** Link in memtx_bg_build::changes. */
+	struct rlist in_changes;
+	/** Tuple removed by the change or NULL. Referenced. */
+	struct tuple *old_tuple;
+	/** Tuple inserted by the change or NULL. Referenced. */
+	struct tuple *new_tuple;
+	/** Mode used to apply the change to the new index. */
+	enum dup_replace_mode mode;
+};
+
+/** State of a secondary index build done by a worker cord. */
+struct memtx_bg_build {
+	/**
+	 * Number of references to the state: one is held by the build,
+	 * and one by each statement that changed the space during the
+	 * build until the statement is committed or rolled back.
+	 */
+	int refs;
+	/** Set while the build is in progress. */
+	bool is_active;
+	/** Index being built. */
+	struct index *index;
+	/** Format of the new space. */
+	struct tuple_format *format;
+	/** Iterator over the frozen primary key used by the worker. */
+	struct memtx_tree_index_frozen_iterator *pk_iterator;
+	/**
+	 * Changes made to the space after the primary key was frozen,
+	 * in chronological order. Tuples referenced by the changes
+	 * include all tuples deleted from the frozen primary key, so
+	 * they can't be freed while the worker is running.
+	 */
+	struct rlist changes;
+	/** Tuples with equal keys found by the worker in a unique index. */
+	struct tuple *dup_old, *dup_new;
+	/** Worker cord. */
+	struct cord cord;
+	/** Set if a change made to the space can't be logged. */
+	int rc;
+	/** Error that occurred while logging a change. */
+	struct diag diag;
+};
+
+static struct memtx_bg_build *
+memtx_bg_build_new(struct index *index, struct tuple_format *format)
+{
+	struct memtx_bg_build *build = calloc(1, sizeof(*build));
+	if (build == NULL) {
+		diag_set(OutOfMemory, sizeof(*build), "calloc",
+			 "struct memtx_bg_build");
+		return NULL;
+	}
+	build->refs = 1;
+	build->is_active = true;
+	build->index = index;
+	build->format = format;
+	rlist_create(&build->changes);
+	diag_create(&build->diag);
+	return build;
+}
+
+/** Forget all changes logged by the build so far. */
+static void
+memtx_bg_build_discard_changes(struct memtx_bg_build *build)
+{
+	struct memtx_bg_build_change *change, *tmp;
+	rlist_foreach_entry_safe(change, &build->changes, in_changes, tmp) {
+		if (change->old_tuple != NULL)
+			tuple_unref(change->old_tuple);
+		if (change->new_tuple != NULL)
+			tuple_unref(change->new_tuple);
+		free(change);
+	}
+	rlist_create(&build->changes);
+}
+
+static void
+memtx_bg_build_unref(struct memtx_bg_build *build)
+{
+	assert(build->refs > 0);
+	if (--build->refs > 0)
+		return;
+	memtx_bg_build_discard_changes(build);
+	diag_destroy(&build->diag);
+	free(build);
+}
+
+/** Log a change so that it's applied to the new index after the build. */
+static int
+memtx_bg_build_log(struct memtx_bg_build *build, struct tuple *old_tuple,
+		   struct tuple *new_tuple, enum dup_replace_mode mode)
+{
+	struct memtx_bg_build_change *change = malloc(sizeof(*change));
+	if (change == NULL) {
+		diag_set(OutOfMemory, sizeof(*change), "malloc",
+			 "struct memtx_bg_build_change");
+		return -1;
+	}
+	change->old_tuple = old_tuple;
+	change->new_tuple = new_tuple;
+	change->mode = mode;
+	if (old_tuple != NULL)
+		tuple_ref(old_tuple);
+	if (new_tuple != NULL)
+		tuple_ref(new_tuple);
+	rlist_add_tail_entry(&build->changes, change, in_changes);
+	return 0;
+}
+
+/**
+ * Statement triggers set by memtx_bg_build_on_replace() to release
+ * the build state and log the reverse change on rollback.
+ */
+struct memtx_bg_build_stmt_triggers {
+	struct trigger on_commit;
+	struct trigger on_rollback;
+	struct memtx_bg_build *build;
+	struct txn_stmt *stmt;
+};
+
+static int
+memtx_bg_build_on_stmt_commit(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct memtx_bg_build_stmt_triggers *triggers = trigger->data;
+	memtx_bg_build_unref(triggers->build);
+	return 0;
+}
+
+static int
+memtx_bg_build_on_stmt_rollback(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct memtx_bg_build_stmt_triggers *triggers = trigger->data;
+	struct memtx_bg_build *build = triggers->build;
+	struct txn_stmt *stmt = triggers->stmt;
+	/*
+	 * Use DUP_REPLACE_OR_INSERT mode because if we tried to replace a tuple
+	 * with a duplicate at a unique index, this trigger would not be called.
+	 */
+	if (build->is_active && build->rc == 0 &&
+	    memtx_bg_build_log(build, stmt->new_tuple, stmt->old_tuple,
+			       DUP_REPLACE_OR_INSERT) != 0) {
+		build->rc = -1;
+		diag_move(diag_get(), &build->diag);
+	}
+	memtx_bg_build_unref(build);
+	return 0;
+}
+
+static int
+memtx_bg_build_on_replace(struct trigger *trigger, void *event)
+{
+	struct txn *txn = event;
+	struct memtx_bg_build *build = trigger->data;
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	struct memtx_bg_build_stmt_triggers *triggers = NULL;
+	enum dup_replace_mode mode =
+		build->index->def->opts.is_unique ? DUP_INSERT :
+						    DUP_REPLACE_OR_INSERT;
+	if (build->rc != 0)
+		return 0;
+	if (stmt->new_tuple != NULL &&
+	    memtx_tuple_validate(build->format, stmt->new_tuple) != 0)
+		goto fail;
+
+	struct errinj *inj = errinj(ERRINJ_BUILD_INDEX_ON_ROLLBACK_ALLOC,
+				    ERRINJ_BOOL);
+	if (inj == NULL || inj->bparam == false) {
+		triggers = region_aligned_alloc(
+			&txn->region, sizeof(*triggers),
+			alignof(struct memtx_bg_build_stmt_triggers));
+	}
+	if (triggers == NULL) {
+		diag_set(OutOfMemory, sizeof(*triggers),
+			 "region_aligned_alloc",
+			 "struct memtx_bg_build_stmt_triggers");
+		goto fail;
+	}
+	if (memtx_bg_build_log(build, stmt->old_tuple, stmt->new_tuple,
+			       mode) != 0)
+		goto fail;
+	triggers->build = build;
+	triggers->stmt = stmt;
+	build->refs++;
+	trigger_create(&triggers->on_commit, memtx_bg_build_on_stmt_commit,
+		       triggers, NULL);
+	trigger_create(&triggers->on_rollback, memtx_bg_build_on_stmt_rollback,
+		       triggers, NULL);
+	txn_stmt_on_commit(stmt, &triggers->on_commit);
+	txn_stmt_on_rollback(stmt, &triggers->on_rollback);
+	return 0;
+fail:
+	build->rc = -1;
+	diag_move(diag_get(), &build->diag);
+	return 0;
+}
+
+/**
+ * Fills the new index with the tuples of the frozen primary key and
+ * sorts them. Runs in a worker cord.
+ */
+static int
+memtx_bg_build_f(va_list ap)
+{
+	struct memtx_bg_build *build = va_arg(ap, struct memtx_bg_build *);
+	struct index *index = build->index;
+	struct key_def *key_def = index->def->key_def;
+	/* Hold the build to test DML on the space meanwhile. */
+	ERROR_INJECT_SLEEP(ERRINJ_BUILD_INDEX_DELAY);
+	struct tuple *tuple;
+	while ((tuple = memtx_tree_index_frozen_iterator_next(
+					build->pk_iterator)) != NULL) {
+		if (!tuple_format_is_compatible_with_key_def(tuple_format(tuple),
+							     key_def))
+			return -1;
+		/*
+		 * Not memtx_tuple_validate(), because it references the
+		 * tuple, which may only be done in the tx thread.
+		 */
+		if (tuple_validate_raw(build->format, tuple_data(tuple)) != 0)
+			return -1;
+		if (index_build_next(index, tuple) != 0)
+			return -1;
+	}
+	memtx_tree_index_sort_build_array(index);
+	if (index->def->opts.is_unique) {
+		memtx_tree_index_find_build_array_dup(index, &build->dup_old,
+						      &build->dup_new);
+	}
+	return 0;
+}
+
+/**
+ * Return true if the new index can be built by a worker cord with
+ * memtx_space_build_index_in_background().
+ */
+static bool
+memtx_space_can_build_index_in_background(struct space *space,
+					  struct index *pk,
+					  struct index *new_index)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	/*
+	 * With MVCC, the primary key may store tuples that aren't
+	 * visible yet. Transactions submitted to the limbo before
+	 * the build started could be rolled back without notifying
+	 * the build.
+	 */
+	return memtx->index_build_threads > 0 && memtx->state == MEMTX_OK &&
+	       !memtx_tx_manager_use_mvcc_engine &&
+	       new_index->def->iid != 0 && pk->def->type == TREE &&
+	       memtx_tree_index_supports_parallel_build(new_index) &&
+	       !memtx_space->has_compressed_tuples &&
+	       txn_limbo_is_empty(&txn_limbo);
+}
+
+/**
+ * Build a secondary index in a worker cord from a frozen primary key,
+ * then apply the changes made to the space in the meantime. The tx
+ * thread is only busy with building the tree from the sorted keys
+ * and replaying the changes.
+ */
+static int
+memtx_space_build_index_in_background(struct space *src_space,
+				      struct index *pk,
+				      struct index *new_index,
+				      struct tuple_format *new_format)
+{
+	struct memtx_bg_build *build = memtx_bg_build_new(new_index,
+							  new_format);
+	if (build == NULL)
+		return -1;
+	int rc = -1;
+	struct trigger on_replace;
+	trigger_create(&on_replace, memtx_bg_build_on_replace, build, NULL);
+	trigger_add(&src_space->on_replace, &on_replace);
+	/*
+	 * Wait for transactions that changed the space before the
+	 * trigger was set to be committed or rolled back. Changes
+	 * made after that are already in the primary key, so they
+	 * may be forgotten when it's frozen.
+	 */
+	if (wal_sync(NULL) != 0)
+		goto out;
+	if (build->rc != 0) {
+		diag_move(&build->diag, diag_get());
+		goto out;
+	}
+	memtx_bg_build_discard_changes(build);
+	build->pk_iterator = memtx_tree_index_frozen_iterator_new(pk);
+	if (build->pk_iterator == NULL)
+		goto out;
+
+	index_begin_build(new_index);
+	if (index_reserve(new_index, index_size(pk)) != 0)
+		goto out;
+	if (cord_costart(&build->cord, "index_build", memtx_bg_build_f,
+			 build) != 0)
+		goto out;
+	if (cord_cojoin(&build->cord) != 0)
+		goto out;
+	if (build->dup_old != NULL) {
+		diag_set(ClientError, ER_TUPLE_FOUND, new_index->def->name,
+			 space_name(src_space), tuple_str(build->dup_old),
+			 tuple_str(build->dup_new));
+		goto out;
+	}
+	if (build->rc != 0) {
+		diag_move(&build->diag, diag_get());
+		goto out;
+	}
+	/*
+	 * Apply the changes logged during the build. Must not yield
+	 * until the index is built, otherwise we'd miss changes.
+	 */
+	index_end_build(new_index);
+	struct memtx_bg_build_change *change;
+	rlist_foreach_entry(change, &build->changes, in_changes) {
+		struct tuple *unused;
+		struct tuple *successor;
+		if (index_replace(new_index, change->old_tuple,
+				  change->new_tuple, change->mode,
+				  &unused, &successor) != 0)
+			goto out;
+	}
+	rc = 0;
+out:
+	build->is_active = false;
+	trigger_clear(&on_replace);
+	if (build->pk_iterator != NULL)
+		memtx_tree_index_frozen_iterator_delete(build->pk_iterator);
+	memtx_bg_build_discard_changes(build);
+	memtx_bg_build_unref(build);
+	return rc;
+}
+
+/* }}} Background index build */
+
 static int
 memtx_space_build_index(struct space *src_space, struct index *new_index,
 			struct tuple_format *new_format,
@@ -1233,6 +1815,15 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		return -1;
 	}
 
+	if (memtx_space_can_build_index_in_background(src_space, pk,
+						      new_index)) {
+		if (txn_check_singlestatement(txn, "index build") != 0)
+			return -1;
+		return memtx_space_build_index_in_background(src_space, pk,
+							     new_index,
+							     new_format);
+	}
+
 	/* Now deal with any kind of add index during normal operation. */
 	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
 	if (it == NULL)
@@ -1365,6 +1956,8 @@ memtx_space_prepare_alter(struct space *old_space, struct space *new_space)
 
 	new_memtx_space->replace = old_memtx_space->replace;
 	new_memtx_space->bsize = old_memtx_space->bsize;
+	new_memtx_space->has_compressed_tuples =
+		old_memtx_space->has_compressed_tuples;
 	return 0;
 }
 
@@ -1391,6 +1984,8 @@ static const struct space_vtab memtx_space_vtab = {
 	/* .swap_index = */ generic_space_swap_index,
 	/* .prepare_alter = */ memtx_space_prepare_alter,
 	/* .invalidate = */ generic_space_invalidate,
+	/* .begin_bulk_insert = */ memtx_space_begin_bulk_insert,
+	/* .end_bulk_insert = */ memtx_space_end_bulk_insert,
 };
 
 struct space *
@@ -1432,6 +2027,10 @@ memtx_space_new(struct memtx_engine *memtx,
 
 	memtx_space->bsize = 0;
 	memtx_space->rowid = 0;
+	memtx_space->has_compressed_tuples = false;
+	memtx_space->bulk_tuples = NULL;
+	memtx_space->bulk_tuple_count = 0;
+	memtx_space->bulk_tuple_capacity = 0;
 	memtx_space->replace = memtx_space_replace_no_keys;
 	return (struct space *)memtx_space;
 }
@@ -56,6 +56,23 @@ struct memtx_space {
 	 */
 	int (*replace)(struct space *, struct tuple *, struct tuple *,
 		       enum dup_replace_mode, struct tuple **);
+	/**
+	 * Set if the space may store tuples with compressed fields.
+	 * Unlike tuple_format::is_compressed, it stays set after the
+	 * compression is disabled by alter, because old tuples are
+	 * not rebuilt.
+	 */
+	bool has_compressed_tuples;
+	/**
+	 * Tuples inserted into the space in the bulk insert mode that
+	 * haven't been added to indexes yet, in insertion order. See
+	 * memtx_space_replace_bulk_insert().
+	 */
+	struct tuple **bulk_tuples;
+	/** Number of tuples in bulk_tuples. */
+	uint32_t bulk_tuple_count;
+	/** Number of tuples bulk_tuples has room for. */
+	uint32_t bulk_tuple_capacity;
 };
 
 /**
@@ -83,6 +100,16 @@ memtx_space_replace_primary_key(struct space *, struct tuple *, struct tuple *,
 int
 memtx_space_replace_all_keys(struct space *, struct tuple *, struct tuple *,
 			     enum dup_replace_mode, struct tuple **);
+int
+memtx_space_replace_bulk_insert(struct space *, struct tuple *, struct tuple *,
+				enum dup_replace_mode, struct tuple **);
+
+/**
+ * Forget a tuple inserted in the bulk insert mode. Called on
+ * statement rollback. The tuple must be the last inserted one.
+ */
+void
+memtx_space_rollback_bulk_insert(struct space *space, struct tuple *tuple);
 
 struct space *
 memtx_space_new(struct memtx_engine *memtx,
@@ -108,6 +108,20 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 	return a->tuple == b->tuple;
 }
 
+/**
+ * Return the hint of a searched key or tuple if it may be used to
+ * order tuples by comparing hints (see tuple_hint()), HINT_NONE
+ * otherwise. Multikey and functional indexes store the multikey
+ * index and the functional key in the hint, respectively.
+ */
+static inline hint_t
+memtx_tree_order_hint(hint_t hint, struct key_def *cmp_def)
+{
+	if (cmp_def->is_multikey || cmp_def->for_func_index)
+		return HINT_NONE;
+	return hint;
+}
+
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
 #define BPS_TREE_EXTENT_SIZE MEMTX_EXTENT_SIZE
@@ -118,6 +132,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 			       (b)->part_count, (b)->hint, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
 #define BPS_TREE_NO_DEBUG 1
+#define BPS_INNER_CARD
 #define bps_tree_arg_t struct key_def *
 
 #define BPS_TREE_NAMESPACE NS_NO_HINT
@@ -133,12 +148,19 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #define BPS_TREE_NAMESPACE NS_USE_HINT
 #define bps_tree_elem_t struct memtx_tree_data<true>
 #define bps_tree_key_t struct memtx_tree_key_data<true> *
+#define BPS_TREE_ELEM_HINT(elem) ((elem).hint)
+#define BPS_TREE_KEY_HINT(key, arg) memtx_tree_order_hint((key)->hint, arg)
+#define BPS_TREE_SEARCH_ELEM_HINT(elem, arg)\
+	memtx_tree_order_hint((elem).hint, arg)
 
 #include "salad/bps_tree.h"
 
 #undef BPS_TREE_NAMESPACE
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
+#undef BPS_TREE_ELEM_HINT
+#undef BPS_TREE_KEY_HINT
+#undef BPS_TREE_SEARCH_ELEM_HINT
 
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
@@ -147,6 +169,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef BPS_TREE_COMPARE_KEY
 #undef BPS_TREE_IS_IDENTICAL
 #undef BPS_TREE_NO_DEBUG
+#undef BPS_INNER_CARD
 #undef bps_tree_arg_t
 
 using namespace NS_NO_HINT;
@@ -198,6 +221,12 @@ struct memtx_tree_index {
 	memtx_tree_t<USE_HINT> tree;
 	struct memtx_tree_data<USE_HINT> *build_array;
 	size_t build_array_size, build_array_alloc_size;
+	/**
+	 * Set if build_array has already been sorted and deduplicated
+	 * by memtx_tree_index_sort_build_array() so end_build may
+	 * proceed directly to building the tree.
+	 */
+	bool build_array_is_sorted;
 	struct memtx_gc_task gc_task;
 	memtx_tree_iterator_t<USE_HINT> gc_iterator;
 };
@@ -251,6 +280,11 @@ struct tree_iterator {
 	 */
 	memtx_tree_iterator_t<USE_HINT> tree_iterator;
 	enum iterator_type type;
+	/**
+	 * Number of tuples to skip on the first iteration step,
+	 * see memtx_tree_index_create_iterator_with_offset().
+	 */
+	uint32_t offset;
 	struct memtx_tree_key_data<USE_HINT> key_data;
 	struct memtx_tree_data<USE_HINT> current;
 	/**
@@ -606,6 +640,77 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	it->base.next = memtx_iterator_next;
 }
 
+/**
+ * Find the offsets of the first tuple matching the given iterator type
+ * and key and of the tuple following the last matching one, i.e. the
+ * matching tuples occupy positions [*begin, *end) in the tree. Uses
+ * subtree cardinalities stored in the tree so it takes logarithmic
+ * time. The key must not be empty. The tree may be either an index
+ * tree or a tree read view.
+ */
+template <bool USE_HINT, class TREE>
+static void
+memtx_tree_find_range(TREE *tree, enum iterator_type type,
+		      struct memtx_tree_key_data<USE_HINT> *key_data,
+		      size_t *begin, size_t *end)
+{
+	size_t lb = 0, ub = 0;
+	if (type != ITER_GT && type != ITER_LE)
+		memtx_tree_lower_bound_get_offset(tree, key_data, NULL, &lb);
+	if (type == ITER_EQ || type == ITER_REQ ||
+	    type == ITER_GT || type == ITER_LE)
+		memtx_tree_upper_bound_get_offset(tree, key_data, NULL, &ub);
+	*begin = 0;
+	*end = memtx_tree_size(tree);
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+		*begin = lb;
+		*end = ub;
+		break;
+	case ITER_ALL:
+	case ITER_GE:
+		*begin = lb;
+		break;
+	case ITER_GT:
+		*begin = ub;
+		break;
+	case ITER_LT:
+		*end = lb;
+		break;
+	case ITER_LE:
+		*end = ub;
+		break;
+	default:
+		unreachable();
+	}
+}
+
+/**
+ * Position the iterator at the tuple that goes the given number of
+ * tuples after the start of the iteration and return the tree element
+ * or NULL if there is no such tuple. Must only be used if all tree
+ * elements are visible, i.e. when MVCC is disabled.
+ */
+template <bool USE_HINT>
+static struct memtx_tree_data<USE_HINT> *
+tree_iterator_start_with_offset(struct tree_iterator<USE_HINT> *it,
+				memtx_tree_t<USE_HINT> *tree)
+{
+	assert(!memtx_tx_manager_use_mvcc_engine);
+	size_t begin = 0;
+	size_t end = memtx_tree_size(tree);
+	if (it->key_data.key != NULL)
+		memtx_tree_find_range<USE_HINT>(tree, it->type, &it->key_data,
+						&begin, &end);
+	if (end - begin <= it->offset)
+		return NULL;
+	size_t pos = iterator_type_is_reverse(it->type) ?
+		     end - 1 - it->offset : begin + it->offset;
+	it->tree_iterator = memtx_tree_iterator_at(tree, pos);
+	return memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
+}
+
 template <bool USE_HINT>
 static int
 tree_iterator_start_raw(struct iterator *iterator, struct tuple **ret)
@@ -630,6 +735,21 @@ tree_iterator_start_raw(struct iterator *iterator, struct tuple **ret)
 	/* The flag will be change to true if found tuple equals to the key. */
 	bool equals = false;
 	assert(it->current.tuple == NULL);
+	if (it->offset != 0) {
+		/*
+		 * Without MVCC there is nothing to track and all tuples
+		 * are visible so we can jump straight to the tuple.
+		 */
+		struct memtx_tree_data<USE_HINT> *res =
+			tree_iterator_start_with_offset(it, tree);
+		it->offset = 0;
+		if (res == NULL)
+			return 0;
+		tree_iterator_set_current(it, res);
+		tree_iterator_set_next_method(it);
+		*ret = res->tuple;
+		return 0;
+	}
 	if (it->key_data.key == NULL) {
 		assert(type == ITER_GE || type == ITER_LE);
 		if (iterator_type_is_reverse(it->type))
@@ -870,7 +990,28 @@ memtx_tree_index_count(struct index *base, enum iterator_type type,
 {
 	if (type == ITER_ALL)
 		return memtx_tree_index_size<USE_HINT>(base); /* optimization */
-	return generic_index_count(base, type, key, part_count);
+	/*
+	 * With MVCC some tuples may be invisible to the current
+	 * transaction and reads must be tracked, so fall back to
+	 * iteration. Otherwise count the tuples in logarithmic
+	 * time using subtree cardinalities stored in the tree.
+	 */
+	if (memtx_tx_manager_use_mvcc_engine || type > ITER_GT)
+		return generic_index_count(base, type, key, part_count);
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (part_count == 0)
+		return memtx_tree_size(&index->tree);
+	struct memtx_tree_key_data<USE_HINT> key_data;
+	key_data.key = key;
+	key_data.part_count = part_count;
+	if (USE_HINT)
+		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	size_t begin, end;
+	memtx_tree_find_range<USE_HINT>(&index->tree, type, &key_data,
+					&begin, &end);
+	return end - begin;
 }
 
 template <bool USE_HINT>
@@ -1413,6 +1554,7 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	it->base.next = memtx_iterator_next;
 	it->base.free = tree_iterator_free<USE_HINT>;
 	it->type = type;
+	it->offset = 0;
 	it->key_data.key = key;
 	it->key_data.part_count = part_count;
 	if (USE_HINT)
@@ -1425,6 +1567,30 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	return (struct iterator *)it;
 }
 
+template <bool USE_HINT>
+static struct iterator *
+memtx_tree_index_create_iterator_with_offset(struct index *base,
+					     enum iterator_type type,
+					     const char *key,
+					     uint32_t part_count,
+					     uint32_t offset)
+{
+	/*
+	 * With MVCC we can't skip tuples without checking their
+	 * visibility so we have to iterate.
+	 */
+	if (memtx_tx_manager_use_mvcc_engine)
+		return generic_index_create_iterator_with_offset(
+			base, type, key, part_count, offset);
+	struct iterator *it = memtx_tree_index_create_iterator<USE_HINT>(
+		base, type, key, part_count);
+	if (it == NULL)
+		return NULL;
+	/* The offset is applied on the first iteration step. */
+	get_tree_iterator<USE_HINT>(it)->offset = offset;
+	return it;
+}
+
 template <bool USE_HINT>
 static void
 memtx_tree_index_begin_build(struct index *base)
@@ -1603,12 +1769,14 @@ memtx_tree_index_build_array_deduplicate(
 	index->build_array_size = w_idx + 1;
 }
 
+/**
+ * Sort build_array of specified index and remove duplicates from it
+ * so that it can be passed to memtx_tree_build().
+ */
 template <bool USE_HINT>
 static void
-memtx_tree_index_end_build(struct index *base)
+memtx_tree_index_prepare_build_array(struct memtx_tree_index<USE_HINT> *index)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	qsort_arg(index->build_array, index->build_array_size,
 		  sizeof(index->build_array[0]),
@@ -1623,6 +1791,17 @@ memtx_tree_index_end_build(struct index *base)
 		 */
 		memtx_tree_index_build_array_deduplicate<USE_HINT>(index);
 	}
+	index->build_array_is_sorted = true;
+}
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_end_build(struct index *base)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	if (!index->build_array_is_sorted)
+		memtx_tree_index_prepare_build_array<USE_HINT>(index);
 	memtx_tree_build(&index->tree, index->build_array,
 			 index->build_array_size);
 
@@ -1630,6 +1809,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	index->build_array_is_sorted = false;
 }
 
 template <bool USE_HINT>
@@ -1745,6 +1925,8 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .get = */ generic_index_get,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		generic_index_create_snapshot_iterator,
 	/* .stat = */ generic_index_stat,
@@ -1809,6 +1991,8 @@ get_memtx_tree_index_vtab(void)
 				 memtx_tree_index_replace<USE_HINT>,
 		/* .create_iterator = */
 			memtx_tree_index_create_iterator<USE_HINT>,
+		/* .create_iterator_with_offset = */
+			memtx_tree_index_create_iterator_with_offset<USE_HINT>,
 		/* .create_snapshot_iterator = */
 			memtx_tree_index_create_snapshot_iterator<USE_HINT>,
 		/* .stat = */ generic_index_stat,
@@ -1853,6 +2037,372 @@ memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 	return &index->base;
 }
 
+/**
+ * Return true if the index created by memtx_tree_index_new() for
+ * the given definition uses hints.
+ */
+static bool
+memtx_tree_index_def_uses_hint(const struct index_def *def)
+{
+	return def->key_def->for_func_index || def->key_def->is_multikey ||
+	       def->opts.hint;
+}
+
+bool
+memtx_tree_index_supports_parallel_build(struct index *index)
+{
+	/*
+	 * Functional index keys are produced by a Lua or SQL function,
+	 * which can only be called from the tx thread.
+	 */
+	return index->def->type == TREE &&
+	       !index->def->key_def->for_func_index;
+}
+
+void
+memtx_tree_index_sort_build_array(struct index *base)
+{
+	assert(memtx_tree_index_supports_parallel_build(base));
+	if (memtx_tree_index_def_uses_hint(base->def)) {
+		memtx_tree_index_prepare_build_array<true>(
+			(struct memtx_tree_index<true> *)base);
+	} else {
+		memtx_tree_index_prepare_build_array<false>(
+			(struct memtx_tree_index<false> *)base);
+	}
+}
+
+template <bool USE_HINT>
+static bool
+memtx_tree_index_find_build_array_dup_tpl(
+	struct memtx_tree_index<USE_HINT> *index, struct tuple **dup,
+	struct tuple **tuple)
+{
+	assert(index->build_array_is_sorted);
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	for (size_t i = 1; i < index->build_array_size; i++) {
+		struct memtx_tree_data<USE_HINT> *prev =
+			&index->build_array[i - 1];
+		struct memtx_tree_data<USE_HINT> *curr = &index->build_array[i];
+		if (tuple_compare(prev->tuple, prev->hint, curr->tuple,
+				  curr->hint, cmp_def) == 0) {
+			*dup = prev->tuple;
+			*tuple = curr->tuple;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool
+memtx_tree_index_find_build_array_dup(struct index *base, struct tuple **dup,
+				      struct tuple **tuple)
+{
+	assert(memtx_tree_index_supports_parallel_build(base));
+	if (memtx_tree_index_def_uses_hint(base->def)) {
+		return memtx_tree_index_find_build_array_dup_tpl<true>(
+			(struct memtx_tree_index<true> *)base, dup, tuple);
+	} else {
+		return memtx_tree_index_find_build_array_dup_tpl<false>(
+			(struct memtx_tree_index<false> *)base, dup, tuple);
+	}
+}
+
+/* {{{ Read views *************************************************/
+
+template <bool USE_HINT>
+struct memtx_tree_view_selector;
+
+template <>
+struct memtx_tree_view_selector<false> {
+	using type = NS_NO_HINT::memtx_tree_view;
+};
+
+template <>
+struct memtx_tree_view_selector<true> {
+	using type = NS_USE_HINT::memtx_tree_view;
+};
+
+template <bool USE_HINT>
+using memtx_tree_view_t = typename memtx_tree_view_selector<USE_HINT>::type;
+
+struct memtx_tree_index_view {
+	/** Select tuples from the view, see memtx_tree_index_view_select(). */
+	ssize_t
+	(*select)(struct memtx_tree_index_view *view, enum iterator_type type,
+		  const char *key, uint32_t part_count, uint32_t offset,
+		  uint32_t limit, memtx_tree_index_view_select_cb cb,
+		  void *arg);
+	/** Destroy the view, see memtx_tree_index_view_delete(). */
+	void
+	(*free)(struct memtx_tree_index_view *view);
+	/** Index the view was created for. Referenced by the view. */
+	struct index *index;
+	/**
+	 * Copy of the tree comparison definition with comparators that
+	 * don't access tuple formats (see tuple_compare.h), because the
+	 * format identifier of a tuple deleted from the index may be
+	 * overwritten by the allocator. Owned by the view so that it may
+	 * be accessed outside the tx thread.
+	 */
+	struct key_def *cmp_def;
+	/** Number of parts in the index key definition. */
+	uint32_t key_part_count;
+};
+
+template <bool USE_HINT>
+struct memtx_tree_index_view_impl {
+	struct memtx_tree_index_view base;
+	/** Frozen index tree using base.cmp_def for comparisons. */
+	memtx_tree_view_t<USE_HINT> view;
+};
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_view_free(struct memtx_tree_index_view *base)
+{
+	struct memtx_tree_index_view_impl<USE_HINT> *view =
+		(struct memtx_tree_index_view_impl<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base->index;
+	memtx_tree_view_destroy(&view->view, &index->tree);
+	key_def_delete(base->cmp_def);
+	index_unref(base->index);
+	free(view);
+}
+
+template <bool USE_HINT>
+static ssize_t
+memtx_tree_index_view_select_tpl(struct memtx_tree_index_view *base,
+				 enum iterator_type type, const char *key,
+				 uint32_t part_count, uint32_t offset,
+				 uint32_t limit,
+				 memtx_tree_index_view_select_cb cb, void *arg)
+{
+	struct memtx_tree_index_view_impl<USE_HINT> *view =
+		(struct memtx_tree_index_view_impl<USE_HINT> *)base;
+	auto *tree = &view->view.tree;
+	assert(type <= ITER_GT);
+	if (part_count > base->key_part_count) {
+		diag_set(ClientError, ER_KEY_PART_COUNT, base->key_part_count,
+			 part_count);
+		return -1;
+	}
+	const char *key_end;
+	if (key_validate_parts(base->cmp_def, key, part_count, true,
+			       &key_end) != 0)
+		return -1;
+	size_t begin = 0;
+	size_t end = memtx_tree_size(tree);
+	if (part_count > 0) {
+		struct memtx_tree_key_data<USE_HINT> key_data;
+		key_data.key = key;
+		key_data.part_count = part_count;
+		if (USE_HINT)
+			key_data.set_hint(key_hint(key, part_count,
+						   base->cmp_def));
+		memtx_tree_find_range<USE_HINT>(tree, type, &key_data,
+						&begin, &end);
+	}
+	if (end - begin <= offset)
+		return 0;
+	size_t count = MIN(end - begin - offset, (size_t)limit);
+	bool is_reverse = iterator_type_is_reverse(type);
+	size_t pos = is_reverse ? end - 1 - offset : begin + offset;
+	memtx_tree_iterator_t<USE_HINT> itr = memtx_tree_iterator_at(tree, pos);
+	for (size_t i = 0; i < count; i++) {
+		struct memtx_tree_data<USE_HINT> *res =
+			memtx_tree_iterator_get_elem(tree, &itr);
+		assert(res != NULL);
+		if (cb(res->tuple, arg) != 0)
+			return -1;
+		if (is_reverse)
+			memtx_tree_iterator_prev(tree, &itr);
+		else
+			memtx_tree_iterator_next(tree, &itr);
+	}
+	return count;
+}
+
+template <bool USE_HINT>
+static struct memtx_tree_index_view *
+memtx_tree_index_view_new_tpl(struct index *base)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index_view_impl<USE_HINT> *view =
+		(struct memtx_tree_index_view_impl<USE_HINT> *)
+		malloc(sizeof(*view));
+	if (view == NULL) {
+		diag_set(OutOfMemory, sizeof(*view), "malloc",
+			 "struct memtx_tree_index_view");
+		return NULL;
+	}
+	struct key_def *cmp_def = key_def_dup(memtx_tree_cmp_def(&index->tree));
+	if (cmp_def == NULL) {
+		free(view);
+		return NULL;
+	}
+	key_def_set_sequential_compare_func(cmp_def);
+	view->base.select = memtx_tree_index_view_select_tpl<USE_HINT>;
+	view->base.free = memtx_tree_index_view_free<USE_HINT>;
+	view->base.index = base;
+	view->base.cmp_def = cmp_def;
+	view->base.key_part_count = base->def->key_def->part_count;
+	index_ref(base);
+	memtx_tree_view_create(&view->view, &index->tree);
+	view->view.tree.arg = cmp_def;
+	return &view->base;
+}
+
+bool
+memtx_tree_index_supports_view(struct index *index)
+{
+	struct key_def *key_def = index->def->key_def;
+	if (index->def->type != TREE || key_def->for_func_index ||
+	    key_def->is_multikey || key_def_has_collation(key_def))
+		return false;
+	/*
+	 * Check the definition actually used by the tree for
+	 * comparisons, see memtx_tree_index_new_tpl().
+	 */
+	if (memtx_tree_index_def_uses_hint(index->def)) {
+		struct memtx_tree_index<true> *tree_index =
+			(struct memtx_tree_index<true> *)index;
+		return key_def_is_sequential(
+			memtx_tree_cmp_def(&tree_index->tree));
+	}
+	struct memtx_tree_index<false> *tree_index =
+		(struct memtx_tree_index<false> *)index;
+	return key_def_is_sequential(memtx_tree_cmp_def(&tree_index->tree));
+}
+
+struct memtx_tree_index_view *
+memtx_tree_index_view_new(struct index *index)
+{
+	assert(memtx_tree_index_supports_view(index));
+	if (memtx_tree_index_def_uses_hint(index->def))
+		return memtx_tree_index_view_new_tpl<true>(index);
+	else
+		return memtx_tree_index_view_new_tpl<false>(index);
+}
+
+void
+memtx_tree_index_view_delete(struct memtx_tree_index_view *view)
+{
+	view->free(view);
+}
+
+ssize_t
+memtx_tree_index_view_select(struct memtx_tree_index_view *view,
+			     enum iterator_type type, const char *key,
+			     uint32_t part_count, uint32_t offset,
+			     uint32_t limit, memtx_tree_index_view_select_cb cb,
+			     void *arg)
+{
+	return view->select(view, type, key, part_count, offset, limit,
+			    cb, arg);
+}
+
+struct memtx_tree_index_frozen_iterator {
+	/** Return the next tuple, see frozen_iterator_next(). */
+	struct tuple *
+	(*next)(struct memtx_tree_index_frozen_iterator *it);
+	/** Destroy the iterator, see frozen_iterator_delete(). */
+	void
+	(*free)(struct memtx_tree_index_frozen_iterator *it);
+	/** Index the iterator was created for. Referenced by the iterator. */
+	struct index *index;
+};
+
+template <bool USE_HINT>
+struct memtx_tree_index_frozen_iterator_impl {
+	struct memtx_tree_index_frozen_iterator base;
+	/** Frozen index tree. */
+	memtx_tree_view_t<USE_HINT> view;
+	/** Position in the frozen tree. */
+	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+};
+
+template <bool USE_HINT>
+static struct tuple *
+memtx_tree_index_frozen_iterator_next_tpl(
+	struct memtx_tree_index_frozen_iterator *base)
+{
+	struct memtx_tree_index_frozen_iterator_impl<USE_HINT> *it =
+		(struct memtx_tree_index_frozen_iterator_impl<USE_HINT> *)base;
+	auto *tree = &it->view.tree;
+	struct memtx_tree_data<USE_HINT> *res =
+		memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
+	if (res == NULL)
+		return NULL;
+	memtx_tree_iterator_next(tree, &it->tree_iterator);
+	return res->tuple;
+}
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_frozen_iterator_free(
+	struct memtx_tree_index_frozen_iterator *base)
+{
+	struct memtx_tree_index_frozen_iterator_impl<USE_HINT> *it =
+		(struct memtx_tree_index_frozen_iterator_impl<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base->index;
+	memtx_tree_view_destroy(&it->view, &index->tree);
+	index_unref(base->index);
+	free(it);
+}
+
+template <bool USE_HINT>
+static struct memtx_tree_index_frozen_iterator *
+memtx_tree_index_frozen_iterator_new_tpl(struct index *base)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index_frozen_iterator_impl<USE_HINT> *it =
+		(struct memtx_tree_index_frozen_iterator_impl<USE_HINT> *)
+		malloc(sizeof(*it));
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(*it), "malloc",
+			 "struct memtx_tree_index_frozen_iterator");
+		return NULL;
+	}
+	it->base.next = memtx_tree_index_frozen_iterator_next_tpl<USE_HINT>;
+	it->base.free = memtx_tree_index_frozen_iterator_free<USE_HINT>;
+	it->base.index = base;
+	index_ref(base);
+	memtx_tree_view_create(&it->view, &index->tree);
+	it->tree_iterator = memtx_tree_iterator_first(&it->view.tree);
+	return &it->base;
+}
+
+struct memtx_tree_index_frozen_iterator *
+memtx_tree_index_frozen_iterator_new(struct index *index)
+{
+	assert(index->def->type == TREE);
+	if (memtx_tree_index_def_uses_hint(index->def))
+		return memtx_tree_index_frozen_iterator_new_tpl<true>(index);
+	else
+		return memtx_tree_index_frozen_iterator_new_tpl<false>(index);
+}
+
+struct tuple *
+memtx_tree_index_frozen_iterator_next(
+	struct memtx_tree_index_frozen_iterator *it)
+{
+	return it->next(it);
+}
+
+void
+memtx_tree_index_frozen_iterator_delete(
+	struct memtx_tree_index_frozen_iterator *it)
+{
+	it->free(it);
+}
+
+/* }}} */
+
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 {
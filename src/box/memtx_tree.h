@@ -30,6 +30,11 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "iterator_type.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -38,10 +43,129 @@ extern "C" {
 struct index;
 struct index_def;
 struct memtx_engine;
+struct memtx_tree_index_frozen_iterator;
+struct memtx_tree_index_view;
+struct tuple;
 
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Return true if the given memtx index is a tree index that can be
+ * filled with index_build_next() and sorted with
+ * memtx_tree_index_sort_build_array() outside the tx thread.
+ */
+bool
+memtx_tree_index_supports_parallel_build(struct index *index);
+
+/**
+ * Sort and deduplicate the keys added to a tree index with
+ * index_build_next() so that index_end_build() only has to
+ * build the tree. Unlike index_end_build(), doesn't allocate
+ * index extents and hence may be called from any thread
+ * provided the index isn't accessed concurrently.
+ */
+void
+memtx_tree_index_sort_build_array(struct index *index);
+
+/**
+ * Look for two tuples with equal keys in the build array of a tree
+ * index sorted with memtx_tree_index_sort_build_array(). Returns true
+ * and sets @a dup and @a tuple to the first such pair if found. Used
+ * to check the uniqueness constraint before index_end_build(). May be
+ * called from any thread provided the index isn't accessed concurrently.
+ */
+bool
+memtx_tree_index_find_build_array_dup(struct index *index,
+				      struct tuple **dup,
+				      struct tuple **tuple);
+
+/**
+ * Return true if a read view that may be searched outside the tx
+ * thread can be created for the given memtx index with
+ * memtx_tree_index_view_new(). It's only possible for tree indexes
+ * that compare tuples without looking up their formats, i.e. whose
+ * key definition is sequential and doesn't use collations.
+ */
+bool
+memtx_tree_index_supports_view(struct index *index);
+
+/**
+ * Create a read view of a tree index. The view references the index
+ * and freezes its current state: later index modifications are not
+ * visible through the view. Tuples stored in the view must be pinned
+ * by a memtx allocator read view (see memtx_allocators_open_read_view())
+ * opened before the index view and closed after it is deleted.
+ *
+ * Must be called in the tx thread. Returns NULL on memory allocation
+ * error (diag is set).
+ */
+struct memtx_tree_index_view *
+memtx_tree_index_view_new(struct index *index);
+
+/**
+ * Delete a read view created with memtx_tree_index_view_new().
+ * Must be called in the tx thread.
+ */
+void
+memtx_tree_index_view_delete(struct memtx_tree_index_view *view);
+
+/** Callback invoked for each tuple selected from an index read view. */
+typedef int
+(*memtx_tree_index_view_select_cb)(struct tuple *tuple, void *arg);
+
+/**
+ * Select tuples matching the given iterator type and key from an index
+ * read view, skipping the first @a offset of them and stopping after
+ * @a limit. The callback is invoked for each selected tuple. It may
+ * only access the tuple data with tuple_data() and tuple_bsize(): the
+ * tuple may have been deleted from the space, in which case the rest
+ * of its metadata may be reused by the allocator.
+ *
+ * The key is validated against the index key definition. The iterator
+ * type must be one of ITER_EQ, ITER_REQ, ITER_ALL, ITER_LT, ITER_LE,
+ * ITER_GE, ITER_GT.
+ *
+ * May be called from any thread while the view is alive. Returns the
+ * number of selected tuples on success, -1 if the key is invalid or
+ * the callback failed (diag is set).
+ */
+ssize_t
+memtx_tree_index_view_select(struct memtx_tree_index_view *view,
+			     enum iterator_type type, const char *key,
+			     uint32_t part_count, uint32_t offset,
+			     uint32_t limit, memtx_tree_index_view_select_cb cb,
+			     void *arg);
+
+/**
+ * Create an iterator over all tuples stored in a tree index at the
+ * moment of the call. The iterator references the index and freezes
+ * its current state: later index modifications are not visible to
+ * it. Tuples returned by the iterator aren't referenced: the caller
+ * must make sure they aren't freed while the iterator is in use.
+ *
+ * Must be called in the tx thread. Returns NULL on memory allocation
+ * error (diag is set).
+ */
+struct memtx_tree_index_frozen_iterator *
+memtx_tree_index_frozen_iterator_new(struct index *index);
+
+/**
+ * Return the next tuple of a frozen index iterator or NULL if there
+ * are no more tuples. May be called from any thread.
+ */
+struct tuple *
+memtx_tree_index_frozen_iterator_next(
+	struct memtx_tree_index_frozen_iterator *it);
+
+/**
+ * Delete an iterator created with memtx_tree_index_frozen_iterator_new().
+ * Must be called in the tx thread.
+ */
+void
+memtx_tree_index_frozen_iterator_delete(
+	struct memtx_tree_index_frozen_iterator *it);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -0,0 +1,301 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_tuple_compression.h"
+
+#if !defined(ENABLE_TUPLE_COMPRESSION)
+
+#include <string.h>
+
+#include "diag.h"
+#include "errcode.h"
+#include "fiber.h"
+#include "memtx_engine.h"
+#include "mp_compression.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "tuple_format.h"
+
+struct memtx_tuple_compression_stat memtx_tuple_compression_stat;
+
+/**
+ * An entry of the decompressed tuple cache. The cache is a direct
+ * mapped table indexed by the compressed tuple address, so a hot
+ * tuple read over and over again is decompressed only once, while
+ * a cold one is evicted by the next tuple that maps to its entry.
+ */
+struct memtx_tuple_decompression_cache_entry {
+	/** Compressed tuple, NULL if the entry is unused. */
+	struct tuple *tuple;
+	/** Decompressed copy of the tuple, referenced by the cache. */
+	struct tuple *decompressed;
+};
+
+static struct memtx_tuple_decompression_cache_entry
+memtx_tuple_decompression_cache[MEMTX_TUPLE_DECOMPRESSION_CACHE_SIZE];
+
+static inline struct memtx_tuple_decompression_cache_entry *
+memtx_tuple_decompression_cache_entry(struct tuple *tuple)
+{
+	/* Tuples are aligned, so skip the low bits. */
+	uintptr_t h = (uintptr_t)tuple >> 3;
+	h ^= h >> 17;
+	h *= 0x9e3779b97f4a7c15ULL;
+	h ^= h >> 29;
+	return &memtx_tuple_decompression_cache[
+		h % MEMTX_TUPLE_DECOMPRESSION_CACHE_SIZE];
+}
+
+static void
+memtx_tuple_decompression_cache_entry_clear(
+		struct memtx_tuple_decompression_cache_entry *entry)
+{
+	if (entry->tuple == NULL)
+		return;
+	struct tuple *decompressed = entry->decompressed;
+	entry->tuple = NULL;
+	entry->decompressed = NULL;
+	memtx_tuple_compression_stat.cache_count--;
+	tuple_unref(decompressed);
+}
+
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	assert(format->is_compressed);
+	uint32_t field_count_max = tuple_format_field_count(format);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	/* Compressed fields are always smaller than original ones. */
+	char *new_data = (char *)region_alloc(region, bsize);
+	if (new_data == NULL) {
+		diag_set(OutOfMemory, bsize, "region_alloc", "tuple");
+		return NULL;
+	}
+	bool is_compressed = false;
+	char *pos = new_data;
+	const char *field = data;
+	uint32_t field_count = mp_decode_array(&field);
+	pos = mp_encode_array(pos, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		size_t size = field_end - field;
+		enum compression_type type = COMPRESSION_TYPE_NONE;
+		if (i < field_count_max)
+			type = tuple_format_field(format, i)->compression_type;
+		char *buf = NULL;
+		char *buf_end = NULL;
+		if (type != COMPRESSION_TYPE_NONE &&
+		    size >= MEMTX_TUPLE_COMPRESSION_FIELD_SIZE_MIN &&
+		    !mp_is_compressed(field)) {
+			size_t buf_size = mp_sizeof_compression_max(size);
+			buf = (char *)region_alloc(region, buf_size);
+			if (buf == NULL) {
+				diag_set(OutOfMemory, buf_size,
+					 "region_alloc", "compressed field");
+				region_truncate(region, region_svp);
+				return NULL;
+			}
+			buf_end = mp_compress(buf, field, size, type);
+		}
+		if (buf_end != NULL) {
+			memcpy(pos, buf, buf_end - buf);
+			pos += buf_end - buf;
+			is_compressed = true;
+		} else {
+			memcpy(pos, field, size);
+			pos += size;
+		}
+		field = field_end;
+	}
+	assert(pos <= new_data + bsize);
+	struct tuple *result = tuple;
+	if (is_compressed)
+		result = memtx_tuple_new_raw(format, new_data, pos, false);
+	region_truncate(region, region_svp);
+	return result;
+}
+
+/**
+ * Return the size of tuple data @a data after decompression or 0 if
+ * the data has no compressed fields. Returns -1 on error.
+ */
+static ssize_t
+memtx_tuple_data_decompress_size(const char *data, uint32_t size)
+{
+	bool is_compressed = false;
+	ssize_t new_size = size;
+	const char *field = data;
+	uint32_t field_count = mp_decode_array(&field);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		if (mp_is_compressed(field)) {
+			size_t raw_size = mp_decompress_size(field);
+			if (raw_size == 0) {
+				diag_set(ClientError, ER_DECOMPRESSION,
+					 "invalid compressed field");
+				return -1;
+			}
+			new_size += raw_size - (field_end - field);
+			is_compressed = true;
+		}
+		field = field_end;
+	}
+	return is_compressed ? new_size : 0;
+}
+
+/**
+ * Decompress tuple data @a data to @a new_data of size @a new_size,
+ * as returned by memtx_tuple_data_decompress_size().
+ */
+static int
+memtx_tuple_data_decompress_to(const char *data, char *new_data,
+			       size_t new_size)
+{
+	char *pos = new_data;
+	char *end = new_data + new_size;
+	const char *field = data;
+	uint32_t field_count = mp_decode_array(&field);
+	pos = mp_encode_array(pos, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (mp_is_compressed(field)) {
+			size_t size = mp_decompress(&field, pos, end - pos);
+			if (size == 0) {
+				diag_set(ClientError, ER_DECOMPRESSION,
+					 "invalid compressed field");
+				return -1;
+			}
+			pos += size;
+		} else {
+			const char *field_end = field;
+			mp_next(&field_end);
+			memcpy(pos, field, field_end - field);
+			pos += field_end - field;
+			field = field_end;
+		}
+	}
+	assert(pos == end);
+	return 0;
+}
+
+int
+memtx_tuple_data_decompress(const char **data, uint32_t *size,
+			    struct region *region)
+{
+	ssize_t new_size = memtx_tuple_data_decompress_size(*data, *size);
+	if (new_size <= 0)
+		return new_size;
+	char *new_data = (char *)region_alloc(region, new_size);
+	if (new_data == NULL) {
+		diag_set(OutOfMemory, new_size, "region_alloc", "tuple");
+		return -1;
+	}
+	if (memtx_tuple_data_decompress_to(*data, new_data, new_size) != 0)
+		return -1;
+	*data = new_data;
+	*size = new_size;
+	return 0;
+}
+
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple)
+{
+	struct memtx_tuple_decompression_cache_entry *entry =
+		memtx_tuple_decompression_cache_entry(tuple);
+	if (entry->tuple == tuple) {
+		memtx_tuple_compression_stat.cache_hits++;
+		return entry->decompressed;
+	}
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	ssize_t new_size = memtx_tuple_data_decompress_size(data, bsize);
+	if (new_size < 0)
+		return NULL;
+	if (new_size == 0)
+		return tuple;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct tuple *result = NULL;
+	char *new_data = (char *)region_alloc(region, new_size);
+	if (new_data == NULL) {
+		diag_set(OutOfMemory, new_size, "region_alloc", "tuple");
+		goto out;
+	}
+	if (memtx_tuple_data_decompress_to(data, new_data, new_size) != 0)
+		goto out;
+	result = memtx_tuple_new_raw(tuple_format(tuple), new_data,
+				     new_data + new_size, false);
+	if (result == NULL)
+		goto out;
+	memtx_tuple_compression_stat.decompressions++;
+	if (new_size <= MEMTX_TUPLE_DECOMPRESSION_CACHE_TUPLE_SIZE_MAX) {
+		memtx_tuple_decompression_cache_entry_clear(entry);
+		entry->tuple = tuple;
+		entry->decompressed = result;
+		tuple_ref(result);
+		memtx_tuple_compression_stat.cache_count++;
+	}
+out:
+	region_truncate(region, region_svp);
+	return result;
+}
+
+void
+memtx_tuple_compression_account(struct tuple *tuple, int sign)
+{
+	struct memtx_tuple_compression_stat *stat =
+		&memtx_tuple_compression_stat;
+	int64_t fields = 0;
+	const char *field = tuple_data(tuple);
+	uint32_t field_count = mp_decode_array(&field);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		if (mp_is_compressed(field)) {
+			fields++;
+			stat->bytes_raw += sign *
+				(int64_t)mp_decompress_size(field);
+			stat->bytes_compressed += sign *
+				(int64_t)(field_end - field);
+		}
+		field = field_end;
+	}
+	if (fields > 0) {
+		stat->tuples += sign;
+		stat->fields += sign * fields;
+	}
+}
+
+void
+memtx_tuple_compression_forget(struct tuple *tuple)
+{
+	memtx_tuple_compression_account(tuple, -1);
+	struct memtx_tuple_decompression_cache_entry *entry =
+		memtx_tuple_decompression_cache_entry(tuple);
+	if (entry->tuple == tuple)
+		memtx_tuple_decompression_cache_entry_clear(entry);
+}
+
+void
+memtx_tuple_compression_reset_stat(void)
+{
+	memtx_tuple_compression_stat.decompressions = 0;
+	memtx_tuple_compression_stat.cache_hits = 0;
+}
+
+void
+memtx_tuple_compression_free(void)
+{
+	for (int i = 0; i < MEMTX_TUPLE_DECOMPRESSION_CACHE_SIZE; i++)
+		memtx_tuple_decompression_cache_entry_clear(
+			&memtx_tuple_decompression_cache[i]);
+}
+
+#endif /* !defined(ENABLE_TUPLE_COMPRESSION) */
@@ -11,36 +11,110 @@
 # include "memtx_tuple_compression_impl.h"
 #else /* !defined(ENABLE_TUPLE_COMPRESSION) */
 
+#include <stdint.h>
+
 #include "tuple.h"
 
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
-static inline struct tuple *
-memtx_tuple_compress(struct tuple *tuple)
-{
-        (void)tuple;
-        unreachable();
-        return NULL;
-}
+struct region;
 
-static inline struct tuple *
-memtx_tuple_decompress(struct tuple *tuple)
-{
-	(void)tuple;
-	unreachable();
-	return NULL;
-}
+enum {
+	/** Fields smaller than this are never compressed. */
+	MEMTX_TUPLE_COMPRESSION_FIELD_SIZE_MIN = 64,
+	/** Number of entries in the decompressed tuple cache. */
+	MEMTX_TUPLE_DECOMPRESSION_CACHE_SIZE = 1024,
+	/** Max size of a decompressed tuple stored in the cache. */
+	MEMTX_TUPLE_DECOMPRESSION_CACHE_TUPLE_SIZE_MAX = 4096,
+};
+
+/**
+ * Memtx tuple compression statistics, reported by box.stat.memtx.
+ * The tuple, field and byte counts describe the tuples currently
+ * allocated, the decompression and cache hit counters are cumulative
+ * and are cleared by box.stat.reset().
+ */
+struct memtx_tuple_compression_stat {
+	/** Number of allocated tuples with compressed fields. */
+	int64_t tuples;
+	/** Number of compressed fields in allocated tuples. */
+	int64_t fields;
+	/** Total size of compressed fields before compression. */
+	int64_t bytes_raw;
+	/** Total size of compressed fields after compression. */
+	int64_t bytes_compressed;
+	/** Number of tuples decompressed on read since the last reset. */
+	int64_t decompressions;
+	/** Number of reads served by the decompressed tuple cache. */
+	int64_t cache_hits;
+	/** Number of decompressed tuples stored in the cache. */
+	int64_t cache_count;
+};
+
+extern struct memtx_tuple_compression_stat memtx_tuple_compression_stat;
+
+/**
+ * Compress the fields of @a tuple that have compression enabled in
+ * the tuple format. Returns a new tuple or @a tuple itself if no
+ * field is worth compressing. Returns NULL and sets diag on error.
+ */
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple);
+
+/**
+ * Return a tuple with all fields of @a tuple decompressed. The
+ * result may be @a tuple itself if it has no compressed fields or
+ * a tuple from the decompressed tuple cache. Returns NULL and sets
+ * diag on error.
+ */
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple);
 
 static inline struct tuple *
 memtx_tuple_maybe_decompress(struct tuple *tuple)
 {
-        if (!tuple_is_compressed(tuple))
-                return tuple;
-        return memtx_tuple_decompress(tuple);
+	if (!tuple_is_compressed(tuple))
+		return tuple;
+	return memtx_tuple_decompress(tuple);
 }
 
+/**
+ * Decompress the raw tuple data @a data of size @a size if it has
+ * compressed fields. The decompressed data is allocated on @a region
+ * and returned in @a data and @a size. Doesn't use the tuple cache,
+ * so can be called from any thread. Returns 0 on success, -1 on
+ * error (diag is set).
+ */
+int
+memtx_tuple_data_decompress(const char **data, uint32_t *size,
+			    struct region *region);
+
+/**
+ * Add (@a sign is 1) or subtract (@a sign is -1) the compressed
+ * fields of @a tuple to or from the compression statistics. Called
+ * when a tuple of a format with compressed fields is allocated.
+ */
+void
+memtx_tuple_compression_account(struct tuple *tuple, int sign);
+
+/**
+ * Drop the decompressed copy of @a tuple from the cache and remove
+ * the tuple from the compression statistics. Called when a tuple of
+ * a format with compressed fields is deleted.
+ */
+void
+memtx_tuple_compression_forget(struct tuple *tuple);
+
+/** Reset the cumulative compression statistics. */
+void
+memtx_tuple_compression_reset_stat(void);
+
+/** Free all tuples stored in the decompressed tuple cache. */
+void
+memtx_tuple_compression_free(void);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
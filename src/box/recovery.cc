@@ -241,14 +241,23 @@ recovery_delete(struct recovery *r)
  * set l.eof_read.
  * The reading will be stopped on reaching stop_vclock.
  * Use NULL for boundless recover
+ *
+ * A row beyond limit_vclock is left unread and the function
+ * returns true. Use NULL to read all rows.
  */
-static void
+static bool
 recover_xlog(struct recovery *r, struct xstream *stream,
-	     const struct vclock *stop_vclock)
+	     const struct vclock *stop_vclock,
+	     const struct vclock *limit_vclock)
 {
 	struct xrow_header row;
 	while (xlog_cursor_next_xc(&r->cursor, &row,
 				   r->wal_dir.force_recovery) == 0) {
+		if (limit_vclock != NULL &&
+		    row.lsn > vclock_get(limit_vclock, row.replica_id)) {
+			xlog_cursor_unread_row(&r->cursor);
+			return true;
+		}
 		if (++stream->row_count % WAL_ROWS_PER_YIELD == 0) {
 			xstream_yield(stream);
 		}
@@ -266,7 +275,7 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 		 */
 		if (stop_vclock != NULL &&
 		    r->vclock.signature >= stop_vclock->signature)
-			return;
+			return false;
 		int64_t current_lsn = vclock_get(&r->vclock, row.replica_id);
 		if (row.lsn <= current_lsn)
 			continue; /* already applied, skip */
@@ -293,6 +302,7 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 			diag_log();
 		}
 	}
+	return false;
 }
 
 /**
@@ -308,7 +318,8 @@ recover_xlog(struct recovery *r, struct xstream *stream,
  */
 void
 recover_remaining_wals(struct recovery *r, struct xstream *stream,
-		       const struct vclock *stop_vclock, bool scan_dir)
+		       const struct vclock *stop_vclock,
+		       const struct vclock *limit_vclock, bool scan_dir)
 {
 	struct vclock *clock;
 
@@ -337,6 +348,14 @@ recover_remaining_wals(struct recovery *r, struct xstream *stream,
 		    clock->signature >= stop_vclock->signature) {
 			break;
 		}
+		/*
+		 * limit_vclock is a vclock of the same WAL, so if
+		 * the file starts past it, neither the file nor the
+		 * following ones have rows that may be read.
+		 */
+		if (limit_vclock != NULL &&
+		    clock->signature > limit_vclock->signature)
+			break;
 
 		if (xlog_cursor_is_eof(&r->cursor) &&
 		    vclock_sum(&r->cursor.meta.vclock) >= vclock_sum(clock)) {
@@ -352,7 +371,8 @@ recover_remaining_wals(struct recovery *r, struct xstream *stream,
 		say_info("recover from `%s'", r->cursor.name);
 
 recover_current_wal:
-		recover_xlog(r, stream, stop_vclock);
+		if (recover_xlog(r, stream, stop_vclock, limit_vclock))
+			break;
 	}
 
 	if (xlog_cursor_is_eof(&r->cursor))
@@ -484,7 +504,7 @@ hot_standby_f(va_list ap)
 		do {
 			start = vclock_sum(&r->vclock);
 			try {
-				recover_remaining_wals(r, stream, NULL,
+				recover_remaining_wals(r, stream, NULL, NULL,
 						       scan_dir);
 			} catch (Exception *e) {
 				e->log();
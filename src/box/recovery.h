@@ -97,11 +97,16 @@ recovery_finalize(struct recovery *r);
  * Reading will be stopped on reaching stop_vclock.
  * Use NULL for boundless recover
  *
+ * Rows beyond limit_vclock, which must be a vclock of the WAL
+ * being read, are left unread: the next call starts from them.
+ * Use NULL to read all rows.
+ *
  * This function will not close r->current_wal if
  * recovery was successful.
  */
 void
 recover_remaining_wals(struct recovery *r, struct xstream *stream,
-		       const struct vclock *stop_vclock, bool scan_dir);
+		       const struct vclock *stop_vclock,
+		       const struct vclock *limit_vclock, bool scan_dir);
 
 #endif /* TARANTOOL_RECOVERY_H_INCLUDED */
@@ -502,7 +502,7 @@ relay_final_join_f(va_list ap)
 	/* Send all WALs until stop_vclock */
 	assert(relay->stream.write != NULL);
 	recover_remaining_wals(relay->r, &relay->stream,
-			       &relay->stop_vclock, true);
+			       &relay->stop_vclock, NULL, true);
 	assert(vclock_compare(&relay->r->vclock, &relay->stop_vclock) == 0);
 	return 0;
 }
@@ -667,7 +667,8 @@ relay_set_error(struct relay *relay, struct error *e)
 }
 
 static void
-relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
+relay_process_wal_event(struct wal_watcher *watcher, unsigned events,
+			const struct vclock *vclock)
 {
 	struct relay *relay = container_of(watcher, struct relay, wal_watcher);
 	if (fiber_is_cancelled()) {
@@ -683,7 +684,7 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
+		recover_remaining_wals(relay->r, &relay->stream, NULL, vclock,
 				       (events & WAL_EVENT_ROTATE) != 0);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
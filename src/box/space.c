@@ -918,4 +918,18 @@ generic_space_invalidate(struct space *space)
 	(void)space;
 }
 
+bool
+generic_space_begin_bulk_insert(struct space *space)
+{
+	(void)space;
+	return false;
+}
+
+int
+generic_space_end_bulk_insert(struct space *space)
+{
+	(void)space;
+	return 0;
+}
+
 /* }}} */
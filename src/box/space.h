@@ -152,6 +152,24 @@ struct space_vtab {
 	 * This function isn't allowed to yield or fail.
 	 */
 	void (*invalidate)(struct space *space);
+	/**
+	 * Called before a batch of tuples is inserted into the space
+	 * in the current transaction with box_bulk_load(). The engine
+	 * may defer index updates until end_bulk_insert() to amortize
+	 * them over the whole batch. Returns true if it does so. Then
+	 * the indexes lack the tuples of the batch so the engine must
+	 * make sure inserts don't yield until end_bulk_insert().
+	 */
+	bool (*begin_bulk_insert)(struct space *space);
+	/**
+	 * Called after the last tuple of a batch started with
+	 * begin_bulk_insert() has been inserted, if the latter returned
+	 * true, before the transaction is committed. Applies the
+	 * deferred index updates. On failure the space stays in the
+	 * bulk insert mode: the caller must roll back the transaction
+	 * and call this function again.
+	 */
+	int (*end_bulk_insert)(struct space *space);
 };
 
 struct space {
@@ -520,6 +538,18 @@ space_invalidate(struct space *space)
 	return space->vtab->invalidate(space);
 }
 
+static inline bool
+space_begin_bulk_insert(struct space *space)
+{
+	return space->vtab->begin_bulk_insert(space);
+}
+
+static inline int
+space_end_bulk_insert(struct space *space)
+{
+	return space->vtab->end_bulk_insert(space);
+}
+
 static inline bool
 space_is_memtx(struct space *space) { return space->engine->id == 0; }
 
@@ -624,6 +654,8 @@ int generic_space_build_index(struct space *, struct index *,
 			      struct tuple_format *, bool);
 int generic_space_prepare_alter(struct space *, struct space *);
 void generic_space_invalidate(struct space *);
+bool generic_space_begin_bulk_insert(struct space *);
+int generic_space_end_bulk_insert(struct space *);
 
 #if defined(__cplusplus)
 } /* extern "C" */
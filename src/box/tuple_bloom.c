@@ -150,7 +150,8 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 }
 
 struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
+tuple_bloom_new(struct tuple_bloom_builder *builder, enum bloom_type type,
+		double fpr)
 {
 	uint32_t part_count = builder->part_count;
 	size_t size = sizeof(struct tuple_bloom) +
@@ -162,6 +163,7 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 	}
 
 	bloom->is_legacy = false;
+	bloom->type = type;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
@@ -179,7 +181,8 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 		for (uint32_t j = 0; j < i; j++)
 			part_fpr /= bloom_fpr(&bloom->parts[j], count);
 		part_fpr = MIN(part_fpr, 0.5);
-		if (bloom_create(&bloom->parts[i], count, part_fpr) != 0) {
+		if (bloom_create(&bloom->parts[i], type, count,
+				 part_fpr) != 0) {
 			diag_set(OutOfMemory, 0, "bloom_create",
 				 "tuple bloom part");
 			tuple_bloom_delete(bloom);
@@ -280,9 +283,11 @@ tuple_bloom_encode_part(const struct bloom *part, char *buf)
 }
 
 static int
-tuple_bloom_decode_part(struct bloom *part, const char **data)
+tuple_bloom_decode_part(struct bloom *part, enum bloom_type type,
+			const char **data)
 {
 	memset(part, 0, sizeof(*part));
+	part->type = type;
 	if (mp_decode_array(data) != 3)
 		unreachable();
 	part->table_size = mp_decode_uint(data);
@@ -298,10 +303,20 @@ tuple_bloom_decode_part(struct bloom *part, const char **data)
 	return 0;
 }
 
+/*
+ * The versioned format is [version, type, parts], where parts is
+ * encoded in the same way as the whole unversioned bloom filter.
+ */
+
 size_t
 tuple_bloom_size(const struct tuple_bloom *bloom)
 {
 	size_t size = 0;
+	if (tuple_bloom_is_versioned(bloom)) {
+		size += mp_sizeof_array(3);
+		size += mp_sizeof_uint(TUPLE_BLOOM_VERSION);
+		size += mp_sizeof_uint(bloom->type);
+	}
 	size += mp_sizeof_array(bloom->part_count);
 	for (uint32_t i = 0; i < bloom->part_count; i++)
 		size += tuple_bloom_sizeof_part(&bloom->parts[i]);
@@ -311,14 +326,20 @@ tuple_bloom_size(const struct tuple_bloom *bloom)
 char *
 tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf)
 {
+	if (tuple_bloom_is_versioned(bloom)) {
+		buf = mp_encode_array(buf, 3);
+		buf = mp_encode_uint(buf, TUPLE_BLOOM_VERSION);
+		buf = mp_encode_uint(buf, bloom->type);
+	}
 	buf = mp_encode_array(buf, bloom->part_count);
 	for (uint32_t i = 0; i < bloom->part_count; i++)
 		buf = tuple_bloom_encode_part(&bloom->parts[i], buf);
 	return buf;
 }
 
-struct tuple_bloom *
-tuple_bloom_decode(const char **data)
+/** Decode bloom filters of partial keys of the given type. */
+static struct tuple_bloom *
+tuple_bloom_decode_parts(const char **data, enum bloom_type type)
 {
 	uint32_t part_count = mp_decode_array(data);
 	struct tuple_bloom *bloom = malloc(sizeof(*bloom) +
@@ -331,10 +352,12 @@ tuple_bloom_decode(const char **data)
 	}
 
 	bloom->is_legacy = false;
+	bloom->type = type;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
-		if (tuple_bloom_decode_part(&bloom->parts[i], data) != 0) {
+		if (tuple_bloom_decode_part(&bloom->parts[i], type,
+					    data) != 0) {
 			tuple_bloom_delete(bloom);
 			return NULL;
 		}
@@ -343,6 +366,38 @@ tuple_bloom_decode(const char **data)
 	return bloom;
 }
 
+struct tuple_bloom *
+tuple_bloom_decode(const char **data)
+{
+	return tuple_bloom_decode_parts(data, BLOOM_TYPE_CLASSIC);
+}
+
+int
+tuple_bloom_decode_versioned(const char **data, struct tuple_bloom **bloom)
+{
+	/*
+	 * A filter written by a newer version may have a different
+	 * layout, so check the header before decoding anything and
+	 * skip the whole filter if it isn't supported.
+	 */
+	const char *pos = *data;
+	*bloom = NULL;
+	mp_next(data);
+	if (mp_typeof(*pos) != MP_ARRAY || mp_decode_array(&pos) != 3 ||
+	    mp_typeof(*pos) != MP_UINT ||
+	    mp_decode_uint(&pos) != TUPLE_BLOOM_VERSION ||
+	    mp_typeof(*pos) != MP_UINT)
+		return 0;
+	uint64_t type = mp_decode_uint(&pos);
+	if (type >= bloom_type_MAX)
+		return 0;
+	*bloom = tuple_bloom_decode_parts(&pos, (enum bloom_type)type);
+	if (*bloom == NULL)
+		return -1;
+	assert(pos == *data);
+	return 0;
+}
+
 struct tuple_bloom *
 tuple_bloom_decode_legacy(const char **data)
 {
@@ -355,6 +410,7 @@ tuple_bloom_decode_legacy(const char **data)
 	}
 
 	bloom->is_legacy = true;
+	bloom->type = BLOOM_TYPE_CLASSIC;
 	bloom->part_count = 1;
 
 	if (mp_decode_array(data) != 4)
@@ -364,6 +420,7 @@ tuple_bloom_decode_legacy(const char **data)
 
 	bloom->parts[0].table_size = mp_decode_uint(data);
 	bloom->parts[0].hash_count = mp_decode_uint(data);
+	bloom->parts[0].type = BLOOM_TYPE_CLASSIC;
 
 	size_t store_size = mp_decode_binl(data);
 	assert(store_size == bloom_store_size(&bloom->parts[0]));
@@ -58,12 +58,19 @@ struct tuple_bloom {
 	 * (see tuple_bloom_decode_legacy).
 	 */
 	bool is_legacy;
+	/** Type of bloom filters of all partial keys. */
+	enum bloom_type type;
 	/** Number of key parts. */
 	uint32_t part_count;
 	/** Array of bloom filters, one per each partial key. */
 	struct bloom parts[0];
 };
 
+enum {
+	/** Version of the tuple bloom filter encoding. */
+	TUPLE_BLOOM_VERSION = 1,
+};
+
 /**
  * Array of tuple hashes.
  */
@@ -153,11 +160,13 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 /**
  * Create a new tuple bloom filter.
  * @param builder - bloom filter builder
+ * @param type - type of bloom filters
  * @param fpr - desired false positive rate
  * @return bloom filter on success or NULL on OOM
  */
 struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr);
+tuple_bloom_new(struct tuple_bloom_builder *builder, enum bloom_type type,
+		double fpr);
 
 /**
  * Delete a tuple bloom filter.
@@ -206,10 +215,25 @@ tuple_bloom_size(const struct tuple_bloom *bloom);
  * @param bloom - bloom filter
  * @param buf - buffer where to store the bloom filter
  * @return pointer to the first byte following encoded data
+ *
+ * Classic bloom filters are encoded in the unversioned format,
+ * which is understood by all versions that support partial key
+ * bloom filters (see tuple_bloom_decode). Other types are encoded
+ * in the versioned format (see tuple_bloom_decode_versioned).
  */
 char *
 tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf);
 
+/**
+ * Return true if a tuple bloom filter is encoded in the versioned
+ * format by tuple_bloom_encode.
+ */
+static inline bool
+tuple_bloom_is_versioned(const struct tuple_bloom *bloom)
+{
+	return bloom->type != BLOOM_TYPE_CLASSIC;
+}
+
 /**
  * Decode a tuple bloom filter from MsgPack.
  * @param data - pointer to buffer storing encoded bloom filter;
@@ -219,6 +243,18 @@ tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf);
 struct tuple_bloom *
 tuple_bloom_decode(const char **data);
 
+/**
+ * Decode a tuple bloom filter encoded in the versioned format.
+ * @param data - pointer to buffer storing encoded bloom filter;
+ *  on success it is advanced by the number of decoded bytes
+ * @param[out] bloom - the decoded bloom or NULL if the filter
+ *  version or type isn't supported, in which case the filter
+ *  is skipped and should be treated as absent
+ * @return 0 on success, -1 on OOM
+ */
+int
+tuple_bloom_decode_versioned(const char **data, struct tuple_bloom **bloom);
+
 /**
  * Decode a legacy bloom filter from MsgPack.
  * @param data - pointer to buffer storing encoded bloom filter;
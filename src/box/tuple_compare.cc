@@ -2211,3 +2211,23 @@ key_def_set_compare_func(struct key_def *def)
 	}
 	key_def_set_hint_func(def);
 }
+
+void
+key_def_set_sequential_compare_func(struct key_def *def)
+{
+	assert(key_def_is_sequential(def));
+	assert(!key_def_has_collation(def));
+	assert(!def->for_func_index);
+	if (def->is_nullable && def->has_optional_parts) {
+		key_def_set_compare_func_plain<true, true>(def);
+	} else if (def->is_nullable && !def->has_optional_parts) {
+		key_def_set_compare_func_plain<true, false>(def);
+	} else {
+		assert(!def->is_nullable && !def->has_optional_parts);
+		key_def_set_compare_func_plain<false, false>(def);
+	}
+	if (key_def_incomparable_type(def) != field_type_MAX) {
+		def->tuple_compare = NULL;
+		def->tuple_compare_with_key = NULL;
+	}
+}
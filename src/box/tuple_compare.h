@@ -76,6 +76,18 @@ typedef uint64_t hint_t;
 void
 key_def_set_compare_func(struct key_def *def);
 
+/**
+ * Initialize comparator functions for a sequential key_def so that
+ * they only access the tuple data (see tuple_data()) and never look
+ * up the tuple format. Used to compare tuples that may be accessed
+ * concurrently with their metadata being reused by the allocator,
+ * see memtx_tree_index_view_new().
+ * @param key_def key definition, must be sequential and must not
+ *                have collations
+ */
+void
+key_def_set_sequential_compare_func(struct key_def *def);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
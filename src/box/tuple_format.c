@@ -614,21 +614,25 @@ tuple_format_register(struct tuple_format *format)
 		format->id = (uint16_t) recycled_format_ids;
 		recycled_format_ids = (intptr_t) tuple_formats[recycled_format_ids];
 	} else {
-		if (formats_size == formats_capacity) {
-			uint32_t new_capacity = formats_capacity ?
-						formats_capacity * 2 : 16;
+		if (tuple_formats == NULL) {
+			/*
+			 * The table is allocated at its maximal size
+			 * and never reallocated so that tuple_format()
+			 * may be safely called from threads other than
+			 * tx, e.g. by index build workers, while new
+			 * formats are registered.
+			 */
+			uint32_t capacity = FORMAT_ID_NIL + 1;
 			struct tuple_format **formats;
 			formats = (struct tuple_format **)
-				realloc(tuple_formats, new_capacity *
-						       sizeof(tuple_formats[0]));
+				calloc(capacity, sizeof(tuple_formats[0]));
 			if (formats == NULL) {
 				diag_set(OutOfMemory,
-					 sizeof(struct tuple_format), "malloc",
-					 "tuple_formats");
+					 capacity * sizeof(tuple_formats[0]),
+					 "calloc", "tuple_formats");
 				return -1;
 			}
-
-			formats_capacity = new_capacity;
+			formats_capacity = capacity;
 			tuple_formats = formats;
 		}
 		uint32_t formats_size_max = FORMAT_ID_MAX + 1;
@@ -46,6 +46,7 @@
 #include "vy_regulator.h"
 #include "vy_stat.h"
 
+#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -263,6 +264,17 @@ vy_info_append_regulator(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "rate_limit", vy_quota_get_rate_limit(r->quota,
 							VY_QUOTA_CONSUMER_TX));
 	info_append_int(h, "blocked_writers", r->quota->n_blocked);
+	info_append_str(h, "mode", vy_regulator_mode_strs[r->mode]);
+	/* Report the absence of a rate limit as math.huge. */
+	if (r->target_rate == SIZE_MAX)
+		info_append_double(h, "target_rate", HUGE_VAL);
+	else
+		info_append_int(h, "target_rate", r->target_rate);
+	info_append_int(h, "compaction_debt", *r->compaction_debt);
+	info_append_int(h, "compaction_bandwidth", r->compaction_bandwidth);
+	info_append_double(h, "compaction_utilization",
+			   r->compaction_utilization);
+	info_append_double(h, "predicted_stall", r->predicted_stall);
 	info_table_end(h); /* regulator */
 }
 
@@ -297,11 +309,34 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "tx", vy_tx_manager_mem_used(env->xm));
 	info_append_int(h, "level0", lsregion_used(&env->mem_env.allocator));
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
+	info_append_int(h, "page_cache", env->run_env.page_cache.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
+	info_append_int(h, "compression_dict", vy_run_dict_mem_used());
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache_stat *stat = &env->run_env.page_cache.stat;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "hit", stat->hit);
+	info_append_int(h, "miss", stat->miss);
+	info_append_int(h, "evict", stat->evict);
+	info_table_end(h); /* page_cache */
+}
+
+static void
+vy_info_append_prefetch(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_run_prefetch_stat *stat = &env->run_env.prefetch_stat;
+	info_table_begin(h, "prefetch");
+	info_append_int(h, "read", stat->read);
+	info_append_int(h, "hit", stat->hit);
+	info_table_end(h); /* prefetch */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -320,6 +355,8 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_tx(env, h);
 	vy_info_append_memory(env, h);
+	vy_info_append_page_cache(env, h);
+	vy_info_append_prefetch(env, h);
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
@@ -457,6 +494,43 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "dumps_per_compaction",
 			vy_lsm_dumps_per_compaction(lsm));
 
+	/*
+	 * Per-range read statistics. Ranges are identified by
+	 * their boundaries.
+	 */
+	info_append_int(h, "hot_range_count", lsm->hot_range_count);
+	info_table_begin(h, "ranges");
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		info_table_begin(h, vy_range_str(range));
+		info_append_int(h, "lookup", range->lookup);
+		info_append_int(h, "scan", range->scan);
+		info_append_double(h, "heat", range->heat);
+		info_table_end(h); /* range */
+	}
+	info_table_end(h); /* ranges */
+
+	/*
+	 * Write amplification is the number of bytes written to
+	 * disk per byte dumped from memory, read amplification is
+	 * the average number of runs a lookup may have to check,
+	 * space amplification is the ratio of the disk size to
+	 * the size of the last LSM tree level.
+	 */
+	info_table_begin(h, "amplification");
+	int64_t dump_input = stat->disk.dump.input.bytes;
+	int64_t disk_output = stat->disk.dump.output.bytes +
+			      stat->disk.compaction.output.bytes;
+	info_append_double(h, "write", dump_input == 0 ? 0 :
+			   (double)disk_output / dump_input);
+	info_append_double(h, "read", (double)lsm->run_count /
+			   lsm->range_count);
+	int64_t last_level = stat->disk.last_level_count.bytes;
+	info_append_double(h, "space", last_level == 0 ? 0 :
+			   (double)stat->disk.count.bytes / last_level);
+	info_table_end(h); /* amplification */
+
 	info_end(h);
 }
 
@@ -498,6 +572,14 @@ vinyl_index_reset_stat(struct index *index)
 	vy_stmt_counter_reset(&cache_stat->put);
 	vy_stmt_counter_reset(&cache_stat->invalidate);
 	vy_stmt_counter_reset(&cache_stat->evict);
+
+	/* Range reads */
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		range->lookup = 0;
+		range->scan = 0;
+	}
 }
 
 static void
@@ -511,6 +593,7 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->index += env->lsm_env.bloom_size;
 	stat->index += env->lsm_env.page_index_size;
 	stat->cache += env->cache_env.mem_used;
+	stat->cache += env->run_env.page_cache.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
 }
 
@@ -524,6 +607,10 @@ vinyl_engine_reset_stat(struct engine *engine)
 
 	vy_scheduler_reset_stat(&env->scheduler);
 	vy_regulator_reset_stat(&env->regulator);
+	memset(&env->run_env.page_cache.stat, 0,
+	       sizeof(env->run_env.page_cache.stat));
+	memset(&env->run_env.prefetch_stat, 0,
+	       sizeof(env->run_env.prefetch_stat));
 }
 
 /** }}} Introspection */
@@ -692,6 +779,21 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "functional index");
 		return -1;
 	}
+	if (index_def->opts.covering) {
+		const char *reason = NULL;
+		if (index_def->iid == 0)
+			reason = "primary key can't be covering";
+		else if (key_def->is_multikey)
+			reason = "multikey index can't be covering";
+		else if (space->def->opts.defer_deletes)
+			reason = "covering index is incompatible with "
+				 "deferred deletes";
+		if (reason != NULL) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space), reason);
+			return -1;
+		}
+	}
 	return 0;
 }
 
@@ -924,7 +1026,11 @@ static void
 vinyl_index_update_def(struct index *index)
 {
 	struct vy_lsm *lsm = vy_lsm(index);
+	bool cache_hot_ranges = lsm->opts.cache_hot_ranges;
 	lsm->opts = index->def->opts;
+	/* Move cached tuples of hot ranges to the right LRU list. */
+	lsm->opts.cache_hot_ranges = cache_hot_ranges;
+	vy_lsm_set_cache_hot_ranges(lsm, index->def->opts.cache_hot_ranges);
 	key_def_copy(lsm->key_def, index->def->key_def);
 	key_def_copy(lsm->cmp_def, index->def->cmp_def);
 }
@@ -954,6 +1060,8 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.func_id != new_def->opts.func_id)
 		return true;
+	if (old_def->opts.covering != new_def->opts.covering)
+		return true;
 
 	assert(index_depends_on_pk(index));
 	const struct key_def *old_cmp_def = old_def->cmp_def;
@@ -996,12 +1104,26 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 static int
 vinyl_space_prepare_alter(struct space *old_space, struct space *new_space)
 {
-	(void)new_space;
 	struct vy_env *env = vy_env(old_space->engine);
 
 	if (vinyl_check_wal(env, "DDL") != 0)
 		return -1;
 
+	/*
+	 * Covering indexes rely on secondary index entries being
+	 * deleted along with primary index entries.
+	 */
+	if (new_space->def->opts.defer_deletes) {
+		for (uint32_t i = 0; i < new_space->index_count; i++) {
+			if (!new_space->index[i]->def->opts.covering)
+				continue;
+			diag_set(ClientError, ER_ALTER_SPACE,
+				 space_name(new_space),
+				 "deferred deletes are incompatible with "
+				 "covering indexes");
+			return -1;
+		}
+	}
 	return 0;
 }
 
@@ -1292,6 +1414,19 @@ vy_get_by_secondary_tuple(struct vy_lsm *lsm, struct vy_tx *tx,
 	int rc = 0;
 	assert(lsm->index_id > 0);
 
+	if (vy_lsm_is_covering(lsm)) {
+		/*
+		 * A covering index stores full tuples and, since
+		 * deferred DELETEs are disabled for it, never has
+		 * stale entries so no primary index lookup is
+		 * needed.
+		 */
+		assert(!vy_stmt_is_key(entry.stmt));
+		tuple_ref(entry.stmt);
+		*result = entry;
+		return 0;
+	}
+
 	/*
 	 * Lookup the full tuple by a secondary statement.
 	 * There are two cases: the secondary statement may be
@@ -1374,8 +1509,9 @@ vy_get_by_secondary_tuple(struct vy_lsm *lsm, struct vy_tx *tx,
 	}
 
 	if ((*rv)->vlsn == INT64_MAX) {
-		vy_cache_add(&lsm->pk->cache, pk_entry,
-			     vy_entry_none(), key, ITER_EQ);
+		vy_cache_add(&lsm->pk->cache, pk_entry, vy_entry_none(),
+			     key, ITER_EQ,
+			     vy_lsm_key_is_cache_hot(lsm->pk, pk_entry));
 	}
 
 	vy_stmt_counter_acct_tuple(&lsm->pk->stat.get, pk_entry.stmt);
@@ -1436,8 +1572,9 @@ vy_get(struct vy_lsm *lsm, struct vy_tx *tx,
 			entry = partial;
 		}
 		if ((*rv)->vlsn == INT64_MAX) {
-			vy_cache_add(&lsm->cache, entry,
-				     vy_entry_none(), key, ITER_EQ);
+			vy_cache_add(&lsm->cache, entry, vy_entry_none(),
+				     key, ITER_EQ,
+				     vy_lsm_key_is_cache_hot(lsm, key));
 		}
 		goto out;
 	}
@@ -2644,6 +2781,8 @@ vy_env_new(const char *path, size_t memory,
 
 	vy_quota_create(&e->quota, memory, vy_env_quota_exceeded_cb);
 	vy_regulator_create(&e->regulator, &e->quota,
+			    &e->lsm_env.compaction_queue_size,
+			    &e->scheduler.compaction_pool,
 			    vy_env_trigger_dump_cb);
 
 	struct slab_cache *slab_cache = cord_slab_cache();
@@ -2729,6 +2868,30 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_page_cache_set_quota(&env->run_env.page_cache, quota);
+}
+
+void
+vinyl_engine_set_prefetch_pages(struct engine *engine, int pages)
+{
+	struct vy_env *env = vy_env(engine);
+	assert(pages >= 0 && pages <= VY_RUN_PREFETCH_MAX);
+	env->run_env.prefetch_pages = pages;
+}
+
+void
+vinyl_engine_set_regulator_mode(struct engine *engine, const char *mode)
+{
+	struct vy_env *env = vy_env(engine);
+	enum vy_regulator_mode m = STR2ENUM(vy_regulator_mode, mode);
+	assert(m != vy_regulator_mode_MAX);
+	vy_regulator_set_mode(&env->regulator, m);
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -3684,6 +3847,7 @@ next:
 		goto fail;
 	if (entry.stmt == NULL)
 		goto next;
+	vy_lsm_acct_lookup(lsm->pk, entry.stmt);
 	vy_read_iterator_cache_add(&it->iterator, entry);
 	vinyl_iterator_account_read(it, start_time, entry.stmt);
 	*ret = entry.stmt;
@@ -3765,6 +3929,7 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 	lsm->stat.lookup++;
 	vy_read_iterator_open(&it->iterator, lsm, tx, type, it->key,
 			      (const struct vy_read_view **)&tx->read_view);
+	it->iterator.acct_range_reads = true;
 	return (struct iterator *)it;
 }
 
@@ -3851,7 +4016,17 @@ vinyl_index_get(struct index *index, const char *key,
 	 * reading from it.
 	 */
 	vy_lsm_ref(lsm);
-	int rc = vy_get_by_raw_key(lsm, tx, rv, key, part_count, ret);
+	int rc = -1;
+	struct tuple *key_stmt = vy_key_new(lsm->env->key_format,
+					    key, part_count);
+	if (key_stmt != NULL) {
+		vy_lsm_acct_lookup(lsm, key_stmt);
+		rc = vy_get(lsm, tx, rv, key_stmt, ret);
+		tuple_unref(key_stmt);
+	}
+	/* Account the primary index lookup done by vy_get(). */
+	if (rc == 0 && lsm->index_id > 0 && *ret != NULL)
+		vy_lsm_acct_lookup(lsm->pk, *ret);
 	vy_lsm_unref(lsm);
 	if (rc != 0)
 		return -1;
@@ -4621,6 +4796,8 @@ static const struct space_vtab vinyl_space_vtab = {
 	/* .swap_index = */ vinyl_space_swap_index,
 	/* .prepare_alter = */ vinyl_space_prepare_alter,
 	/* .invalidate = */ vinyl_space_invalidate,
+	/* .begin_bulk_insert = */ generic_space_begin_bulk_insert,
+	/* .end_bulk_insert = */ generic_space_end_bulk_insert,
 };
 
 static const struct index_vtab vinyl_index_vtab = {
@@ -4643,6 +4820,8 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .get = */ vinyl_index_get,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ vinyl_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		vinyl_index_create_snapshot_iterator,
 	/* .stat = */ vinyl_index_stat,
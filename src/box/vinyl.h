@@ -41,6 +41,11 @@ extern "C" {
 struct info_handler;
 struct engine;
 
+enum {
+	/** Max number of pages a run iterator may prefetch. */
+	VY_RUN_PREFETCH_MAX = 16,
+};
+
 struct engine *
 vinyl_engine_new(const char *dir, size_t memory,
 		 int read_threads, int write_threads, bool force_recovery);
@@ -57,6 +62,24 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update vinyl page cache size.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
+/**
+ * Update the number of pages read ahead during scans.
+ */
+void
+vinyl_engine_set_prefetch_pages(struct engine *engine, int pages);
+
+/**
+ * Set the load regulator mode ("static" or "adaptive").
+ */
+void
+vinyl_engine_set_regulator_mode(struct engine *engine, const char *mode);
+
 /**
  * Update vinyl memory size.
  */
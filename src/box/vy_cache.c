@@ -56,7 +56,9 @@ void
 vy_cache_env_create(struct vy_cache_env *e, struct slab_cache *slab_cache)
 {
 	rlist_create(&e->cache_lru);
+	rlist_create(&e->hot_lru);
 	e->mem_used = 0;
+	e->hot_mem_used = 0;
 	e->mem_quota = 0;
 	mempool_create(&e->cache_node_mempool, slab_cache,
 		       sizeof(struct vy_cache_node));
@@ -84,7 +86,7 @@ vy_cache_node_size(const struct vy_cache_node *node)
 
 static struct vy_cache_node *
 vy_cache_node_new(struct vy_cache_env *env, struct vy_cache *cache,
-		  struct vy_entry entry)
+		  struct vy_entry entry, bool is_hot)
 {
 	struct vy_cache_node *node = mempool_alloc(&env->cache_node_mempool);
 	if (node == NULL)
@@ -95,7 +97,13 @@ vy_cache_node_new(struct vy_cache_env *env, struct vy_cache *cache,
 	node->flags = 0;
 	node->left_boundary_level = cache->cmp_def->part_count;
 	node->right_boundary_level = cache->cmp_def->part_count;
-	rlist_add(&env->cache_lru, &node->in_lru);
+	node->is_hot = is_hot;
+	if (is_hot) {
+		rlist_add(&env->hot_lru, &node->in_lru);
+		env->hot_mem_used += vy_cache_node_size(node);
+	} else {
+		rlist_add(&env->cache_lru, &node->in_lru);
+	}
 	env->mem_used += vy_cache_node_size(node);
 	vy_stmt_counter_acct_tuple(&cache->stat.count, entry.stmt);
 	return node;
@@ -108,6 +116,10 @@ vy_cache_node_delete(struct vy_cache_env *env, struct vy_cache_node *node)
 				     node->entry.stmt);
 	assert(env->mem_used >= vy_cache_node_size(node));
 	env->mem_used -= vy_cache_node_size(node);
+	if (node->is_hot) {
+		assert(env->hot_mem_used >= vy_cache_node_size(node));
+		env->hot_mem_used -= vy_cache_node_size(node);
+	}
 	tuple_unref(node->entry.stmt);
 	rlist_del(&node->in_lru);
 	TRASH(node);
@@ -166,7 +178,15 @@ vy_cache_destroy(struct vy_cache *cache)
 static void
 vy_cache_gc_step(struct vy_cache_env *env)
 {
+	/*
+	 * Evict tuples of hot ranges only if the rest of the cache
+	 * is small, like the page cache does with its 'hot' queue.
+	 */
 	struct rlist *lru = &env->cache_lru;
+	if (env->mem_used - env->hot_mem_used <= env->mem_quota / 4 &&
+	    !rlist_empty(&env->hot_lru))
+		lru = &env->hot_lru;
+	assert(!rlist_empty(lru));
 	struct vy_cache_node *node =
 		rlist_last_entry(lru, struct vy_cache_node, in_lru);
 	struct vy_cache *cache = node->cache;
@@ -224,10 +244,43 @@ vy_cache_env_set_quota(struct vy_cache_env *env, size_t quota)
 	}
 }
 
+void
+vy_cache_set_hot(struct vy_cache *cache, struct vy_entry begin,
+		 struct vy_entry end, bool is_hot)
+{
+	struct vy_cache_env *env = cache->env;
+	struct vy_cache_tree *tree = &cache->cache_tree;
+	struct vy_cache_tree_iterator itr;
+	if (begin.stmt != NULL)
+		itr = vy_cache_tree_lower_bound(tree, begin, NULL);
+	else
+		itr = vy_cache_tree_iterator_first(tree);
+	while (!vy_cache_tree_iterator_is_invalid(&itr)) {
+		struct vy_cache_node *node =
+			*vy_cache_tree_iterator_get_elem(tree, &itr);
+		if (end.stmt != NULL &&
+		    vy_entry_compare(node->entry, end, cache->cmp_def) >= 0)
+			break;
+		if (node->is_hot != is_hot) {
+			node->is_hot = is_hot;
+			if (is_hot) {
+				rlist_move(&env->hot_lru, &node->in_lru);
+				env->hot_mem_used += vy_cache_node_size(node);
+			} else {
+				rlist_move(&env->cache_lru, &node->in_lru);
+				assert(env->hot_mem_used >=
+				       vy_cache_node_size(node));
+				env->hot_mem_used -= vy_cache_node_size(node);
+			}
+		}
+		vy_cache_tree_iterator_next(tree, &itr);
+	}
+}
+
 void
 vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 	     struct vy_entry prev, struct vy_entry key,
-	     enum iterator_type order)
+	     enum iterator_type order, bool is_hot)
 {
 	if (cache->env->mem_quota == 0) {
 		/* Cache is disabled. */
@@ -302,7 +355,7 @@ vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 
 	/* Insert/replace new node to the tree */
 	struct vy_cache_node *node =
-		vy_cache_node_new(cache->env, cache, curr);
+		vy_cache_node_new(cache->env, cache, curr, is_hot);
 	if (node == NULL) {
 		/* memory error, let's live without a cache */
 		return;
@@ -391,7 +444,7 @@ vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 
 	/* Insert/replace node with previous statement */
 	struct vy_cache_node *prev_node =
-		vy_cache_node_new(cache->env, cache, prev);
+		vy_cache_node_new(cache->env, cache, prev, is_hot);
 	if (prev_node == NULL) {
 		/* memory error, let's live without a chain */
 		return;
@@ -58,6 +58,8 @@ struct vy_cache_node {
 	struct vy_entry entry;
 	/* Link in LRU list */
 	struct rlist in_lru;
+	/* Set if the node is linked in the hot LRU list */
+	bool is_hot;
 	/* VY_CACHE_LEFT_LINKED and/or VY_CACHE_RIGHT_LINKED, see
 	 * description of them for more information */
 	uint32_t flags;
@@ -117,10 +119,18 @@ vy_cache_tree_key_cmp(struct vy_cache_node *a, struct vy_entry b,
 struct vy_cache_env {
 	/** Common LRU list of read cache. The first element is the newest */
 	struct rlist cache_lru;
+	/**
+	 * LRU list of tuples of hot ranges. Tuples are evicted from
+	 * it only when the rest of the cache is smaller than a quarter
+	 * of the quota so that scans can't push them out.
+	 */
+	struct rlist hot_lru;
 	/** Common mempool for vy_cache_node struct */
 	struct mempool cache_node_mempool;
 	/** Size of memory occupied by cached tuples */
 	size_t mem_used;
+	/** Size of memory occupied by tuples stored in hot_lru */
+	size_t hot_mem_used;
 	/** Max memory size that can be used for cache */
 	size_t mem_quota;
 };
@@ -199,11 +209,23 @@ vy_cache_destroy(struct vy_cache *cache);
  * sequence (by one iterator).
  * @param direction - direction in which the reader (iterator) observes data,
  *  +1 - forward, -1 - backward.
+ * @param is_hot - set if the statements belong to a hot range and
+ * should be given priority over other cached statements.
  */
 void
 vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 	     struct vy_entry prev, struct vy_entry key,
-	     enum iterator_type order);
+	     enum iterator_type order, bool is_hot);
+
+/**
+ * Move cached statements that fall in the key range [begin, end)
+ * to the hot LRU list if is_hot is set, to the common LRU list
+ * otherwise. An empty boundary stands for infinity. Used when
+ * a range turns hot or cools down.
+ */
+void
+vy_cache_set_hot(struct vy_cache *cache, struct vy_entry begin,
+		 struct vy_entry end, bool is_hot);
 
 /**
  * Find value in cache.
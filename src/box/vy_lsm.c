@@ -70,6 +70,22 @@ static const int64_t VY_MIN_RANGE_SIZE = 128 * 1024 * 1024;
  */
 static const int64_t VY_MAX_RANGE_SIZE = 2LL * 1024 * 1024 * 1024;
 
+/**
+ * Range heat is updated after each VY_RANGE_HEAT_READS_PER_RANGE
+ * reads per range, but not more often than every
+ * VY_RANGE_HEAT_READS_MIN reads, so that the cost of the update
+ * is amortized over many reads.
+ */
+static const int64_t VY_RANGE_HEAT_READS_MIN = 1000;
+static const int64_t VY_RANGE_HEAT_READS_PER_RANGE = 64;
+
+/**
+ * A range is considered hot if its heat is at least this many
+ * times greater than the average heat of ranges of the same LSM
+ * tree.
+ */
+static const double VY_RANGE_HOT_RATIO = 2;
+
 int
 vy_lsm_env_create(struct vy_lsm_env *env, const char *path,
 		  int64_t *p_generation, struct tuple_format *key_format,
@@ -150,11 +166,12 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 
 	lsm->cmp_def = cmp_def;
 	lsm->key_def = key_def;
-	if (index_def->iid == 0) {
+	if (index_def->iid == 0 || index_def->opts.covering) {
 		/*
 		 * Disk tuples can be returned to an user from a
-		 * primary key. And they must have field
-		 * definitions as well as space->format tuples.
+		 * primary key or a covering secondary key. And they
+		 * must have field definitions as well as
+		 * space->format tuples.
 		 */
 		lsm->disk_format = format;
 	} else {
@@ -166,7 +183,8 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 		 * up a full tuple in the primary index.
 		 */
 		lsm->disk_format = lsm_env->key_format;
-
+	}
+	if (index_def->iid > 0) {
 		lsm->pk_in_cmp_def = key_def_find_pk_in_cmp_def(lsm->cmp_def,
 								pk->key_def,
 								&fiber()->gc);
@@ -270,6 +288,8 @@ vy_lsm_delete(struct vy_lsm *lsm)
 	struct vy_run *run, *next_run;
 	rlist_foreach_entry_safe(run, &lsm->runs, in_lsm, next_run)
 		vy_lsm_remove_run(lsm, run);
+	if (lsm->compression_dict != NULL)
+		vy_run_dict_unref(lsm->compression_dict);
 
 	vy_range_tree_iter(&lsm->range_tree, NULL, vy_range_tree_free_cb, NULL);
 	vy_range_heap_destroy(&lsm->range_heap);
@@ -640,6 +660,21 @@ vy_lsm_recover(struct vy_lsm *lsm, struct vy_recovery *recovery,
 	if (rc != 0)
 		return -1;
 
+	/*
+	 * Continue compressing new runs with the dictionary of
+	 * the newest run. A dictionary trained after the run was
+	 * written isn't persisted, but it will be trained again
+	 * by the next dump or compaction.
+	 */
+	struct vy_run *dict_run = NULL;
+	rlist_foreach_entry(run, &lsm->runs, in_lsm) {
+		if (run->info.dict != NULL &&
+		    (dict_run == NULL || run->id > dict_run->id))
+			dict_run = run;
+	}
+	if (dict_run != NULL)
+		vy_lsm_set_compression_dict(lsm, dict_run->info.dict);
+
 	/*
 	 * Account ranges to the LSM tree and check that the range tree
 	 * does not have holes or overlaps.
@@ -795,6 +830,15 @@ vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run)
 		env->disk_index_size -= run->count.bytes;
 }
 
+void
+vy_lsm_set_compression_dict(struct vy_lsm *lsm, struct vy_run_dict *dict)
+{
+	if (lsm->compression_dict != NULL)
+		vy_run_dict_unref(lsm->compression_dict);
+	vy_run_dict_ref(dict);
+	lsm->compression_dict = dict;
+}
+
 void
 vy_lsm_add_range(struct vy_lsm *lsm, struct vy_range *range)
 {
@@ -802,6 +846,8 @@ vy_lsm_add_range(struct vy_lsm *lsm, struct vy_range *range)
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_range_tree_insert(&lsm->range_tree, range);
 	lsm->range_count++;
+	if (range->is_hot)
+		lsm->hot_range_count++;
 }
 
 void
@@ -811,6 +857,8 @@ vy_lsm_remove_range(struct vy_lsm *lsm, struct vy_range *range)
 	vy_range_heap_delete(&lsm->range_heap, range);
 	vy_range_tree_remove(&lsm->range_tree, range);
 	lsm->range_count--;
+	if (range->is_hot)
+		lsm->hot_range_count--;
 }
 
 void
@@ -1076,32 +1124,117 @@ vy_lsm_find_range_intersection(struct vy_lsm *lsm,
 	return 0;
 }
 
-bool
-vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
+/**
+ * Update the heat of all ranges of an LSM tree with the reads
+ * accounted since the last update and mark ranges that get much
+ * more reads than on average as hot.
+ */
+static void
+vy_lsm_update_range_heat(struct vy_lsm *lsm)
 {
-	struct tuple_format *key_format = lsm->env->key_format;
+	double total_heat = 0;
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		range->heat = range->heat / 2 + range->recent_reads;
+		range->recent_reads = 0;
+		total_heat += range->heat;
+	}
+	double avg_heat = total_heat / lsm->range_count;
+	lsm->hot_range_count = 0;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		bool is_hot = lsm->range_count > 1 && range->heat > 0 &&
+			      range->heat >= VY_RANGE_HOT_RATIO * avg_heat;
+		if (is_hot != range->is_hot && lsm->opts.cache_hot_ranges)
+			vy_cache_set_hot(&lsm->cache, range->begin,
+					 range->end, is_hot);
+		range->is_hot = is_hot;
+		if (range->is_hot)
+			lsm->hot_range_count++;
+	}
+	lsm->range_reads = 0;
+}
 
-	const char *split_key_raw;
-	if (!vy_range_needs_split(range, vy_lsm_range_size(lsm),
-				  &split_key_raw))
+void
+vy_lsm_acct_range_read(struct vy_lsm *lsm, struct vy_range *range,
+		       bool is_scan)
+{
+	if (is_scan)
+		range->scan++;
+	else
+		range->lookup++;
+	range->recent_reads++;
+	if (++lsm->range_reads >= MAX(VY_RANGE_HEAT_READS_MIN,
+				      VY_RANGE_HEAT_READS_PER_RANGE *
+				      lsm->range_count))
+		vy_lsm_update_range_heat(lsm);
+}
+
+void
+vy_lsm_acct_lookup(struct vy_lsm *lsm, struct tuple *stmt)
+{
+	struct vy_entry key;
+	key.stmt = stmt;
+	key.hint = vy_stmt_hint(stmt, lsm->cmp_def);
+	struct vy_range *range = vy_range_tree_find_by_key(&lsm->range_tree,
+							   ITER_EQ, key);
+	vy_lsm_acct_range_read(lsm, range, false);
+}
+
+void
+vy_lsm_set_cache_hot_ranges(struct vy_lsm *lsm, bool value)
+{
+	if (lsm->opts.cache_hot_ranges == value)
+		return;
+	lsm->opts.cache_hot_ranges = value;
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		if (range->is_hot)
+			vy_cache_set_hot(&lsm->cache, range->begin,
+					 range->end, value);
+	}
+}
+
+bool
+vy_lsm_key_is_cache_hot(struct vy_lsm *lsm, struct vy_entry key)
+{
+	if (!lsm->opts.cache_hot_ranges)
 		return false;
+	struct vy_range *range = vy_range_tree_find_by_key(&lsm->range_tree,
+							   ITER_EQ, key);
+	return range->is_hot;
+}
+
+/**
+ * Split a range in n_keys + 1 parts by the given keys, which must
+ * be in ascending order and lie strictly inside the range.
+ */
+static int
+vy_lsm_split_range_by_keys(struct vy_lsm *lsm, struct vy_range *range,
+			   const char **split_keys_raw, int n_keys)
+{
+	struct tuple_format *key_format = lsm->env->key_format;
 
-	/* Split a range in two parts. */
-	const int n_parts = 2;
-	struct vy_range *parts[2] = { NULL, NULL };
+	assert(n_keys > 0 && n_keys <= VY_RANGE_SUBCOMPACTION_MAX);
+	const int n_parts = n_keys + 1;
+	struct vy_range *parts[VY_RANGE_SUBCOMPACTION_MAX + 1];
+	memset(parts, 0, sizeof(parts));
 	/*
 	 * Determine new ranges' boundaries.
 	 */
-	struct vy_entry split_key;
-	split_key = vy_entry_key_from_msgpack(key_format, lsm->cmp_def,
-					      split_key_raw);
-	if (split_key.stmt == NULL)
-		goto fail;
-
-	struct vy_entry keys[3];
+	struct vy_entry keys[VY_RANGE_SUBCOMPACTION_MAX + 2];
+	memset(keys, 0, sizeof(keys));
 	keys[0] = range->begin;
-	keys[1] = split_key;
-	keys[2] = range->end;
+	keys[n_parts] = range->end;
+	for (int i = 0; i < n_keys; i++) {
+		keys[i + 1] = vy_entry_key_from_msgpack(key_format,
+							lsm->cmp_def,
+							split_keys_raw[i]);
+		if (keys[i + 1].stmt == NULL)
+			goto fail;
+	}
 
 	/*
 	 * Allocate new ranges and create slices of
@@ -1129,6 +1262,9 @@ vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 				vy_range_add_slice(part, new_slice);
 		}
 		part->needs_compaction = range->needs_compaction;
+		/* The parts are as hot as the range they were split from. */
+		part->heat = range->heat;
+		part->is_hot = range->is_hot;
 		vy_range_update_compaction_priority(part, &lsm->opts);
 		vy_range_update_dumps_per_compaction(part);
 	}
@@ -1166,26 +1302,65 @@ vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 	}
 	lsm->range_tree_version++;
 
-	say_info("%s: split range %s by key %s", vy_lsm_name(lsm),
-		 vy_range_str(range), tuple_str(split_key.stmt));
+	if (n_keys == 1) {
+		say_info("%s: split range %s by key %s", vy_lsm_name(lsm),
+			 vy_range_str(range), tuple_str(keys[1].stmt));
+	} else {
+		say_info("%s: split range %s in %d parts", vy_lsm_name(lsm),
+			 vy_range_str(range), n_parts);
+	}
 
 	rlist_foreach_entry(slice, &range->slices, in_range)
 		vy_slice_wait_pinned(slice);
 	vy_range_delete(range);
-	tuple_unref(split_key.stmt);
-	return true;
+	for (int i = 1; i < n_parts; i++)
+		tuple_unref(keys[i].stmt);
+	return 0;
 fail:
 	for (int i = 0; i < n_parts; i++) {
 		if (parts[i] != NULL)
 			vy_range_delete(parts[i]);
 	}
-	if (split_key.stmt != NULL)
-		tuple_unref(split_key.stmt);
+	for (int i = 1; i < n_parts; i++) {
+		if (keys[i].stmt != NULL)
+			tuple_unref(keys[i].stmt);
+	}
+	return -1;
+}
 
-	diag_log();
-	say_error("%s: failed to split range %s",
-		  vy_lsm_name(lsm), vy_range_str(range));
-	return false;
+bool
+vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
+{
+	const char *split_key_raw;
+	if (!vy_range_needs_split(range, vy_lsm_range_size(lsm),
+				  &split_key_raw))
+		return false;
+	if (vy_lsm_split_range_by_keys(lsm, range, &split_key_raw, 1) != 0) {
+		diag_log();
+		say_error("%s: failed to split range %s",
+			  vy_lsm_name(lsm), vy_range_str(range));
+		return false;
+	}
+	return true;
+}
+
+bool
+vy_lsm_split_range_for_compaction(struct vy_lsm *lsm, struct vy_range *range)
+{
+	const char *split_keys_raw[VY_RANGE_SUBCOMPACTION_MAX];
+	int n_keys = vy_range_needs_subcompaction(range,
+						  vy_lsm_range_size(lsm),
+						  split_keys_raw);
+	if (n_keys == 0)
+		return false;
+	if (vy_lsm_split_range_by_keys(lsm, range, split_keys_raw,
+				       n_keys) != 0) {
+		diag_log();
+		say_error("%s: failed to split range %s for compaction",
+			  vy_lsm_name(lsm), vy_range_str(range));
+		return false;
+	}
+	return true;
 }
 
 bool
@@ -1240,6 +1415,10 @@ vy_lsm_coalesce_range(struct vy_lsm *lsm, struct vy_range *range)
 		vy_disk_stmt_counter_add(&result->count, &it->count);
 		if (it->needs_compaction)
 			result->needs_compaction = true;
+		result->heat += it->heat;
+		result->recent_reads += it->recent_reads;
+		if (it->is_hot)
+			result->is_hot = true;
 		vy_range_delete(it);
 		it = next;
 	}
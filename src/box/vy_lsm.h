@@ -59,6 +59,7 @@ struct vy_mem;
 struct vy_mem_env;
 struct vy_recovery;
 struct vy_run;
+struct vy_run_dict;
 struct vy_run_env;
 
 typedef void
@@ -246,6 +247,10 @@ struct vy_lsm {
 	vy_range_tree_t range_tree;
 	/** Number of ranges in this LSM tree. */
 	int range_count;
+	/** Number of hot ranges in this LSM tree, see vy_range::is_hot. */
+	int hot_range_count;
+	/** Number of range reads since the last heat update. */
+	int64_t range_reads;
 	/** Sum dumps_per_compaction across all ranges. */
 	int sum_dumps_per_compaction;
 	/** Heap of ranges, prioritized by compaction_priority. */
@@ -266,6 +271,11 @@ struct vy_lsm {
 	size_t bloom_size;
 	/** Size of memory used for page index. */
 	size_t page_index_size;
+	/**
+	 * Dictionary used for compressing new runs or NULL.
+	 * Maintained only if the compression_dict option is set.
+	 */
+	struct vy_run_dict *compression_dict;
 	/**
 	 * Incremented for each change of the mem list,
 	 * to invalidate iterators.
@@ -371,6 +381,28 @@ vy_lsm_is_being_constructed(struct vy_lsm *lsm)
 	return lsm->commit_lsn < 0;
 }
 
+/**
+ * Return true if the LSM tree is a covering secondary index, i.e.
+ * stores full tuples and so can be read without primary index
+ * lookups.
+ */
+static inline bool
+vy_lsm_is_covering(struct vy_lsm *lsm)
+{
+	return lsm->index_id > 0 && lsm->opts.covering;
+}
+
+/**
+ * Return true if tuples and pages of a range should be given
+ * priority in the cache, because the range is hot and the index
+ * has the cache_hot_ranges option set.
+ */
+static inline bool
+vy_lsm_range_is_cache_hot(struct vy_lsm *lsm, struct vy_range *range)
+{
+	return lsm->opts.cache_hot_ranges && range->is_hot;
+}
+
 /**
  * Return the averange number of dumps it takes to trigger major
  * compaction of a range in this LSM tree.
@@ -478,6 +510,13 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run);
 void
 vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run);
 
+/**
+ * Set the dictionary used for compressing new runs of an LSM tree.
+ * The LSM tree takes a reference to the dictionary.
+ */
+void
+vy_lsm_set_compression_dict(struct vy_lsm *lsm, struct vy_run_dict *dict);
+
 /**
  * Add a range to both the range tree and the range heap
  * of an LSM tree.
@@ -513,6 +552,41 @@ vy_lsm_acct_range(struct vy_lsm *lsm, struct vy_range *range);
 void
 vy_lsm_unacct_range(struct vy_lsm *lsm, struct vy_range *range);
 
+/**
+ * Account a user read that fell in a range of an LSM tree.
+ * A point lookup is accounted once, a scan is accounted once
+ * per each range it visits.
+ *
+ * Every now and then this function also updates the heat of all
+ * ranges of the LSM tree and marks ranges that get much more
+ * reads than on average as hot.
+ */
+void
+vy_lsm_acct_range_read(struct vy_lsm *lsm, struct vy_range *range,
+		       bool is_scan);
+
+/**
+ * Account a user point lookup of the given key or tuple in
+ * the range statistics of an LSM tree.
+ */
+void
+vy_lsm_acct_lookup(struct vy_lsm *lsm, struct tuple *stmt);
+
+/**
+ * Update the cache_hot_ranges option of an LSM tree and move
+ * cached tuples of hot ranges between the cache LRU lists
+ * accordingly.
+ */
+void
+vy_lsm_set_cache_hot_ranges(struct vy_lsm *lsm, bool value);
+
+/**
+ * Return true if the range the given key falls in should be given
+ * priority in the cache, see vy_lsm_range_is_cache_hot().
+ */
+bool
+vy_lsm_key_is_cache_hot(struct vy_lsm *lsm, struct vy_entry key);
+
 /**
  * Account dump in LSM tree statistics.
  */
@@ -586,6 +660,16 @@ vy_lsm_find_range_intersection(struct vy_lsm *lsm,
 bool
 vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range);
 
+/**
+ * Split a range scheduled for compaction in parts of about the
+ * target range size if it is much bigger, return true if the range
+ * was split. The parts are then compacted in parallel by different
+ * worker threads, producing consecutive runs. Splitting is done in
+ * the same way as by vy_lsm_split_range().
+ */
+bool
+vy_lsm_split_range_for_compaction(struct vy_lsm *lsm, struct vy_range *range);
+
 /**
  * Coalesce a range with one or more its neighbors if it is too small,
  * return true if the range was coalesced. We coalesce ranges by
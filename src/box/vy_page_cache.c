@@ -0,0 +1,297 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "vy_page_cache.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "trivia/util.h"
+#include "vy_run.h"
+
+enum {
+	/** Min number of entries the 'ghost' queue may hold. */
+	VY_PAGE_CACHE_GHOST_COUNT_MIN = 64,
+};
+
+/** Cache entry. */
+struct vy_page_cache_entry {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
+	/** Page number in the run. */
+	uint32_t page_no;
+	/** Cached page or NULL if the entry is in the 'ghost' queue. */
+	struct vy_page *page;
+	/** Size of memory occupied by the page. */
+	size_t size;
+	/** Set if the entry is in the 'hot' queue. */
+	bool is_hot;
+	/** Link in one of the cache queues. */
+	struct rlist in_queue;
+	/** Link in vy_run::cached_pages. Unused for 'ghost' entries. */
+	struct rlist in_run;
+};
+
+/** Key of the page cache hash. */
+struct vy_page_cache_key {
+	int64_t run_id;
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = ((uint64_t)run_id << 32) ^ page_no;
+	h *= 0x9e3779b97f4a7c15ULL;
+	return h >> 32;
+}
+
+#define MH_SOURCE 1
+#define mh_name _vy_page_cache
+#define mh_key_t const struct vy_page_cache_key *
+#define mh_node_t struct vy_page_cache_entry *
+#define mh_arg_t void *
+#define mh_hash(a, arg) vy_page_cache_hash((*(a))->run_id, (*(a))->page_no)
+#define mh_hash_key(a, arg) vy_page_cache_hash((a)->run_id, (a)->page_no)
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->page_no != (*(b))->page_no)
+#include "salad/mhash.h"
+
+/** Size of memory occupied by a page. */
+static inline size_t
+vy_page_size(struct vy_page *page)
+{
+	return sizeof(*page) + page->row_count * sizeof(uint32_t) +
+	       page->unpacked_size;
+}
+
+void
+vy_page_cache_create(struct vy_page_cache *cache,
+		     struct slab_cache *slab_cache)
+{
+	cache->hash = mh_vy_page_cache_new();
+	rlist_create(&cache->in);
+	rlist_create(&cache->hot);
+	rlist_create(&cache->ghost);
+	cache->in_size = 0;
+	cache->page_count = 0;
+	cache->ghost_count = 0;
+	cache->mem_used = 0;
+	cache->mem_quota = 0;
+	mempool_create(&cache->entry_pool, slab_cache,
+		       sizeof(struct vy_page_cache_entry));
+	memset(&cache->stat, 0, sizeof(cache->stat));
+}
+
+/** Remove an entry from the hash and free it. */
+static void
+vy_page_cache_entry_delete(struct vy_page_cache *cache,
+			   struct vy_page_cache_entry *entry)
+{
+	struct vy_page_cache_key key = {
+		.run_id = entry->run_id,
+		.page_no = entry->page_no,
+	};
+	mh_int_t k = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	assert(k != mh_end(cache->hash));
+	mh_vy_page_cache_del(cache->hash, k, NULL);
+	rlist_del_entry(entry, in_queue);
+	if (entry->page == NULL) {
+		assert(cache->ghost_count > 0);
+		cache->ghost_count--;
+	} else {
+		rlist_del_entry(entry, in_run);
+		if (!entry->is_hot)
+			cache->in_size -= entry->size;
+		cache->mem_used -= entry->size;
+		cache->page_count--;
+		vy_page_unref(entry->page);
+	}
+	mempool_free(&cache->entry_pool, entry);
+}
+
+/**
+ * Free the page of an entry evicted from the 'in' queue and move
+ * the entry to the 'ghost' queue.
+ */
+static void
+vy_page_cache_entry_make_ghost(struct vy_page_cache *cache,
+			       struct vy_page_cache_entry *entry)
+{
+	assert(entry->page != NULL && !entry->is_hot);
+	rlist_del_entry(entry, in_run);
+	rlist_del_entry(entry, in_queue);
+	cache->in_size -= entry->size;
+	cache->mem_used -= entry->size;
+	cache->page_count--;
+	vy_page_unref(entry->page);
+	entry->page = NULL;
+	entry->size = 0;
+	rlist_add_entry(&cache->ghost, entry, in_queue);
+	cache->ghost_count++;
+	/* The 'ghost' queue remembers half as many pages as cached. */
+	uint32_t ghost_count_max = MAX(cache->page_count / 2,
+				       (uint32_t)VY_PAGE_CACHE_GHOST_COUNT_MIN);
+	while (cache->ghost_count > ghost_count_max) {
+		entry = rlist_last_entry(&cache->ghost,
+					 struct vy_page_cache_entry, in_queue);
+		vy_page_cache_entry_delete(cache, entry);
+	}
+}
+
+/** Evict pages until the cache fits in the quota. */
+static void
+vy_page_cache_gc(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		struct vy_page_cache_entry *entry;
+		if (cache->in_size > cache->mem_quota / 4 ||
+		    rlist_empty(&cache->hot)) {
+			assert(!rlist_empty(&cache->in));
+			entry = rlist_last_entry(&cache->in,
+						 struct vy_page_cache_entry,
+						 in_queue);
+			vy_page_cache_entry_make_ghost(cache, entry);
+		} else {
+			entry = rlist_last_entry(&cache->hot,
+						 struct vy_page_cache_entry,
+						 in_queue);
+			vy_page_cache_entry_delete(cache, entry);
+		}
+		cache->stat.evict++;
+	}
+	if (cache->mem_quota == 0) {
+		/* Forget everything if the cache is disabled. */
+		while (!rlist_empty(&cache->ghost)) {
+			struct vy_page_cache_entry *entry = rlist_first_entry(
+				&cache->ghost, struct vy_page_cache_entry,
+				in_queue);
+			vy_page_cache_entry_delete(cache, entry);
+		}
+	}
+}
+
+void
+vy_page_cache_destroy(struct vy_page_cache *cache)
+{
+	cache->mem_quota = 0;
+	vy_page_cache_gc(cache);
+	assert(cache->mem_used == 0);
+	assert(mh_size(cache->hash) == 0);
+	mh_vy_page_cache_delete(cache->hash);
+	mempool_destroy(&cache->entry_pool);
+}
+
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota)
+{
+	cache->mem_quota = quota;
+	vy_page_cache_gc(cache);
+}
+
+/** Find a cache entry, including a 'ghost' one. */
+static struct vy_page_cache_entry *
+vy_page_cache_find(struct vy_page_cache *cache, struct vy_run *run,
+		   uint32_t page_no)
+{
+	struct vy_page_cache_key key = {
+		.run_id = run->id,
+		.page_no = page_no,
+	};
+	mh_int_t k = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	if (k == mh_end(cache->hash))
+		return NULL;
+	return *mh_vy_page_cache_node(cache->hash, k);
+}
+
+struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, struct vy_run *run,
+		  uint32_t page_no, bool is_hot)
+{
+	if (cache->mem_quota == 0)
+		return NULL;
+	struct vy_page_cache_entry *entry = vy_page_cache_find(cache, run,
+							       page_no);
+	if (entry == NULL || entry->page == NULL) {
+		cache->stat.miss++;
+		return NULL;
+	}
+	if (is_hot && !entry->is_hot) {
+		/* The page belongs to a hot range, promote it. */
+		cache->in_size -= entry->size;
+		entry->is_hot = true;
+	}
+	/* Pages in the 'in' queue are evicted in FIFO order. */
+	if (entry->is_hot)
+		rlist_move_entry(&cache->hot, entry, in_queue);
+	cache->stat.hit++;
+	return entry->page;
+}
+
+bool
+vy_page_cache_has(struct vy_page_cache *cache, struct vy_run *run,
+		  uint32_t page_no)
+{
+	if (cache->mem_quota == 0)
+		return false;
+	struct vy_page_cache_entry *entry = vy_page_cache_find(cache, run,
+							       page_no);
+	return entry != NULL && entry->page != NULL;
+}
+
+void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_run *run,
+		  struct vy_page *page, bool is_hot)
+{
+	size_t size = vy_page_size(page);
+	if (size > cache->mem_quota)
+		return;
+	struct vy_page_cache_entry *entry = vy_page_cache_find(cache, run,
+							       page->page_no);
+	if (entry != NULL && entry->page != NULL) {
+		/* Read by another fiber while we were reading it. */
+		return;
+	}
+	if (entry != NULL) {
+		/* A recently evicted page is read again, it's hot. */
+		rlist_del_entry(entry, in_queue);
+		cache->ghost_count--;
+		entry->is_hot = true;
+		rlist_add_entry(&cache->hot, entry, in_queue);
+	} else {
+		entry = mempool_alloc(&cache->entry_pool);
+		if (entry == NULL)
+			return;
+		entry->run_id = run->id;
+		entry->page_no = page->page_no;
+		entry->is_hot = is_hot;
+		mh_vy_page_cache_put(cache->hash, &entry, NULL, NULL);
+		if (is_hot) {
+			rlist_add_entry(&cache->hot, entry, in_queue);
+		} else {
+			rlist_add_entry(&cache->in, entry, in_queue);
+			cache->in_size += size;
+		}
+	}
+	entry->page = page;
+	entry->size = size;
+	vy_page_ref(page);
+	rlist_add_entry(&run->cached_pages, entry, in_run);
+	cache->page_count++;
+	cache->mem_used += size;
+	vy_page_cache_gc(cache);
+}
+
+void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache,
+			     struct vy_run *run)
+{
+	struct vy_page_cache_entry *entry, *next;
+	rlist_foreach_entry_safe(entry, &run->cached_pages, in_run, next)
+		vy_page_cache_entry_delete(cache, entry);
+}
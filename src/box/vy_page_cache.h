@@ -0,0 +1,125 @@
+#pragma once
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <small/mempool.h>
+#include <small/rlist.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct vy_page;
+struct vy_run;
+struct mh_vy_page_cache_t;
+
+/** Page cache statistics, reported by box.stat.vinyl(). */
+struct vy_page_cache_stat {
+	/** Number of lookups that found the page in the cache. */
+	int64_t hit;
+	/** Number of lookups that had to read the page from disk. */
+	int64_t miss;
+	/** Number of pages evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Cache of decompressed run pages shared by all LSM trees.
+ *
+ * Pages are evicted according to the 2Q algorithm: a page read for
+ * the first time is put to the FIFO queue 'in'. When evicted from
+ * it, the page is freed, but its key is remembered in the 'ghost'
+ * queue. If a page is read again while its key is in the 'ghost'
+ * queue, it is put to the LRU queue 'hot'. Pages are evicted from
+ * the 'in' queue while it is bigger than a quarter of the cache
+ * and from the 'hot' queue otherwise, so a long scan can't push
+ * out pages that are accessed over and over again. Pages of hot
+ * ranges (see vy_range::is_hot) may be put to the 'hot' queue
+ * right away.
+ *
+ * The cache is used only by the tx thread.
+ */
+struct vy_page_cache {
+	/** Map (run id, page no) -> struct vy_page_cache_entry. */
+	struct mh_vy_page_cache_t *hash;
+	/** Pages read once, the first element is the newest. */
+	struct rlist in;
+	/** Pages read more than once, the first element is the newest. */
+	struct rlist hot;
+	/** Keys of pages recently evicted from 'in', newest first. */
+	struct rlist ghost;
+	/** Size of memory occupied by pages stored in 'in'. */
+	size_t in_size;
+	/** Number of pages stored in the cache. */
+	uint32_t page_count;
+	/** Number of entries stored in 'ghost'. */
+	uint32_t ghost_count;
+	/** Size of memory occupied by cached pages. */
+	size_t mem_used;
+	/** Max memory size that can be used for cache. */
+	size_t mem_quota;
+	/** Mempool for struct vy_page_cache_entry. */
+	struct mempool entry_pool;
+	/** Cache statistics. */
+	struct vy_page_cache_stat stat;
+};
+
+/** Initialize an empty page cache. The cache is disabled. */
+void
+vy_page_cache_create(struct vy_page_cache *cache,
+		     struct slab_cache *slab_cache);
+
+/** Free all cached pages and destroy the cache. */
+void
+vy_page_cache_destroy(struct vy_page_cache *cache);
+
+/**
+ * Set memory limit for the cache and evict pages that don't fit
+ * in it. Zero limit disables the cache.
+ */
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota);
+
+/**
+ * Look up a page of a run in the cache. Returns NULL if the page
+ * isn't cached. The caller must reference the returned page if it
+ * wants to use it after yield. If @is_hot is set, the page is
+ * moved to the 'hot' queue.
+ */
+struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, struct vy_run *run,
+		  uint32_t page_no, bool is_hot);
+
+/**
+ * Add a page just read from disk to the cache. The cache takes a
+ * reference to the page. The page isn't cached if there isn't
+ * enough memory for it. If @is_hot is set, the page is put to
+ * the 'hot' queue.
+ */
+void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_run *run,
+		  struct vy_page *page, bool is_hot);
+
+/**
+ * Return true if a page of a run is in the cache. Unlike
+ * vy_page_cache_get(), doesn't update the cache statistics
+ * and eviction queues.
+ */
+bool
+vy_page_cache_has(struct vy_page_cache *cache, struct vy_run *run,
+		  uint32_t page_no);
+
+/** Drop all pages of a run from the cache. */
+void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache,
+			     struct vy_run *run);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -134,7 +134,7 @@ vy_point_lookup_scan_mems(struct vy_lsm *lsm, const struct vy_read_view **rv,
 static int
 vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 			   const struct vy_read_view **rv, struct vy_entry key,
-			   struct vy_history *history)
+			   bool is_hot, struct vy_history *history)
 {
 	/*
 	 * The format of the statement must be exactly the space
@@ -145,6 +145,7 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	vy_run_iterator_open(&run_itr, &lsm->stat.disk.iterator, slice,
 			     ITER_EQ, key, rv, lsm->cmp_def, lsm->key_def,
 			     lsm->disk_format);
+	run_itr.is_hot = is_hot;
 	struct vy_history slice_history;
 	vy_history_create(&slice_history, &lsm->env->history_node_pool);
 	int rc = vy_run_iterator_next(&run_itr, &slice_history);
@@ -166,6 +167,7 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	struct vy_range *range = vy_range_tree_find_by_key(&lsm->range_tree,
 							   ITER_EQ, key);
 	assert(range != NULL);
+	bool is_hot = vy_lsm_range_is_cache_hot(lsm, range);
 	int slice_count = range->slice_count;
 	size_t size;
 	struct vy_slice **slices =
@@ -185,8 +187,8 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	int rc = 0;
 	for (i = 0; i < slice_count; i++) {
 		if (rc == 0 && !vy_history_is_terminal(history))
-			rc = vy_point_lookup_scan_slice(lsm, slices[i],
-							rv, key, history);
+			rc = vy_point_lookup_scan_slice(lsm, slices[i], rv,
+							key, is_hot, history);
 		vy_slice_unpin(slices[i]);
 	}
 	return rc;
@@ -280,6 +280,12 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * compaction is relatively cheap, because of the level size
  * ratio.
  *
+ * The leveled compaction policy limits the number of runs at each
+ * level to one, which bounds space amplification at the cost of
+ * rewriting data more often. The lazy policy doesn't limit the last
+ * level to one run, which suits bulk loads that rarely overwrite
+ * data.
+ *
  * Given a range, this function computes the maximal level that needs
  * to be compacted and sets @compaction_priority to the number of runs
  * in this level and all preceding levels.
@@ -398,9 +404,14 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		 * this function is called on every memory dump and
 		 * scans all LSM tree levels. Instead we use the
 		 * value of rand() from the slice creation time.
+		 *
+		 * The leveled policy keeps exactly one run per level,
+		 * so it isn't randomized.
 		 */
 		uint32_t max_run_count = opts->run_count_per_level;
-		if (slice->seed < RAND_MAX / 10)
+		if (opts->compaction_policy == COMPACTION_POLICY_LEVELED)
+			max_run_count = 1;
+		else if (slice->seed < RAND_MAX / 10)
 			max_run_count++;
 		if (level_run_count > max_run_count) {
 			/*
@@ -415,10 +426,13 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		}
 	}
 
-	if (level_run_count > 1) {
+	if (level_run_count > 1 &&
+	    opts->compaction_policy != COMPACTION_POLICY_LAZY) {
 		/*
 		 * Do not store more than one run at the last level
-		 * to keep space amplification low.
+		 * to keep space amplification low. The lazy policy
+		 * trades space for fewer rewrites of the last level,
+		 * which is the biggest one.
 		 */
 		range->compaction_priority = total_run_count;
 		range->compaction_queue = total_stmt_count;
@@ -515,6 +529,68 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	return true;
 }
 
+int
+vy_range_needs_subcompaction(struct vy_range *range, int64_t range_size,
+			     const char **split_keys)
+{
+	int64_t size = range->compaction_queue.bytes;
+	if (size < range_size * 2)
+		return 0;
+	/* Don't make parts smaller than the target range size. */
+	int n_parts = MIN(size / range_size,
+			  (int64_t)VY_RANGE_SUBCOMPACTION_MAX);
+
+	/*
+	 * Take split keys from the page index of the biggest
+	 * run so that the parts are of about the same size.
+	 */
+	struct vy_slice *slice, *biggest = NULL;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		if (biggest == NULL ||
+		    slice->count.bytes > biggest->count.bytes)
+			biggest = slice;
+	}
+	assert(biggest != NULL);
+	slice = biggest;
+	uint32_t page_count = slice->last_page_no - slice->first_page_no + 1;
+	if (slice->count.pages == 0 || page_count < (uint32_t)n_parts)
+		return 0;
+
+	struct key_def *cmp_def = range->cmp_def;
+	struct vy_page_info *prev = vy_run_page_info(slice->run,
+						     slice->first_page_no);
+	int n_keys = 0;
+	for (int i = 1; i < n_parts; i++) {
+		struct vy_page_info *page = vy_run_page_info(slice->run,
+				slice->first_page_no +
+				(uint64_t)page_count * i / n_parts);
+		/* Split keys must be strictly ascending. */
+		if (key_compare(prev->min_key, prev->min_key_hint,
+				page->min_key, page->min_key_hint,
+				cmp_def) >= 0)
+			continue;
+		/* See the comment in vy_range_needs_split(). */
+		if (slice->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(slice->begin, page->min_key,
+						  page->min_key_hint,
+						  cmp_def) >= 0)
+			continue;
+		if (range->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(range->begin, page->min_key,
+						  page->min_key_hint,
+						  cmp_def) >= 0)
+			continue;
+		if (range->end.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(range->end, page->min_key,
+						  page->min_key_hint,
+						  cmp_def) <= 0)
+			break;
+		split_keys[n_keys++] = page->min_key;
+		prev = page;
+	}
+	return n_keys;
+}
+
 /**
  * Check if a range should be coalesced with one or more its neighbors.
  * If it should, return true and set @p_first and @p_last to the first
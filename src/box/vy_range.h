@@ -119,6 +119,22 @@ struct vy_range {
 	bool needs_compaction;
 	/** Number of times the range was compacted. */
 	int n_compactions;
+	/** Number of point lookups that fell in this range. */
+	int64_t lookup;
+	/** Number of times a range scan entered this range. */
+	int64_t scan;
+	/** Number of reads since the last heat update. */
+	int64_t recent_reads;
+	/**
+	 * Exponentially decaying number of reads that fell in
+	 * this range, see vy_lsm_acct_range_read().
+	 */
+	double heat;
+	/**
+	 * Set if the range gets much more reads than an average
+	 * range of the same LSM tree.
+	 */
+	bool is_hot;
 	/**
 	 * Number of dumps it takes to trigger major compaction in
 	 * this range, see vy_run::dump_count for more details.
@@ -266,6 +282,28 @@ bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
 		     const char **p_split_key);
 
+/** Max number of parts a range can be split in for compaction. */
+enum { VY_RANGE_SUBCOMPACTION_MAX = 16 };
+
+/**
+ * Check if a range scheduled for compaction is big enough to be
+ * split in several parts compacted in parallel, i.e. if it is at
+ * least twice as big as the target range size. The parts are
+ * about the target range size each.
+ *
+ * @param range             The range.
+ * @param range_size        Target range size.
+ * @param[out] split_keys   Keys to split the range by, in
+ *                          ascending order. Must have room for
+ *                          VY_RANGE_SUBCOMPACTION_MAX - 1 keys.
+ *
+ * @return                  Number of split keys, 0 if the range
+ *                          shouldn't be split.
+ */
+int
+vy_range_needs_subcompaction(struct vy_range *range, int64_t range_size,
+			     const char **split_keys);
+
 /**
  * Check if a range needs to be coalesced with adjacent
  * ranges in a range tree.
@@ -651,6 +651,13 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 					    itr->iterator_type : ITER_LE);
 	struct vy_lsm *lsm = itr->lsm;
 	struct vy_slice *slice;
+	if (itr->acct_range_reads &&
+	    itr->curr_range->id != itr->last_acct_range_id) {
+		/* Don't account the range again on restore. */
+		vy_lsm_acct_range_read(lsm, itr->curr_range, true);
+		itr->last_acct_range_id = itr->curr_range->id;
+	}
+	bool is_hot = vy_lsm_range_is_cache_hot(lsm, itr->curr_range);
 	/*
 	 * The format of the statement must be exactly the space
 	 * format with the same identifier to fully match the
@@ -663,6 +670,7 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 				     iterator_type, itr->key,
 				     itr->read_view, lsm->cmp_def,
 				     lsm->key_def, lsm->disk_format);
+		sub_src->run_iterator.is_hot = is_hot;
 	}
 }
 
@@ -718,6 +726,7 @@ vy_read_iterator_open(struct vy_read_iterator *itr, struct vy_lsm *lsm,
 	itr->read_view = rv;
 	itr->last = vy_entry_none();
 	itr->last_cached = vy_entry_none();
+	itr->last_acct_range_id = -1;
 
 	if (vy_stmt_is_empty_key(key.stmt)) {
 		/*
@@ -933,8 +942,16 @@ vy_read_iterator_cache_add(struct vy_read_iterator *itr, struct vy_entry entry)
 		itr->last_cached = vy_entry_none();
 		return;
 	}
+	/*
+	 * The current range may have been split or coalesced
+	 * while the caller was reading the primary index.
+	 */
+	bool is_hot = itr->curr_range != NULL &&
+		      itr->range_tree_version ==
+				itr->lsm->range_tree_version &&
+		      vy_lsm_range_is_cache_hot(itr->lsm, itr->curr_range);
 	vy_cache_add(&itr->lsm->cache, entry, itr->last_cached,
-		     itr->key, itr->iterator_type);
+		     itr->key, itr->iterator_type, is_hot);
 	if (entry.stmt != NULL)
 		tuple_ref(entry.stmt);
 	if (itr->last_cached.stmt != NULL)
@@ -87,6 +87,13 @@ struct vy_read_iterator {
 	uint32_t range_version;
 	/** Range the iterator is currently positioned at. */
 	struct vy_range *curr_range;
+	/**
+	 * Set if the iterator serves a user request and so should
+	 * account reads in range statistics.
+	 */
+	bool acct_range_reads;
+	/** ID of the last range accounted by the iterator. */
+	int64_t last_acct_range_id;
 	/**
 	 * Array of merge sources. Sources are sorted by age.
 	 * In particular, this means that all mutable sources
@@ -43,6 +43,7 @@
 #include "trivia/util.h"
 
 #include "vy_quota.h"
+#include "vy_scheduler.h"
 #include "vy_stat.h"
 
 /**
@@ -83,6 +84,52 @@ static const size_t VY_DUMP_SIZE_ACCT_MIN = 1024 * 1024;
  */
 static const int VY_RECENT_DUMP_COUNT = 100;
 
+/**
+ * Weight of the last observation in the compaction utilization
+ * moving average. Utilization is sampled every second so it
+ * takes about 10 seconds for it to adapt to a workload change.
+ */
+static const double VY_COMPACTION_UTILIZATION_WEIGHT = 0.2;
+
+/**
+ * Time, in seconds, it may take compaction to pay off its debt
+ * before the adaptive regulator starts lowering the rate limit.
+ */
+static const double VY_REGULATOR_STALL_TARGET = 30;
+
+/**
+ * Max value of the adaptive regulator error. Limits the impact
+ * of a sudden debt spike, e.g. after a huge dump.
+ */
+static const double VY_REGULATOR_STALL_ERROR_MAX = 4;
+
+/**
+ * Proportional and integral gains of the adaptive regulator.
+ */
+static const double VY_REGULATOR_GAIN_P = 0.5;
+static const double VY_REGULATOR_GAIN_I = 0.05;
+
+/**
+ * Min and max ratio of the rate limit set by the adaptive
+ * regulator to the one set by the static regulator. The max
+ * ratio is applied only if compaction threads are idle most
+ * of the time and lifts the 0.75 safety margin of the static
+ * regulator, see vy_regulator_update_rate_limit().
+ */
+static const double VY_REGULATOR_RATE_RATIO_MIN = 0.1;
+static const double VY_REGULATOR_RATE_RATIO_MAX = 1 / 0.75;
+
+/**
+ * Compaction utilization below which compaction threads are
+ * considered mostly idle.
+ */
+static const double VY_COMPACTION_UTILIZATION_LOW = 0.5;
+
+const char *vy_regulator_mode_strs[] = {
+	/* [VY_REGULATOR_STATIC]   = */ "static",
+	/* [VY_REGULATOR_ADAPTIVE] = */ "adaptive",
+};
+
 static void
 vy_regulator_trigger_dump(struct vy_regulator *regulator)
 {
@@ -189,6 +236,125 @@ vy_regulator_update_dump_watermark(struct vy_regulator *regulator)
 					quota->limit / 2);
 }
 
+/**
+ * Convert a rate calculated as a floating point number to size_t.
+ */
+static size_t
+vy_regulator_rate(double rate)
+{
+	/*
+	 * We can't simply use (size_t)MIN(rate, SIZE_MAX) to cast
+	 * the rate from double to size_t here, because on a 64-bit
+	 * system SIZE_MAX equals 2^64-1, which can't be represented
+	 * as double without loss of precision and hence is rounded
+	 * up to 2^64, which in turn can't be converted back to size_t.
+	 * So we first convert the rate to uint64_t using exp2(64) to
+	 * check if it fits and only then cast the uint64_t to size_t.
+	 */
+	uint64_t rate64;
+	if (rate < exp2(64))
+		rate64 = rate;
+	else
+		rate64 = UINT64_MAX;
+	return MIN(rate64, SIZE_MAX);
+}
+
+/**
+ * Set the rate limit that keeps compaction in pace with dumps.
+ */
+static void
+vy_regulator_set_target_rate(struct vy_regulator *regulator, size_t rate)
+{
+	regulator->target_rate = rate;
+	vy_quota_set_rate_limit(regulator->quota, VY_QUOTA_RESOURCE_DISK,
+				rate);
+}
+
+/*
+ * The static rate limit set by vy_regulator_update_rate_limit()
+ * keeps compaction in pace with dumps on average, but it is only
+ * updated on dump completion and doesn't take into account the
+ * compaction debt, i.e. the amount of data awaiting compaction.
+ * The debt may build up for a long time, e.g. because of a burst
+ * of writes to an LSM tree with a low run_size_ratio, until it
+ * results in a write stall followed by a compaction storm.
+ *
+ * In the adaptive mode, the regulator also runs a feedback
+ * (proportional-integral) controller every second. It predicts
+ * how long it would take compaction to pay off the current debt
+ *
+ *                         compaction_debt
+ *     predicted_stall = --------------------
+ *                       compaction_bandwidth
+ *
+ * and compares it with the target VY_REGULATOR_STALL_TARGET:
+ *
+ *     error = predicted_stall / VY_REGULATOR_STALL_TARGET - 1
+ *
+ * The rate limit is then set to
+ *
+ *     target_rate = base_rate * (1 - Kp * error - Ki * sum(error))
+ *
+ * where base_rate is the static rate limit. So the more debt there
+ * is and the longer it stays above the target, the lower the rate
+ * limit. When there's little debt, the rate limit may go above the
+ * static limit, but only if compaction threads are idle most of the
+ * time, i.e. the disk has spare bandwidth.
+ */
+static void
+vy_regulator_update_target_rate(struct vy_regulator *regulator)
+{
+	int64_t debt = *regulator->compaction_debt;
+	if (regulator->compaction_bandwidth > 0) {
+		regulator->predicted_stall = (double)debt /
+					     regulator->compaction_bandwidth;
+	} else {
+		regulator->predicted_stall = 0;
+	}
+	if (regulator->mode != VY_REGULATOR_ADAPTIVE ||
+	    regulator->base_rate == 0)
+		return;
+
+	double error = regulator->predicted_stall /
+		       VY_REGULATOR_STALL_TARGET - 1;
+	error = MIN(error, VY_REGULATOR_STALL_ERROR_MAX);
+	double integral = regulator->stall_error_integral +
+			  error * VY_REGULATOR_TIMER_PERIOD;
+	double ratio = 1 - VY_REGULATOR_GAIN_P * error -
+			   VY_REGULATOR_GAIN_I * integral;
+	double ratio_max = 1;
+	if (regulator->compaction_utilization < VY_COMPACTION_UTILIZATION_LOW)
+		ratio_max = VY_REGULATOR_RATE_RATIO_MAX;
+	/*
+	 * Don't accumulate the error while the output is saturated,
+	 * otherwise the controller would take long to react when
+	 * the error changes its sign.
+	 */
+	if (ratio >= VY_REGULATOR_RATE_RATIO_MIN && ratio <= ratio_max)
+		regulator->stall_error_integral = integral;
+	ratio = MAX(ratio, VY_REGULATOR_RATE_RATIO_MIN);
+	ratio = MIN(ratio, ratio_max);
+	vy_regulator_set_target_rate(regulator,
+			vy_regulator_rate(regulator->base_rate * ratio));
+}
+
+/**
+ * Sample the number of busy compaction threads and update the
+ * compaction utilization moving average.
+ */
+static void
+vy_regulator_update_compaction_utilization(struct vy_regulator *regulator)
+{
+	const struct vy_worker_pool *pool = regulator->compaction_pool;
+	if (pool->size == 0)
+		return;
+	double utilization = (double)pool->busy_count / pool->size;
+	regulator->compaction_utilization =
+		(1 - VY_COMPACTION_UTILIZATION_WEIGHT) *
+		regulator->compaction_utilization +
+		VY_COMPACTION_UTILIZATION_WEIGHT * utilization;
+}
+
 static void
 vy_regulator_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 {
@@ -198,12 +364,16 @@ vy_regulator_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 	struct vy_regulator *regulator = timer->data;
 
 	vy_regulator_update_write_rate(regulator);
+	vy_regulator_update_compaction_utilization(regulator);
 	vy_regulator_update_dump_watermark(regulator);
+	vy_regulator_update_target_rate(regulator);
 	vy_regulator_check_dump_watermark(regulator);
 }
 
 void
 vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
+		    const int64_t *compaction_debt,
+		    const struct vy_worker_pool *compaction_pool,
 		    vy_trigger_dump_f trigger_dump_cb)
 {
 	enum { KB = 1024, MB = KB * KB };
@@ -224,12 +394,16 @@ vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
 		panic("failed to allocate dump bandwidth histogram");
 
 	regulator->quota = quota;
+	regulator->compaction_debt = compaction_debt;
+	regulator->compaction_pool = compaction_pool;
 	regulator->trigger_dump_cb = trigger_dump_cb;
 	ev_timer_init(&regulator->timer, vy_regulator_timer_cb, 0,
 		      VY_REGULATOR_TIMER_PERIOD);
 	regulator->timer.data = regulator;
 	regulator->dump_bandwidth = VY_DUMP_BANDWIDTH_DEFAULT;
 	regulator->dump_watermark = SIZE_MAX;
+	regulator->target_rate = SIZE_MAX;
+	regulator->mode = VY_REGULATOR_STATIC;
 }
 
 void
@@ -323,6 +497,20 @@ vy_regulator_reset_stat(struct vy_regulator *regulator)
 	       sizeof(regulator->sched_stat_last));
 }
 
+void
+vy_regulator_set_mode(struct vy_regulator *regulator,
+		      enum vy_regulator_mode mode)
+{
+	if (regulator->mode == mode)
+		return;
+	regulator->mode = mode;
+	regulator->stall_error_integral = 0;
+	if (regulator->base_rate > 0) {
+		vy_regulator_set_target_rate(regulator, regulator->base_rate);
+		vy_regulator_update_target_rate(regulator);
+	}
+}
+
 /*
  * The goal of rate limiting is to ensure LSM trees stay close to
  * their perfect shape, as defined by run_size_ratio. When dump rate
@@ -420,6 +608,8 @@ vy_regulator_update_rate_limit(struct vy_regulator *regulator,
 	int32_t dump_count = stat->dump_count - last->dump_count;
 	int64_t dump_input = stat->dump_input - last->dump_input;
 	double compaction_time = stat->compaction_time - last->compaction_time;
+	int64_t compaction_input = stat->compaction_input -
+				   last->compaction_input;
 	*last = *stat;
 
 	if (dump_input < (ssize_t)VY_DUMP_SIZE_ACCT_MIN || compaction_time == 0)
@@ -428,25 +618,19 @@ vy_regulator_update_rate_limit(struct vy_regulator *regulator,
 	recent->dump_count += dump_count;
 	recent->dump_input += dump_input;
 	recent->compaction_time += compaction_time;
+	recent->compaction_input += compaction_input;
+
+	regulator->compaction_bandwidth = vy_regulator_rate(
+			compaction_threads * recent->compaction_input /
+			recent->compaction_time);
 
 	double rate = 0.75 * compaction_threads * recent->dump_input /
 						  recent->compaction_time;
-	/*
-	 * We can't simply use (size_t)MIN(rate, SIZE_MAX) to cast
-	 * the rate from double to size_t here, because on a 64-bit
-	 * system SIZE_MAX equals 2^64-1, which can't be represented
-	 * as double without loss of precision and hence is rounded
-	 * up to 2^64, which in turn can't be converted back to size_t.
-	 * So we first convert the rate to uint64_t using exp2(64) to
-	 * check if it fits and only then cast the uint64_t to size_t.
-	 */
-	uint64_t rate64;
-	if (rate < exp2(64))
-		rate64 = rate;
+	regulator->base_rate = MAX(vy_regulator_rate(rate), 1);
+	if (regulator->mode == VY_REGULATOR_ADAPTIVE)
+		vy_regulator_update_target_rate(regulator);
 	else
-		rate64 = UINT64_MAX;
-	vy_quota_set_rate_limit(regulator->quota, VY_QUOTA_RESOURCE_DISK,
-				(size_t)MIN(rate64, SIZE_MAX));
+		vy_regulator_set_target_rate(regulator, regulator->base_rate);
 
 	/*
 	 * Periodically rotate statistics for quicker adaptation
@@ -456,5 +640,6 @@ vy_regulator_update_rate_limit(struct vy_regulator *regulator,
 		recent->dump_count /= 2;
 		recent->dump_input /= 2;
 		recent->compaction_time /= 2;
+		recent->compaction_input /= 2;
 	}
 }
@@ -33,6 +33,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <tarantool_ev.h>
 
 #include "vy_stat.h"
@@ -44,10 +45,30 @@ extern "C" {
 struct histogram;
 struct vy_quota;
 struct vy_regulator;
+struct vy_worker_pool;
 
 typedef int
 (*vy_trigger_dump_f)(struct vy_regulator *regulator);
 
+/** How the regulator limits the transaction write rate. */
+enum vy_regulator_mode {
+	/**
+	 * The write rate is limited so that compaction keeps up
+	 * with dumps on average, see vy_regulator_update_rate_limit().
+	 */
+	VY_REGULATOR_STATIC,
+	/**
+	 * In addition, a feedback controller adjusts the limit
+	 * every second depending on the accumulated compaction
+	 * debt and compaction thread utilization.
+	 */
+	VY_REGULATOR_ADAPTIVE,
+	vy_regulator_mode_MAX,
+};
+
+/** Names of regulator modes, as used by box.cfg. */
+extern const char *vy_regulator_mode_strs[];
+
 /**
  * The regulator is supposed to keep track of vinyl memory usage
  * and dump/compaction progress and adjust transaction write rate
@@ -124,10 +145,54 @@ struct vy_regulator {
 	 * Used for calculating the rate limit.
 	 */
 	struct vy_scheduler_stat sched_stat_recent;
+	/** Regulator mode. */
+	enum vy_regulator_mode mode;
+	/**
+	 * Pointer to the number of bytes awaiting compaction in
+	 * all LSM trees, i.e. compaction debt.
+	 */
+	const int64_t *compaction_debt;
+	/**
+	 * Pool of compaction threads. Used for sampling compaction
+	 * thread utilization.
+	 */
+	const struct vy_worker_pool *compaction_pool;
+	/**
+	 * Rate at which compaction threads process data, in bytes
+	 * per second. Calculated over the most recent few dumps.
+	 * Zero if there hasn't been enough compaction to tell.
+	 */
+	size_t compaction_bandwidth;
+	/**
+	 * Fraction of compaction threads busy doing compaction,
+	 * sampled every second and averaged over time.
+	 */
+	double compaction_utilization;
+	/**
+	 * Time it would take compaction to pay off the current
+	 * compaction debt, in seconds. If it grows, the database
+	 * is heading for a write stall.
+	 */
+	double predicted_stall;
+	/**
+	 * Rate limit that keeps compaction in pace with dumps on
+	 * average, in bytes per second, or zero if unknown yet.
+	 * See vy_regulator_update_rate_limit().
+	 */
+	size_t base_rate;
+	/**
+	 * Write rate limit currently set by the regulator to keep
+	 * compaction in pace with dumps, in bytes per second.
+	 */
+	size_t target_rate;
+	/** Integral term of the feedback controller. */
+	double stall_error_integral;
 };
 
 void
 vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
+		    const int64_t *compaction_debt,
+		    const struct vy_worker_pool *compaction_pool,
 		    vy_trigger_dump_f trigger_dump_cb);
 
 void
@@ -175,6 +240,13 @@ vy_regulator_reset_dump_bandwidth(struct vy_regulator *regulator, size_t max);
 void
 vy_regulator_reset_stat(struct vy_regulator *regulator);
 
+/**
+ * Switch the regulator to the given mode.
+ */
+void
+vy_regulator_set_mode(struct vy_regulator *regulator,
+		      enum vy_regulator_mode mode);
+
 /**
  * Set transaction rate limit so as to ensure that compaction
  * will keep up with dumps.
@@ -31,6 +31,7 @@
 #include "vy_run.h"
 
 #include <zstd.h>
+#include <zdict.h>
 
 #include "fiber.h"
 #include "fiber_cond.h"
@@ -74,6 +75,23 @@ const char *vy_file_suffix[] = {
 /* sync run and index files very 16 MB */
 #define VY_RUN_SYNC_INTERVAL (1 << 24)
 
+enum {
+	/** Level of zstd compression used with a dictionary. */
+	VY_RUN_DICT_COMPRESSION_LEVEL = 3,
+	/** Max size of a trained compression dictionary. */
+	VY_RUN_DICT_SIZE_MAX = 16 * 1024,
+	/** Don't bother training dictionaries smaller than that. */
+	VY_RUN_DICT_SIZE_MIN = 1024,
+	/**
+	 * Max size of statements sampled to train a dictionary.
+	 * Zstd recommends to train a dictionary on about 100 times
+	 * more data than the dictionary size.
+	 */
+	VY_RUN_DICT_SAMPLES_MAX = 100 * VY_RUN_DICT_SIZE_MAX,
+	/** Sampled data is at least this much bigger than a dictionary. */
+	VY_RUN_DICT_SAMPLES_RATIO_MIN = 16,
+};
+
 /**
  * We read runs in background threads so as not to stall tx.
  * This structure represents such a thread.
@@ -111,6 +129,35 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/**
+ * Cbus message for reading a page ahead of a run iterator.
+ * Unlike vy_page_read_task, it is sent asynchronously: the
+ * iterator waits for it only when it needs the page.
+ */
+struct vy_page_prefetch {
+	/** Message sent to a reader thread and back to tx. */
+	struct cmsg base;
+	/** Route of the message. */
+	struct cmsg_hop route[2];
+	/** Run to read the page from (referenced). */
+	struct vy_run *run;
+	/** Number of the page to read. */
+	uint32_t page_no;
+	/** Buffer for the page, NULL if reading failed. */
+	struct vy_page *page;
+	/** Set by the reader thread if it failed to read the page. */
+	bool is_failed;
+	/** Set when the message returns to tx. */
+	bool is_done;
+	/**
+	 * Set if the iterator doesn't need the page anymore.
+	 * The message is freed as soon as it returns to tx.
+	 */
+	bool is_orphan;
+	/** Signaled when the message returns to tx. */
+	struct fiber_cond done_cond;
+};
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -183,6 +230,9 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	mempool_create(&env->prefetch_pool, cord_slab_cache(),
+		       sizeof(struct vy_page_prefetch));
+	vy_page_cache_create(&env->page_cache, cord_slab_cache());
 	env->initial_join = false;
 }
 
@@ -195,6 +245,8 @@ vy_run_env_destroy(struct vy_run_env *env)
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
 	mempool_destroy(&env->read_task_pool);
+	mempool_destroy(&env->prefetch_pool);
+	vy_page_cache_destroy(&env->page_cache);
 	tt_pthread_key_delete(env->zdctx_key);
 }
 
@@ -209,6 +261,18 @@ vy_run_env_enable_coio(struct vy_run_env *env)
 	vy_run_env_start_readers(env);
 }
 
+/**
+ * Pick a reader thread to process the next read request.
+ */
+static struct vy_run_reader *
+vy_run_env_next_reader(struct vy_run_env *env)
+{
+	struct vy_run_reader *reader;
+	reader = &env->reader_pool[env->next_reader++];
+	env->next_reader %= env->reader_pool_size;
+	return reader;
+}
+
 /**
  * Execute a task on behalf of a reader thread.
  */
@@ -220,10 +284,7 @@ vy_run_env_coio_call(struct vy_run_env *env, struct cbus_call_msg *msg,
 	if (env->reader_pool == NULL)
 		return func(msg);
 
-	/* Pick a reader thread. */
-	struct vy_run_reader *reader;
-	reader = &env->reader_pool[env->next_reader++];
-	env->next_reader %= env->reader_pool_size;
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
 
 	/* Post the task to the reader thread. */
 	int rc = cbus_call(&reader->reader_pipe, &reader->tx_pipe,
@@ -285,9 +346,66 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	run->refs = 1;
 	rlist_create(&run->in_lsm);
 	rlist_create(&run->in_unused);
+	rlist_create(&run->cached_pages);
 	return run;
 }
 
+/**
+ * Memory used by compression dictionaries. Updated atomically,
+ * because dictionaries are trained by worker threads.
+ */
+static size_t vy_run_dict_mem;
+
+size_t
+vy_run_dict_mem_used(void)
+{
+	return __atomic_load_n(&vy_run_dict_mem, __ATOMIC_RELAXED);
+}
+
+/** Return the amount of memory used by a dictionary. */
+static size_t
+vy_run_dict_mem_size(struct vy_run_dict *dict)
+{
+	return sizeof(*dict) + dict->size + ZSTD_sizeof_DDict(dict->ddict);
+}
+
+struct vy_run_dict *
+vy_run_dict_new(const char *data, uint32_t size)
+{
+	struct vy_run_dict *dict = malloc(sizeof(*dict) + size);
+	if (dict == NULL) {
+		diag_set(OutOfMemory, sizeof(*dict) + size, "malloc",
+			 "struct vy_run_dict");
+		return NULL;
+	}
+	memcpy(dict->data, data, size);
+	dict->size = size;
+	dict->ddict = ZSTD_createDDict(dict->data, size);
+	if (dict->ddict == NULL) {
+		diag_set(OutOfMemory, size, "ZSTD_createDDict",
+			 "compression dictionary");
+		free(dict);
+		return NULL;
+	}
+	dict->refs = 1;
+	__atomic_add_fetch(&vy_run_dict_mem, vy_run_dict_mem_size(dict),
+			   __ATOMIC_RELAXED);
+	return dict;
+}
+
+void
+vy_run_dict_unref(struct vy_run_dict *dict)
+{
+	assert(dict->refs > 0);
+	if (--dict->refs > 0)
+		return;
+	__atomic_sub_fetch(&vy_run_dict_mem, vy_run_dict_mem_size(dict),
+			   __ATOMIC_RELAXED);
+	ZSTD_freeDDict(dict->ddict);
+	TRASH(dict);
+	free(dict);
+}
+
 static void
 vy_run_clear(struct vy_run *run)
 {
@@ -308,12 +426,18 @@ vy_run_clear(struct vy_run *run)
 	run->info.min_key = NULL;
 	free(run->info.max_key);
 	run->info.max_key = NULL;
+	if (run->info.dict != NULL) {
+		vy_run_dict_unref(run->info.dict);
+		run->info.dict = NULL;
+	}
 }
 
 void
 vy_run_delete(struct vy_run *run)
 {
 	assert(run->refs == 0);
+	if (!rlist_empty(&run->cached_pages))
+		vy_page_cache_invalidate_run(&run->env->page_cache, run);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
 	vy_run_clear(run);
@@ -434,6 +558,16 @@ vy_slice_new(int64_t id, struct vy_run *run, struct vy_entry begin,
 	slice->end = end;
 	rlist_create(&slice->in_range);
 	fiber_cond_create(&slice->pin_cond);
+	if (run->info.min_key != NULL && run->info.max_key != NULL) {
+		const char *key = run->info.min_key;
+		uint32_t part_count = mp_decode_array(&key);
+		slice->min_key = run->info.min_key;
+		slice->min_key_hint = key_hint(key, part_count, cmp_def);
+		key = run->info.max_key;
+		part_count = mp_decode_array(&key);
+		slice->max_key = run->info.max_key;
+		slice->max_key_hint = key_hint(key, part_count, cmp_def);
+	}
 	if (run->info.page_count == 0) {
 		/* The run is empty hence the slice is empty too. */
 		return slice;
@@ -685,6 +819,22 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_BLOOM_VERSIONED:
+			if (tuple_bloom_decode_versioned(&pos,
+							 &run_info->bloom) != 0)
+				return -1;
+			if (run_info->bloom == NULL)
+				say_warn("%s: unsupported bloom filter, "
+					 "ignoring it", filename);
+			break;
+		case VY_RUN_INFO_COMPRESSION_DICT: {
+			uint32_t size;
+			tmp = mp_decode_bin(&pos, &size);
+			run_info->dict = vy_run_dict_new(tmp, size);
+			if (run_info->dict == NULL)
+				return -1;
+			break;
+		}
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -712,6 +862,7 @@ vy_page_new(const struct vy_page_info *page_info)
 	}
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
+	page->refs = 1;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
 	if (page->row_index == NULL) {
 		diag_set(OutOfMemory, page_info->row_count * sizeof(uint32_t),
@@ -731,7 +882,7 @@ vy_page_new(const struct vy_page_info *page_info)
 	return page;
 }
 
-static void
+void
 vy_page_delete(struct vy_page *page)
 {
 	uint32_t *row_index = page->row_index;
@@ -821,20 +972,62 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 	return end;
 }
 
+/** Free a page prefetch message that has returned to tx. */
+static void
+vy_page_prefetch_delete(struct vy_page_prefetch *prefetch)
+{
+	assert(prefetch->is_done);
+	struct vy_run_env *env = prefetch->run->env;
+	if (prefetch->page != NULL)
+		vy_page_unref(prefetch->page);
+	vy_run_unref(prefetch->run);
+	fiber_cond_destroy(&prefetch->done_cond);
+	mempool_free(&env->prefetch_pool, prefetch);
+}
+
+/**
+ * Drop a page read ahead by a run iterator. If the message hasn't
+ * returned from the reader thread yet, it will be freed on return.
+ */
+static void
+vy_page_prefetch_cancel(struct vy_page_prefetch *prefetch)
+{
+	if (prefetch->is_done)
+		vy_page_prefetch_delete(prefetch);
+	else
+		prefetch->is_orphan = true;
+}
+
+/**
+ * Drop the first @a count pages read ahead by a run iterator.
+ */
+static void
+vy_run_iterator_cancel_prefetch(struct vy_run_iterator *itr, int count)
+{
+	assert(count <= itr->prefetch_count);
+	for (int i = 0; i < count; i++)
+		vy_page_prefetch_cancel(itr->prefetch[i]);
+	itr->prefetch_count -= count;
+	memmove(itr->prefetch, itr->prefetch + count,
+		itr->prefetch_count * sizeof(itr->prefetch[0]));
+}
+
 /**
  * End iteration and free cached data.
  */
 static void
 vy_run_iterator_stop(struct vy_run_iterator *itr)
 {
+	vy_run_iterator_cancel_prefetch(itr, itr->prefetch_count);
+	itr->last_read_page_no = UINT32_MAX;
 	if (itr->curr.stmt != NULL) {
 		tuple_unref(itr->curr.stmt);
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -923,7 +1116,9 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	const char *data_end = data + readen;
 	char *rows = page->data;
 	char *rows_end = rows + page_info->unpacked_size;
-	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx) != 0)
+	const ZSTD_DDict *zdict = run->info.dict != NULL ?
+				  run->info.dict->ddict : NULL;
+	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx, zdict) != 0)
 		goto error;
 
 	struct xrow_header xrow;
@@ -994,9 +1189,237 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/**
+ * Read a page requested by vy_run_iterator_prefetch().
+ * Called in a reader thread.
+ */
+static void
+vy_page_prefetch_read_f(struct cmsg *base)
+{
+	struct vy_page_prefetch *prefetch = (struct vy_page_prefetch *)base;
+	struct vy_run *run = prefetch->run;
+	struct vy_page_info *page_info = vy_run_page_info(run,
+							  prefetch->page_no);
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(run->env);
+	if (zdctx == NULL ||
+	    vy_page_read(prefetch->page, page_info, run, zdctx) != 0) {
+		/*
+		 * Prefetching is best effort: the iterator will
+		 * read the page synchronously and report the error.
+		 */
+		prefetch->is_failed = true;
+		diag_clear(diag_get());
+	}
+}
+
+/**
+ * Wake up the iterator waiting for a prefetched page or free
+ * the message if the page isn't needed anymore. Called in tx.
+ */
+static void
+vy_page_prefetch_complete_f(struct cmsg *base)
+{
+	struct vy_page_prefetch *prefetch = (struct vy_page_prefetch *)base;
+	prefetch->is_done = true;
+	if (prefetch->is_failed) {
+		vy_page_unref(prefetch->page);
+		prefetch->page = NULL;
+	}
+	if (prefetch->is_orphan)
+		vy_page_prefetch_delete(prefetch);
+	else
+		fiber_cond_signal(&prefetch->done_cond);
+}
+
+/**
+ * Start reading a page of a run in a reader thread without
+ * waiting for the result. Returns false if the page couldn't
+ * be scheduled for reading.
+ */
+static bool
+vy_run_iterator_submit_prefetch(struct vy_run_iterator *itr,
+				uint32_t page_no)
+{
+	assert(itr->prefetch_count < VY_RUN_PREFETCH_MAX);
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
+	struct vy_page_prefetch *prefetch = mempool_alloc(&env->prefetch_pool);
+	if (prefetch == NULL)
+		return false;
+	prefetch->page = vy_page_new(vy_run_page_info(run, page_no));
+	if (prefetch->page == NULL) {
+		diag_clear(diag_get());
+		mempool_free(&env->prefetch_pool, prefetch);
+		return false;
+	}
+	prefetch->page->page_no = page_no;
+	prefetch->run = run;
+	vy_run_ref(run);
+	prefetch->page_no = page_no;
+	prefetch->is_done = false;
+	prefetch->is_failed = false;
+	prefetch->is_orphan = false;
+	fiber_cond_create(&prefetch->done_cond);
+
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
+	prefetch->route[0].f = vy_page_prefetch_read_f;
+	prefetch->route[0].pipe = &reader->tx_pipe;
+	prefetch->route[1].f = vy_page_prefetch_complete_f;
+	prefetch->route[1].pipe = NULL;
+	cmsg_init(&prefetch->base, prefetch->route);
+	cpipe_push(&reader->reader_pipe, &prefetch->base);
+
+	itr->prefetch[itr->prefetch_count++] = prefetch;
+	env->prefetch_stat.read++;
+	return true;
+}
+
+/**
+ * Start reading pages following @a page_no in the iteration
+ * direction so that they are ready by the time a sequential scan
+ * gets to them. Pages that are already being read or are stored
+ * in the page cache are skipped.
+ */
+static void
+vy_run_iterator_prefetch(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run_env *env = slice->run->env;
+	if (env->reader_pool == NULL)
+		return;
+	int window = env->prefetch_pages;
+	assert(window <= VY_RUN_PREFETCH_MAX);
+	int dir = iterator_direction(itr->iterator_type);
+	int64_t last = page_no;
+	if (itr->prefetch_count > 0)
+		last = itr->prefetch[itr->prefetch_count - 1]->page_no;
+	for (int i = 1; i <= window; i++) {
+		int64_t next = (int64_t)page_no + dir * i;
+		if (next < slice->first_page_no || next > slice->last_page_no)
+			break;
+		if ((next - last) * dir <= 0)
+			continue;
+		if (vy_page_cache_has(&env->page_cache, slice->run, next))
+			continue;
+		if (itr->prefetch_count == VY_RUN_PREFETCH_MAX ||
+		    !vy_run_iterator_submit_prefetch(itr, next))
+			break;
+	}
+}
+
+/**
+ * Look up a page among the pages read ahead by a run iterator and
+ * wait for it to be read. Pages preceding the found one are dropped,
+ * because the scan has already passed them. If the page isn't found,
+ * the scan must have been repositioned so all pages are dropped.
+ *
+ * On success returns 0 and sets @a result to the page or to NULL
+ * if it wasn't prefetched. Returns -1 if the fiber was cancelled
+ * while waiting.
+ */
+static int
+vy_run_iterator_take_prefetched(struct vy_run_iterator *itr, uint32_t page_no,
+				struct vy_page **result)
+{
+	*result = NULL;
+	int i;
+	for (i = 0; i < itr->prefetch_count; i++) {
+		if (itr->prefetch[i]->page_no == page_no)
+			break;
+	}
+	if (i == itr->prefetch_count) {
+		vy_run_iterator_cancel_prefetch(itr, itr->prefetch_count);
+		return 0;
+	}
+	vy_run_iterator_cancel_prefetch(itr, i);
+	struct vy_page_prefetch *prefetch = itr->prefetch[0];
+	itr->prefetch_count--;
+	memmove(itr->prefetch, itr->prefetch + 1,
+		itr->prefetch_count * sizeof(itr->prefetch[0]));
+	while (!prefetch->is_done) {
+		if (fiber_cond_wait(&prefetch->done_cond) != 0) {
+			prefetch->is_orphan = true;
+			return -1;
+		}
+	}
+	if (prefetch->page != NULL) {
+		*result = prefetch->page;
+		prefetch->page = NULL;
+		prefetch->run->env->prefetch_stat.hit++;
+	}
+	vy_page_prefetch_delete(prefetch);
+	return 0;
+}
+
+/**
+ * Make a page the current page of a run iterator. The iterator
+ * keeps references to two most recently used pages.
+ */
+static void
+vy_run_iterator_cache_page(struct vy_run_iterator *itr, struct vy_page *page)
+{
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
+/**
+ * Read a page from disk given its number in a reader thread and
+ * wait for the result. If @a key is set, the position of the key
+ * in the page is looked up in the reader thread, too.
+ *
+ * Returns NULL on error.
+ */
+static struct vy_page *
+vy_run_iterator_read_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  uint32_t *pos_in_page, bool *equal_found)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
+
+	/* Allocate buffers */
+	struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+	struct vy_page *page = vy_page_new(page_info);
+	if (page == NULL)
+		return NULL;
+
+	/* Read page data from the disk */
+	struct vy_page_read_task *task = mempool_alloc(&env->read_task_pool);
+	if (task == NULL) {
+		diag_set(OutOfMemory, sizeof(*task),
+			 "mempool", "vy_page_read_task");
+		vy_page_unref(page);
+		return NULL;
+	}
+	task->run = run;
+	task->page_info = page_info;
+	task->page = page;
+	task->key = key;
+	task->iterator_type = iterator_type;
+	task->cmp_def = itr->cmp_def;
+	task->format = itr->format;
+	task->pos_in_page = 0;
+	task->equal_found = false;
+
+	int rc = vy_run_env_coio_call(env, &task->base, vy_page_read_cb);
+
+	*pos_in_page = task->pos_in_page;
+	*equal_found = task->equal_found;
+
+	mempool_free(&env->read_task_pool, task);
+	if (rc != 0) {
+		vy_page_unref(page);
+		return NULL;
+	}
+	return page;
+}
+
 /**
  * Read a page from disk given its number.
  * The function caches two most recently read pages.
+ * Pages are looked up in and added to the page cache.
  *
  * @retval 0 success
  * @retval -1 critical error
@@ -1029,49 +1452,59 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return 0;
 	}
 
-	/* Allocate buffers */
-	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
-	page = vy_page_new(page_info);
-	if (page == NULL)
-		return -1;
-
-	/* Read page data from the disk */
-	struct vy_page_read_task *task = mempool_alloc(&env->read_task_pool);
-	if (task == NULL) {
-		diag_set(OutOfMemory, sizeof(*task),
-			 "mempool", "vy_page_read_task");
-		vy_page_delete(page);
-		return -1;
+	/*
+	 * Read ahead only if the pages are accessed sequentially
+	 * so that point lookups don't waste disk bandwidth.
+	 */
+	bool is_sequential = env->prefetch_pages > 0 &&
+		itr->last_read_page_no != UINT32_MAX &&
+		(int64_t)page_no - itr->last_read_page_no ==
+		iterator_direction(itr->iterator_type);
+	itr->last_read_page_no = page_no;
+
+	/* Check the page cache. */
+	page = vy_page_cache_get(&env->page_cache, slice->run, page_no,
+				 itr->is_hot);
+	if (page != NULL) {
+		vy_page_ref(page);
+		vy_run_iterator_cache_page(itr, page);
+		if (is_sequential)
+			vy_run_iterator_prefetch(itr, page_no);
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+		*result = page;
+		return 0;
 	}
-	task->run = slice->run;
-	task->page_info = page_info;
-	task->page = page;
-	task->key = key;
-	task->iterator_type = iterator_type;
-	task->cmp_def = itr->cmp_def;
-	task->format = itr->format;
-	task->pos_in_page = 0;
-	task->equal_found = false;
 
-	int rc = vy_run_env_coio_call(env, &task->base, vy_page_read_cb);
-
-	*pos_in_page = task->pos_in_page;
-	*equal_found = task->equal_found;
-
-	mempool_free(&env->read_task_pool, task);
-	if (rc != 0) {
-		vy_page_delete(page);
+	/* Check pages read ahead. */
+	if (vy_run_iterator_take_prefetched(itr, page_no, &page) != 0)
 		return -1;
+	if (page != NULL) {
+		vy_run_iterator_prefetch(itr, page_no);
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+	} else {
+		/* Read ahead while we're waiting for the page. */
+		if (is_sequential)
+			vy_run_iterator_prefetch(itr, page_no);
+		page = vy_run_iterator_read_page(itr, page_no, key,
+						 iterator_type, pos_in_page,
+						 equal_found);
+		if (page == NULL)
+			return -1;
 	}
 
 	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
 	page->page_no = page_no;
+	vy_run_iterator_cache_page(itr, page);
+	vy_page_cache_put(&env->page_cache, slice->run, page, itr->is_hot);
 
 	/* Update read statistics. */
+	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	itr->stat->read.rows += page_info->row_count;
 	itr->stat->read.bytes += page_info->unpacked_size;
 	itr->stat->read.bytes_compressed += page_info->size;
@@ -1329,6 +1762,33 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 	}
 }
 
+/**
+ * Return false if the slice can't contain statements matching
+ * the given key of an EQ iterator, judging by the min and max
+ * keys of the run and the slice boundaries.
+ */
+static bool
+vy_slice_may_contain(struct vy_slice *slice, struct vy_entry key,
+		     struct key_def *cmp_def)
+{
+	if (slice->min_key == NULL)
+		return false;
+	if (vy_entry_compare_with_raw_key(key, slice->min_key,
+					  slice->min_key_hint, cmp_def) < 0)
+		return false;
+	if (vy_entry_compare_with_raw_key(key, slice->max_key,
+					  slice->max_key_hint, cmp_def) > 0)
+		return false;
+	/*
+	 * The slice end is exclusive, but a partial key equal to
+	 * it may still match statements preceding it.
+	 */
+	if (slice->end.stmt != NULL &&
+	    vy_entry_compare(key, slice->end, cmp_def) > 0)
+		return false;
+	return true;
+}
+
 /**
  * Position the iterator to the first statement satisfying
  * the iterator search criteria and following the given key
@@ -1347,6 +1807,17 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 	*ret = vy_entry_none();
 	assert(itr->search_started);
 
+	/*
+	 * Check the key fences on the first iteration. This is
+	 * cheaper than the bloom filter and rules out runs that
+	 * don't overlap the key, e.g. older runs of a time series.
+	 */
+	if (itr->iterator_type == ITER_EQ && itr->curr.stmt == NULL &&
+	    !vy_slice_may_contain(slice, itr->key, cmp_def)) {
+		vy_run_iterator_stop(itr);
+		return 0;
+	}
+
 	/* Check the bloom filter on the first iteration. */
 	bool check_bloom = (itr->iterator_type == ITER_EQ &&
 			    itr->curr.stmt == NULL && bloom != NULL);
@@ -1481,7 +1952,10 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_pos.page_no = slice->run->info.page_count;
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
+	itr->prefetch_count = 0;
+	itr->last_read_page_no = UINT32_MAX;
 	itr->search_started = false;
+	itr->is_hot = false;
 
 	/*
 	 * Make sure the format we use to create tuples won't
@@ -1782,10 +2256,10 @@ fail:
 static int
 vy_run_dump_stmt(struct vy_entry entry, struct xlog *data_xlog,
 		 struct vy_page_info *info, struct key_def *key_def,
-		 bool is_primary)
+		 bool store_tuples)
 {
 	struct xrow_header xrow;
-	int rc = (is_primary ?
+	int rc = (store_tuples ?
 		  vy_stmt_encode_primary(entry.stmt, key_def, 0, &xrow) :
 		  vy_stmt_encode_secondary(entry.stmt, key_def,
 					   vy_entry_multikey_idx(entry, key_def),
@@ -1989,6 +2463,8 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->dict != NULL)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -1999,11 +2475,18 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		mp_sizeof_uint(run_info->max_lsn);
 	size += mp_sizeof_uint(VY_RUN_INFO_PAGE_COUNT) +
 		mp_sizeof_uint(run_info->page_count);
+	enum vy_run_info_key bloom_key = VY_RUN_INFO_BLOOM;
+	if (run_info->bloom != NULL &&
+	    tuple_bloom_is_versioned(run_info->bloom))
+		bloom_key = VY_RUN_INFO_BLOOM_VERSIONED;
 	if (run_info->bloom != NULL)
-		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM) +
+		size += mp_sizeof_uint(bloom_key) +
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->dict != NULL)
+		size += mp_sizeof_uint(VY_RUN_INFO_COMPRESSION_DICT) +
+			mp_sizeof_bin(run_info->dict->size);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2027,11 +2510,16 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	pos = mp_encode_uint(pos, VY_RUN_INFO_PAGE_COUNT);
 	pos = mp_encode_uint(pos, run_info->page_count);
 	if (run_info->bloom != NULL) {
-		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM);
+		pos = mp_encode_uint(pos, bloom_key);
 		pos = tuple_bloom_encode(run_info->bloom, pos);
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->dict != NULL) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_COMPRESSION_DICT);
+		pos = mp_encode_bin(pos, run_info->dict->data,
+				    run_info->dict->size);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2110,17 +2598,21 @@ fail:
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
-		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     bool store_tuples, struct key_def *cmp_def,
+		     struct key_def *key_def, uint64_t page_size,
+		     enum bloom_type bloom_type, double bloom_fpr,
+		     bool no_compression, bool train_dict)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
 	writer->dirpath = dirpath;
 	writer->space_id = space_id;
 	writer->iid = iid;
+	writer->store_tuples = store_tuples;
 	writer->cmp_def = cmp_def;
 	writer->key_def = key_def;
 	writer->page_size = page_size;
+	writer->bloom_type = bloom_type;
 	writer->bloom_fpr = bloom_fpr;
 	writer->no_compression = no_compression;
 	if (bloom_fpr < 1) {
@@ -2131,6 +2623,13 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
+	writer->train_dict = train_dict;
+	writer->dict_sample_stride = 1;
+	writer->dict_stmt_count = 0;
+	ibuf_create(&writer->dict_samples, &cord()->slabc,
+		    VY_RUN_DICT_SIZE_MAX);
+	ibuf_create(&writer->dict_sample_sizes, &cord()->slabc,
+		    1024 * sizeof(size_t));
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
 	assert(run->page_info == NULL);
@@ -2155,10 +2654,21 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	struct xlog_meta meta;
 	xlog_meta_create(&meta, XLOG_META_TYPE_RUN, &INSTANCE_UUID,
 			 NULL, NULL);
+	struct vy_run_dict *dict = writer->run->info.dict;
+	if (dict != NULL && !writer->no_compression) {
+		writer->zdict = ZSTD_createCDict(dict->data, dict->size,
+						 VY_RUN_DICT_COMPRESSION_LEVEL);
+		if (writer->zdict == NULL) {
+			diag_set(OutOfMemory, dict->size, "ZSTD_createCDict",
+				 "compression dictionary");
+			return -1;
+		}
+	}
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
 	opts.no_compression = writer->no_compression;
+	opts.zdict = writer->zdict;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
 	return 0;
@@ -2202,6 +2712,73 @@ vy_run_writer_start_page(struct vy_run_writer *writer,
 	return 0;
 }
 
+/**
+ * Drop every other sample collected to train a compression
+ * dictionary and double the sampling stride.
+ */
+static void
+vy_run_writer_thin_samples(struct vy_run_writer *writer)
+{
+	size_t *sizes = (size_t *)writer->dict_sample_sizes.rpos;
+	size_t count = ibuf_used(&writer->dict_sample_sizes) / sizeof(size_t);
+	char *src = writer->dict_samples.rpos;
+	char *dst = src;
+	size_t kept = 0;
+	for (size_t i = 0; i < count; i++) {
+		size_t size = sizes[i];
+		if (i % 2 == 0) {
+			memmove(dst, src, size);
+			dst += size;
+			sizes[kept++] = size;
+		}
+		src += size;
+	}
+	writer->dict_samples.wpos = dst;
+	writer->dict_sample_sizes.wpos = (char *)(sizes + kept);
+	writer->dict_sample_stride *= 2;
+}
+
+/**
+ * Remember a statement to train a compression dictionary on it.
+ *
+ * Every dict_sample_stride-th statement is sampled. When the size
+ * of samples exceeds VY_RUN_DICT_SAMPLES_MAX, every other sample is
+ * dropped and the stride is doubled, so that the samples are spread
+ * evenly over the whole run rather than taken from its beginning.
+ */
+static int
+vy_run_writer_sample_stmt(struct vy_run_writer *writer, struct tuple *stmt)
+{
+	uint64_t stmt_no = writer->dict_stmt_count++;
+	if (stmt_no % writer->dict_sample_stride != 0)
+		return 0;
+	uint32_t size;
+	const char *data = tuple_data_range(stmt, &size);
+	if (size > VY_RUN_DICT_SAMPLES_MAX / 2)
+		return 0;
+	while (ibuf_used(&writer->dict_samples) + size >
+	       VY_RUN_DICT_SAMPLES_MAX) {
+		vy_run_writer_thin_samples(writer);
+		if (stmt_no % writer->dict_sample_stride != 0)
+			return 0;
+	}
+	char *buf = ibuf_alloc(&writer->dict_samples, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "dictionary samples");
+		return -1;
+	}
+	memcpy(buf, data, size);
+	size_t *sample_size = ibuf_alloc(&writer->dict_sample_sizes,
+					 sizeof(size_t));
+	if (sample_size == NULL) {
+		diag_set(OutOfMemory, sizeof(size_t), "ibuf",
+			 "dictionary samples");
+		return -1;
+	}
+	*sample_size = size;
+	return 0;
+}
+
 /**
  * Write @a stmt into a current page.
  * @param writer Run writer.
@@ -2230,12 +2807,15 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	}
 	*offset = page->unpacked_size;
 	if (vy_run_dump_stmt(entry, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
+			     writer->cmp_def, writer->store_tuples) != 0)
 		return -1;
 	int64_t lsn = vy_stmt_lsn(entry.stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
 	run->info.max_lsn = MAX(run->info.max_lsn, lsn);
 	vy_stmt_stat_acct(&run->info.stmt_stat, vy_stmt_type(entry.stmt));
+	if (writer->train_dict &&
+	    vy_run_writer_sample_stmt(writer, entry.stmt) != 0)
+		return -1;
 	return 0;
 }
 
@@ -2315,6 +2895,49 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
 	ibuf_destroy(&writer->row_index_buf);
+	ibuf_destroy(&writer->dict_samples);
+	ibuf_destroy(&writer->dict_sample_sizes);
+	ZSTD_freeCDict(writer->zdict);
+}
+
+struct vy_run_dict *
+vy_run_writer_train_dict(struct vy_run_writer *writer)
+{
+	if (!writer->train_dict)
+		return NULL;
+	size_t samples_size = ibuf_used(&writer->dict_samples);
+	size_t size = MIN(samples_size / VY_RUN_DICT_SAMPLES_RATIO_MIN,
+			  (size_t)VY_RUN_DICT_SIZE_MAX);
+	if (size < VY_RUN_DICT_SIZE_MIN)
+		return NULL;
+	unsigned sample_count = ibuf_used(&writer->dict_sample_sizes) /
+				sizeof(size_t);
+	size_t region_svp = region_used(&fiber()->gc);
+	char *data = region_alloc(&fiber()->gc, size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, size, "region", "dictionary");
+		goto fail;
+	}
+	size = ZDICT_trainFromBuffer(data, size, writer->dict_samples.rpos,
+				     (size_t *)writer->dict_sample_sizes.rpos,
+				     sample_count);
+	if (ZDICT_isError(size)) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZDICT_getErrorName(size));
+		goto fail;
+	}
+	struct vy_run_dict *dict = vy_run_dict_new(data, size);
+	if (dict == NULL)
+		goto fail;
+	region_truncate(&fiber()->gc, region_svp);
+	return dict;
+fail:
+	region_truncate(&fiber()->gc, region_svp);
+	diag_log();
+	say_warn("failed to train compression dictionary for %s",
+		 vy_run_filename(writer->run));
+	diag_clear(diag_get());
+	return NULL;
 }
 
 int
@@ -2361,6 +2984,7 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 
 	if (writer->bloom != NULL) {
 		run->info.bloom = tuple_bloom_new(writer->bloom,
+						  writer->bloom_type,
 						  writer->bloom_fpr);
 		if (run->info.bloom == NULL)
 			goto out;
@@ -2509,6 +3133,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 
 	if (bloom_builder != NULL) {
 		run->info.bloom = tuple_bloom_new(bloom_builder,
+						  opts->bloom_type,
 						  opts->bloom_fpr);
 		if (run->info.bloom == NULL)
 			goto close_err;
@@ -2586,7 +3211,7 @@ vy_slice_stream_read_page(struct vy_slice_stream *stream)
 		return -1;
 
 	if (vy_page_read(stream->page, page_info, run, zdctx) != 0) {
-		vy_page_delete(stream->page);
+		vy_page_unref(stream->page);
 		stream->page = NULL;
 		return -1;
 	}
@@ -2624,7 +3249,7 @@ vy_slice_stream_search(struct vy_stmt_stream *virt_stream)
 
 	if (stream->pos_in_page == stream->page->row_count) {
 		/* The first tuple is in the beginning of the next page */
-		vy_page_delete(stream->page);
+		vy_page_unref(stream->page);
 		stream->page = NULL;
 		stream->page_no++;
 		stream->pos_in_page = 0;
@@ -2685,7 +3310,7 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct vy_entry *ret)
 		 * Out of page. Free page, move the position to the next page
 		 * and * nullify page pointer to read it on the next iteration.
 		 */
-		vy_page_delete(stream->page);
+		vy_page_unref(stream->page);
 		stream->page = NULL;
 		stream->page_no++;
 		stream->pos_in_page = 0;
@@ -2703,7 +3328,7 @@ vy_slice_stream_stop(struct vy_stmt_stream *virt_stream)
 	assert(virt_stream->iface->stop == vy_slice_stream_stop);
 	struct vy_slice_stream *stream = (struct vy_slice_stream *)virt_stream;
 	if (stream->page != NULL) {
-		vy_page_delete(stream->page);
+		vy_page_unref(stream->page);
 		stream->page = NULL;
 	}
 	if (stream->entry.stmt != NULL) {
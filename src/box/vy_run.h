@@ -40,7 +40,9 @@
 #include "vy_stmt_stream.h"
 #include "vy_read_view.h"
 #include "vy_stat.h"
+#include "vy_page_cache.h"
 #include "index_def.h"
+#include "vinyl.h"
 #include "xlog.h"
 
 #include "small/mempool.h"
@@ -51,6 +53,58 @@ extern "C" {
 
 struct vy_history;
 struct vy_run_reader;
+struct vy_page_prefetch;
+
+/**
+ * Zstd dictionary used for compressing run pages. Dictionaries are
+ * trained from statements sampled while runs of an LSM tree are
+ * written and are used for compressing runs written later. A run
+ * compressed with a dictionary references it and stores a copy of
+ * it in the index file. The reference counter may be updated only
+ * in the tx thread while the dictionary data may be used by any
+ * thread.
+ */
+struct vy_run_dict {
+	/** Reference counter. */
+	int refs;
+	/** Dictionary digested for decompression. */
+	ZSTD_DDict *ddict;
+	/** Size of the dictionary data. */
+	uint32_t size;
+	/** Dictionary data. */
+	char data[0];
+};
+
+/**
+ * Create a dictionary from raw data. The new dictionary has the
+ * reference counter set to 1. Returns NULL on memory allocation
+ * error.
+ */
+struct vy_run_dict *
+vy_run_dict_new(const char *data, uint32_t size);
+
+static inline void
+vy_run_dict_ref(struct vy_run_dict *dict)
+{
+	assert(dict->refs > 0);
+	dict->refs++;
+}
+
+/** Drop a reference to a dictionary, delete it if it was the last. */
+void
+vy_run_dict_unref(struct vy_run_dict *dict);
+
+/** Return the amount of memory used by compression dictionaries. */
+size_t
+vy_run_dict_mem_used(void);
+
+/** Page prefetch statistics, reported by box.stat.vinyl(). */
+struct vy_run_prefetch_stat {
+	/** Number of pages read ahead by run iterators. */
+	int64_t read;
+	/** Number of prefetched pages used by run iterators. */
+	int64_t hit;
+};
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
@@ -58,6 +112,15 @@ struct vy_run_env {
 	uint64_t snap_io_rate_limit;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
+	/** Mempool for struct vy_page_prefetch */
+	struct mempool prefetch_pool;
+	/**
+	 * Number of pages a run iterator reads ahead during
+	 * a scan, 0 if prefetching is disabled.
+	 */
+	int prefetch_pages;
+	/** Page prefetch statistics. */
+	struct vy_run_prefetch_stat prefetch_stat;
 	/** Key for thread-local ZSTD context */
 	pthread_key_t zdctx_key;
 	/** Pool of threads used for reading run files. */
@@ -69,6 +132,8 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/** Cache of decompressed pages shared by all runs. */
+	struct vy_page_cache page_cache;
 	/**
 	 * We need this flag during compaction in order to determine we can
 	 * unconditionally remove unused runs' files in-place.
@@ -94,6 +159,8 @@ struct vy_run_info {
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/** Dictionary the run pages are compressed with or NULL. */
+	struct vy_run_dict *dict;
 };
 
 /**
@@ -173,6 +240,8 @@ struct vy_run {
 	struct rlist in_unused;
 	/** Link in vy_lsm::runs list. */
 	struct rlist in_lsm;
+	/** Pages of this run stored in the page cache. */
+	struct rlist cached_pages;
 };
 
 /**
@@ -220,6 +289,17 @@ struct vy_slice {
 	 */
 	uint32_t first_page_no;
 	uint32_t last_page_no;
+	/**
+	 * Min and max keys of the run (point to vy_run_info) and
+	 * their comparison hints. Used as fences to skip the slice
+	 * on lookup of a key outside the run without checking the
+	 * bloom filter and searching the page index. NULL if the
+	 * run is empty.
+	 */
+	const char *min_key;
+	const char *max_key;
+	hint_t min_key_hint;
+	hint_t max_key_hint;
 	/** An estimate of the number of statements in this slice. */
 	struct vy_disk_stmt_counter count;
 };
@@ -284,8 +364,26 @@ struct vy_run_iterator {
 	 */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/**
+	 * Pages being read ahead of the current position during
+	 * a scan, ordered in the iteration direction.
+	 */
+	struct vy_page_prefetch *prefetch[VY_RUN_PREFETCH_MAX];
+	/** Number of entries in the prefetch array. */
+	int prefetch_count;
+	/**
+	 * Number of the page last read from disk. Used to detect
+	 * a sequential scan.
+	 */
+	uint32_t last_read_page_no;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
+	/**
+	 * Set by the caller if the slice belongs to a hot range so
+	 * that pages read by the iterator are given priority in the
+	 * page cache.
+	 */
+	bool is_hot;
 };
 
 /**
@@ -302,8 +400,32 @@ struct vy_page {
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/**
+	 * Reference counter. A page may be shared by the page cache
+	 * and run iterators.
+	 */
+	int refs;
 };
 
+/** Free a page, called when the last reference is dropped. */
+void
+vy_page_delete(struct vy_page *page);
+
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
 /**
  * Initialize vinyl run environment
  *
@@ -600,6 +722,12 @@ struct vy_run_writer {
 	uint32_t space_id;
 	/** Identifier of an index owning the run. */
 	uint32_t iid;
+	/**
+	 * Set if full tuples are written to the run, as it is
+	 * the case for primary and covering secondary indexes.
+	 * Otherwise only extended keys are written.
+	 */
+	bool store_tuples;
 	/**
 	 * Key definition to extract from tuple and store as page
 	 * min key, run min/max keys, and secondary index
@@ -621,6 +749,8 @@ struct vy_run_writer {
 	bool no_compression;
 	/** Xlog to write data. */
 	struct xlog data_xlog;
+	/** Bloom filter type. */
+	enum bloom_type bloom_type;
 	/** Bloom filter false positive rate. */
 	double bloom_fpr;
 	/** Bloom filter. */
@@ -632,14 +762,41 @@ struct vy_run_writer {
 	 * of max key of a finished run.
 	 */
 	struct vy_entry last;
+	/**
+	 * Digested run->info.dict used for compressing pages or
+	 * NULL if pages are compressed without a dictionary.
+	 */
+	ZSTD_CDict *zdict;
+	/** Set if statements are sampled to train a dictionary. */
+	bool train_dict;
+	/** Data of statements sampled to train a dictionary. */
+	struct ibuf dict_samples;
+	/** Sizes of sampled statements, array of size_t. */
+	struct ibuf dict_sample_sizes;
+	/** Every dict_sample_stride-th statement is sampled. */
+	uint64_t dict_sample_stride;
+	/** Number of statements passed to the sampler. */
+	uint64_t dict_stmt_count;
 };
 
-/** Create a run writer to fill a run with statements. */
+/**
+ * Create a run writer to fill a run with statements.
+ *
+ * If @a store_tuples is set, full tuples are written to the run,
+ * otherwise statements are reduced to extended keys (@a cmp_def).
+ *
+ * Unless @a no_compression is set, pages are compressed with
+ * run->info.dict if it isn't NULL. If @a train_dict is set,
+ * written statements are sampled so that a new dictionary can
+ * be trained with vy_run_writer_train_dict().
+ */
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
-		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     bool store_tuples, struct key_def *cmp_def,
+		     struct key_def *key_def, uint64_t page_size,
+		     enum bloom_type bloom_type, double bloom_fpr,
+		     bool no_compression, bool train_dict);
 
 /**
  * Write a specified statement into a run.
@@ -652,6 +809,16 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 int
 vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry);
 
+/**
+ * Train a zstd dictionary on statements written so far. Returns
+ * NULL if dictionary training wasn't requested on writer creation,
+ * there are too few statements to train a dictionary or training
+ * failed. Since a dictionary is just an optimization, errors are
+ * logged, but not reported to the caller.
+ */
+struct vy_run_dict *
+vy_run_writer_train_dict(struct vy_run_writer *writer);
+
 /**
  * Finalize run writing by writing run index into file. The writer
  * is deleted after call.
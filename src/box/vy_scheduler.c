@@ -203,8 +203,16 @@ struct vy_task {
 	 * progress so we save them here to safely access them
 	 * from another thread.
 	 */
+	enum bloom_type bloom_type;
 	double bloom_fpr;
 	int64_t page_size;
+	bool train_dict;
+	/**
+	 * Compression dictionary trained on the statements written
+	 * by this task. Used for compressing runs written by the
+	 * following tasks.
+	 */
+	struct vy_run_dict *new_dict;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -273,6 +281,8 @@ vy_task_delete(struct vy_task *task)
 	assert(task->deferred_delete_in_progress == 0);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
+	if (task->new_dict != NULL)
+		vy_run_dict_unref(task->new_dict);
 	vy_lsm_unref(task->lsm);
 	diag_destroy(&task->diag);
 	free(task);
@@ -379,6 +389,7 @@ vy_worker_pool_create(struct vy_worker_pool *pool, const char *name, int size)
 	pool->size = size;
 	pool->workers = NULL;
 	stailq_create(&pool->idle_workers);
+	pool->busy_count = 0;
 }
 
 static void
@@ -407,6 +418,7 @@ vy_worker_pool_get(struct vy_worker_pool *pool)
 		worker = stailq_shift_entry(&pool->idle_workers,
 					    struct vy_worker, in_idle);
 		assert(worker->pool == pool);
+		pool->busy_count++;
 	}
 	return worker;
 }
@@ -419,6 +431,8 @@ static void
 vy_worker_pool_put(struct vy_worker *worker)
 {
 	struct vy_worker_pool *pool = worker->pool;
+	assert(pool->busy_count > 0);
+	pool->busy_count--;
 	stailq_add_entry(&pool->idle_workers, worker, in_idle);
 }
 
@@ -1073,9 +1087,11 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 	struct vy_run_writer writer;
 	if (vy_run_writer_create(&writer, task->new_run, lsm->env->path,
 				 lsm->space_id, lsm->index_id,
+				 lsm->index_id == 0 || vy_lsm_is_covering(lsm),
 				 task->cmp_def, task->key_def,
-				 task->page_size, task->bloom_fpr,
-				 no_compression) != 0)
+				 task->page_size, task->bloom_type,
+				 task->bloom_fpr, no_compression,
+				 task->train_dict) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -1103,8 +1119,10 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 	}
 	wi->iface->stop(wi);
 
-	if (rc == 0)
+	if (rc == 0) {
+		task->new_dict = vy_run_writer_train_dict(&writer);
 		rc = vy_run_writer_commit(&writer);
+	}
 	if (rc != 0)
 		goto fail_abort_writer;
 
@@ -1390,7 +1408,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (lsm->run_count == 0);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views, NULL);
+				   vy_lsm_is_covering(lsm), is_last_level,
+				   scheduler->read_views, NULL);
 	if (wi == NULL)
 		goto err_wi;
 	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
@@ -1402,8 +1421,10 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	task->new_run = new_run;
 	task->wi = wi;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->train_dict = lsm->opts.compression_dict;
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1654,6 +1675,18 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		return 0;
 	}
 
+	/*
+	 * If the range is too big and there are idle workers,
+	 * split it so that its parts are compacted in parallel.
+	 * Note, vy_lsm_split_range() doesn't split a range that
+	 * has never been compacted, e.g. after a bulk load.
+	 */
+	if (!stailq_empty(&worker->pool->idle_workers) &&
+	    vy_lsm_split_range_for_compaction(lsm, range)) {
+		vy_scheduler_update_lsm(scheduler, lsm);
+		return 0;
+	}
+
 	struct vy_task *task = vy_task_new(scheduler, worker, lsm,
 					   &compaction_ops);
 	if (task == NULL)
@@ -1666,7 +1699,8 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (range->compaction_priority == range->slice_count);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views,
+				   vy_lsm_is_covering(lsm), is_last_level,
+				   scheduler->read_views,
 				   lsm->index_id > 0 ? NULL :
 				   &task->deferred_delete_handler);
 	if (wi == NULL)
@@ -1709,8 +1743,15 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->range = range;
 	task->new_run = new_run;
 	task->wi = wi;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->train_dict = lsm->opts.compression_dict;
+	if (lsm->opts.compression_dict && lsm->compression_dict != NULL) {
+		/* Compress the new run with the last trained dictionary. */
+		new_run->info.dict = lsm->compression_dict;
+		vy_run_dict_ref(new_run->info.dict);
+	}
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1985,6 +2026,8 @@ vy_task_complete(struct vy_task *task)
 		diag_move(diag_get(), diag);
 		goto fail;
 	}
+	if (task->new_dict != NULL && task->lsm->opts.compression_dict)
+		vy_lsm_set_compression_dict(task->lsm, task->new_dict);
 	scheduler->stat.tasks_completed++;
 	return 0;
 fail:
@@ -67,6 +67,8 @@ struct vy_worker_pool {
 	struct vy_worker *workers;
 	/** List of workers that are currently idle. */
 	struct stailq idle_workers;
+	/** Number of workers that are currently executing a task. */
+	int busy_count;
 };
 
 struct vy_scheduler {
@@ -1093,7 +1093,7 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 		v->is_first_insert = true;
 
 	if (lsm->index_id > 0 && old != NULL && !old->is_nop &&
-	    !vy_lsm_is_being_constructed(lsm)) {
+	    !vy_lsm_is_being_constructed(lsm) && !vy_lsm_is_covering(lsm)) {
 		/*
 		 * In a secondary index write set, DELETE statement purges
 		 * exactly one older statement so REPLACE + DELETE is no-op.
@@ -1115,6 +1115,9 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 		 * vinyl_space_build_index() as featuring bumped lsn).
 		 * Finally, we'll get missing tuple in secondary index after
 		 * it is built.
+		 *
+		 * Covering indexes store full tuples so REPLACE statements
+		 * for the same key may differ and we can't zap them either.
 		 */
 		enum iproto_type type = vy_stmt_type(entry.stmt);
 		enum iproto_type old_type = vy_stmt_type(old->entry.stmt);
@@ -240,6 +240,8 @@ struct vy_deferred_delete_handler {
  * use vy_write_iterator_add_* functions.
  * @param cmp_def - key definition for tuple compare.
  * @param LSM tree is_primary - set if this iterator is for a primary index.
+ * @param is_covering - set if this iterator is for a covering secondary
+ * index, i.e. a secondary index that stores full tuples.
  * @param is_last_level - there is no older level than the one we're writing to.
  * @param read_views - Opened read views.
  * @param handler - Deferred DELETE handler or NULL if no deferred DELETEs is
@@ -249,7 +251,8 @@ struct vy_deferred_delete_handler {
  */
 struct vy_stmt_stream *
 vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
-		      bool is_last_level, struct rlist *read_views,
+		      bool is_covering, bool is_last_level,
+		      struct rlist *read_views,
 		      struct vy_deferred_delete_handler *handler);
 
 /**
@@ -42,6 +42,10 @@
 #include "cbus.h"
 #include "coio_task.h"
 #include "replication.h"
+#include "clock.h"
+#include "histogram.h"
+#include "latency.h"
+#include "info/info.h"
 
 enum {
 	/**
@@ -75,6 +79,33 @@ wal_write_none_async(struct journal *, struct journal_entry *);
 static int
 wal_write_none(struct journal *, struct journal_entry *);
 
+/** WAL writer statistics, see box.stat.wal(). Updated by tx. */
+struct wal_stat {
+	/** Number of batches written to WAL. */
+	int64_t batches;
+	/** Number of transactions written to WAL. */
+	int64_t txns;
+	/** Histogram of the number of transactions in a batch. */
+	struct histogram *batch_txns;
+	/** Histogram of the size of a batch, in bytes. */
+	struct histogram *batch_bytes;
+	/**
+	 * Time since the first transaction of a batch was submitted
+	 * till the WAL thread started writing the batch. Includes
+	 * the group commit window.
+	 */
+	struct latency queue;
+	/** Time spent writing a batch to the WAL file. */
+	struct latency write;
+	/** Time spent syncing a batch, in the fsync mode only. */
+	struct latency sync;
+	/**
+	 * Time since a batch was made durable till its transactions
+	 * were completed by tx.
+	 */
+	struct latency complete;
+};
+
 /*
  * WAL writer - maintain a Write Ahead Log for every change
  * in the data state.
@@ -107,6 +138,24 @@ struct wal_writer
 	 * rolled back too.
 	 */
 	struct journal_entry *last_entry;
+	/**
+	 * Group commit window, in seconds: how long the first
+	 * transaction of a batch waits for more transactions
+	 * before the batch is sent to the WAL thread.
+	 */
+	double batch_window;
+	/** Max approximate size of a batch, in bytes, 0 if unlimited. */
+	int64_t batch_max_size;
+	/**
+	 * Batch collecting transactions during the group commit
+	 * window. It isn't in the WAL pipe until the window expires
+	 * or the batch grows up to batch_max_size.
+	 */
+	struct wal_msg *pending_batch;
+	/** Timer sending pending_batch when the window expires. */
+	struct ev_timer batch_timer;
+	/** Batch statistics. */
+	struct wal_stat stat;
 	/* ----------------- wal ------------------- */
 	/** A setting from instance configuration - wal_max_size */
 	int64_t wal_max_size;
@@ -170,6 +219,45 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Sequence number of the last batch written to WAL.
+	 * Updated by the WAL thread, read by the sync cord.
+	 */
+	int64_t write_seq;
+	/**
+	 * Incremented by the WAL thread whenever it opens a WAL
+	 * file, read by the sync cord.
+	 */
+	int64_t file_seq;
+	/* ----------------- wal sync ------------------- */
+	/**
+	 * In the fsync mode batches written by the WAL thread are
+	 * made durable by this cord, so that writing a batch and
+	 * syncing the previous one go in parallel.
+	 */
+	struct cord sync_cord;
+	/** A pipe from 'wal' to 'wal_sync'. */
+	struct cpipe sync_pipe;
+	/** A pipe from 'wal_sync' back to 'wal'. */
+	struct cpipe sync_wal_pipe;
+	/**
+	 * WAL events that happened while the current batch was
+	 * being written in the fsync mode. Watchers are notified
+	 * about them only after the batch is synced, see
+	 * wal_complete_sync().
+	 */
+	unsigned sync_events;
+	/**
+	 * Sequence number of the last batch that is known to be
+	 * durable. Accessed only by the sync cord.
+	 */
+	int64_t sync_seq;
+	/**
+	 * Vclock of the last synced row in the fsync mode. Watchers
+	 * may read only rows up to it, see wal_watcher_notify().
+	 * Accessed only by the WAL thread.
+	 */
+	struct vclock sync_vclock;
 };
 
 struct wal_msg {
@@ -185,6 +273,29 @@ struct wal_msg {
 	struct stailq rollback;
 	/** vclock after the batch processed. */
 	struct vclock vclock;
+	/** Number of transactions in the batch. */
+	int txn_count;
+	/** Number of rows in the batch. */
+	int row_count;
+	/** Time when the batch was created by tx. */
+	double create_time;
+	/** Time when the WAL thread started writing the batch. */
+	double write_start_time;
+	/** Time when the batch was written, 0 on failure. */
+	double write_end_time;
+	/** Time when the batch was made durable, 0 on failure. */
+	double sync_end_time;
+	/**
+	 * Descriptor of the WAL file to sync the batch, owned by
+	 * the batch, or -1 if the batch doesn't need syncing.
+	 */
+	int sync_fd;
+	/** Sequence number of the batch, see wal_writer::write_seq. */
+	int64_t seq;
+	/** WAL file the batch was written to, see wal_writer::file_seq. */
+	int64_t file_seq;
+	/** WAL events to notify watchers about after syncing the batch. */
+	unsigned events;
 };
 
 /**
@@ -213,6 +324,12 @@ wal_dir(void)
 static void
 wal_write_to_disk(struct cmsg *msg);
 
+static void
+wal_sync_to_disk(struct cmsg *msg);
+
+static void
+wal_complete_sync(struct cmsg *msg);
+
 static void
 tx_complete_batch(struct cmsg *msg);
 
@@ -221,20 +338,45 @@ static struct cmsg_hop wal_request_route[] = {
 	{tx_complete_batch, NULL},
 };
 
+/**
+ * Route of a batch in the fsync mode. The batch returns to the
+ * WAL thread after it is synced to notify WAL watchers, so that
+ * relays never see rows that aren't durable yet.
+ */
+static struct cmsg_hop wal_fsync_request_route[] = {
+	{wal_write_to_disk, &wal_writer_singleton.sync_pipe},
+	{wal_sync_to_disk, &wal_writer_singleton.sync_wal_pipe},
+	{wal_complete_sync, &wal_writer_singleton.tx_prio_pipe},
+	{tx_complete_batch, NULL},
+};
+
 static void
 wal_msg_create(struct wal_msg *batch)
 {
-	cmsg_init(&batch->base, wal_request_route);
+	cmsg_init(&batch->base, wal_writer_singleton.wal_mode == WAL_FSYNC ?
+		  wal_fsync_request_route : wal_request_route);
 	batch->approx_len = 0;
 	stailq_create(&batch->commit);
 	stailq_create(&batch->rollback);
 	vclock_create(&batch->vclock);
+	batch->txn_count = 0;
+	batch->row_count = 0;
+	batch->create_time = clock_monotonic();
+	batch->write_start_time = 0;
+	batch->write_end_time = 0;
+	batch->sync_end_time = 0;
+	batch->sync_fd = -1;
+	batch->seq = 0;
+	batch->file_seq = 0;
+	batch->events = 0;
 }
 
 static struct wal_msg *
 wal_msg(struct cmsg *msg)
 {
-	return msg->route == wal_request_route ? (struct wal_msg *) msg : NULL;
+	return msg->route == wal_request_route ||
+	       msg->route == wal_fsync_request_route ?
+	       (struct wal_msg *) msg : NULL;
 }
 
 /** Write a request to a log in a single transaction. */
@@ -349,6 +491,66 @@ tx_complete_rollback(void)
 	cpipe_push(&writer->wal_pipe, &msg);
 }
 
+static void
+wal_stat_create(struct wal_stat *stat)
+{
+	enum { KB = 1024, MB = KB * KB };
+	static int64_t batch_txns_buckets[] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096,
+		8192, 16384, 32768, 65536,
+	};
+	static int64_t batch_bytes_buckets[] = {
+		256, 512, 1 * KB, 2 * KB, 4 * KB, 8 * KB, 16 * KB, 32 * KB,
+		64 * KB, 128 * KB, 256 * KB, 512 * KB, 1 * MB, 2 * MB, 4 * MB,
+		8 * MB, 16 * MB, 32 * MB, 64 * MB,
+	};
+	memset(stat, 0, sizeof(*stat));
+	stat->batch_txns = histogram_new(batch_txns_buckets,
+					 lengthof(batch_txns_buckets));
+	stat->batch_bytes = histogram_new(batch_bytes_buckets,
+					  lengthof(batch_bytes_buckets));
+	if (stat->batch_txns == NULL || stat->batch_bytes == NULL ||
+	    latency_create(&stat->queue) != 0 ||
+	    latency_create(&stat->write) != 0 ||
+	    latency_create(&stat->sync) != 0 ||
+	    latency_create(&stat->complete) != 0)
+		panic("failed to allocate WAL statistics");
+}
+
+static void
+wal_stat_reset(struct wal_stat *stat)
+{
+	stat->batches = 0;
+	stat->txns = 0;
+	histogram_reset(stat->batch_txns);
+	histogram_reset(stat->batch_bytes);
+	latency_reset(&stat->queue);
+	latency_reset(&stat->write);
+	latency_reset(&stat->sync);
+	latency_reset(&stat->complete);
+}
+
+/** Account a batch successfully written to WAL. */
+static void
+wal_stat_collect_batch(struct wal_stat *stat, struct wal_msg *batch,
+		       enum wal_mode wal_mode)
+{
+	stat->batches++;
+	stat->txns += batch->txn_count;
+	histogram_collect(stat->batch_txns, batch->txn_count);
+	histogram_collect(stat->batch_bytes, batch->approx_len);
+	latency_collect(&stat->queue,
+			batch->write_start_time - batch->create_time);
+	latency_collect(&stat->write,
+			batch->write_end_time - batch->write_start_time);
+	if (wal_mode == WAL_FSYNC) {
+		latency_collect(&stat->sync, batch->sync_end_time -
+					     batch->write_end_time);
+	}
+	latency_collect(&stat->complete,
+			clock_monotonic() - batch->sync_end_time);
+}
+
 /**
  * Complete execution of a batch of WAL write requests:
  * schedule all committed requests, and, should there
@@ -362,6 +564,7 @@ tx_complete_batch(struct cmsg *msg)
 {
 	struct wal_writer *writer = &wal_writer_singleton;
 	struct wal_msg *batch = (struct wal_msg *) msg;
+	bool is_written = batch->write_end_time != 0;
 	/*
 	 * Move the rollback list to the writer first, since
 	 * wal_msg memory disappears after the first
@@ -374,6 +577,8 @@ tx_complete_batch(struct cmsg *msg)
 	/* Update the tx vclock to the latest written by wal. */
 	vclock_copy(&replicaset.vclock, &batch->vclock);
 	tx_schedule_queue(&batch->commit);
+	if (is_written)
+		wal_stat_collect_batch(&writer->stat, batch, writer->wal_mode);
 	mempool_free(&writer->msg_pool, container_of(msg, struct wal_msg, base));
 }
 
@@ -406,6 +611,32 @@ tx_notify_checkpoint(struct cmsg *msg)
 	free(msg);
 }
 
+/**
+ * Send the batch collected during the group commit window to
+ * the WAL thread.
+ */
+static void
+wal_push_pending_batch(struct wal_writer *writer)
+{
+	struct wal_msg *batch = writer->pending_batch;
+	if (batch == NULL)
+		return;
+	writer->pending_batch = NULL;
+	ev_timer_stop(loop(), &writer->batch_timer);
+	cpipe_push_input(&writer->wal_pipe, &batch->base);
+	writer->wal_pipe.n_input += batch->row_count * XROW_IOVMAX;
+	cpipe_flush_input(&writer->wal_pipe);
+}
+
+static void
+wal_batch_timer_cb(struct ev_loop *loop, struct ev_timer *timer, int events)
+{
+	(void)loop;
+	(void)timer;
+	(void)events;
+	wal_push_pending_batch(&wal_writer_singleton);
+}
+
 /**
  * Initialize WAL writer context. Even though it's a singleton,
  * encapsulate the details just in case we may use
@@ -431,8 +662,6 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	opts.sync_is_async = true;
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
-		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
 	writer->is_in_rollback = false;
@@ -440,16 +669,28 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	writer->checkpoint_wal_size = 0;
 	writer->checkpoint_threshold = INT64_MAX;
 	writer->checkpoint_triggered = false;
+	writer->sync_events = 0;
 
 	vclock_create(&writer->vclock);
 	vclock_create(&writer->checkpoint_vclock);
+	vclock_create(&writer->sync_vclock);
 	rlist_create(&writer->watchers);
 
+	writer->write_seq = 0;
+	writer->file_seq = 0;
+	writer->sync_seq = 0;
+
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
 
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
+
+	writer->batch_window = 0;
+	writer->batch_max_size = 0;
+	writer->pending_batch = NULL;
+	ev_timer_init(&writer->batch_timer, wal_batch_timer_cb, 0, 0);
+	wal_stat_create(&writer->stat);
 }
 
 /** Destroy a WAL writer structure. */
@@ -457,12 +698,26 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	histogram_delete(writer->stat.batch_txns);
+	histogram_delete(writer->stat.batch_bytes);
+	latency_destroy(&writer->stat.queue);
+	latency_destroy(&writer->stat.write);
+	latency_destroy(&writer->stat.sync);
+	latency_destroy(&writer->stat.complete);
 }
 
 /** WAL writer thread routine. */
 static int
 wal_writer_f(va_list ap);
 
+/** Called by the WAL thread after opening a WAL file. */
+static inline void
+wal_writer_advance_file_seq(struct wal_writer *writer)
+{
+	__atomic_store_n(&writer->file_seq, writer->file_seq + 1,
+			 __ATOMIC_RELEASE);
+}
+
 static int
 wal_open_f(struct cbus_call_msg *msg)
 {
@@ -471,7 +726,10 @@ wal_open_f(struct cbus_call_msg *msg)
 	const char *path = xdir_format_filename(&writer->wal_dir,
 				vclock_sum(&writer->vclock), NONE);
 	assert(!xlog_is_open(&writer->current_wal));
-	return xlog_open(&writer->current_wal, path, &writer->wal_dir.opts);
+	if (xlog_open(&writer->current_wal, path, &writer->wal_dir.opts) != 0)
+		return -1;
+	wal_writer_advance_file_seq(writer);
+	return 0;
 }
 
 /**
@@ -561,6 +819,7 @@ wal_enable(void)
 
 	/* Initialize the writer vclock from the recovery state. */
 	vclock_copy(&writer->vclock, &replicaset.vclock);
+	vclock_copy(&writer->sync_vclock, &replicaset.vclock);
 
 	/*
 	 * Scan the WAL directory to build an index of all
@@ -584,6 +843,7 @@ wal_free(void)
 {
 	struct wal_writer *writer = &wal_writer_singleton;
 
+	wal_push_pending_batch(writer);
 	cbus_stop_loop(&writer->wal_pipe);
 
 	if (cord_join(&writer->cord)) {
@@ -599,6 +859,81 @@ struct wal_vclock_msg {
     struct vclock vclock;
 };
 
+/**
+ * A message following the route of WAL batches in the fsync mode.
+ * Since the batch route goes through the sync cord, a call to the
+ * WAL thread may return to tx before previously written batches,
+ * so this message is used instead to wait for them.
+ */
+struct wal_barrier_msg {
+	struct cmsg base;
+	/** Fiber waiting for the message to get back to tx. */
+	struct fiber *fiber;
+	/** Set when the message gets back to tx. */
+	bool is_done;
+	/** Set if the WAL thread is rolling back a failed write. */
+	bool is_in_rollback;
+	/** WAL writer vclock. */
+	struct vclock vclock;
+};
+
+static void
+wal_barrier_write(struct cmsg *base)
+{
+	struct wal_barrier_msg *msg = (struct wal_barrier_msg *)base;
+	struct wal_writer *writer = &wal_writer_singleton;
+	msg->is_in_rollback = writer->is_in_rollback;
+	vclock_copy(&msg->vclock, &writer->vclock);
+}
+
+/** Pass a barrier through the sync cord and back to WAL. */
+static void
+wal_barrier_pass(struct cmsg *base)
+{
+	(void)base;
+}
+
+static void
+tx_barrier_done(struct cmsg *base)
+{
+	struct wal_barrier_msg *msg = (struct wal_barrier_msg *)base;
+	msg->is_done = true;
+	fiber_wakeup(msg->fiber);
+}
+
+static struct cmsg_hop wal_barrier_route[] = {
+	{wal_barrier_write, &wal_writer_singleton.sync_pipe},
+	{wal_barrier_pass, &wal_writer_singleton.sync_wal_pipe},
+	{wal_barrier_pass, &wal_writer_singleton.tx_prio_pipe},
+	{tx_barrier_done, NULL},
+};
+
+/**
+ * Wait until all batches sent to the WAL thread so far are
+ * completed in the fsync mode and return the WAL vclock.
+ */
+static int
+wal_barrier(struct wal_writer *writer, struct vclock *vclock)
+{
+	assert(writer->wal_mode == WAL_FSYNC);
+	struct wal_barrier_msg msg;
+	cmsg_init(&msg.base, wal_barrier_route);
+	msg.fiber = fiber();
+	msg.is_done = false;
+	cpipe_push(&writer->wal_pipe, &msg.base);
+	do {
+		fiber_yield();
+	} while (!msg.is_done);
+	if (msg.is_in_rollback) {
+		/* We're rolling back a failed write. */
+		diag_set(ClientError, ER_CASCADE_ROLLBACK);
+		return -1;
+	}
+	if (vclock != NULL)
+		vclock_copy(vclock, &msg.vclock);
+	return 0;
+}
+
 static int
 wal_sync_f(struct cbus_call_msg *data)
 {
@@ -632,6 +967,10 @@ wal_sync(struct vclock *vclock)
 		diag_set(ClientError, ER_CASCADE_ROLLBACK);
 		return -1;
 	}
+	/* Don't wait for the group commit window to expire. */
+	wal_push_pending_batch(writer);
+	if (writer->wal_mode == WAL_FSYNC)
+		return wal_barrier(writer, vclock);
 	struct wal_vclock_msg msg;
 	int rc = cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
 			   &msg.base, wal_sync_f, NULL, TIMEOUT_INFINITY);
@@ -692,11 +1031,19 @@ wal_begin_checkpoint(struct wal_checkpoint *checkpoint)
 		diag_set(ClientError, ER_CASCADE_ROLLBACK);
 		return -1;
 	}
+	/* The checkpoint must include all submitted transactions. */
+	wal_push_pending_batch(writer);
 	int rc = cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
 			   &checkpoint->base, wal_begin_checkpoint_f, NULL,
 			   TIMEOUT_INFINITY);
 	if (rc != 0)
 		return -1;
+	/*
+	 * Make sure all transactions included in the checkpoint
+	 * have been completed by tx, like in the write mode.
+	 */
+	if (writer->wal_mode == WAL_FSYNC && wal_barrier(writer, NULL) != 0)
+		return -1;
 	return 0;
 }
 
@@ -769,6 +1116,69 @@ wal_set_queue_max_size(int64_t size)
 	journal_queue_set_max_size(size);
 }
 
+void
+wal_set_batch_window(double window)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	writer->batch_window = window;
+	if (window == 0)
+		wal_push_pending_batch(writer);
+}
+
+void
+wal_set_batch_max_size(int64_t size)
+{
+	wal_writer_singleton.batch_max_size = size;
+}
+
+static void
+wal_info_append_latency(struct info_handler *h, const char *name,
+			struct latency *latency)
+{
+	info_table_begin(h, name);
+	info_append_double(h, "p50", latency_get(latency, 50));
+	info_append_double(h, "p90", latency_get(latency, 90));
+	info_append_double(h, "p99", latency_get(latency, 99));
+	info_table_end(h);
+}
+
+static void
+wal_info_append_histogram(struct info_handler *h, const char *name,
+			  struct histogram *hist)
+{
+	info_table_begin(h, name);
+	info_append_int(h, "p50", histogram_percentile(hist, 50));
+	info_append_int(h, "p90", histogram_percentile(hist, 90));
+	info_append_int(h, "p99", histogram_percentile(hist, 99));
+	info_table_end(h);
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_stat *stat = &wal_writer_singleton.stat;
+	info_begin(h);
+	info_append_int(h, "batches", stat->batches);
+	info_append_int(h, "txns", stat->txns);
+	info_table_begin(h, "batch");
+	wal_info_append_histogram(h, "txns", stat->batch_txns);
+	wal_info_append_histogram(h, "bytes", stat->batch_bytes);
+	info_table_end(h); /* batch */
+	info_table_begin(h, "latency");
+	wal_info_append_latency(h, "queue", &stat->queue);
+	wal_info_append_latency(h, "write", &stat->write);
+	wal_info_append_latency(h, "sync", &stat->sync);
+	wal_info_append_latency(h, "complete", &stat->complete);
+	info_table_end(h); /* latency */
+	info_end(h);
+}
+
+void
+wal_reset_stat(void)
+{
+	wal_stat_reset(&wal_writer_singleton.stat);
+}
+
 struct wal_gc_msg
 {
 	struct cbus_call_msg base;
@@ -855,13 +1265,22 @@ wal_opt_rotate(struct wal_writer *writer)
 	if (xdir_create_xlog(&writer->wal_dir, &writer->current_wal,
 			     &writer->vclock) != 0)
 		return -1;
+	wal_writer_advance_file_seq(writer);
 	/*
 	 * Keep track of the new WAL vclock. Required for garbage
 	 * collection, see wal_collect_garbage().
 	 */
 	xdir_add_vclock(&writer->wal_dir, &writer->vclock);
 
-	wal_notify_watchers(writer, WAL_EVENT_ROTATE);
+	/*
+	 * In the fsync mode the previous WAL may still have rows
+	 * that aren't synced, so let watchers switch to the new
+	 * WAL only after the current batch is synced.
+	 */
+	if (writer->wal_mode == WAL_FSYNC)
+		writer->sync_events |= WAL_EVENT_ROTATE;
+	else
+		wal_notify_watchers(writer, WAL_EVENT_ROTATE);
 	return 0;
 }
 
@@ -1021,6 +1440,115 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 		(*row)->tsn = tsn;
 }
 
+/**
+ * Pass a batch written in the fsync mode to the sync cord.
+ *
+ * The whole batch is made durable with one fdatasync(2) call.
+ * Opening the file with O_SYNC would sync every write(2)
+ * separately (a batch that doesn't fit in one xlog transaction
+ * takes several writes) and would flush the file modification
+ * time along with the data. The file descriptor is duplicated,
+ * because the WAL thread may close the file before the sync
+ * cord gets to the batch.
+ */
+static void
+wal_msg_prepare_sync(struct wal_writer *writer, struct wal_msg *batch)
+{
+	struct xlog *l = &writer->current_wal;
+	assert(xlog_is_open(l));
+	batch->file_seq = writer->file_seq;
+	batch->seq = writer->write_seq + 1;
+	__atomic_store_n(&writer->write_seq, batch->seq, __ATOMIC_RELEASE);
+	batch->sync_fd = dup(l->fd);
+	if (batch->sync_fd < 0) {
+		say_syserror("%s: dup() failed", l->filename);
+		/* Sync in the WAL thread then. */
+		if (fdatasync(l->fd) != 0)
+			panic_syserror("%s: failed to sync WAL", l->filename);
+		batch->sync_end_time = clock_monotonic();
+	}
+}
+
+/**
+ * Make a batch written in the fsync mode durable. Runs in the
+ * sync cord while the WAL thread is writing next batches.
+ *
+ * By the time the sync cord gets to a batch, the WAL thread may
+ * have written a few more batches to the same file, so the sync
+ * covers them as well and they don't need to be synced again.
+ *
+ * The batch data may be partially on disk already, and after
+ * a failed sync it is unknown which part of it, so there's no
+ * good position to roll back to.
+ */
+static void
+wal_sync_to_disk(struct cmsg *msg)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_msg *batch = (struct wal_msg *)msg;
+	if (batch->sync_fd < 0)
+		return;
+	if (batch->seq > writer->sync_seq) {
+		/*
+		 * Load the write sequence number before the file
+		 * sequence number: if the file hasn't changed, all
+		 * batches up to write_seq are in the file.
+		 */
+		int64_t write_seq = __atomic_load_n(&writer->write_seq,
+						    __ATOMIC_ACQUIRE);
+		int64_t file_seq = __atomic_load_n(&writer->file_seq,
+						   __ATOMIC_ACQUIRE);
+		ERROR_INJECT_COUNTDOWN(ERRINJ_WAL_SYNC_DELAY_COUNTDOWN, {
+			struct errinj *e = errinj(ERRINJ_WAL_SYNC_DELAY,
+						  ERRINJ_BOOL);
+			e->bparam = true;
+		});
+		ERROR_INJECT_SLEEP(ERRINJ_WAL_SYNC_DELAY);
+		if (fdatasync(batch->sync_fd) != 0)
+			panic_syserror("failed to sync WAL");
+		writer->sync_seq = file_seq == batch->file_seq ?
+				   write_seq : batch->seq;
+	}
+	close(batch->sync_fd);
+	batch->sync_fd = -1;
+	batch->sync_end_time = clock_monotonic();
+}
+
+/**
+ * Notify WAL watchers about a batch synced in the fsync mode.
+ * Runs in the WAL thread, which owns the watcher pipes.
+ *
+ * Batches are synced in order, so all rows up to the batch
+ * vclock are durable now. Rows of the next batches may be
+ * in the file already, but watchers must not read them.
+ */
+static void
+wal_complete_sync(struct cmsg *msg)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_msg *batch = (struct wal_msg *)msg;
+	vclock_copy(&writer->sync_vclock, &batch->vclock);
+	if (batch->events != 0)
+		wal_notify_watchers(writer, batch->events);
+	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
+}
+
+/** WAL sync cord main loop. */
+static int
+wal_sync_cord_f(va_list ap)
+{
+	(void)ap;
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "wal_sync", fiber_schedule_cb,
+			     fiber());
+	cpipe_create(&writer->sync_wal_pipe, "wal");
+	cbus_loop(&endpoint);
+	cpipe_destroy(&writer->sync_wal_pipe);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1032,6 +1560,7 @@ wal_write_to_disk(struct cmsg *msg)
 	struct error *error;
 	if (stailq_empty(&wal_msg->commit))
 		panic("Attempted to write an empty batch to WAL");
+	wal_msg->write_start_time = clock_monotonic();
 
 	/*
 	 * Track all vclock changes made by this batch into
@@ -1115,6 +1644,7 @@ wal_write_to_disk(struct cmsg *msg)
 		err_code= JOURNAL_ENTRY_ERR_IO;
 		goto done;
 	}
+	wal_msg->write_end_time = clock_monotonic();
 
 	writer->checkpoint_wal_size += rc;
 	last_committed = stailq_last(&wal_msg->commit);
@@ -1165,6 +1695,13 @@ done:
 	struct stailq rollback;
 	stailq_cut_tail(&wal_msg->commit, last_committed, &rollback);
 
+	if (last_committed != NULL) {
+		if (writer->wal_mode == WAL_FSYNC)
+			wal_msg_prepare_sync(writer, wal_msg);
+		else
+			wal_msg->sync_end_time = clock_monotonic();
+	}
+
 	if (!stailq_empty(&rollback)) {
 		assert(err_code != JOURNAL_ENTRY_ERR_UNKNOWN);
 		/* Update status of the successfully committed requests. */
@@ -1177,6 +1714,12 @@ done:
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
 	fiber_gc();
+	if (writer->wal_mode == WAL_FSYNC) {
+		/* Watchers are notified after the batch is synced. */
+		wal_msg->events = writer->sync_events | WAL_EVENT_WRITE;
+		writer->sync_events = 0;
+		return;
+	}
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
@@ -1200,8 +1743,24 @@ wal_writer_f(va_list ap)
 	 */
 	cpipe_create(&writer->tx_prio_pipe, "tx_prio");
 
+	if (writer->wal_mode == WAL_FSYNC) {
+		if (cord_costart(&writer->sync_cord, "wal_sync",
+				 wal_sync_cord_f, NULL) != 0)
+			panic("failed to start WAL sync thread");
+		cpipe_create(&writer->sync_pipe, "wal_sync");
+	}
+
 	cbus_loop(&endpoint);
 
+	if (writer->wal_mode == WAL_FSYNC) {
+		cbus_stop_loop(&writer->sync_pipe);
+		cpipe_destroy(&writer->sync_pipe);
+		if (cord_join(&writer->sync_cord) != 0)
+			panic_syserror("WAL sync thread join failed");
+		/* Complete batches that got back from the sync cord. */
+		cbus_process(&endpoint);
+	}
+
 	/*
 	 * Create a new empty WAL on shutdown so that we don't
 	 * have to rescan the last WAL to find the instance vclock.
@@ -1229,6 +1788,69 @@ wal_writer_f(va_list ap)
 	return 0;
 }
 
+/** Allocate a new WAL batch. Returns NULL and sets diag on OOM. */
+static struct wal_msg *
+wal_msg_new(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_msg *batch =
+		(struct wal_msg *)mempool_alloc(&writer->msg_pool);
+	if (batch == NULL) {
+		diag_set(OutOfMemory, sizeof(struct wal_msg),
+			 "region", "struct wal_msg");
+		return NULL;
+	}
+	wal_msg_create(batch);
+	return batch;
+}
+
+/** Check if no more transactions may be added to a batch. */
+static inline bool
+wal_msg_is_full(struct wal_writer *writer, struct wal_msg *batch)
+{
+	return writer->batch_max_size > 0 &&
+	       batch->approx_len >= (size_t)writer->batch_max_size;
+}
+
+static inline void
+wal_msg_account_entry(struct wal_msg *batch, struct journal_entry *entry)
+{
+	batch->approx_len += entry->approx_len;
+	batch->txn_count++;
+	batch->row_count += entry->n_rows;
+}
+
+/**
+ * Add a request to the batch collected during the group commit
+ * window. The batch is sent to the WAL thread when the window
+ * expires or the batch size reaches the limit.
+ */
+static int
+wal_write_async_pending(struct wal_writer *writer,
+			struct journal_entry *entry)
+{
+	struct wal_msg *batch = writer->pending_batch;
+	if (batch == NULL) {
+		batch = wal_msg_new();
+		if (batch == NULL) {
+			assert(entry->res == JOURNAL_ENTRY_ERR_UNKNOWN);
+			return -1;
+		}
+		writer->pending_batch = batch;
+		ev_timer_set(&writer->batch_timer, writer->batch_window, 0);
+		ev_timer_start(loop(), &writer->batch_timer);
+	}
+	stailq_add_tail_entry(&batch->commit, entry, fifo);
+	writer->last_entry = entry;
+	wal_msg_account_entry(batch, entry);
+#ifndef NDEBUG
+	++errinj(ERRINJ_WAL_WRITE_COUNT, ERRINJ_INT)->iparam;
+#endif
+	if (wal_msg_is_full(writer, batch))
+		wal_push_pending_batch(writer);
+	return 0;
+}
+
 /**
  * WAL writer main entry point: queue a single request
  * to be written to disk.
@@ -1258,20 +1880,20 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 		goto fail;
 	}
 
+	if (writer->batch_window > 0)
+		return wal_write_async_pending(writer, entry);
+
 	struct wal_msg *batch;
 	if (!stailq_empty(&writer->wal_pipe.input) &&
-	    (batch = wal_msg(stailq_first_entry(&writer->wal_pipe.input,
-						struct cmsg, fifo)))) {
+	    (batch = wal_msg(stailq_last_entry(&writer->wal_pipe.input,
+					       struct cmsg, fifo))) != NULL &&
+	    !wal_msg_is_full(writer, batch)) {
 
 		stailq_add_tail_entry(&batch->commit, entry, fifo);
 	} else {
-		batch = (struct wal_msg *)mempool_alloc(&writer->msg_pool);
-		if (batch == NULL) {
-			diag_set(OutOfMemory, sizeof(struct wal_msg),
-				 "region", "struct wal_msg");
+		batch = wal_msg_new();
+		if (batch == NULL)
 			goto fail;
-		}
-		wal_msg_create(batch);
 		/*
 		 * Sic: first add a request, then push the batch,
 		 * since cpipe_push() may pass the batch to WAL
@@ -1286,7 +1908,7 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 	 * transactions until and including this one.
 	 */
 	writer->last_entry = entry;
-	batch->approx_len += entry->approx_len;
+	wal_msg_account_entry(batch, entry);
 	writer->wal_pipe.n_input += entry->n_rows * XROW_IOVMAX;
 #ifndef NDEBUG
 	++errinj(ERRINJ_WAL_WRITE_COUNT, ERRINJ_INT)->iparam;
@@ -1418,6 +2040,10 @@ wal_watcher_notify(struct wal_watcher *watcher, unsigned events)
 	}
 
 	msg->events = events;
+	/* In the fsync mode rows are readable once synced. */
+	struct wal_writer *writer = &wal_writer_singleton;
+	vclock_copy(&msg->vclock, writer->wal_mode == WAL_FSYNC ?
+		    &writer->sync_vclock : &writer->vclock);
 	cmsg_init(&msg->cmsg, watcher->route);
 	cpipe_push(&watcher->watcher_pipe, &msg->cmsg);
 	ERROR_INJECT(ERRINJ_RELAY_FASTER_THAN_TX,
@@ -1431,7 +2057,7 @@ wal_watcher_notify_perform(struct cmsg *cmsg)
 	struct wal_watcher *watcher = msg->watcher;
 	unsigned events = msg->events;
 
-	watcher->cb(watcher, events);
+	watcher->cb(watcher, events, &msg->vclock);
 }
 
 static void
@@ -1484,7 +2110,8 @@ wal_watcher_detach(void *arg)
 
 void
 wal_set_watcher(struct wal_watcher *watcher, const char *name,
-		void (*watcher_cb)(struct wal_watcher *, unsigned events),
+		void (*watcher_cb)(struct wal_watcher *, unsigned events,
+				   const struct vclock *vclock),
 		void (*process_cb)(struct cbus_endpoint *))
 {
 	assert(journal_is_initialized(&wal_writer_singleton.base));
@@ -128,6 +128,8 @@ struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
 	unsigned events;
+	/** Vclock of the last row the watcher may read. */
+	struct vclock vclock;
 };
 
 enum wal_event {
@@ -141,7 +143,8 @@ struct wal_watcher {
 	/** Link in wal_writer::watchers. */
 	struct rlist next;
 	/** The watcher callback function. */
-	void (*cb)(struct wal_watcher *, unsigned events);
+	void (*cb)(struct wal_watcher *, unsigned events,
+		   const struct vclock *vclock);
 	/** Pipe from the watcher to WAL. */
 	struct cpipe wal_pipe;
 	/** Pipe from WAL to the watcher. */
@@ -176,7 +179,11 @@ struct wal_watcher {
  * @param name        Name of the cbus endpoint at the caller's cord.
  * @param watcher_cb  Callback to invoke from the caller's cord
  *                    upon receiving a WAL event. Apart from the
- *                    watcher itself, it takes a bit mask of events.
+ *                    watcher itself, it takes a bit mask of events
+ *                    and the vclock of the last row that may be
+ *                    read from WAL. In the fsync mode rows become
+ *                    readable only after they are synced, so the
+ *                    vclock may lag behind the end of WAL.
  *                    Events are described in wal_event enum.
  * @param process_cb  Function called to process cbus messages
  *                    while the watcher is being attached or NULL
@@ -184,7 +191,8 @@ struct wal_watcher {
  */
 void
 wal_set_watcher(struct wal_watcher *watcher, const char *name,
-		void (*watcher_cb)(struct wal_watcher *, unsigned events),
+		void (*watcher_cb)(struct wal_watcher *, unsigned events,
+				   const struct vclock *vclock),
 		void (*process_cb)(struct cbus_endpoint *));
 
 /**
@@ -263,6 +271,31 @@ wal_set_checkpoint_threshold(int64_t threshold);
 void
 wal_set_queue_max_size(int64_t size);
 
+/**
+ * Set the group commit window, in seconds: how long the first
+ * transaction of a batch waits for more transactions before the
+ * batch is sent to the WAL thread. 0 means send it right away.
+ */
+void
+wal_set_batch_window(double window);
+
+/**
+ * Set the max approximate size of a batch of transactions written
+ * to WAL with one write, in bytes. 0 means unlimited.
+ */
+void
+wal_set_batch_max_size(int64_t size);
+
+struct info_handler;
+
+/** Fill WAL writer statistics, see box.stat.wal(). */
+void
+wal_stat(struct info_handler *h);
+
+/** Reset WAL writer statistics. */
+void
+wal_reset_stat(void);
+
 /**
  * Remove WAL files that are not needed by consumers reading
  * rows at @vclock or newer.
@@ -96,6 +96,7 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.zdict = NULL,
 };
 
 /* {{{ struct xlog_meta */
@@ -114,6 +115,7 @@ enum {
 #define VCLOCK_KEY "VClock"
 #define VERSION_KEY "Version"
 #define PREV_VCLOCK_KEY "PrevVClock"
+#define SHARD_COUNT_KEY "Shards"
 
 static const char v13[] = "0.13";
 static const char v12[] = "0.12";
@@ -134,6 +136,7 @@ xlog_meta_create(struct xlog_meta *meta, const char *filetype,
 		vclock_copy(&meta->prev_vclock, prev_vclock);
 	else
 		vclock_clear(&meta->prev_vclock);
+	meta->shard_count = 0;
 }
 
 /**
@@ -167,6 +170,10 @@ xlog_meta_format(const struct xlog_meta *meta, char *buf, int size)
 		SNPRINT(total, snprintf, buf, size, PREV_VCLOCK_KEY ": %s\n",
 			vclock_to_string(&meta->prev_vclock));
 	}
+	if (meta->shard_count > 1) {
+		SNPRINT(total, snprintf, buf, size, SHARD_COUNT_KEY ": %u\n",
+			(unsigned)meta->shard_count);
+	}
 	SNPRINT(total, snprintf, buf, size, "\n");
 	assert(total > 0);
 	return total;
@@ -308,6 +315,17 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 			 */
 			if (parse_vclock(val, val_end, &meta->prev_vclock) != 0)
 				return -1;
+		} else if (xlog_meta_key_equal(key, key_end, SHARD_COUNT_KEY)) {
+			/*
+			 * Shards: <count>
+			 */
+			char *count_end;
+			unsigned long count = strtoul(val, &count_end, 10);
+			if (count_end != val_end || count > UINT32_MAX) {
+				diag_set(XlogError, "can't parse shard count");
+				return -1;
+			}
+			meta->shard_count = count;
 		} else if (xlog_meta_key_equal(key, key_end, VERSION_KEY)) {
 			/* Ignore Version: for now */
 		} else {
@@ -658,6 +676,18 @@ xdir_format_filename(struct xdir *dir, int64_t signature,
 					      inprogress_suffix : "");
 }
 
+const char *
+xdir_format_shard_filename(struct xdir *dir, int64_t signature,
+			   uint32_t shard, enum log_suffix suffix)
+{
+	if (shard == 0)
+		return xdir_format_filename(dir, signature, suffix);
+	return tt_snprintf(PATH_MAX, "%s/%020lld.%u%s%s",
+			   dir->dirname, (long long) signature,
+			   (unsigned)shard, dir->filename_ext,
+			   suffix == INPROGRESS ? inprogress_suffix : "");
+}
+
 static void
 xdir_say_gc(int result, int errorno, const char *filename)
 {
@@ -1138,8 +1168,12 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	if (log->opts.zdict != NULL) {
+		ZSTD_compressBegin_usingCDict(log->zctx, log->opts.zdict);
+	} else {
+		/* 3 is compression level. */
+		ZSTD_compressBegin(log->zctx, 3);
+	}
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1693,7 +1727,8 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 
 int
 xlog_tx_decode(const char *data, const char *data_end,
-	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
+	       char *rows, char *rows_end, ZSTD_DStream *zdctx,
+	       const ZSTD_DDict *zdict)
 {
 	/* Decode fixheader */
 	struct xlog_fixheader fixheader;
@@ -1733,6 +1768,8 @@ xlog_tx_decode(const char *data, const char *data_end,
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
 	ZSTD_initDStream(zdctx);
+	if (zdict != NULL)
+		ZSTD_DCtx_refDDict(zdctx, zdict);
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -1782,6 +1819,7 @@ xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 
 	ibuf_create(&tx_cursor->rows, &cord()->slabc,
 		    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	tx_cursor->last_row = NULL;
 	if (fixheader.magic == row_marker) {
 		void *dst = ibuf_alloc(&tx_cursor->rows, fixheader.len);
 		if (dst == NULL) {
@@ -1826,6 +1864,7 @@ xlog_tx_cursor_next_row(struct xlog_tx_cursor *tx_cursor,
 {
 	if (ibuf_used(&tx_cursor->rows) == 0)
 		return 1;
+	tx_cursor->last_row = tx_cursor->rows.rpos;
 	/* Return row from xlog tx buffer */
 	int rc = xrow_header_decode(xrow,
 				    (const char **)&tx_cursor->rows.rpos,
@@ -1975,6 +2014,19 @@ xlog_cursor_next(struct xlog_cursor *cursor,
 	return 0;
 }
 
+void
+xlog_cursor_unread_row(struct xlog_cursor *cursor)
+{
+	/*
+	 * The tx is destroyed only when the next row is fetched,
+	 * so the last fetched row is still in the rows buffer.
+	 */
+	assert(cursor->state == XLOG_CURSOR_TX);
+	assert(cursor->tx_cursor.last_row != NULL);
+	cursor->tx_cursor.rows.rpos = cursor->tx_cursor.last_row;
+	cursor->tx_cursor.last_row = NULL;
+}
+
 int
 xlog_cursor_openfd(struct xlog_cursor *i, int fd, const char *name)
 {
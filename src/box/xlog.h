@@ -82,6 +82,12 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * Zstd dictionary to compress data with or NULL. The same
+	 * dictionary must be passed to xlog_tx_decode() to read
+	 * the data back. Not owned by the xlog.
+	 */
+	const ZSTD_CDict *zdict;
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -204,6 +210,17 @@ const char *
 xdir_format_filename(struct xdir *dir, int64_t signature,
 		     enum log_suffix suffix);
 
+/**
+ * Return the name of a shard of the file with the given vector
+ * clock sum: <signature>.<shard><extension>[.inprogress]. Shard 0
+ * is the file itself, @sa xdir_format_filename(). Shards aren't
+ * indexed by xdir_scan(): they are managed by the owner of the
+ * directory with the aid of xlog_meta::shard_count.
+ */
+const char *
+xdir_format_shard_filename(struct xdir *dir, int64_t signature,
+			   uint32_t shard, enum log_suffix suffix);
+
 /**
  * Return true if the given directory index has files whose
  * signature is less than specified.
@@ -319,6 +336,13 @@ struct xlog_meta {
 	 * directory for missing WALs.
 	 */
 	struct vclock prev_vclock;
+	/**
+	 * Text file header: number of files the data is split
+	 * into, including this one, @sa xdir_format_shard_filename().
+	 * Zero means that the file isn't split. Written only if
+	 * greater than 1.
+	 */
+	uint32_t shard_count;
 };
 
 /**
@@ -576,6 +600,8 @@ struct xlog_tx_cursor
 	struct ibuf rows;
 	/** tx size */
 	size_t size;
+	/** start of the last fetched row in the rows buffer */
+	char *last_row;
 };
 
 /**
@@ -627,13 +653,15 @@ xlog_tx_cursor_pos(struct xlog_tx_cursor *tx_cursor)
  * @param data_end the end of @a data buffer
  * @param[out] rows a buffer to store decoded rows
  * @param[out] rows_end the end of @a rows buffer
+ * @param zdctx zstd decompression context
+ * @param zdict dictionary the data was compressed with or NULL
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end,
-	       ZSTD_DStream *zdctx);
+	       ZSTD_DStream *zdctx, const ZSTD_DDict *zdict);
 
 /* }}} */
 
@@ -772,6 +800,14 @@ int
 xlog_cursor_next(struct xlog_cursor *cursor,
 		 struct xrow_header *xrow, bool force_recovery);
 
+/**
+ * Return the row fetched by the last successful call to
+ * xlog_cursor_next() to the cursor so that the next call
+ * fetches it again.
+ */
+void
+xlog_cursor_unread_row(struct xlog_cursor *cursor);
+
 /**
  * Move to the next xlog tx
  *
@@ -665,12 +665,13 @@ iproto_prepare_header(struct obuf *buf, struct obuf_svp *svp, size_t size)
 }
 
 void
-iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		    uint32_t schema_version, uint32_t count)
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, size_t ext_size)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
-			        obuf_size(buf) - svp->used -
+			        obuf_size(buf) - svp->used + ext_size -
 				IPROTO_HEADER_LEN);
 
 	struct iproto_body_bin body = iproto_body_bin;
@@ -685,12 +685,26 @@ iproto_prepare_select(struct obuf *buf, struct obuf_svp *svp)
 }
 
 /**
- * Write select header to a preallocated buffer.
+ * Write select header to a preallocated buffer. The response body
+ * consists of the data written to @a buf after the header and
+ * @a ext_size bytes sent to the client separately.
  * This function doesn't throw (and we rely on this in iproto.cc).
  */
 void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, size_t ext_size);
+
+/**
+ * Write select header to a preallocated buffer.
+ * This function doesn't throw (and we rely on this in iproto.cc).
+ */
+static inline void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		    uint32_t schema_version, uint32_t count);
+		    uint32_t schema_version, uint32_t count)
+{
+	iproto_reply_select_ext(buf, svp, sync, schema_version, count, 0);
+}
 
 /**
  * Encode iproto header with IPROTO_OK response code.
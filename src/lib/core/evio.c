@@ -56,6 +56,12 @@ struct evio_service_entry {
 	struct ev_io ev;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
+	/**
+	 * Set if the acceptor socket was created by
+	 * evio_service_bind_reuseport(), and so is closed
+	 * on detach.
+	 */
+	bool is_reuseport;
 };
 
 static inline bool
@@ -153,6 +159,20 @@ evio_setsockopt_server(int fd, int family, int type)
 	return 0;
 }
 
+/** Let other sockets bind to the address of the socket. */
+static int
+evio_setsockopt_reuseport(int fd)
+{
+#ifdef SO_REUSEPORT
+	int on = 1;
+	return sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#else
+	(void)fd;
+	diag_set(IllegalParams, "SO_REUSEPORT is not supported");
+	return -1;
+#endif
+}
+
 static inline const char *
 evio_service_name(struct evio_service *service)
 {
@@ -263,6 +283,10 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 				   SOCK_STREAM) != 0)
 		goto error;
 
+	if (entry->service->reuseport && entry->addr.sa_family != AF_UNIX &&
+	    evio_setsockopt_reuseport(fd) != 0)
+		goto error;
+
 	if (sio_bind(fd, &entry->addr, entry->addr_len) != 0)
 		goto error;
 
@@ -320,6 +344,7 @@ evio_service_entry_create(struct evio_service_entry *entry,
 	ev_io_set(&entry->ev, -1, 0);
 	entry->ev.data = entry;
 	entry->service = service;
+	entry->is_reuseport = false;
 }
 
 /**
@@ -385,6 +410,10 @@ evio_service_entry_detach(struct evio_service_entry *entry)
 		ev_io_stop(entry->service->loop, &entry->ev);
 		entry->addr_len = 0;
 	}
+	if (entry->is_reuseport && entry->ev.fd >= 0 &&
+	    close(entry->ev.fd) < 0)
+		say_error("Failed to close socket: %s", strerror(errno));
+	entry->is_reuseport = false;
 	ev_io_set(&entry->ev, -1, 0);
 	uri_destroy(&entry->uri);
 }
@@ -425,6 +454,25 @@ evio_service_entry_attach(struct evio_service_entry *dst,
 	ev_io_set(&dst->ev, src->ev.fd, EV_READ);
 }
 
+/**
+ * Bind a new SO_REUSEPORT socket to the address @a src is bound
+ * to, or share the socket of @a src if it isn't an IP socket.
+ */
+static int
+evio_service_entry_bind_reuseport(struct evio_service_entry *dst,
+				  const struct evio_service_entry *src)
+{
+	evio_service_entry_attach(dst, src);
+	if (dst->addr.sa_family == AF_UNIX)
+		return 0;
+	ev_io_set(&dst->ev, -1, 0);
+	assert(dst->service->reuseport);
+	if (evio_service_entry_bind_addr(dst) != 0)
+		return -1;
+	dst->is_reuseport = true;
+	return 0;
+}
+
 static inline int
 evio_service_reuse_addr(const struct uri_set *uri_set)
 {
@@ -482,6 +530,22 @@ evio_service_attach(struct evio_service *dst, const struct evio_service *src)
 		evio_service_entry_attach(&dst->entries[i], &src->entries[i]);
 }
 
+int
+evio_service_bind_reuseport(struct evio_service *dst,
+			    const struct evio_service *src)
+{
+	assert(dst->entry_count == 0);
+	assert(src->reuseport);
+	dst->reuseport = true;
+	evio_service_create_entries(dst, src->entry_count);
+	for (int i = 0; i < src->entry_count; i++) {
+		if (evio_service_entry_bind_reuseport(&dst->entries[i],
+						      &src->entries[i]) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 void
 evio_service_detach(struct evio_service *service)
 {
@@ -88,6 +88,12 @@ struct evio_service {
         evio_accept_f on_accept;
         void *on_accept_param;
         ev_loop *loop;
+        /**
+         * Set SO_REUSEPORT on IP acceptor sockets so that other
+         * services can bind to the same addresses, see
+         * evio_service_bind_reuseport().
+         */
+        bool reuseport;
 };
 
 /**
@@ -135,6 +141,19 @@ evio_service_stop(struct evio_service *service);
 void
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
+/**
+ * Bind @a dst to the addresses @a src is bound to. @a src must be
+ * bound with the reuseport flag set. IP acceptor sockets are
+ * created anew with SO_REUSEPORT, so the kernel balances incoming
+ * connections between all services listening on the addresses,
+ * other sockets are shared with @a src as by evio_service_attach().
+ * The service must be stopped with evio_service_detach(), which
+ * closes the sockets created by this function.
+ */
+int
+evio_service_bind_reuseport(struct evio_service *dst,
+			    const struct evio_service *src);
+
 bool
 evio_service_is_active(const struct evio_service *service);
 
@@ -0,0 +1,262 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "mp_compression.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <zstd.h>
+
+#include "mp_extension_types.h"
+#include "msgpuck.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+
+enum {
+	/** Zstd compression level used for tuple fields. */
+	MP_COMPRESSION_ZSTD_LEVEL = 3,
+};
+
+/** Per-thread codec contexts, created on demand. */
+struct mp_compression_ctx {
+	ZSTD_CCtx *zcctx;
+	ZSTD_DCtx *zdctx;
+};
+
+static pthread_key_t mp_compression_ctx_key;
+static pthread_once_t mp_compression_ctx_key_once = PTHREAD_ONCE_INIT;
+
+/** Destructor for the mp_compression_ctx_key thread-local variable. */
+static void
+mp_compression_ctx_delete(void *arg)
+{
+	struct mp_compression_ctx *ctx = (struct mp_compression_ctx *)arg;
+	assert(ctx != NULL);
+	ZSTD_freeCCtx(ctx->zcctx);
+	ZSTD_freeDCtx(ctx->zdctx);
+	free(ctx);
+}
+
+static void
+mp_compression_ctx_key_create(void)
+{
+	tt_pthread_key_create(&mp_compression_ctx_key,
+			      mp_compression_ctx_delete);
+}
+
+/** Get codec contexts of the current thread. */
+static struct mp_compression_ctx *
+mp_compression_ctx(void)
+{
+	tt_pthread_once(&mp_compression_ctx_key_once,
+			mp_compression_ctx_key_create);
+	struct mp_compression_ctx *ctx = (struct mp_compression_ctx *)
+		tt_pthread_getspecific(mp_compression_ctx_key);
+	if (ctx == NULL) {
+		ctx = (struct mp_compression_ctx *)calloc(1, sizeof(*ctx));
+		if (ctx == NULL)
+			return NULL;
+		tt_pthread_setspecific(mp_compression_ctx_key, ctx);
+	}
+	return ctx;
+}
+
+static ZSTD_CCtx *
+mp_compression_zcctx(void)
+{
+	struct mp_compression_ctx *ctx = mp_compression_ctx();
+	if (ctx == NULL)
+		return NULL;
+	if (ctx->zcctx == NULL)
+		ctx->zcctx = ZSTD_createCCtx();
+	return ctx->zcctx;
+}
+
+static ZSTD_DCtx *
+mp_compression_zdctx(void)
+{
+	struct mp_compression_ctx *ctx = mp_compression_ctx();
+	if (ctx == NULL)
+		return NULL;
+	if (ctx->zdctx == NULL)
+		ctx->zdctx = ZSTD_createDCtx();
+	return ctx->zdctx;
+}
+
+size_t
+mp_sizeof_compression_max(size_t src_size)
+{
+	size_t len = mp_sizeof_uint(compression_type_MAX) +
+		     mp_sizeof_uint(src_size) + ZSTD_compressBound(src_size);
+	return mp_sizeof_ext(len);
+}
+
+char *
+mp_compress(char *dst, const char *src, size_t src_size,
+	    enum compression_type type)
+{
+	assert(type == COMPRESSION_TYPE_ZSTD);
+	(void)type;
+	ZSTD_CCtx *zcctx = mp_compression_zcctx();
+	if (zcctx == NULL)
+		return NULL;
+	/*
+	 * The extension header size depends on the compressed size,
+	 * so compress the data to the end of the buffer first, then
+	 * move it right after the header.
+	 */
+	size_t bound = ZSTD_compressBound(src_size);
+	char *data = dst + mp_sizeof_compression_max(src_size) - bound;
+	size_t size = ZSTD_compressCCtx(zcctx, data, bound, src, src_size,
+					MP_COMPRESSION_ZSTD_LEVEL);
+	if (ZSTD_isError(size))
+		return NULL;
+	uint32_t len = mp_sizeof_uint(type) + mp_sizeof_uint(src_size) + size;
+	/* Not worth it. */
+	if (mp_sizeof_ext(len) >= src_size)
+		return NULL;
+	char *pos = mp_encode_extl(dst, MP_COMPRESSION, len);
+	pos = mp_encode_uint(pos, type);
+	pos = mp_encode_uint(pos, src_size);
+	assert(pos <= data);
+	memmove(pos, data, size);
+	return pos + size;
+}
+
+bool
+mp_is_compressed(const char *data)
+{
+	if (mp_typeof(*data) != MP_EXT)
+		return false;
+	int8_t ext_type;
+	mp_decode_extl(&data, &ext_type);
+	return ext_type == MP_COMPRESSION;
+}
+
+/**
+ * Decode the header of an MP_COMPRESSION payload. On success
+ * advances @a data to the compressed data and returns 0.
+ */
+static int
+mp_decode_compression_header(const char **data, const char *end,
+			     enum compression_type *type, size_t *size)
+{
+	if (*data >= end || mp_typeof(**data) != MP_UINT ||
+	    mp_check_uint(*data, end) > 0)
+		return -1;
+	uint64_t value = mp_decode_uint(data);
+	if (value == COMPRESSION_TYPE_NONE || value >= compression_type_MAX)
+		return -1;
+	*type = (enum compression_type)value;
+	if (*data >= end || mp_typeof(**data) != MP_UINT ||
+	    mp_check_uint(*data, end) > 0)
+		return -1;
+	value = mp_decode_uint(data);
+	if (value == 0 || value > SIZE_MAX)
+		return -1;
+	*size = value;
+	return 0;
+}
+
+size_t
+mp_decompress_size(const char *data)
+{
+	int8_t ext_type;
+	uint32_t len = mp_decode_extl(&data, &ext_type);
+	if (ext_type != MP_COMPRESSION)
+		return 0;
+	enum compression_type type;
+	size_t size;
+	if (mp_decode_compression_header(&data, data + len, &type, &size) != 0)
+		return 0;
+	return size;
+}
+
+/**
+ * Decompress an MP_COMPRESSION payload of length @a len to @a dst.
+ * Returns the size of the decompressed value or 0 on error.
+ */
+static size_t
+mp_decompress_payload(const char *data, uint32_t len,
+		      char *dst, size_t dst_size)
+{
+	const char *end = data + len;
+	enum compression_type type;
+	size_t size;
+	if (mp_decode_compression_header(&data, end, &type, &size) != 0)
+		return 0;
+	if (size > dst_size)
+		return 0;
+	assert(type == COMPRESSION_TYPE_ZSTD);
+	ZSTD_DCtx *zdctx = mp_compression_zdctx();
+	if (zdctx == NULL)
+		return 0;
+	size_t rc = ZSTD_decompressDCtx(zdctx, dst, dst_size,
+					data, end - data);
+	if (ZSTD_isError(rc) || rc != size)
+		return 0;
+	return size;
+}
+
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size)
+{
+	const char *data = *src;
+	int8_t ext_type;
+	uint32_t len = mp_decode_extl(&data, &ext_type);
+	if (ext_type != MP_COMPRESSION)
+		return 0;
+	size_t size = mp_decompress_payload(data, len, dst, dst_size);
+	if (size == 0)
+		return 0;
+	*src = data + len;
+	return size;
+}
+
+/**
+ * Decompress an MP_COMPRESSION payload to a new buffer, which
+ * must be freed by the caller. Returns NULL on error.
+ */
+static char *
+mp_decompress_payload_dup(const char *data, uint32_t len)
+{
+	const char *pos = data;
+	enum compression_type type;
+	size_t size;
+	if (mp_decode_compression_header(&pos, data + len, &type, &size) != 0)
+		return NULL;
+	char *buf = (char *)malloc(size);
+	if (buf == NULL)
+		return NULL;
+	if (mp_decompress_payload(data, len, buf, size) == 0) {
+		free(buf);
+		return NULL;
+	}
+	return buf;
+}
+
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
+{
+	char *value = mp_decompress_payload_dup(*data, len);
+	if (value == NULL)
+		return -1;
+	int rc = mp_snprint(buf, size, value);
+	free(value);
+	*data += len;
+	return rc;
+}
+
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len)
+{
+	char *value = mp_decompress_payload_dup(*data, len);
+	if (value == NULL)
+		return -1;
+	int rc = mp_fprint(file, value);
+	free(value);
+	*data += len;
+	return rc;
+}
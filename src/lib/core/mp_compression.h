@@ -11,57 +11,81 @@
 # include "mp_compression_impl.h"
 #else /* !defined(ENABLE_TUPLE_COMPRESSION) */
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include "tt_compression.h"
-#include <trivia/util.h>
 
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
-static inline char *
+/*
+ * A compressed MsgPack value is stored as MP_EXT of type
+ * MP_COMPRESSION with the following payload:
+ *
+ *   MP_UINT    compression type
+ *   MP_UINT    size of the original MsgPack value
+ *   BIN        original value compressed with the given codec
+ *              (up to the end of the extension)
+ */
+
+/**
+ * Return the max size of an MP_COMPRESSION value holding
+ * @a src_size bytes of compressed data.
+ */
+size_t
+mp_sizeof_compression_max(size_t src_size);
+
+/**
+ * Compress the MsgPack value @a src of size @a src_size with the
+ * given codec and encode it as MP_COMPRESSION to @a dst. The
+ * buffer must be at least mp_sizeof_compression_max(src_size)
+ * bytes long.
+ *
+ * Returns a pointer to the end of the encoded value or NULL if
+ * the value can't be compressed. The diagnostics area is not set
+ * in the latter case: the caller is supposed to store the value
+ * uncompressed.
+ */
+char *
 mp_compress(char *dst, const char *src, size_t src_size,
-	    enum compression_type type)
-{
-        (void)dst;
-        (void)src;
-        (void)src_size;
-        (void)type;
-        unreachable();
-        return NULL;
-}
+	    enum compression_type type);
+
+/** Check if @a data points to an MP_COMPRESSION value. */
+bool
+mp_is_compressed(const char *data);
 
-static inline size_t
-mp_decompress(const char **src, char *dst, size_t dst_size)
-{
-        (void)src;
-        (void)dst;
-        (void)dst_size;
-        unreachable();
-        return 0;
-}
+/**
+ * Return the size of the original value stored in the
+ * MP_COMPRESSION value @a data or 0 if the value is malformed.
+ */
+size_t
+mp_decompress_size(const char *data);
 
-static inline int
-mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
-{
-        (void)buf;
-        (void)size;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/**
+ * Decompress the MP_COMPRESSION value @a *src to @a dst, which
+ * must be at least mp_decompress_size() bytes long, and advance
+ * @a src past the value. Returns the size of the decompressed
+ * value or 0 if the value is malformed. The diagnostics area is
+ * not set on error.
+ *
+ * Thread-safe: codec contexts are allocated per thread.
+ */
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size);
+
+/**
+ * Print the decompressed value of an MP_COMPRESSION extension
+ * with payload @a data of length @a len to a buffer.
+ */
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len);
 
-static inline int
-mp_fprint_compression(FILE *file, const char **data, uint32_t len)
-{
-        (void)file;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/** Same as mp_snprint_compression(), but prints to a file. */
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len);
 
 #if defined(__cplusplus)
 } /* extern "C" */
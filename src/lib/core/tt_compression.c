@@ -10,5 +10,6 @@
 #endif
 
 const char *compression_type_strs[] = {
-        "none",
+	/* [COMPRESSION_TYPE_NONE] = */ "none",
+	/* [COMPRESSION_TYPE_ZSTD] = */ "zstd",
 };
@@ -19,9 +19,11 @@
 extern "C" {
 #endif
 
+/** Compression type of a tuple field. */
 enum compression_type {
-        COMPRESSION_TYPE_NONE = 0,
-        compression_type_MAX
+	COMPRESSION_TYPE_NONE = 0,
+	COMPRESSION_TYPE_ZSTD,
+	compression_type_MAX
 };
 
 extern const char *compression_type_strs[];
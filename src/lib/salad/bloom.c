@@ -39,15 +39,74 @@
 #include <assert.h>
 #include <string.h>
 
-int
-bloom_create(struct bloom *bloom, uint32_t number_of_values,
-	     double false_positive_rate)
+const char *bloom_type_strs[] = { "classic", "blocked" };
+
+/**
+ * Return the expected false positive rate of a split block bloom
+ * filter storing on average @a load values per half block.
+ *
+ * The number of values stored in a half block is approximated
+ * with the Poisson distribution. A half block storing j values
+ * gives a false positive if all 8 bits selected by a lookup are
+ * set, each of them is set with probability 1 - (1 - 1/32)^j.
+ */
+static double
+bloom_blocked_fpr(double load)
+{
+	const double word_bits = CHAR_BIT * sizeof(uint32_t);
+	double p = exp(-load);
+	double fpr = 0;
+	uint32_t j_max = load + 10 * sqrt(load) + 20;
+	for (uint32_t j = 1; j <= j_max; j++) {
+		p *= load / j;
+		double bit_set = 1 - pow(1 - 1 / word_bits, j);
+		fpr += p * pow(bit_set, BLOOM_BLOCKED_HASH_COUNT);
+	}
+	return fpr;
+}
+
+/**
+ * Return the number of blocks a split block bloom filter needs to
+ * store the given number of values with the given false positive
+ * rate.
+ */
+static uint32_t
+bloom_blocked_block_count(uint32_t number_of_values,
+			  double false_positive_rate)
 {
-	/* Optimal hash_count and bit count calculation */
-	uint16_t hash_count = ceil(log(false_positive_rate) / log(0.5));
-	uint64_t bit_count = ceil(number_of_values * hash_count / log(2));
+	/* Start with the size of a classic filter with 8 hashes. */
+	double k = BLOOM_BLOCKED_HASH_COUNT;
+	double bit_count = -k * number_of_values /
+			   log(1 - pow(false_positive_rate, 1 / k));
 	uint32_t block_bits = CHAR_BIT * sizeof(struct bloom_block);
-	uint32_t block_count = (bit_count + block_bits - 1) / block_bits;
+	uint64_t block_count = ceil(bit_count / block_bits);
+	if (block_count == 0)
+		block_count = 1;
+	/* Grow it until blocking doesn't break the false positive rate. */
+	while (bloom_blocked_fpr((double)number_of_values /
+				 (2 * block_count)) > false_positive_rate)
+		block_count += block_count / 16 + 1;
+	return block_count;
+}
+
+int
+bloom_create(struct bloom *bloom, enum bloom_type type,
+	     uint32_t number_of_values, double false_positive_rate)
+{
+	uint16_t hash_count;
+	uint32_t block_count;
+	if (type == BLOOM_TYPE_BLOCKED) {
+		hash_count = BLOOM_BLOCKED_HASH_COUNT;
+		block_count = bloom_blocked_block_count(number_of_values,
+							false_positive_rate);
+	} else {
+		/* Optimal hash_count and bit count calculation */
+		hash_count = ceil(log(false_positive_rate) / log(0.5));
+		uint64_t bit_count = ceil(number_of_values * hash_count /
+					  log(2));
+		uint32_t block_bits = CHAR_BIT * sizeof(struct bloom_block);
+		block_count = (bit_count + block_bits - 1) / block_bits;
+	}
 
 	bloom->table = calloc(block_count, sizeof(*bloom->table));
 	if (bloom->table == NULL)
@@ -55,6 +114,7 @@ bloom_create(struct bloom *bloom, uint32_t number_of_values,
 
 	bloom->table_size = block_count;
 	bloom->hash_count = hash_count;
+	bloom->type = type;
 	return 0;
 }
 
@@ -67,6 +127,10 @@ bloom_destroy(struct bloom *bloom)
 double
 bloom_fpr(const struct bloom *bloom, uint32_t number_of_values)
 {
+	if (bloom->type == BLOOM_TYPE_BLOCKED) {
+		return bloom_blocked_fpr((double)number_of_values /
+					 (2 * bloom->table_size));
+	}
 	/* Number of hash functions. */
 	uint16_t k = bloom->hash_count;
 	/* Number of bits. */
@@ -38,6 +38,10 @@
 #include <stdio.h> /* printf */
 #include "small/matras.h"
 
+#if defined(__SSE4_2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 /* {{{ BPS-tree description */
 /**
  * BPS-tree implementation.
@@ -163,6 +167,16 @@
  * bool bps_tree_iterator_prev(tree, itr);
  * void bps_tree_iterator_freeze(tree, itr);
  * void bps_tree_iterator_destroy(tree, itr);
+ * // read views:
+ * struct bps_tree_view;
+ * void bps_tree_view_create(view, tree);
+ * void bps_tree_view_destroy(view, tree);
+ * // only if BPS_INNER_CARD is defined:
+ * struct bps_tree_iterator bps_tree_iterator_at(tree, offset);
+ * struct bps_tree_iterator bps_tree_lower_bound_get_offset(tree, key, exact,
+ *                                                          offset);
+ * struct bps_tree_iterator bps_tree_upper_bound_get_offset(tree, key, exact,
+ *                                                          offset);
  */
 /* }}} */
 
@@ -302,6 +316,39 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * A switch that makes inner blocks store the number of elements in
+ * the subtree of each child (subtree cardinality). It enables
+ * bps_tree_iterator_at() and bps_tree_*_bound_get_offset() that
+ * find the N-th element or the offset of a key in logarithmic time
+ * at the cost of a slightly smaller fan-out of inner blocks and
+ * a bit more work on each modification. To turn it on,
+ * #define BPS_INNER_CARD
+ */
+
+/**
+ * Optional comparison hints. If an element stores a 64-bit hint
+ * such that elements with different hints compare as their hints
+ * do, a search in a block first counts the elements whose hints
+ * are less and greater than the hint of the searched value and
+ * then runs the comparison function only on the remaining range of
+ * elements with equal hints. The count is done with a scalar loop
+ * by default. If the hint is the second half of a 16-byte element,
+ * it is done with SSE4.2 or AVX2 instructions when they are enabled
+ * at compile time (-DENABLE_AVX=ON enables SSE4.2, AVX2 needs
+ * -mavx2 or -march in CFLAGS). UINT64_MAX is reserved for
+ * an unknown hint: such elements are always compared, and if the
+ * searched value has no hint, the whole block is searched.
+ * To turn it on, define:
+ * BPS_TREE_ELEM_HINT(elem) - lvalue of the hint stored in elem;
+ * BPS_TREE_KEY_HINT(key, arg) - hint of a searched key;
+ * BPS_TREE_SEARCH_ELEM_HINT(elem, arg) - hint of a searched elem.
+ * Example:
+ * #define BPS_TREE_ELEM_HINT(elem) ((elem).hint)
+ * #define BPS_TREE_KEY_HINT(key, arg) ((key)->hint)
+ * #define BPS_TREE_SEARCH_ELEM_HINT(elem, arg) ((elem).hint)
+ */
+
 /**
  * A switch that enables collection of executions of different
  * branches of code. Used only for debug purposes, I hope you
@@ -318,6 +365,13 @@ namespace BPS_TREE_NAMESPACE {
 /* {{{ BPS-tree internal settings */
 typedef int16_t bps_tree_pos_t;
 typedef uint32_t bps_tree_block_id_t;
+/*
+ * Number of elements in a subtree, see BPS_INNER_CARD. 32 bits are
+ * enough for a subtree of a child of the root unless the tree holds
+ * hundreds of billions of elements, while a wider type would cost
+ * inner blocks a few children.
+ */
+typedef uint32_t bps_tree_card_t;
 /* }}} */
 
 /* {{{ Compile time utils */
@@ -365,6 +419,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_inner _bps(inner)
 #define bps_garbage _bps(garbage)
 #define bps_tree_iterator _api_name(iterator)
+#define bps_tree_view _api_name(view)
 #define bps_inner_path_elem _bps(inner_path_elem)
 #define bps_leaf_path_elem _bps(leaf_path_elem)
 
@@ -394,6 +449,11 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_iterator_prev _api_name(iterator_prev)
 #define bps_tree_iterator_freeze _api_name(iterator_freeze)
 #define bps_tree_iterator_destroy _api_name(iterator_destroy)
+#define bps_tree_view_create _api_name(view_create)
+#define bps_tree_view_destroy _api_name(view_destroy)
+#define bps_tree_iterator_at _api_name(iterator_at)
+#define bps_tree_lower_bound_get_offset _api_name(lower_bound_get_offset)
+#define bps_tree_upper_bound_get_offset _api_name(upper_bound_get_offset)
 #define bps_tree_debug_check _api_name(debug_check)
 #define bps_tree_print _api_name(print)
 #define bps_tree_debug_check_internal_functions \
@@ -412,6 +472,8 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_restore_block_ver _bps_tree(restore_block_ver)
 #define bps_tree_root _bps_tree(root)
 #define bps_tree_touch_block _bps_tree(touch_block)
+#define bps_tree_hint_count _bps_tree(hint_count)
+#define bps_tree_hint_narrow _bps_tree(hint_narrow)
 #define bps_tree_find_ins_point_key _bps_tree(find_ins_point_key)
 #define bps_tree_find_ins_point_elem _bps_tree(find_ins_point_elem)
 #define bps_tree_find_after_ins_point_key _bps_tree(find_after_ins_point_key)
@@ -429,6 +491,13 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_touch_leaf_path_max_elem _bps_tree(touch_leaf_path_max_elem)
 #define bps_tree_touch_path _bps_tree(touch_path_max_elem)
 #define bps_tree_process_replace _bps_tree(process_replace)
+#define bps_tree_inner_card_sum _bps_tree(inner_card_sum)
+#define bps_tree_inner_set_card _bps_tree(inner_set_card)
+#define bps_tree_inner_move_cards _bps_tree(inner_move_cards)
+#define bps_tree_block_card _bps_tree(block_card)
+#define bps_tree_update_card _bps_tree(update_card)
+#define bps_tree_update_leaf_card _bps_tree(update_leaf_card)
+#define bps_tree_update_inner_card _bps_tree(update_inner_card)
 #define bps_tree_debug_memmove _bps_tree(debug_memmove)
 #define bps_tree_insert_into_leaf _bps_tree(insert_into_leaf)
 #define bps_tree_insert_into_inner _bps_tree(insert_into_inner)
@@ -567,6 +636,22 @@ struct bps_tree_iterator {
 	struct matras_view view;
 };
 
+/**
+ * Tree read view. Freezes the whole tree state at the moment of creation.
+ * The frozen tree can be searched and iterated with the usual read-only
+ * functions (bps_tree_find, bps_tree_lower_bound, bps_tree_iterator_next
+ * and so on) passing a pointer to the tree member. Since the frozen blocks
+ * are never modified by the original tree, the frozen tree may be read
+ * from any thread, but the view must be created and destroyed in the
+ * thread that owns the original tree.
+ */
+struct bps_tree_view {
+	/* Copy of the tree header that reads blocks from the view */
+	struct bps_tree tree;
+	/* Version of matras memory the tree copy refers to */
+	struct matras_view view;
+};
+
 /**
  * Pointer to function that allocates extent of size BPS_TREE_EXTENT_SIZE
  * BPS-tree properly handles with NULL result but could leak memory
@@ -860,6 +945,68 @@ bps_tree_iterator_freeze(struct bps_tree *tree, struct bps_tree_iterator *itr);
 static inline void
 bps_tree_iterator_destroy(struct bps_tree *tree, struct bps_tree_iterator *itr);
 
+/**
+ * @brief Create a read view of a tree. All following tree modifications
+ * will not be visible through view->tree. The view must be destroyed with
+ * a bps_tree_view_destroy call after usage.
+ * @param view - pointer to a read view to create
+ * @param tree - pointer to a tree
+ */
+static inline void
+bps_tree_view_create(struct bps_tree_view *view, struct bps_tree *tree);
+
+/**
+ * @brief Destroy a read view created with bps_tree_view_create.
+ * @param view - pointer to a read view
+ * @param tree - pointer to the tree the view was created for
+ */
+static inline void
+bps_tree_view_destroy(struct bps_tree_view *view, struct bps_tree *tree);
+
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Get an iterator to the element with the given offset, i.e.
+ * the number of elements that are less than it.
+ * @param tree - pointer to a tree
+ * @param offset - offset of the element
+ * @return - Iterator pointing to the element. Invalid if the offset is
+ *  greater than or equal to the tree size.
+ */
+static inline struct bps_tree_iterator
+bps_tree_iterator_at(const struct bps_tree *tree, size_t offset);
+
+/**
+ * @brief Same as bps_tree_lower_bound, but also returns the offset of
+ * the found element (the number of elements that are less than key).
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - see bps_tree_lower_bound. Pass NULL if you don't need it.
+ * @param offset - the offset is stored here. It is equal to the tree size
+ *  if the returned iterator is invalid.
+ * @return - Lower-bound iterator.
+ */
+static inline struct bps_tree_iterator
+bps_tree_lower_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset);
+
+/**
+ * @brief Same as bps_tree_upper_bound, but also returns the offset of
+ * the found element (the number of elements that are less than or equal
+ * to key).
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - see bps_tree_upper_bound. Pass NULL if you don't need it.
+ * @param offset - the offset is stored here. It is equal to the tree size
+ *  if the returned iterator is invalid.
+ * @return - Upper-bound iterator.
+ */
+static inline struct bps_tree_iterator
+bps_tree_upper_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset);
+#endif /* BPS_INNER_CARD */
+
 #ifndef BPS_TREE_NO_DEBUG
 
 /**
@@ -938,9 +1085,18 @@ enum bps_tree_max_sizes {
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block)
 		 - 2 * sizeof(bps_tree_block_id_t) )
 		/ sizeof(bps_tree_elem_t),
+#ifdef BPS_INNER_CARD
+	/* Reserve one more card for alignment of child_cards. */
+	BPS_TREE_MAX_COUNT_IN_INNER =
+		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block)
+		 - sizeof(bps_tree_card_t))
+		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)
+		   + sizeof(bps_tree_card_t)),
+#else
 	BPS_TREE_MAX_COUNT_IN_INNER =
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block))
 		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)),
+#endif
 	BPS_TREE_MAX_DEPTH = 16
 };
 
@@ -986,6 +1142,10 @@ struct bps_inner {
 	bps_tree_elem_t elems[BPS_TREE_MAX_COUNT_IN_INNER - 1];
 	/* Corresponding child IDs */
 	bps_tree_block_id_t child_ids[BPS_TREE_MAX_COUNT_IN_INNER];
+#ifdef BPS_INNER_CARD
+	/* Number of elements in the corresponding child subtrees */
+	bps_tree_card_t child_cards[BPS_TREE_MAX_COUNT_IN_INNER];
+#endif
 };
 
 /**
@@ -1061,6 +1221,73 @@ struct bps_leaf_path_elem {
 	bps_tree_pos_t max_elem_pos;
 };
 
+/**
+ * @brief Get total number of elements in subtrees of @a num children
+ * of an inner block starting from position @a pos.
+ * Always returns 0 if BPS_INNER_CARD is not defined.
+ */
+static inline size_t
+bps_tree_inner_card_sum(const struct bps_inner *inner, bps_tree_pos_t pos,
+			bps_tree_pos_t num)
+{
+#ifdef BPS_INNER_CARD
+	assert(pos >= 0 && num >= 0);
+	assert(pos + num <= BPS_TREE_MAX_COUNT_IN_INNER);
+	size_t res = 0;
+	for (bps_tree_pos_t i = pos; i < pos + num; i++)
+		res += inner->child_cards[i];
+	return res;
+#else
+	(void)inner;
+	(void)pos;
+	(void)num;
+	return 0;
+#endif
+}
+
+/**
+ * @brief Set number of elements in subtree of a child of an inner block.
+ * Does nothing if BPS_INNER_CARD is not defined.
+ */
+static inline void
+bps_tree_inner_set_card(struct bps_inner *inner, bps_tree_pos_t pos,
+			bps_tree_card_t card)
+{
+#ifdef BPS_INNER_CARD
+	assert(pos >= 0 && pos < BPS_TREE_MAX_COUNT_IN_INNER);
+	inner->child_cards[pos] = card;
+#else
+	(void)inner;
+	(void)pos;
+	(void)card;
+#endif
+}
+
+/**
+ * @brief Move subtree cardinalities of children between inner blocks.
+ * Must accompany every move of child_ids.
+ * Does nothing if BPS_INNER_CARD is not defined.
+ */
+static inline void
+bps_tree_inner_move_cards(struct bps_inner *dst, bps_tree_pos_t dst_pos,
+			  struct bps_inner *src, bps_tree_pos_t src_pos,
+			  bps_tree_pos_t num)
+{
+#ifdef BPS_INNER_CARD
+	assert(num >= 0);
+	assert(dst_pos >= 0 && dst_pos + num <= BPS_TREE_MAX_COUNT_IN_INNER);
+	assert(src_pos >= 0 && src_pos + num <= BPS_TREE_MAX_COUNT_IN_INNER);
+	memmove(dst->child_cards + dst_pos, src->child_cards + src_pos,
+		num * sizeof(bps_tree_card_t));
+#else
+	(void)dst;
+	(void)dst_pos;
+	(void)src;
+	(void)src_pos;
+	(void)num;
+#endif
+}
+
 /**
  * @brief Tree construction. Fills struct bps_tree members.
  * @param tree - pointer to a tree
@@ -1196,6 +1423,8 @@ bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
 			}
 			parents[i]->child_ids[parents[i]->header.size] =
 				insert_id;
+			bps_tree_inner_set_card(parents[i],
+						parents[i]->header.size, 0);
 			if (new_id == (bps_tree_block_id_t)-1)
 				break;
 			if (i == depth - 2) {
@@ -1204,6 +1433,15 @@ bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
 				insert_id = new_id;
 			}
 		}
+#ifdef BPS_INNER_CARD
+		/*
+		 * The last child of each parent is the one that is being
+		 * filled now (it is not counted in header.size yet).
+		 */
+		for (bps_tree_block_id_t i = 0; i < depth - 1; i++)
+			parents[i]->child_cards[parents[i]->header.size] +=
+				leaf->header.size;
+#endif
 
 		bps_tree_elem_t insert_value = current[leaf->header.size - 1];
 		for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
@@ -1347,6 +1585,118 @@ bps_tree_random(const struct bps_tree *tree, size_t rnd)
 	return leaf->elems + pos;
 }
 
+#ifdef BPS_TREE_ELEM_HINT
+/**
+ * @brief Count elements of an array with hints that are less and
+ * greater than the given one. Elements with unknown hints are not
+ * counted.
+ * @param arr - array of elements
+ * @param size - size of the array
+ * @param hint - hint to compare with, must not be unknown
+ * @param less - the number of elements with lesser hints
+ * @param greater - the number of elements with greater hints
+ */
+static inline void
+bps_tree_hint_count(const bps_tree_elem_t *arr, size_t size, uint64_t hint,
+		    size_t *less, size_t *greater)
+{
+	assert(hint != UINT64_MAX);
+	size_t i = 0;
+	size_t lt = 0, gt = 0;
+#if defined(__SSE4_2__) || defined(__AVX2__)
+	/*
+	 * There's no unsigned 64-bit comparison, so flip the sign bit
+	 * and use the signed one.
+	 */
+	if (sizeof(bps_tree_elem_t) == 2 * sizeof(uint64_t) &&
+	    (const char *)&BPS_TREE_ELEM_HINT(arr[0]) - (const char *)arr ==
+	    sizeof(uint64_t)) {
+		uint64_t lt_sum[4], gt_sum[4];
+#if defined(__AVX2__)
+		const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+		const __m256i none = _mm256_set1_epi64x(-1);
+		const __m256i key =
+			_mm256_xor_si256(_mm256_set1_epi64x(hint), bias);
+		__m256i lt_acc = _mm256_setzero_si256();
+		__m256i gt_acc = _mm256_setzero_si256();
+		for (; i + 4 <= size; i += 4) {
+			__m256i a = _mm256_loadu_si256(
+				(const __m256i *)&arr[i]);
+			__m256i b = _mm256_loadu_si256(
+				(const __m256i *)&arr[i + 2]);
+			/* Hints of the four elements (in some order). */
+			__m256i h = _mm256_unpackhi_epi64(a, b);
+			__m256i hs = _mm256_xor_si256(h, bias);
+			/* Comparison results are -1 for true, 0 for false. */
+			lt_acc = _mm256_sub_epi64(lt_acc,
+						  _mm256_cmpgt_epi64(key, hs));
+			gt_acc = _mm256_sub_epi64(gt_acc, _mm256_andnot_si256(
+					_mm256_cmpeq_epi64(h, none),
+					_mm256_cmpgt_epi64(hs, key)));
+		}
+		_mm256_storeu_si256((__m256i *)lt_sum, lt_acc);
+		_mm256_storeu_si256((__m256i *)gt_sum, gt_acc);
+		lt = lt_sum[0] + lt_sum[1] + lt_sum[2] + lt_sum[3];
+		gt = gt_sum[0] + gt_sum[1] + gt_sum[2] + gt_sum[3];
+#else
+		const __m128i bias = _mm_set1_epi64x(INT64_MIN);
+		const __m128i none = _mm_set1_epi64x(-1);
+		const __m128i key = _mm_xor_si128(_mm_set1_epi64x(hint), bias);
+		__m128i lt_acc = _mm_setzero_si128();
+		__m128i gt_acc = _mm_setzero_si128();
+		for (; i + 2 <= size; i += 2) {
+			__m128i a = _mm_loadu_si128((const __m128i *)&arr[i]);
+			__m128i b = _mm_loadu_si128(
+				(const __m128i *)&arr[i + 1]);
+			/* Hints of the two elements. */
+			__m128i h = _mm_unpackhi_epi64(a, b);
+			__m128i hs = _mm_xor_si128(h, bias);
+			/* Comparison results are -1 for true, 0 for false. */
+			lt_acc = _mm_sub_epi64(lt_acc, _mm_cmpgt_epi64(key, hs));
+			gt_acc = _mm_sub_epi64(gt_acc, _mm_andnot_si128(
+					_mm_cmpeq_epi64(h, none),
+					_mm_cmpgt_epi64(hs, key)));
+		}
+		_mm_storeu_si128((__m128i *)lt_sum, lt_acc);
+		_mm_storeu_si128((__m128i *)gt_sum, gt_acc);
+		lt = lt_sum[0] + lt_sum[1];
+		gt = gt_sum[0] + gt_sum[1];
+#endif
+	}
+#endif
+	/* No early exit so that the loop can be vectorized. */
+	for (; i < size; i++) {
+		uint64_t h = BPS_TREE_ELEM_HINT(arr[i]);
+		lt += h < hint;
+		gt += h > hint && h != UINT64_MAX;
+	}
+	*less = lt;
+	*greater = gt;
+}
+
+/**
+ * @brief Narrow down the range of a sorted array to be searched for
+ * a value with the given hint to the elements that can't be ordered
+ * against the value by their hints. See BPS_TREE_ELEM_HINT.
+ * @param arr - array of elements
+ * @param size - size of the array
+ * @param hint - hint of the searched value
+ * @param begin - beginning of the range to search
+ * @param end - end of the range to search
+ */
+static inline void
+bps_tree_hint_narrow(bps_tree_elem_t *arr, size_t size, uint64_t hint,
+		     bps_tree_elem_t **begin, bps_tree_elem_t **end)
+{
+	if (hint == UINT64_MAX)
+		return;
+	size_t less, greater;
+	bps_tree_hint_count(arr, size, hint, &less, &greater);
+	*begin = arr + less;
+	*end = arr + size - greater;
+}
+#endif /* BPS_TREE_ELEM_HINT */
+
 /**
  * @brief Find the lowest element in sorted array that is >= than the key
  * @param tree - pointer to a tree
@@ -1363,6 +1713,11 @@ bps_tree_find_ins_point_key(const struct bps_tree *tree, bps_tree_elem_t *arr,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+#ifdef BPS_TREE_ELEM_HINT
+	bps_tree_hint_narrow(arr, size,
+			     BPS_TREE_KEY_HINT(key, tree->arg),
+			     &begin, &end);
+#endif
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
@@ -1408,6 +1763,11 @@ bps_tree_find_ins_point_elem(const struct bps_tree *tree, bps_tree_elem_t *arr,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+#ifdef BPS_TREE_ELEM_HINT
+	bps_tree_hint_narrow(arr, size,
+			     BPS_TREE_SEARCH_ELEM_HINT(elem, tree->arg),
+			     &begin, &end);
+#endif
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
@@ -1455,6 +1815,11 @@ bps_tree_find_after_ins_point_key(const struct bps_tree *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+#ifdef BPS_TREE_ELEM_HINT
+	bps_tree_hint_narrow(arr, size,
+			     BPS_TREE_KEY_HINT(key, tree->arg),
+			     &begin, &end);
+#endif
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
@@ -1501,6 +1866,11 @@ bps_tree_find_after_ins_point_elem(const struct bps_tree *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+#ifdef BPS_TREE_ELEM_HINT
+	bps_tree_hint_narrow(arr, size,
+			     BPS_TREE_SEARCH_ELEM_HINT(elem, tree->arg),
+			     &begin, &end);
+#endif
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
@@ -1892,6 +2262,162 @@ bps_tree_upper_bound_elem(const struct bps_tree *tree, bps_tree_elem_t key,
 	return res;
 }
 
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Get an iterator to the element with the given offset, i.e.
+ * the number of elements that are less than it.
+ * @param tree - pointer to a tree
+ * @param offset - offset of the element
+ * @return - Iterator pointing to the element. Invalid if the offset is
+ *  greater than or equal to the tree size.
+ */
+static inline struct bps_tree_iterator
+bps_tree_iterator_at(const struct bps_tree *tree, size_t offset)
+{
+	struct bps_tree_iterator res;
+	matras_head_read_view(&res.view);
+	if (offset >= tree->size) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos = 0;
+		while (offset >= inner->child_cards[pos]) {
+			offset -= inner->child_cards[pos];
+			pos++;
+			assert(pos < inner->header.size);
+		}
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+	assert(offset < (size_t)block->size);
+	res.block_id = block_id;
+	res.pos = offset;
+	return res;
+}
+
+/**
+ * @brief Same as bps_tree_lower_bound, but also returns the offset of
+ * the found element (the number of elements that are less than key).
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - see bps_tree_lower_bound. Pass NULL if you don't need it.
+ * @param offset - the offset is stored here. It is equal to the tree size
+ *  if the returned iterator is invalid.
+ * @return - Lower-bound iterator.
+ */
+static inline struct bps_tree_iterator
+bps_tree_lower_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset)
+{
+	struct bps_tree_iterator res;
+	matras_head_read_view(&res.view);
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	*offset = 0;
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos;
+		pos = bps_tree_find_ins_point_key(tree, inner->elems,
+						  inner->header.size - 1,
+						  key, exact);
+		*offset += bps_tree_inner_card_sum(inner, 0, pos);
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	bps_tree_pos_t pos;
+	pos = bps_tree_find_ins_point_key(tree, leaf->elems, leaf->header.size,
+					  key, exact);
+	*offset += pos;
+	if (pos >= leaf->header.size) {
+		res.block_id = leaf->next_id;
+		res.pos = 0;
+	} else {
+		res.block_id = block_id;
+		res.pos = pos;
+	}
+	return res;
+}
+
+/**
+ * @brief Same as bps_tree_upper_bound, but also returns the offset of
+ * the found element (the number of elements that are less than or equal
+ * to key).
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - see bps_tree_upper_bound. Pass NULL if you don't need it.
+ * @param offset - the offset is stored here. It is equal to the tree size
+ *  if the returned iterator is invalid.
+ * @return - Upper-bound iterator.
+ */
+static inline struct bps_tree_iterator
+bps_tree_upper_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset)
+{
+	struct bps_tree_iterator res;
+	matras_head_read_view(&res.view);
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	*offset = 0;
+	bool exact_test;
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos;
+		pos = bps_tree_find_after_ins_point_key(tree, inner->elems,
+							inner->header.size - 1,
+							key, &exact_test);
+		if (exact_test)
+			*exact = true;
+		*offset += bps_tree_inner_card_sum(inner, 0, pos);
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	bps_tree_pos_t pos;
+	pos = bps_tree_find_after_ins_point_key(tree, leaf->elems,
+						leaf->header.size,
+						key, &exact_test);
+	if (exact_test)
+		*exact = true;
+	*offset += pos;
+	if (pos >= leaf->header.size) {
+		res.block_id = leaf->next_id;
+		res.pos = 0;
+	} else {
+		res.block_id = block_id;
+		res.pos = pos;
+	}
+	return res;
+}
+#endif /* BPS_INNER_CARD */
+
 /**
  * @brief Get approximate number of entries that are equal to given key.
  * Accuracy limits:
@@ -2080,6 +2606,37 @@ bps_tree_iterator_destroy(struct bps_tree *tree, struct bps_tree_iterator *itr)
 	matras_destroy_read_view(&tree->matras, &itr->view);
 }
 
+/**
+ * @brief Create a read view of a tree. All following tree modifications
+ * will not be visible through view->tree. The view must be destroyed with
+ * a bps_tree_view_destroy call after usage.
+ * @param view - pointer to a read view to create
+ * @param tree - pointer to a tree
+ */
+static inline void
+bps_tree_view_create(struct bps_tree_view *view, struct bps_tree *tree)
+{
+	matras_create_read_view(&tree->matras, &view->view);
+	view->tree = *tree;
+	/*
+	 * Make the tree copy read blocks from the view: all read-only
+	 * tree functions access blocks with matras_get, which looks up
+	 * the head view.
+	 */
+	view->tree.matras.head = view->view;
+}
+
+/**
+ * @brief Destroy a read view created with bps_tree_view_create.
+ * @param view - pointer to a read view
+ * @param tree - pointer to the tree the view was created for
+ */
+static inline void
+bps_tree_view_destroy(struct bps_tree_view *view, struct bps_tree *tree)
+{
+	matras_destroy_read_view(&tree->matras, &view->view);
+}
+
 /**
  * @brief Find the first element that is equal to the key (comparator returns 0)
  * @param tree - pointer to a tree
@@ -2376,6 +2933,94 @@ bps_tree_process_replace(struct bps_tree *tree,
 	return true;
 }
 
+/**
+ * @brief Get number of elements in the subtree of a block.
+ * Always returns 0 if BPS_INNER_CARD is not defined.
+ */
+static inline size_t
+bps_tree_block_card(const struct bps_tree *tree, bps_tree_block_id_t id)
+{
+#ifdef BPS_INNER_CARD
+	/* exclusive behaviuor for debug checks */
+	if (tree->root_id == (bps_tree_block_id_t) -1)
+		return 0;
+	struct bps_block *block = bps_tree_restore_block(tree, id);
+	if (block->type == BPS_TREE_BT_LEAF)
+		return block->size;
+	assert(block->type == BPS_TREE_BT_INNER);
+	return bps_tree_inner_card_sum((struct bps_inner *)block, 0,
+				       block->size);
+#else
+	(void)tree;
+	(void)id;
+	return 0;
+#endif
+}
+
+/**
+ * @brief Add @a delta to the subtree cardinality of a block in all
+ * its ancestors. The block is given by its ID, its parent path element
+ * and its position in the parent. A block that is not linked to the
+ * parent yet (a new block of a split) is skipped: its whole cardinality
+ * is accounted when it's inserted to the parent.
+ * Does nothing if BPS_INNER_CARD is not defined.
+ */
+static inline void
+bps_tree_update_card(struct bps_tree *tree,
+		     struct bps_inner_path_elem *parent, bps_tree_pos_t pos,
+		     bps_tree_block_id_t block_id, int64_t delta)
+{
+#ifdef BPS_INNER_CARD
+	/* exclusive behaviuor for debug checks */
+	if (tree->root_id == (bps_tree_block_id_t) -1 || delta == 0)
+		return;
+	for (; parent != NULL; parent = parent->parent) {
+		if (pos >= parent->block->header.size ||
+		    parent->block->child_ids[pos] != block_id)
+			return;
+		parent->block = (struct bps_inner *)
+			bps_tree_touch_block(tree, parent->block_id);
+		parent->block->child_cards[pos] += delta;
+		pos = parent->pos_in_parent;
+		block_id = parent->block_id;
+	}
+#else
+	(void)tree;
+	(void)parent;
+	(void)pos;
+	(void)block_id;
+	(void)delta;
+#endif
+}
+
+/**
+ * @brief Add @a delta to the subtree cardinality of a leaf in all
+ * its ancestors. See bps_tree_update_card.
+ */
+static inline void
+bps_tree_update_leaf_card(struct bps_tree *tree,
+			  struct bps_leaf_path_elem *leaf_path_elem,
+			  int64_t delta)
+{
+	bps_tree_update_card(tree, leaf_path_elem->parent,
+			     leaf_path_elem->pos_in_parent,
+			     leaf_path_elem->block_id, delta);
+}
+
+/**
+ * @brief Add @a delta to the subtree cardinality of an inner block in
+ * all its ancestors. See bps_tree_update_card.
+ */
+static inline void
+bps_tree_update_inner_card(struct bps_tree *tree,
+			   struct bps_inner_path_elem *inner_path_elem,
+			   int64_t delta)
+{
+	bps_tree_update_card(tree, inner_path_elem->parent,
+			     inner_path_elem->pos_in_parent,
+			     inner_path_elem->block_id, delta);
+}
+
 #ifndef NDEBUG
 /**
  * @brief Debug memmove, checks for overflow
@@ -2502,6 +3147,7 @@ bps_tree_insert_into_leaf(struct bps_tree *tree,
 	}
 	leaf->header.size++;
 	tree->size++;
+	bps_tree_update_leaf_card(tree, leaf_path_elem, 1);
 }
 
 /**
@@ -2530,14 +3176,19 @@ bps_tree_insert_into_inner(struct bps_tree *tree,
 		BPS_TREE_DATAMOVE(inner->child_ids + pos + 1,
 				  inner->child_ids + pos,
 				  inner->header.size - pos, inner, inner);
+		bps_tree_inner_move_cards(inner, pos + 1, inner, pos,
+					  inner->header.size - pos);
 	} else {
 		if (pos > 0)
 			inner->elems[pos - 1] = *inner_path_elem->max_elem_copy;
 		*inner_path_elem->max_elem_copy = max_elem;
 	}
 	inner->child_ids[pos] = block_id;
+	bps_tree_card_t card = bps_tree_block_card(tree, block_id);
+	bps_tree_inner_set_card(inner, pos, card);
 
 	inner->header.size++;
+	bps_tree_update_inner_card(tree, inner_path_elem, card);
 }
 
 /**
@@ -2569,6 +3220,7 @@ bps_tree_delete_from_leaf(struct bps_tree *tree,
 	}
 
 	tree->size--;
+	bps_tree_update_leaf_card(tree, leaf_path_elem, -1);
 }
 
 /**
@@ -2587,6 +3239,7 @@ bps_tree_delete_from_inner(struct bps_tree *tree,
 
 	assert(pos >= 0);
 	assert(pos < inner->header.size);
+	bps_tree_card_t card = bps_tree_inner_card_sum(inner, pos, 1);
 
 	if (pos < inner->header.size - 1) {
 		BPS_TREE_DATAMOVE(inner->elems + pos, inner->elems + pos + 1,
@@ -2594,11 +3247,14 @@ bps_tree_delete_from_inner(struct bps_tree *tree,
 		BPS_TREE_DATAMOVE(inner->child_ids + pos,
 				  inner->child_ids + pos + 1,
 				  inner->header.size - 1 - pos, inner, inner);
+		bps_tree_inner_move_cards(inner, pos, inner, pos + 1,
+					  inner->header.size - 1 - pos);
 	} else if (pos > 0) {
 		*inner_path_elem->max_elem_copy = inner->elems[pos - 1];
 	}
 
 	inner->header.size--;
+	bps_tree_update_inner_card(tree, inner_path_elem, -(int64_t)card);
 }
 
 /**
@@ -2636,6 +3292,8 @@ bps_tree_move_elems_to_right_leaf(struct bps_tree *tree,
 		*a_leaf_path_elem->max_elem_copy =
 			a->elems[a->header.size - 1];
 	*b_leaf_path_elem->max_elem_copy = b->elems[b->header.size - 1];
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem, -num);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem, num);
 }
 
 /**
@@ -2665,8 +3323,10 @@ bps_tree_move_elems_to_right_inner(struct bps_tree *tree,
 
 	BPS_TREE_DATAMOVE(b->child_ids + num, b->child_ids,
 			  b->header.size, b, b);
+	bps_tree_inner_move_cards(b, num, b, 0, b->header.size);
 	BPS_TREE_DATAMOVE(b->child_ids, a->child_ids + a->header.size - num,
 			  num, b, a);
+	bps_tree_inner_move_cards(b, 0, a, a->header.size - num, num);
 
 	if (!move_to_empty)
 		BPS_TREE_DATAMOVE(b->elems + num, b->elems,
@@ -2684,6 +3344,9 @@ bps_tree_move_elems_to_right_inner(struct bps_tree *tree,
 
 	a->header.size -= num;
 	b->header.size += num;
+	bps_tree_card_t card = bps_tree_inner_card_sum(b, 0, num);
+	bps_tree_update_inner_card(tree, a_inner_path_elem, -(int64_t)card);
+	bps_tree_update_inner_card(tree, b_inner_path_elem, card);
 }
 
 /**
@@ -2716,6 +3379,8 @@ bps_tree_move_elems_to_left_leaf(struct bps_tree *tree,
 	a->header.size += num;
 	b->header.size -= num;
 	*a_leaf_path_elem->max_elem_copy = a->elems[a->header.size - 1];
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem, num);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem, -num);
 }
 
 /**
@@ -2745,8 +3410,10 @@ bps_tree_move_elems_to_left_inner(struct bps_tree *tree,
 
 	BPS_TREE_DATAMOVE(a->child_ids + a->header.size, b->child_ids,
 			  num, a, b);
+	bps_tree_inner_move_cards(a, a->header.size, b, 0, num);
 	BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num,
 			  b->header.size - num, b, b);
+	bps_tree_inner_move_cards(b, 0, b, num, b->header.size - num);
 
 	if (!move_to_empty)
 		a->elems[a->header.size - 1] =
@@ -2763,6 +3430,10 @@ bps_tree_move_elems_to_left_inner(struct bps_tree *tree,
 
 	a->header.size += num;
 	b->header.size -= num;
+	bps_tree_card_t card = bps_tree_inner_card_sum(a, a->header.size - num,
+						       num);
+	bps_tree_update_inner_card(tree, a_inner_path_elem, card);
+	bps_tree_update_inner_card(tree, b_inner_path_elem, -(int64_t)card);
 }
 
 /**
@@ -2831,6 +3502,8 @@ bps_tree_insert_and_move_elems_to_right_leaf(struct bps_tree *tree,
 		*b_leaf_path_elem->max_elem_copy =
 			b->elems[b->header.size - 1];
 	tree->size++;
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem, 1 - num);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem, num);
 	return ret;
 }
 
@@ -2865,10 +3538,12 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 	assert(b->header.size + num <= BPS_TREE_MAX_COUNT_IN_INNER);
 	assert(pos <= a->header.size);
 	assert(pos >= 0);
+	bps_tree_card_t card = bps_tree_block_card(tree, block_id);
 
 	if (!move_to_empty) {
 		BPS_TREE_DATAMOVE(b->child_ids + num, b->child_ids,
 				  b->header.size, b, b);
+		bps_tree_inner_move_cards(b, num, b, 0, b->header.size);
 		BPS_TREE_DATAMOVE(b->elems + num, b->elems,
 				  b->header.size - 1, b, b);
 	}
@@ -2879,9 +3554,13 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 		BPS_TREE_DATAMOVE(b->child_ids,
 				  a->child_ids + a->header.size - num,
 				  num, b, a);
+		bps_tree_inner_move_cards(b, 0, a, a->header.size - num, num);
 		BPS_TREE_DATAMOVE(a->child_ids + pos + 1, a->child_ids + pos,
 				  mid_part_size - num, a, a);
+		bps_tree_inner_move_cards(a, pos + 1, a, pos,
+					  mid_part_size - num);
 		a->child_ids[pos] = block_id;
+		bps_tree_inner_set_card(a, pos, card);
 
 		BPS_TREE_DATAMOVE(b->elems, a->elems + (a->header.size - num),
 				  num - 1, b, a);
@@ -2901,9 +3580,13 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 		BPS_TREE_DATAMOVE(b->child_ids,
 				  a->child_ids + a->header.size - num,
 				  num, b, a);
+		bps_tree_inner_move_cards(b, 0, a, a->header.size - num, num);
 		BPS_TREE_DATAMOVE(a->child_ids + pos + 1, a->child_ids + pos,
 				  mid_part_size - num, a, a);
+		bps_tree_inner_move_cards(a, pos + 1, a, pos,
+					  mid_part_size - num);
 		a->child_ids[pos] = block_id;
+		bps_tree_inner_set_card(a, pos, card);
 
 		BPS_TREE_DATAMOVE(b->elems, a->elems + (a->header.size - num),
 				  num - 1, b, a);
@@ -2920,9 +3603,14 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 		BPS_TREE_DATAMOVE(b->child_ids,
 				  a->child_ids + a->header.size - num + 1,
 				  new_pos, b, a);
+		bps_tree_inner_move_cards(b, 0, a, a->header.size - num + 1,
+					  new_pos);
 		b->child_ids[new_pos] = block_id;
+		bps_tree_inner_set_card(b, new_pos, card);
 		BPS_TREE_DATAMOVE(b->child_ids + new_pos + 1,
 				  a->child_ids + pos, mid_part_size, b, a);
+		bps_tree_inner_move_cards(b, new_pos + 1, a, pos,
+					  mid_part_size);
 
 		if (pos == a->header.size) {
 			/* +1 */
@@ -2967,6 +3655,10 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 
 	a->header.size -= (num - 1);
 	b->header.size += num;
+	bps_tree_card_t moved_card = bps_tree_inner_card_sum(b, 0, num);
+	bps_tree_update_inner_card(tree, a_inner_path_elem,
+				    (int64_t)card - (int64_t)moved_card);
+	bps_tree_update_inner_card(tree, b_inner_path_elem, moved_card);
 }
 
 /**
@@ -3034,6 +3726,8 @@ bps_tree_insert_and_move_elems_to_left_leaf(struct bps_tree *tree,
 		*b_leaf_path_elem->max_elem_copy =
 			b->elems[b->header.size - 1];
 	tree->size++;
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem, num);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem, 1 - num);
 	return ret;
 }
 
@@ -3068,18 +3762,24 @@ bps_tree_insert_and_move_elems_to_left_inner(struct bps_tree *tree,
 	assert(a->header.size + num <= BPS_TREE_MAX_COUNT_IN_INNER);
 	assert(pos >= 0);
 	assert(pos <= b->header.size);
+	bps_tree_card_t card = bps_tree_block_card(tree, block_id);
 
 	if (pos >= num) {
 		/* In fact insert to 'b' block */
 		bps_tree_pos_t new_pos = pos - num; /* Can be 0 */
 		BPS_TREE_DATAMOVE(a->child_ids + a->header.size, b->child_ids,
 				  num, a, b);
+		bps_tree_inner_move_cards(a, a->header.size, b, 0, num);
 		BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num,
 				  new_pos, b, b);
+		bps_tree_inner_move_cards(b, 0, b, num, new_pos);
 		b->child_ids[new_pos] = block_id;
+		bps_tree_inner_set_card(b, new_pos, card);
 		BPS_TREE_DATAMOVE(b->child_ids + new_pos + 1,
 				  b->child_ids + pos,
 				  b->header.size - pos, b, b);
+		bps_tree_inner_move_cards(b, new_pos + 1, b, pos,
+					  b->header.size - pos);
 
 		if (!move_to_empty)
 			a->elems[a->header.size - 1] =
@@ -3115,12 +3815,19 @@ bps_tree_insert_and_move_elems_to_left_inner(struct bps_tree *tree,
 		bps_tree_pos_t new_pos = a->header.size + pos; /* Can be 0 */
 		BPS_TREE_DATAMOVE(a->child_ids + a->header.size,
 				  b->child_ids, pos, a, b);
+		bps_tree_inner_move_cards(a, a->header.size, b, 0, pos);
 		a->child_ids[new_pos] = block_id;
+		bps_tree_inner_set_card(a, new_pos, card);
 		BPS_TREE_DATAMOVE(a->child_ids + new_pos + 1,
 				  b->child_ids + pos, num - 1 - pos, a, b);
-		if (!move_all)
+		bps_tree_inner_move_cards(a, new_pos + 1, b, pos,
+					  num - 1 - pos);
+		if (!move_all) {
 			BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num - 1,
 					  b->header.size - num + 1, b, b);
+			bps_tree_inner_move_cards(b, 0, b, num - 1,
+						  b->header.size - num + 1);
+		}
 
 		if (!move_to_empty)
 			a->elems[a->header.size - 1] =
@@ -3165,6 +3872,11 @@ bps_tree_insert_and_move_elems_to_left_inner(struct bps_tree *tree,
 
 	a->header.size += num;
 	b->header.size -= (num - 1);
+	bps_tree_card_t moved_card =
+		bps_tree_inner_card_sum(a, a->header.size - num, num);
+	bps_tree_update_inner_card(tree, a_inner_path_elem, moved_card);
+	bps_tree_update_inner_card(tree, b_inner_path_elem,
+				    (int64_t)card - (int64_t)moved_card);
 }
 
 /**
@@ -3730,6 +4442,10 @@ bps_tree_process_insert_leaf(struct bps_tree *tree,
 		new_root->header.size = 2;
 		new_root->child_ids[0] = tree->root_id;
 		new_root->child_ids[1] = new_block_id;
+		bps_tree_inner_set_card(new_root, 0,
+			bps_tree_block_card(tree, tree->root_id));
+		bps_tree_inner_set_card(new_root, 1,
+			bps_tree_block_card(tree, new_block_id));
 		new_root->elems[0] = tree->max_elem;
 		tree->root_id = new_root_id;
 		tree->max_elem = new_max_elem;
@@ -4050,6 +4766,10 @@ bps_tree_process_insert_inner(struct bps_tree *tree,
 		new_root->header.size = 2;
 		new_root->child_ids[0] = tree->root_id;
 		new_root->child_ids[1] = new_block_id;
+		bps_tree_inner_set_card(new_root, 0,
+			bps_tree_block_card(tree, tree->root_id));
+		bps_tree_inner_set_card(new_root, 1,
+			bps_tree_block_card(tree, new_block_id));
 		new_root->elems[0] = tree->max_elem;
 		tree->root_id = new_root_id;
 		tree->max_elem = new_max_elem;
@@ -4687,13 +5407,21 @@ bps_tree_debug_check_block(const struct bps_tree *tree, struct bps_block *block,
 				result |= 0x4000000;
 		}
 
-		for (bps_tree_pos_t i = 0; i < block->size; i++)
+		for (bps_tree_pos_t i = 0; i < block->size; i++) {
+			size_t prev_count = *calc_count;
 			result |= bps_tree_debug_check_block(tree,
 				bps_tree_restore_block(tree,
 						       inner->child_ids[i]),
 				inner->child_ids[i], level - 1, calc_count,
 				expected_prev_id, expected_this_id,
 				check_fullness_next);
+#ifdef BPS_INNER_CARD
+			if (inner->child_cards[i] != *calc_count - prev_count)
+				result |= 0x8000000;
+#else
+			(void)prev_count;
+#endif
+		}
 		return result;
 	}
 }
@@ -4934,6 +5662,8 @@ bps_tree_debug_check_insert_into_leaf(struct bps_tree *tree, bool assertme)
 			bps_tree_debug_set_elem(&ins, j);
 			path_elem.block = &block;
 			path_elem.block_id = 0;
+			path_elem.parent = NULL;
+			path_elem.pos_in_parent = 0;
 			path_elem.insertion_point = j;
 			path_elem.max_elem_copy = &max;
 			path_elem.max_elem_block_id = -1;
@@ -4989,6 +5719,8 @@ bps_tree_debug_check_delete_from_leaf(struct bps_tree *tree, bool assertme)
 				j == i - 1 ? i - 2 : i - 1);
 			path_elem.block = &block;
 			path_elem.block_id = 0;
+			path_elem.parent = NULL;
+			path_elem.pos_in_parent = 0;
 			path_elem.insertion_point = j;
 			path_elem.max_elem_copy = &max;
 			path_elem.max_elem_block_id = -1;
@@ -5070,7 +5802,11 @@ bps_tree_debug_check_move_to_right_leaf(struct bps_tree *tree, bool assertme)
 				b_path_elem.max_elem_block_id = -1;
 				b_path_elem.max_elem_pos = -1;
 				a_path_elem.block_id = 0;
+				a_path_elem.parent = NULL;
+				a_path_elem.pos_in_parent = 0;
 				b_path_elem.block_id = 0;
+				b_path_elem.parent = NULL;
+				b_path_elem.pos_in_parent = 0;
 
 				bps_tree_move_elems_to_right_leaf(tree,
 					&a_path_elem, &b_path_elem,
@@ -5173,7 +5909,11 @@ bps_tree_debug_check_move_to_left_leaf(struct bps_tree *tree, bool assertme)
 				b_path_elem.max_elem_block_id = -1;
 				b_path_elem.max_elem_pos = -1;
 				a_path_elem.block_id = 0;
+				a_path_elem.parent = NULL;
+				a_path_elem.pos_in_parent = 0;
 				b_path_elem.block_id = 0;
+				b_path_elem.parent = NULL;
+				b_path_elem.pos_in_parent = 0;
 
 				bps_tree_move_elems_to_left_leaf(tree,
 					&a_path_elem, &b_path_elem,
@@ -5285,7 +6025,11 @@ bps_tree_debug_check_insert_and_move_to_right_leaf(struct bps_tree *tree,
 					b_path_elem.max_elem_pos = -1;
 					a_path_elem.insertion_point = k;
 					a_path_elem.block_id = 0;
+					a_path_elem.parent = NULL;
+					a_path_elem.pos_in_parent = 0;
 					b_path_elem.block_id = 0;
+					b_path_elem.parent = NULL;
+					b_path_elem.pos_in_parent = 0;
 					bps_tree_elem_t ins;
 					bps_tree_debug_set_elem(&ins, ic);
 
@@ -5402,7 +6146,11 @@ bps_tree_debug_check_insert_and_move_to_left_leaf(struct bps_tree *tree,
 					b_path_elem.max_elem_pos = -1;
 					b_path_elem.insertion_point = k;
 					a_path_elem.block_id = 0;
+					a_path_elem.parent = NULL;
+					a_path_elem.pos_in_parent = 0;
 					b_path_elem.block_id = 0;
+					b_path_elem.parent = NULL;
+					b_path_elem.pos_in_parent = 0;
 					bps_tree_elem_t ins;
 					bps_tree_debug_set_elem(&ins, ic);
 
@@ -5491,6 +6239,8 @@ bps_tree_debug_check_insert_into_inner(struct bps_tree *tree, bool assertme)
 			struct bps_inner_path_elem path_elem;
 			path_elem.block = &block;
 			path_elem.block_id = 0;
+			path_elem.parent = NULL;
+			path_elem.pos_in_parent = 0;
 			path_elem.max_elem_copy = &max;
 			path_elem.max_elem_block_id = -1;
 			path_elem.max_elem_pos = -1;
@@ -5558,6 +6308,8 @@ bps_tree_debug_check_delete_from_inner(struct bps_tree *tree, bool assertme)
 			bps_tree_debug_set_elem(&max, i - 1);
 			path_elem.block = &block;
 			path_elem.block_id = 0;
+			path_elem.parent = NULL;
+			path_elem.pos_in_parent = 0;
 			path_elem.insertion_point = j;
 			path_elem.max_elem_copy = &max;
 			path_elem.max_elem_block_id = -1;
@@ -5627,7 +6379,11 @@ bps_tree_debug_check_move_to_right_inner(struct bps_tree *tree, bool assertme)
 				b_path_elem.max_elem_block_id = -1;
 				b_path_elem.max_elem_pos = -1;
 				a_path_elem.block_id = 0;
+				a_path_elem.parent = NULL;
+				a_path_elem.pos_in_parent = 0;
 				b_path_elem.block_id = 0;
+				b_path_elem.parent = NULL;
+				b_path_elem.pos_in_parent = 0;
 
 				unsigned char c = 0;
 				bps_tree_block_id_t kk = 0;
@@ -5727,7 +6483,11 @@ bps_tree_debug_check_move_to_left_inner(struct bps_tree *tree, bool assertme)
 				b_path_elem.max_elem_block_id = -1;
 				b_path_elem.max_elem_pos = -1;
 				a_path_elem.block_id = 0;
+				a_path_elem.parent = NULL;
+				a_path_elem.pos_in_parent = 0;
 				b_path_elem.block_id = 0;
+				b_path_elem.parent = NULL;
+				b_path_elem.pos_in_parent = 0;
 
 				unsigned char c = 0;
 				bps_tree_block_id_t kk = 0;
@@ -5833,7 +6593,11 @@ bps_tree_debug_check_insert_and_move_to_right_inner(struct bps_tree *tree,
 					b_path_elem.max_elem_block_id = -1;
 					b_path_elem.max_elem_pos = -1;
 					a_path_elem.block_id = 0;
+					a_path_elem.parent = NULL;
+					a_path_elem.pos_in_parent = 0;
 					b_path_elem.block_id = 0;
+					b_path_elem.parent = NULL;
+					b_path_elem.pos_in_parent = 0;
 
 					unsigned char c = 0;
 					bps_tree_block_id_t kk = 0;
@@ -5965,7 +6729,11 @@ bps_tree_debug_check_insert_and_move_to_left_inner(struct bps_tree *tree,
 					b_path_elem.max_elem_block_id = -1;
 					b_path_elem.max_elem_pos = -1;
 					a_path_elem.block_id = 0;
+					a_path_elem.parent = NULL;
+					a_path_elem.pos_in_parent = 0;
 					b_path_elem.block_id = 0;
+					b_path_elem.parent = NULL;
+					b_path_elem.pos_in_parent = 0;
 
 					unsigned char c = 0;
 					bps_tree_block_id_t kk = 0;
@@ -6101,6 +6869,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_inner
 #undef bps_garbage
 #undef bps_tree_iterator
+#undef bps_tree_view
 #undef bps_inner_path_elem
 #undef bps_leaf_path_elem
 
@@ -6129,6 +6898,11 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_iterator_prev
 #undef bps_tree_iterator_freeze
 #undef bps_tree_iterator_destroy
+#undef bps_tree_view_create
+#undef bps_tree_view_destroy
+#undef bps_tree_iterator_at
+#undef bps_tree_lower_bound_get_offset
+#undef bps_tree_upper_bound_get_offset
 #undef bps_tree_debug_check
 #undef bps_tree_print
 #undef bps_tree_debug_check_internal_functions
@@ -6146,6 +6920,8 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_restore_block_ver
 #undef bps_tree_root
 #undef bps_tree_touch_block
+#undef bps_tree_hint_count
+#undef bps_tree_hint_narrow
 #undef bps_tree_find_ins_point_key
 #undef bps_tree_find_ins_point_elem
 #undef bps_tree_find_after_ins_point_key
@@ -6163,6 +6939,13 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_touch_leaf_path_max_elem
 #undef bps_tree_touch_path
 #undef bps_tree_process_replace
+#undef bps_tree_inner_card_sum
+#undef bps_tree_inner_set_card
+#undef bps_tree_inner_move_cards
+#undef bps_tree_block_card
+#undef bps_tree_update_card
+#undef bps_tree_update_leaf_card
+#undef bps_tree_update_inner_card
 #undef bps_tree_debug_memmove
 #undef bps_tree_insert_into_leaf
 #undef bps_tree_insert_into_inner
@@ -4,7 +4,7 @@ local t = require('luatest')
 
 local g = t.group("invalid compression type", t.helpers.matrix({
     engine = {'memtx', 'vinyl'},
-    compression = {'zstd', 'lz4'}
+    compression = {'lz4'}
 }))
 
 g.before_all(function(cg)
@@ -57,6 +57,63 @@ g.after_test('test_invalid_compression_type_during_setting_format', function(cg)
     end)
 end)
 
+g = t.group("unsupported compression", t.helpers.matrix({
+    engine = {'vinyl'},
+    compression = {'zstd'}
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:stop()
+end)
+
+g.test_unsupported_compression_during_space_creation = function(cg)
+    misc.skip_if_enterprise()
+    cg.server:exec(function(engine, compression)
+        local t = require('luatest')
+        local format = {{
+            name = 'x', type = 'unsigned', compression = compression
+        }}
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support compression",
+            box.schema.space.create, 'T', {engine = engine, format = format})
+    end, {cg.params.engine, cg.params.compression})
+end
+
+g.before_test('test_unsupported_compression_during_setting_format',
+              function(cg)
+    cg.server:exec(function(engine)
+        box.schema.space.create('space', {engine = engine})
+    end, {cg.params.engine})
+end)
+
+g.test_unsupported_compression_during_setting_format = function(cg)
+    misc.skip_if_enterprise()
+    cg.server:exec(function(compression)
+        local t = require('luatest')
+        local format = {{
+            name = 'x', type = 'unsigned', compression = compression
+        }}
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support compression",
+            box.space.space.format, box.space.space, format)
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support compression",
+            box.space.space.alter, box.space.space, {format = format})
+    end, {cg.params.compression})
+end
+
+g.after_test('test_unsupported_compression_during_setting_format',
+             function(cg)
+    cg.server:exec(function()
+        box.space.space:drop()
+    end)
+end)
+
 g = t.group("none compression", t.helpers.matrix({
     engine = {'memtx', 'vinyl'},
 }))
@@ -0,0 +1,295 @@
+local misc = require('test.luatest_helpers.misc')
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        s:create_index('str', {parts = {3, 'string'}, unique = false})
+        s:create_index('nullable', {parts = {{4, 'unsigned',
+                                              is_nullable = true}}})
+        s:create_index('mk', {parts = {{5, 'unsigned', path = '[*]'}},
+                              unique = false})
+        box.schema.func.create('test_func', {
+            body = 'function(t) return {t[2] % 10} end',
+            is_deterministic = true, is_sandboxed = true,
+        })
+        s:create_index('func', {parts = {{1, 'unsigned'}}, unique = false,
+                                func = 'test_func'})
+        rawset(_G, 'make_tuple', function(i)
+            return {i, 100000 - i, tostring(i % 100),
+                    i % 2 == 0 and i or box.NULL, {i % 3, i % 7}}
+        end)
+        rawset(_G, 'check', function(ids)
+            local t = require('luatest')
+            local expected = {}
+            for _, i in ipairs(ids) do
+                table.insert(expected, _G.make_tuple(i))
+            end
+            table.sort(expected, function(a, b) return a[1] < b[1] end)
+            t.assert_equals(s:select(), expected)
+            local sk = s.index.sk:select({}, {iterator = 'LE'})
+            t.assert_equals(sk, expected)
+            local bsize = 0
+            local str = {}
+            local nullable = 0
+            local mk = 0
+            local func = 0
+            for _, tuple in ipairs(expected) do
+                bsize = bsize + box.tuple.new(tuple):bsize()
+                if tuple[3] == '7' then
+                    table.insert(str, tuple)
+                end
+                if tuple[4] ~= nil then
+                    nullable = nullable + 1
+                end
+                if tuple[2] % 10 == 3 then
+                    func = func + 1
+                end
+                if tuple[5][1] == 1 or tuple[5][2] == 1 then
+                    mk = mk + 1
+                end
+            end
+            t.assert_equals(s:bsize(), bsize)
+            t.assert_equals(s.index.str:select('7'), str)
+            t.assert_equals(s.index.nullable:len(), #expected)
+            t.assert_equals(s.index.nullable:count({box.NULL},
+                                                   {iterator = 'GT'}),
+                            nullable)
+            t.assert_equals(s.index.mk:count(1), mk)
+            t.assert_equals(s.index.func:count(3), func)
+        end)
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+        box.schema.func.drop('test_func')
+    end)
+end)
+
+-- Checks loading a batch into an empty space.
+g.test_empty = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local tuples = {}
+        local ids = {}
+        math.randomseed(0)
+        for i = 1, 20000 do
+            table.insert(ids, math.random(#ids + 1), i)
+        end
+        for _, i in ipairs(ids) do
+            table.insert(tuples, _G.make_tuple(i))
+        end
+        s:bulk_load(tuples)
+        _G.check(ids)
+    end)
+end
+
+-- Checks loading a batch into a non-empty space.
+g.test_non_empty = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local ids = {}
+        for i = 1, 10000, 2 do
+            s:insert(_G.make_tuple(i))
+            table.insert(ids, i)
+        end
+        local tuples = {}
+        for i = 10000, 2, -2 do
+            table.insert(tuples, _G.make_tuple(i))
+            table.insert(ids, i)
+        end
+        s:bulk_load(tuples)
+        _G.check(ids)
+    end)
+end
+
+-- Checks that a batch that fails is rolled back as a whole.
+g.test_error = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local ids = {}
+        for i = 1, 100 do
+            s:insert(_G.make_tuple(i))
+            table.insert(ids, i)
+        end
+        local function check_error(msg, tuple)
+            local tuples = {}
+            for i = 101, 200 do
+                table.insert(tuples, _G.make_tuple(i))
+            end
+            table.insert(tuples, 50, tuple)
+            t.assert_error_msg_contains(msg, s.bulk_load, s, tuples)
+            _G.check(ids)
+        end
+        local msg = 'Duplicate key exists in unique index "%s"'
+        -- Duplicate in the batch.
+        check_error(msg:format('pk'), _G.make_tuple(150))
+        local tuple = _G.make_tuple(1000)
+        tuple[2] = 100000 - 150
+        check_error(msg:format('sk'), tuple)
+        tuple = _G.make_tuple(1000)
+        tuple[4] = 150
+        check_error(msg:format('nullable'), tuple)
+        -- Duplicate in the space.
+        check_error(msg:format('pk'), _G.make_tuple(50))
+        tuple = _G.make_tuple(1000)
+        tuple[4] = 50
+        check_error(msg:format('nullable'), tuple)
+        -- Invalid tuple.
+        check_error('Tuple field 2 type does not match one required',
+                    {1000, 'x', 'x'})
+        check_error('Tuple/Key must be MsgPack array', 1000)
+
+        -- The same checks for an empty space.
+        s:truncate()
+        ids = {}
+        check_error(msg:format('pk'), _G.make_tuple(150))
+        tuple = _G.make_tuple(1000)
+        tuple[2] = 100000 - 150
+        check_error(msg:format('sk'), tuple)
+        t.assert_equals(s:len(), 0)
+        t.assert_equals(s:bsize(), 0)
+        -- Nulls don't violate the unique constraint.
+        s:bulk_load({_G.make_tuple(1001), _G.make_tuple(1003)})
+        t.assert_equals(s.index.nullable:count({box.NULL}), 2)
+    end)
+end
+
+-- Checks loading tuples produced by an iterator.
+g.test_iterator = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fun = require('fun')
+        local s = box.space.test
+        s:bulk_load(fun.range(25000):map(_G.make_tuple))
+        t.assert_equals(s:len(), 25000)
+        local ids = fun.range(25000):totable()
+        _G.check(ids)
+
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        s2:bulk_load(s:pairs())
+        t.assert_equals(s2:select(), s:select())
+        s2:truncate()
+        s2:bulk_load(ipairs({{1}, {2}, {3}}))
+        t.assert_equals(s2:select(), {{1}, {2}, {3}})
+        s2:drop()
+
+        -- Tuples are inserted in batches of 10000 tuples so batches
+        -- loaded before the failed one stay in the space.
+        s:truncate()
+        t.assert_error_msg_contains(
+            'Duplicate key exists in unique index "pk"', s.bulk_load, s,
+            fun.range(25000):map(function(i)
+                return _G.make_tuple(i == 15000 and 1 or i)
+            end))
+        t.assert_equals(s:len(), 10000)
+    end)
+end
+
+-- Checks that bulk load works for spaces with triggers, which need
+-- to see each inserted tuple in indexes.
+g.test_triggers = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local count = 0
+        local function trigger(old, new)
+            t.assert_equals(old, nil)
+            t.assert_equals(s:get(new[1]), new)
+            count = count + 1
+        end
+        s:on_replace(trigger)
+        local tuples = {}
+        local ids = {}
+        for i = 1, 1000 do
+            table.insert(tuples, _G.make_tuple(i))
+            table.insert(ids, i)
+        end
+        s:bulk_load(tuples)
+        s:on_replace(nil, trigger)
+        t.assert_equals(count, 1000)
+        _G.check(ids)
+    end)
+end
+
+-- Checks that bulk load is forbidden in a transaction.
+g.test_transaction = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        box.begin()
+        t.assert_error_msg_contains(
+            'Operation is not permitted when there is an active transaction',
+            s.bulk_load, s, {_G.make_tuple(1)})
+        box.rollback()
+        t.assert_equals(s:len(), 0)
+    end)
+end
+
+-- Checks that a batch that failed to be written to WAL is rolled back.
+g.test_wal_error = function(cg)
+    misc.skip_if_not_debug()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        box.error.injection.set('ERRINJ_WAL_WRITE', true)
+        t.assert_error_msg_equals(
+            'Failed to write to disk', s.bulk_load, s,
+            {_G.make_tuple(1), _G.make_tuple(2), _G.make_tuple(3)})
+        box.error.injection.set('ERRINJ_WAL_WRITE', false)
+        _G.check({})
+        s:bulk_load({_G.make_tuple(1), _G.make_tuple(2)})
+        _G.check({1, 2})
+    end)
+end
+
+g.after_test('test_wal_error', function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_WAL_WRITE', false)
+    end)
+end)
+
+-- Checks bulk load over net.box.
+g.test_net_box = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local s = conn.space.test
+    local tuples = {{1, 1, '1', box.NULL, {1}}, {2, 2, '2', 2, {2}}}
+    t.assert_equals(s:bulk_load(tuples), nil)
+    t.assert_error_msg_contains(
+        'Duplicate key exists in unique index "pk"', s.bulk_load, s,
+        {{3, 3, '3', 3, {3}}, {1, 4, '4', 4, {4}}})
+    t.assert_equals(s:select(), tuples)
+    local stream = conn:new_stream()
+    t.assert_error_msg_contains(
+        'Unable to process BULK_LOAD request in stream',
+        stream.space.test.bulk_load, stream.space.test,
+        {{3, 3, '3', 3, {3}}})
+    conn:close()
+
+    -- The batch is written to WAL as a sequence of INSERT requests.
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:select(),
+                        {{1, 1, '1', box.NULL, {1}}, {2, 2, '2', 2, {2}}})
+    end)
+end
@@ -0,0 +1,49 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end)
+
+g.after_all(function()
+    if g.server ~= nil then
+        g.server:drop()
+    end
+end)
+
+g.test_idle_input_buffers_freed = function()
+    local conn = net.connect(g.server.net_box_uri)
+    -- The request is held in the input buffer while it is processed.
+    local size = conn:eval([[
+        return box.stat.net().INPUT_BUFFERS.current
+    ]], {string.rep('x', 1024 * 1024)})
+    t.assert_ge(size, 1024 * 1024)
+    -- Buffers of connections that don't receive data are freed.
+    t.helpers.retrying({timeout = 10}, function()
+        local stat = g.server:exec(function()
+            return box.stat.net()
+        end)
+        t.assert_lt(stat.INPUT_BUFFERS.current, 1024 * 1024)
+        t.assert_gt(stat.OUTPUT_BUFFERS.current, 0)
+    end)
+    t.assert_equals(conn:eval('return 1'), 1)
+    conn:close()
+end
+
+g.test_readahead_budget = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.readahead_budget, 128 * 1024 * 1024)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'readahead_budget': " ..
+            "value must be >= 0",
+            box.cfg, {readahead_budget = -1})
+        box.cfg{readahead_budget = 0}
+        t.assert_equals(box.cfg.readahead_budget, 0)
+        box.cfg{readahead_budget = 128 * 1024 * 1024}
+    end)
+end
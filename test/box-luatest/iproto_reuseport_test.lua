@@ -0,0 +1,68 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function()
+    t.skip_if(jit.os ~= 'Linux', 'SO_REUSEPORT balancing is Linux-only')
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            iproto_threads = 4,
+            iproto_reuseport = true,
+            iproto_cpu_affinity = {0},
+        },
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    if g.server ~= nil then
+        g.server:drop()
+    end
+end)
+
+g.test_connections_balanced = function()
+    -- SO_REUSEPORT is only used for IP sockets.
+    local uri = g.server:exec(function()
+        box.cfg{listen = '127.0.0.1:0'}
+        return box.info.listen
+    end)
+    local conns = {}
+    for i = 1, 100 do
+        conns[i] = net.connect(uri)
+        t.assert_equals(conns[i]:eval('return 1'), 1)
+    end
+    local busy = g.server:exec(function()
+        local busy = 0
+        for _, stat in ipairs(box.stat.net.thread()) do
+            if stat.CONNECTIONS.current > 0 then
+                busy = busy + 1
+            end
+        end
+        return busy
+    end)
+    t.assert_gt(busy, 1)
+    for _, conn in ipairs(conns) do
+        conn:close()
+    end
+    g.server:exec(function(listen)
+        box.cfg{listen = listen}
+    end, {g.server.net_box_uri})
+    local conn = net.connect(g.server.net_box_uri)
+    t.assert_equals(conn:eval('return 1'), 1)
+    conn:close()
+end
+
+g.test_static = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Can't set option 'iproto_reuseport' dynamically",
+            box.cfg, {iproto_reuseport = false})
+        t.assert_error_msg_content_equals(
+            "Can't set option 'iproto_cpu_affinity' dynamically",
+            box.cfg, {iproto_cpu_affinity = 1})
+    end)
+end
@@ -0,0 +1,89 @@
+local fiber = require('fiber')
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 200 do
+            -- Mix tuples that are copied to the output buffer with
+            -- tuples that are sent right from the tuple memory.
+            local size = i % 3 == 0 and 10 or 1000 * (i % 7 + 1)
+            s:insert({i, string.rep(string.char(65 + i % 26), size)})
+        end
+    end)
+    g.expected = g.server:exec(function()
+        return box.space.test:select()
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_select = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    t.assert_equals(s:select(), g.expected)
+    t.assert_equals(s:select({}, {limit = 1}), {g.expected[1]})
+    t.assert_equals(s:select({3}), {g.expected[3]})
+    t.assert_equals(s:get(100), g.expected[100])
+    t.assert_equals(s:select({}, {iterator = 'gt', limit = 5, offset = 10}),
+                    {unpack(g.expected, 11, 15)})
+    conn:close()
+end
+
+g.test_concurrent_select = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local fiber_count = 20
+    local results = fiber.channel(fiber_count * 10)
+    for i = 1, fiber_count do
+        fiber.create(function()
+            for _ = 1, 10 do
+                if i % 2 == 0 then
+                    results:put({conn.space.test:select(), g.expected})
+                else
+                    results:put({conn.space.test:get(i), g.expected[i]})
+                end
+            end
+        end)
+    end
+    for _ = 1, fiber_count * 10 do
+        local res = results:get(10)
+        t.assert_equals(res[1], res[2])
+    end
+    conn:close()
+end
+
+g.test_tuple_deleted_before_sent = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('tmp')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 100000)})
+        end
+    end)
+    local conn = net.connect(g.server.net_box_uri)
+    local f = fiber.new(function()
+        return conn.space.tmp:select()
+    end)
+    f:set_joinable(true)
+    g.server:exec(function()
+        box.space.tmp:drop()
+        collectgarbage()
+    end)
+    -- The request may fail if the space is dropped before it's
+    -- processed, but if it succeeds, the response must be intact.
+    local ok, res = f:join()
+    if ok then
+        t.assert_equals(#res, 100)
+        t.assert_equals(res[100], {100, string.rep('x', 100000)})
+    end
+    t.assert_equals(conn:eval('return 1'), 1)
+    conn:close()
+end
@@ -0,0 +1,176 @@
+local misc = require('test.luatest_helpers.misc')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_index_build_threads = 1},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 20000 do
+            s:insert({i, i % 1000, tostring(i), {i % 3, i % 7}})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+-- Checks that changes made to the space while an index is built
+-- are applied to the new index.
+g.test_concurrent_changes = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.space.test
+        local done = false
+        local change_count = 0
+        local f = fiber.new(function()
+            local i = 0
+            while not done do
+                i = i + 1
+                local id = i * 7 % 25000 + 1
+                if i % 3 == 0 then
+                    s:delete(id)
+                else
+                    s:replace({id, i % 1000, tostring(i), {i % 5}})
+                end
+                if i % 10 == 0 then
+                    box.begin()
+                    s:replace({id, 1001, 'rollback', {1001}})
+                    s:delete(id + 1)
+                    box.rollback()
+                end
+                change_count = change_count + 1
+                fiber.yield()
+            end
+        end)
+        f:set_joinable(true)
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s:create_index('str', {parts = {3, 'string'}, hint = false,
+                               unique = false})
+        s:create_index('mk', {parts = {{4, 'unsigned', path = '[*]'}},
+                              unique = false})
+        done = true
+        f:join()
+        t.assert_gt(change_count, 0)
+
+        local function check(index, key_parts)
+            local expected = s:select()
+            table.sort(expected, function(a, b)
+                for _, fieldno in ipairs(key_parts) do
+                    if a[fieldno] ~= b[fieldno] then
+                        return a[fieldno] < b[fieldno]
+                    end
+                end
+                return false
+            end)
+            t.assert_equals(index:select(), expected, index.name)
+        end
+        check(s.index.sk, {2, 1})
+        check(s.index.str, {3, 1})
+        t.assert_equals(s.index.sk:count(1001), 0)
+        t.assert_equals(s.index.mk:count(1001), 0)
+        local expected_counts = {}
+        for _, tuple in s:pairs() do
+            local keys = {}
+            for _, v in ipairs(tuple[4]) do
+                keys[v] = true
+            end
+            for v in pairs(keys) do
+                expected_counts[v] = (expected_counts[v] or 0) + 1
+            end
+        end
+        for v, count in pairs(expected_counts) do
+            t.assert_equals(s.index.mk:count(v), count, 'mk ' .. v)
+        end
+
+        s:replace({1, 1002, 'x', {1002}})
+        t.assert_equals(s.index.sk:select(1002), {{1, 1002, 'x', {1002}}})
+        t.assert_equals(s.index.str:select('x'), {{1, 1002, 'x', {1002}}})
+    end)
+end
+
+-- Checks that the unique constraint is checked by a background build.
+g.test_unique = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_error_msg_contains(
+            'Duplicate key exists in unique index "sk" in space "test"',
+            s.create_index, s, 'sk', {parts = {2, 'unsigned'}})
+        t.assert_equals(s.index.sk, nil)
+        s:create_index('sk', {parts = {{2, 'unsigned'}, {1, 'unsigned'}}})
+        t.assert_equals(s.index.sk:len(), 20000)
+        t.assert_equals(s.index.sk:get({999, 999}), {999, 999, '999',
+                                                      {0, 5}})
+    end)
+end
+
+-- Checks that the new index format is checked by a background build.
+g.test_format = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_error_msg_contains(
+            'Tuple field 3 type does not match one required by operation',
+            s.create_index, s, 'sk', {parts = {3, 'unsigned'}})
+        t.assert_equals(s.index.sk, nil)
+        t.assert_error_msg_contains(
+            'Tuple field 5 required by space format is missing',
+            s.create_index, s, 'sk', {parts = {5, 'unsigned'}})
+        t.assert_equals(s.index.sk, nil)
+    end)
+end
+
+-- Checks that the space accepts DML while the build worker is busy
+-- and the new index appears only when the build is complete.
+g.test_dml_during_build = function(cg)
+    misc.skip_if_not_debug()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.space.test
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', true)
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {parts = {2, 'unsigned'}, unique = false})
+        f:set_joinable(true)
+        fiber.sleep(0.1)
+        t.assert_equals(f:status(), 'suspended')
+        s:replace({20001, 1001, '20001', {1}})
+        s:delete(1)
+        s:update(2, {{'=', 2, 1001}})
+        t.assert_equals(s.index.sk, nil)
+        t.assert_equals(f:status(), 'suspended')
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', false)
+        t.assert_equals({f:join()}, {true})
+        t.assert_equals(s.index.sk:len(), s:len())
+        t.assert_equals(s.index.sk:select(1001),
+                        {{2, 1001, '2', {2, 2}}, {20001, 1001, '20001', {1}}})
+        t.assert_equals(s.index.sk:count(1), 19)
+    end)
+end
+
+g.after_test('test_dml_during_build', function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', false)
+    end)
+end)
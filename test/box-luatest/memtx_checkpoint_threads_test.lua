@@ -0,0 +1,213 @@
+local fio = require('fio')
+local misc = require('test.luatest_helpers.misc')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            memtx_checkpoint_threads = 4,
+            checkpoint_count = 1,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', false)
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY_COUNTDOWN', -1)
+        box.cfg({memtx_checkpoint_threads = 4})
+        local ids = {}
+        for _, def in box.space._space:pairs({box.schema.SYSTEM_ID_MAX},
+                                             {iterator = 'GT'}) do
+            table.insert(ids, def.id)
+        end
+        for _, id in ipairs(ids) do
+            box.space[id]:drop()
+        end
+    end)
+end)
+
+-- Returns the names of the snapshot files in the server work
+-- directory, sorted.
+local function snap_files(cg)
+    local files = fio.glob(fio.pathjoin(cg.server.workdir, '*.snap'))
+    for i, path in ipairs(files) do
+        files[i] = fio.basename(path)
+    end
+    table.sort(files)
+    return files
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_checkpoint_threads, 4)
+        box.cfg({memtx_checkpoint_threads = 1})
+        t.assert_equals(box.cfg.memtx_checkpoint_threads, 1)
+        local msg = "Incorrect value for option 'memtx_checkpoint_threads':" ..
+                    " must be greater than or equal to 1," ..
+                    " less than or equal to 64"
+        t.assert_error_msg_equals(msg, box.cfg,
+                                  {memtx_checkpoint_threads = 0})
+        t.assert_error_msg_equals(msg, box.cfg,
+                                  {memtx_checkpoint_threads = 65})
+        t.assert_equals(box.cfg.memtx_checkpoint_threads, 1)
+    end)
+end
+
+-- Checks that user spaces are written to several files, which are
+-- loaded on recovery, backed up and garbage collected together.
+g.test_shards = function(cg)
+    cg.server:exec(function()
+        for i = 1, 6 do
+            local s = box.schema.space.create('test' .. i)
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'string'}, unique = false})
+            box.begin()
+            for j = 1, i * 1000 do
+                s:insert({j, tostring(j % 100), string.rep('x', j % 50)})
+            end
+            box.commit()
+        end
+        box.snapshot()
+    end)
+    local signature = cg.server:exec(function()
+        return box.info.signature
+    end)
+    local prefix = string.format('%020d', signature)
+    local files = {prefix .. '.1.snap', prefix .. '.2.snap',
+                   prefix .. '.3.snap', prefix .. '.snap'}
+    t.helpers.retrying({}, function()
+        t.assert_equals(snap_files(cg), files)
+    end)
+    local f = fio.open(fio.pathjoin(cg.server.workdir, prefix .. '.snap'))
+    t.assert_str_contains(f:read(1024), '\nShards: 4\n')
+    f:close()
+
+    cg.server:exec(function(files)
+        local fio = require('fio')
+        local t = require('luatest')
+        local backup = box.backup.start()
+        for i, path in ipairs(backup) do
+            backup[i] = fio.basename(path)
+        end
+        table.sort(backup)
+        box.backup.stop()
+        t.assert_equals(backup, files)
+    end, {files})
+
+    cg.server:restart()
+    t.assert(cg.server:grep_log('recovering from `.*%.3%.snap\''))
+    cg.server:exec(function()
+        local t = require('luatest')
+        for i = 1, 6 do
+            local s = box.space['test' .. i]
+            t.assert_equals(s:count(), i * 1000)
+            t.assert_equals(s.index.sk:count(), i * 1000)
+            t.assert_equals(s:get(i * 1000),
+                            {i * 1000, tostring(i * 1000 % 100),
+                             string.rep('x', i * 1000 % 50)})
+        end
+        -- Fewer user spaces than threads: one file per space.
+        box.space.test1:drop()
+        box.space.test2:drop()
+        box.space.test3:drop()
+        box.space.test4:drop()
+        box.space.test5:insert({0, '0', ''})
+        box.snapshot()
+    end)
+    signature = cg.server:exec(function()
+        return box.info.signature
+    end)
+    prefix = string.format('%020d', signature)
+    files = {prefix .. '.1.snap', prefix .. '.2.snap', prefix .. '.snap'}
+    t.helpers.retrying({}, function()
+        t.assert_equals(snap_files(cg), files)
+    end)
+
+    cg.server:exec(function()
+        box.cfg({memtx_checkpoint_threads = 1})
+        box.space.test5:delete({0})
+        box.snapshot()
+    end)
+    signature = cg.server:exec(function()
+        return box.info.signature
+    end)
+    files = {string.format('%020d.snap', signature)}
+    t.helpers.retrying({}, function()
+        t.assert_equals(snap_files(cg), files)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test5:count(), 5000)
+        t.assert_equals(box.space.test6:count(), 6000)
+    end)
+end
+
+-- Checks that the read view of a space is released as soon as the
+-- space has been written, before the checkpoint ends.
+g.test_release_read_view = function(cg)
+    misc.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local t = require('luatest')
+        box.cfg({memtx_checkpoint_threads = 1})
+        local s1 = box.schema.space.create('test1')
+        s1:create_index('pk')
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        for _, s in ipairs({s1, s2}) do
+            box.begin()
+            for i = 1, 10000 do
+                s:insert({i, 0})
+            end
+            box.commit()
+        end
+        -- System spaces are written first, then user spaces in no
+        -- particular order. Hold the checkpoint after writing the
+        -- first user space.
+        local count = 0
+        for _, def in box.space._space:pairs() do
+            local s = box.space[def.id]
+            if def.id >= box.schema.SYSTEM_ID_MIN and
+                    def.id <= box.schema.SYSTEM_ID_MAX and
+                    def.engine == 'memtx' and not s.temporary and
+                    s.index[0] ~= nil then
+                count = count + 1
+            end
+        end
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY_COUNTDOWN', count)
+        local f = fiber.new(box.snapshot)
+        f:set_joinable(true)
+        t.helpers.retrying({}, function()
+            t.assert(box.error.injection.get('ERRINJ_SNAP_WRITE_DELAY'))
+        end)
+        -- Let tx process the notification from the checkpoint thread.
+        fiber.sleep(0.1)
+        -- Modifying a space whose read view is held makes its index
+        -- copy extents.
+        local bsize1 = s1.index.pk:bsize()
+        local bsize2 = s2.index.pk:bsize()
+        for i = 1, 10000, 100 do
+            s1:update(i, {{'=', 2, 1}})
+            s2:update(i, {{'=', 2, 1}})
+        end
+        local is_held1 = s1.index.pk:bsize() > bsize1
+        local is_held2 = s2.index.pk:bsize() > bsize2
+        t.assert_not_equals(is_held1, is_held2)
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', false)
+        t.assert_equals({f:join()}, {true, 'ok'})
+        t.assert_equals(s1.index.pk:bsize(), bsize1)
+        t.assert_equals(s2.index.pk:bsize(), bsize2)
+    end)
+end
@@ -0,0 +1,95 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_index_build_threads = 4},
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_index_build_threads, 4)
+        t.assert_error_msg_content_equals(
+            "Can't set option 'memtx_index_build_threads' dynamically",
+            box.cfg, {memtx_index_build_threads = 2})
+    end)
+end
+
+g.test_recovery = function()
+    g.server:exec(function()
+        box.schema.func.create('func', {
+            body = 'function(tuple) return {tuple[2] % 7} end',
+            is_deterministic = true, is_sandboxed = true,
+        })
+        for _, name in ipairs({'test1', 'test2'}) do
+            local s = box.schema.space.create(name)
+            s:create_index('pk')
+            s:create_index('tree', {parts = {2, 'unsigned'}})
+            s:create_index('tree_nohint', {parts = {{3, 'string'}},
+                                           hint = false, unique = false})
+            s:create_index('multikey', {parts = {{4, 'unsigned',
+                                                  path = '[*]'}},
+                                        unique = false})
+            s:create_index('hash', {type = 'hash',
+                                    parts = {2, 'unsigned'}})
+            s:create_index('func', {func = 'func', unique = false,
+                                    parts = {{1, 'unsigned'}}})
+            s:create_index('nullable', {parts = {{5, 'unsigned',
+                                                  exclude_null = true}},
+                                        unique = false})
+        end
+        box.schema.space.create('empty'):create_index('pk')
+        box.space.empty:create_index('sk', {parts = {2, 'unsigned'}})
+        local function fill(s, from, to)
+            box.begin()
+            for i = from, to do
+                s:insert({i, 1000000 - i, tostring(i % 100),
+                          {i % 3, i % 5}, i % 2 == 0 and i or box.NULL})
+            end
+            box.commit()
+        end
+        fill(box.space.test1, 1, 5000)
+        fill(box.space.test2, 1, 3000)
+        box.snapshot()
+        fill(box.space.test1, 5001, 6000)
+        fill(box.space.test2, 3001, 4000)
+    end)
+
+    local function dump()
+        local result = {}
+        for _, name in ipairs({'test1', 'test2', 'empty'}) do
+            local s = box.space[name]
+            result[name] = {}
+            for id, idx in pairs(s.index) do
+                if type(id) == 'number' then
+                    result[name][idx.name] = {idx:len(),
+                                              idx:select({}, {limit = 100})}
+                end
+            end
+        end
+        return result
+    end
+    local expected = g.server:exec(dump)
+
+    g.server:restart()
+    t.assert(g.server:grep_log("Adding 6000 keys to TREE index 'tree'"))
+    t.assert_equals(g.server:exec(dump), expected)
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test1
+        t.assert_equals(s.index.tree:get(1000000 - 42), s:get(42))
+        t.assert_equals(s.index.multikey:count(4), 1200)
+        t.assert_equals(s.index.nullable:count(), 3000)
+        s:replace({1, 0, 'x', {}})
+        t.assert_equals(s.index.tree:get(0), {1, 0, 'x', {}})
+    end)
+end
@@ -0,0 +1,179 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_read_view_interval = 0.01},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s:create_index('str', {parts = {{3, 'string',
+                                         collation = 'unicode_ci'}},
+                               unique = false})
+        for i = 1, 1000 do
+            s:insert({i, i % 37, tostring(i % 11)})
+        end
+        box.schema.user.create('alice', {password = 'secret'})
+        box.schema.user.create('bob', {password = 'secret'})
+        box.schema.user.grant('alice', 'write', 'space', 'test')
+        box.schema.user.grant('bob', 'read', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{memtx_read_view_interval = 0.01}
+    end)
+end)
+
+local function select_count(server)
+    return server:exec(function()
+        return box.stat().SELECT.total
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_read_view_interval, 0.01)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'memtx_read_view_interval': " ..
+            "the value must be greater than or equal to 0",
+            box.cfg, {memtx_read_view_interval = -1})
+        t.assert_equals(box.cfg.memtx_read_view_interval, 0.01)
+    end)
+end
+
+-- Checks that SELECT requests served from read views return the same
+-- results as the tx thread.
+g.test_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local s = conn.space.test
+    local iterators = {'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT', 'ALL'}
+    local keys = {{}, {0}, {1}, {18}, {36}, {500}, {1001}}
+    local opts = {{}, {limit = 10}, {offset = 5, limit = 20},
+                  {offset = 2000}}
+    local before = select_count(cg.server)
+    local request_count = 0
+    for _, name in ipairs({'pk', 'sk'}) do
+        for _, it in ipairs(iterators) do
+            for _, key in ipairs(keys) do
+                for _, o in ipairs(opts) do
+                    local o2 = table.copy(o)
+                    o2.iterator = it
+                    local expected = cg.server:exec(function(name, key, o)
+                        return box.space.test.index[name]:select(key, o)
+                    end, {name, key, o2})
+                    t.assert_equals(s.index[name]:select(key, o2), expected,
+                                    string.format('%s %s %s', name, it,
+                                                  table.concat(key, ',')))
+                    request_count = request_count + 1
+                end
+            end
+        end
+    end
+    -- Each server:exec() call does one local SELECT.
+    local tx_count = select_count(cg.server) - before - request_count
+    t.assert_lt(tx_count, request_count / 2)
+
+    -- Invalid requests are forwarded to tx, which replies with an error.
+    t.assert_error_msg_contains('Invalid key part count',
+                                s.index.pk.select, s.index.pk, {1, 2})
+    t.assert_error_msg_contains('Supplied key type of part 0 does not match',
+                                s.index.pk.select, s.index.pk, {'x'})
+    -- Indexes with collations aren't supported, but still work.
+    t.assert_equals(#s.index.str:select({'3'}), 91)
+    conn:close()
+end
+
+-- Checks that a connection sees its own changes and changes made by
+-- other connections become visible shortly.
+g.test_visibility = function(cg)
+    local conn1 = net.connect(cg.server.net_box_uri)
+    local conn2 = net.connect(cg.server.net_box_uri)
+    conn1.space.test:replace({1, 1, 'foo'})
+    t.assert_equals(conn1.space.test:get(1), {1, 1, 'foo'})
+    t.helpers.retrying({}, function()
+        t.assert_equals(conn2.space.test:get(1), {1, 1, 'foo'})
+    end)
+    conn2.space.test:replace({1, 1, '1'})
+    t.assert_equals(conn2.space.test:get(1), {1, 1, '1'})
+    t.helpers.retrying({}, function()
+        t.assert_equals(conn1.space.test:get(1), {1, 1, '1'})
+    end)
+    conn1:close()
+    conn2:close()
+end
+
+-- Checks that access checks are respected.
+g.test_access = function(cg)
+    local uri = cg.server.net_box_uri
+    local alice = net.connect(uri, {user = 'alice', password = 'secret'})
+    local bob = net.connect(uri, {user = 'bob', password = 'secret'})
+    local msg = "Read access to space 'test' is denied for user"
+    for _ = 1, 10 do
+        t.assert_error_msg_contains(msg, alice.space.test.select,
+                                    alice.space.test, {1})
+        t.assert_equals(bob.space.test:select({2}), {{2, 2, '2'}})
+    end
+    cg.server:exec(function()
+        box.schema.user.grant('alice', 'read', 'space', 'test')
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(alice.space.test:select({2}), {{2, 2, '2'}})
+    end)
+    cg.server:exec(function()
+        box.schema.user.revoke('alice', 'read', 'space', 'test')
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_error_msg_contains(msg, alice.space.test.select,
+                                    alice.space.test, {1})
+    end)
+    alice:close()
+    bob:close()
+end
+
+-- Checks that the schema version of a request is respected.
+g.test_ddl = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.space.test:get(3), {3, 3, '3'})
+    cg.server:exec(function()
+        box.space.test:format({{'id', 'unsigned'}})
+        box.space.test:replace({3, 3, 'bar'})
+    end)
+    -- The connection has a stale schema so the request is served by
+    -- tx, which makes the client reload the schema.
+    t.assert_equals(conn.space.test:get(3), {3, 3, 'bar'})
+    t.assert_equals(conn.space.test:get(3):tomap().id, 3)
+    cg.server:exec(function()
+        box.space.test:format({})
+        box.space.test:replace({3, 3, '3'})
+    end)
+    conn:close()
+end
+
+-- Checks that requests are served by tx if read views are disabled.
+g.test_disable = function(cg)
+    cg.server:exec(function()
+        box.cfg{memtx_read_view_interval = 0}
+    end)
+    local conn = net.connect(cg.server.net_box_uri)
+    local before = select_count(cg.server)
+    for i = 1, 10 do
+        t.assert_equals(conn.space.test:get(i * 10),
+                        {i * 10, i * 10 % 37, tostring(i * 10 % 11)})
+    end
+    t.assert_equals(select_count(cg.server) - before, 10)
+    conn:close()
+end
@@ -0,0 +1,126 @@
+local bit = require('bit')
+local fio = require('fio')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_max_tuple_size = 4 * 1024 * 1024},
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+-- Checks that a snapshot that doesn't fit in one batch of the snapshot
+-- reader is recovered correctly, including rows that are bigger than
+-- a batch.
+g.test_recovery = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, tostring(i), string.rep('x', i % 1000)})
+        end
+        box.commit()
+        box.space.test:insert({10001, 'big', string.rep('y', 2 * 1024 * 1024)})
+        box.snapshot()
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 10001)
+        t.assert_equals(s.index.sk:count(), 10001)
+        for _, i in ipairs({1, 999, 1000, 1024, 1025, 5000, 10000}) do
+            t.assert_equals(s:get(i), {i, tostring(i),
+                                       string.rep('x', i % 1000)})
+        end
+        t.assert_equals(#s.index.sk:get('big')[3], 2 * 1024 * 1024)
+    end)
+end
+
+local ROW_COUNT = 100000
+
+-- Writes a snapshot, stops the server and flips a byte in the middle
+-- of the user space data of the snapshot.
+local function corrupt_snapshot(cg)
+    cg.master = server:new({alias = 'master_corrupt'})
+    cg.master:start()
+    cg.master:exec(function(row_count)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, row_count do
+            s:insert({i, i * 7919 % 1000003, tostring(i):rep(10)})
+        end
+        box.commit()
+        box.snapshot()
+    end, {ROW_COUNT})
+    cg.master:stop()
+    local files = fio.glob(fio.pathjoin(cg.master.workdir, '*.snap'))
+    table.sort(files)
+    local f = fio.open(files[#files], {'O_RDWR'})
+    local offset = math.floor(f:stat().size * 3 / 4)
+    local byte = f:pread(1, offset):byte()
+    f:pwrite(string.char(bit.bxor(byte, 0xff)), offset)
+    f:close()
+end
+
+g.before_test('test_corrupted', corrupt_snapshot)
+
+g.after_test('test_corrupted', function(cg)
+    -- The instance must exit by itself, but kill it just in case.
+    pcall(cg.replica.stop, cg.replica)
+    cg.master:cleanup()
+end)
+
+-- Checks that an error found by the snapshot reader fails recovery.
+g.test_corrupted = function(cg)
+    cg.replica = server:new({
+        alias = 'replica_corrupt',
+        workdir = cg.master.workdir,
+    })
+    cg.replica:start({wait_for_readiness = false})
+    local log = fio.pathjoin(cg.replica.workdir, cg.replica.alias .. '.log')
+    t.helpers.retrying({}, function()
+        t.assert(cg.replica:grep_log('tx checksum mismatch', nil,
+                                     {filename = log}))
+    end)
+    t.assert_not(cg.replica:grep_log('ready to accept requests', nil,
+                                     {filename = log}))
+end
+
+g.before_test('test_corrupted_force_recovery', corrupt_snapshot)
+
+g.after_test('test_corrupted_force_recovery', function(cg)
+    cg.replica:stop()
+    cg.master:cleanup()
+end)
+
+-- Checks that the snapshot reader skips a corrupted transaction and
+-- reads the rest of the snapshot if force_recovery is set.
+g.test_corrupted_force_recovery = function(cg)
+    cg.replica = server:new({
+        alias = 'replica_force',
+        workdir = cg.master.workdir,
+        box_cfg = {force_recovery = true},
+    })
+    cg.replica:start()
+    t.assert(cg.replica:grep_log("can't open tx: tx checksum mismatch"))
+    cg.replica:exec(function(row_count)
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_lt(s:count(), row_count)
+        t.assert_gt(s:count(), row_count / 2)
+        t.assert_equals(s:get(row_count),
+                        {row_count, row_count * 7919 % 1000003,
+                         tostring(row_count):rep(10)})
+    end, {ROW_COUNT})
+end
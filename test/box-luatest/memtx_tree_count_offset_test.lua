@@ -0,0 +1,79 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_tree_count_offset', t.helpers.matrix({
+    mvcc = {false, true},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_use_mvcc_engine = cg.params.mvcc},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that index:count() and index:select() with offset agree
+-- with plain index:select() for all iterator types.
+g.test_count_and_offset = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local json = require('json')
+
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s:create_index('sk_nohint', {parts = {2, 'unsigned'},
+                                     unique = false, hint = false})
+        s:create_index('mk', {parts = {{'[3][*]', 'unsigned'}},
+                              unique = false})
+        math.randomseed(0)
+        for i = 1, 3000 do
+            local v = math.random(0, 99)
+            s:replace({i, v, {v, (v + 1) % 100}})
+        end
+        for i = 1, 3000, 3 do
+            s:delete(i)
+        end
+
+        local iterators = {'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT'}
+        local keys = {{}, {0}, {1}, {25}, {50}, {99}, {100}}
+        for _, name in ipairs({'pk', 'sk', 'sk_nohint', 'mk'}) do
+            local index = s.index[name]
+            for _, it in ipairs(iterators) do
+                for _, key in ipairs(keys) do
+                    local all = index:select(key, {iterator = it})
+                    local msg = string.format('%s %s %s', name, it,
+                                              json.encode(key))
+                    t.assert_equals(index:count(key, {iterator = it}),
+                                    #all, msg)
+                    for _, offset in ipairs({1, 2, 7, 100, #all - 1,
+                                             #all, #all + 1}) do
+                        if offset > 0 then
+                            local expected = {}
+                            local last = math.min(offset + 10, #all)
+                            for i = offset + 1, last do
+                                table.insert(expected, all[i])
+                            end
+                            t.assert_equals(index:select(key, {
+                                iterator = it, offset = offset, limit = 10,
+                            }), expected, msg .. ' offset ' .. offset)
+                        end
+                    end
+                end
+            end
+        end
+    end)
+end
@@ -0,0 +1,122 @@
+local misc = require('test.luatest_helpers.misc')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    misc.skip_if_enterprise()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'data', type = 'string', compression = 'zstd'},
+            {name = 'small', type = 'string', compression = 'zstd'},
+            {name = 'raw', type = 'any'},
+        }})
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function()
+    if g.server ~= nil then
+        g.server:drop()
+    end
+end)
+
+g.test_compression = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local data = string.rep('abcdefgh', 100)
+        for i = 1, 100 do
+            s:insert({i, data .. i, 'x', {i}})
+        end
+        local stat = box.stat.memtx.compression()
+        t.assert_equals(stat.tuples, 100)
+        t.assert_equals(stat.fields, 100)
+        t.assert_gt(stat.bytes_raw, 100 * #data)
+        t.assert_lt(stat.bytes_compressed, stat.bytes_raw / 4)
+        t.assert_lt(s:bsize(), 100 * #data / 4)
+
+        t.assert_equals(s:select({}, {limit = 1}),
+                        {{1, data .. 1, 'x', {1}}})
+        t.assert_equals(s:get(42), {42, data .. 42, 'x', {42}})
+        stat = box.stat.memtx.compression()
+        t.assert_ge(stat.decompressions, 2)
+        t.assert_equals(s:get(42), {42, data .. 42, 'x', {42}})
+        t.assert_equals(box.stat.memtx.compression().cache.hits,
+                        stat.cache.hits + 1)
+
+        t.assert_equals(s:update(42, {{'=', 3, 'y'}}),
+                        {42, data .. 42, 'y', {42}})
+        s:upsert({43}, {{'=', 3, 'z'}})
+        t.assert_equals(s:get(43), {43, data .. 43, 'z', {43}})
+        t.assert_equals(s:delete(44), {44, data .. 44, 'x', {44}})
+        t.assert_equals(s:replace({45, 'short', 'x'}), {45, 'short', 'x'})
+
+        t.assert_error_msg_content_equals(
+            "Indexed field does not support compression",
+            s.create_index, s, 'sk', {parts = {'data'}})
+    end)
+end
+
+g.test_recovery = function()
+    local function dump()
+        return box.space.test:select()
+    end
+    g.server:exec(function() box.snapshot() end)
+    g.server:exec(function()
+        box.space.test:replace({1000, string.rep('x', 1000), 'wal'})
+    end)
+    local expected = g.server:exec(dump)
+    g.server:restart()
+    t.assert_equals(g.server:exec(dump), expected)
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_gt(box.stat.memtx.compression().tuples, 0)
+    end)
+end
+
+g.test_stat = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test_stat', {format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'data', type = 'string', compression = 'zstd'},
+        }})
+        s:create_index('pk')
+        local stat = box.stat.memtx.compression()
+        local data = string.rep('abcdefgh', 100)
+        for i = 1, 10 do
+            s:insert({i, data})
+        end
+        t.assert_equals(box.stat.memtx.compression().tuples,
+                        stat.tuples + 10)
+        t.assert_equals(box.stat.memtx.compression().fields,
+                        stat.fields + 10)
+        t.assert_equals(s:get(1), {1, data})
+        t.assert_equals(s:get(1), {1, data})
+        for i = 1, 10 do
+            s:delete(i)
+        end
+        collectgarbage()
+        t.helpers.retrying({}, function()
+            local new_stat = box.stat.memtx.compression()
+            t.assert_equals(new_stat.tuples, stat.tuples)
+            t.assert_equals(new_stat.fields, stat.fields)
+            t.assert_equals(new_stat.bytes_raw, stat.bytes_raw)
+            t.assert_equals(new_stat.bytes_compressed,
+                            stat.bytes_compressed)
+        end)
+        s:drop()
+
+        t.assert_gt(box.stat.memtx.compression().decompressions, 0)
+        t.assert_gt(box.stat.memtx.compression().cache.hits, 0)
+        box.stat.reset()
+        stat = box.stat.memtx.compression()
+        t.assert_equals(stat.decompressions, 0)
+        t.assert_equals(stat.cache.hits, 0)
+        t.assert_gt(stat.tuples, 0)
+    end)
+end
@@ -0,0 +1,115 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        rawset(_G, 'write_concurrently', function(count)
+            local fiber = require('fiber')
+            local fibers = {}
+            for i = 1, count do
+                local f = fiber.new(s.insert, s, {i})
+                f:set_joinable(true)
+                table.insert(fibers, f)
+            end
+            for _, f in ipairs(fibers) do
+                assert(f:join())
+            end
+        end)
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg{wal_batch_window = 0, wal_batch_max_size = 0}
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.wal_batch_window, 0)
+        t.assert_equals(box.cfg.wal_batch_max_size, 0)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_batch_window': " ..
+            "value must be >= 0",
+            box.cfg, {wal_batch_window = -1})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_batch_max_size': " ..
+            "value must be >= 0",
+            box.cfg, {wal_batch_max_size = -1})
+    end)
+end
+
+g.test_batch_window = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local clock = require('clock')
+        box.cfg{wal_batch_window = 0.1}
+        box.stat.reset()
+        local start = clock.monotonic()
+        _G.write_concurrently(10)
+        t.assert_ge(clock.monotonic() - start, 0.09)
+        local stat = box.stat.wal()
+        t.assert_equals(stat.txns, 10)
+        t.assert_equals(stat.batches, 1)
+        -- Percentiles are reported as histogram bucket upper bounds,
+        -- so only check that they are consistent with the batch size.
+        t.assert_ge(stat.batch.txns.p50, 10)
+        t.assert_ge(stat.batch.txns.p99, stat.batch.txns.p50)
+        t.assert_ge(stat.latency.queue.p50, 0.1)
+        t.assert_equals(box.space.test:count(), 10)
+
+        -- Checkpointing doesn't wait for the window to expire.
+        box.space.test:truncate()
+        box.cfg{wal_batch_window = 100}
+        local f = require('fiber').new(box.space.test.insert,
+                                       box.space.test, {1})
+        f:set_joinable(true)
+        require('fiber').yield()
+        box.snapshot()
+        t.assert(f:join())
+    end)
+end
+
+g.test_batch_max_size = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        box.cfg{wal_batch_window = 100, wal_batch_max_size = 1}
+        box.stat.reset()
+        _G.write_concurrently(10)
+        local stat = box.stat.wal()
+        t.assert_equals(stat.txns, 10)
+        t.assert_equals(stat.batches, 10)
+        t.assert_ge(stat.batch.txns.p99, 1)
+    end)
+end
+
+g.test_stat = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        box.stat.reset()
+        local stat = box.stat.wal()
+        t.assert_equals(stat.batches, 0)
+        t.assert_equals(stat.txns, 0)
+        box.space.test:insert({1})
+        stat = box.stat.wal()
+        t.assert_equals(stat.batches, 1)
+        t.assert_equals(stat.txns, 1)
+        t.assert_ge(stat.batch.txns.p50, 1)
+        t.assert_gt(stat.batch.bytes.p50, 0)
+        for _, name in ipairs({'queue', 'write', 'sync', 'complete'}) do
+            t.assert_type(stat.latency[name].p50, 'number')
+            t.assert_type(stat.latency[name].p99, 'number')
+        end
+    end)
+end
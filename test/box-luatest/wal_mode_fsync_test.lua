@@ -0,0 +1,70 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {wal_mode = 'fsync', wal_max_size = 1024 * 1024},
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_recovery = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        -- A transaction that takes several writes.
+        box.begin()
+        for i = 101, 3000 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+        box.commit()
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.wal_mode, 'fsync')
+        t.assert_equals(box.space.test:count(), 3000)
+        t.assert_equals(box.space.test:get(3000)[2], string.rep('x', 1000))
+    end)
+end
+
+g.test_concurrent_writes = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('concurrent')
+        s:create_index('pk')
+        box.stat.reset()
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(function()
+                for j = 1, 10 do
+                    s:insert({i * 100 + j})
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        -- Make a checkpoint while transactions are being synced.
+        fiber.yield()
+        box.snapshot()
+        for _, f in ipairs(fibers) do
+            t.assert(f:join())
+        end
+        t.assert_equals(s:count(), 1000)
+        local stat = box.stat.wal()
+        t.assert_equals(stat.txns, 1000)
+        t.assert_le(stat.batches, 1000)
+        t.assert_gt(stat.latency.sync.p99, 0)
+        s:drop()
+    end)
+end
@@ -0,0 +1,127 @@
+local cluster = require('test.luatest_helpers.cluster')
+local misc = require('test.luatest_helpers.misc')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {wal_mode = 'fsync'},
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_instance_uri('master'),
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+g.after_each(function(cg)
+    cg.master:exec(function()
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY', false)
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY_COUNTDOWN', -1)
+    end)
+end)
+
+-- Checks that in the fsync mode rows aren't relayed before they are
+-- synced to disk.
+g.test_relay_after_sync = function(cg)
+    misc.skip_if_not_debug()
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY', true)
+        local f = fiber.new(box.space.test.insert, box.space.test, {1})
+        f:set_joinable(true)
+        rawset(_G, 'insert_fiber', f)
+    end)
+    require('fiber').sleep(0.5)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:get(1), nil)
+    end)
+    cg.master:exec(function()
+        local t = require('luatest')
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY', false)
+        local ok, tuple = _G.insert_fiber:join()
+        t.assert(ok)
+        t.assert_equals(tuple, {1})
+    end)
+    cg.replica:wait_vclock_of(cg.master)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:get(1), {1})
+    end)
+end
+
+-- Checks that a relay woken up by a synced batch doesn't send rows of
+-- the next batch, which is already written to the WAL file but isn't
+-- synced yet.
+g.test_relay_next_batch = function(cg)
+    misc.skip_if_not_debug()
+    cg.master:exec(function()
+        local fio = require('fio')
+        local fiber = require('fiber')
+        local t = require('luatest')
+        local s = box.space.test
+        local function wal_size()
+            local files = fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+            table.sort(files)
+            return fio.stat(files[#files]).size
+        end
+        local function insert(key)
+            local size = wal_size()
+            local f = fiber.new(s.insert, s, {key})
+            f:set_joinable(true)
+            t.helpers.retrying({}, function()
+                t.assert_gt(wal_size(), size)
+            end)
+            return f
+        end
+        -- Hold the sync of the first batch.
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY', true)
+        local f1 = insert(10)
+        -- Let the sync cord pick up the first batch.
+        fiber.sleep(0.1)
+        -- The second batch is written while the first one is being
+        -- synced. Hold its sync once the first one is released.
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY_COUNTDOWN', 0)
+        local f2 = insert(20)
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY', false)
+        t.assert_equals({f1:join()}, {true, {10}})
+        rawset(_G, 'insert_fiber', f2)
+    end)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.space.test:get(10), {10})
+        end)
+        require('fiber').sleep(0.5)
+        t.assert_equals(box.space.test:get(20), nil)
+    end)
+    cg.master:exec(function()
+        local t = require('luatest')
+        box.error.injection.set('ERRINJ_WAL_SYNC_DELAY', false)
+        t.assert_equals({_G.insert_fiber:join()}, {true, {20}})
+    end)
+    cg.replica:wait_vclock_of(cg.master)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:get(20), {20})
+    end)
+end
@@ -17,12 +17,13 @@ simple_test()
 	srand(time(0));
 	uint32_t error_count = 0;
 	uint32_t fp_rate_too_big = 0;
+	for (int type = 0; type < bloom_type_MAX; type++)
 	for (double p = 0.001; p < 0.5; p *= 1.3) {
 		uint64_t tests = 0;
 		uint64_t false_positive = 0;
 		for (uint32_t count = 1000; count <= 10000; count *= 2) {
 			struct bloom bloom;
-			bloom_create(&bloom, count, p);
+			bloom_create(&bloom, (enum bloom_type)type, count, p);
 			unordered_set<uint32_t> check;
 			for (uint32_t i = 0; i < count; i++) {
 				uint32_t val = rand() % (count * 10);
@@ -56,12 +57,13 @@ store_load_test()
 	srand(time(0));
 	uint32_t error_count = 0;
 	uint32_t fp_rate_too_big = 0;
+	for (int type = 0; type < bloom_type_MAX; type++)
 	for (double p = 0.01; p < 0.5; p *= 1.5) {
 		uint64_t tests = 0;
 		uint64_t false_positive = 0;
 		for (uint32_t count = 300; count <= 3000; count *= 10) {
 			struct bloom bloom;
-			bloom_create(&bloom, count, p);
+			bloom_create(&bloom, (enum bloom_type)type, count, p);
 			unordered_set<uint32_t> check;
 			for (uint32_t i = 0; i < count; i++) {
 				uint32_t val = rand() % (count * 10);
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <inttypes.h>
 #include <time.h>
 
@@ -115,6 +116,78 @@ static int compare_key(const elem_t &a, long b)
 #define bps_tree_key_t uint32_t
 #define bps_tree_arg_t int
 #include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_IS_IDENTICAL
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+
+/* tree for subtree cardinality test */
+#define BPS_TREE_NAME card
+#define BPS_TREE_BLOCK_SIZE 128 /* value is to low specially for tests */
+#define BPS_TREE_EXTENT_SIZE 2048 /* value is to low specially for tests */
+#define BPS_TREE_IS_IDENTICAL(a, b) (a == b)
+#define BPS_TREE_COMPARE(a, b, arg) compare(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) compare(a, b)
+#define bps_tree_elem_t type_t
+#define bps_tree_key_t type_t
+#define bps_tree_arg_t int
+#define BPS_INNER_CARD
+#include "salad/bps_tree.h"
+#undef BPS_INNER_CARD
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_IS_IDENTICAL
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+
+struct hinted_elem_t {
+	type_t value;
+	uint64_t hint;
+};
+
+/*
+ * A coarse order-preserving hint. Some values have no hint to check
+ * that elements and keys with unknown hints are handled correctly.
+ */
+static uint64_t
+value_hint(type_t value, int none_period)
+{
+	return value % none_period == 0 ? UINT64_MAX : (uint64_t)value / 4;
+}
+
+static hinted_elem_t
+hinted_elem(type_t value)
+{
+	hinted_elem_t elem = {value, value_hint(value, 7)};
+	return elem;
+}
+
+/* tree for hinted search test */
+#define BPS_TREE_NAME hinted
+#define BPS_TREE_BLOCK_SIZE 128 /* value is to low specially for tests */
+#define BPS_TREE_EXTENT_SIZE 2048 /* value is to low specially for tests */
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a).value == (b).value)
+#define BPS_TREE_COMPARE(a, b, arg) compare((a).value, (b).value)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) compare((a).value, b)
+#define BPS_TREE_ELEM_HINT(elem) ((elem).hint)
+#define BPS_TREE_KEY_HINT(key, arg) value_hint(key, 5)
+#define BPS_TREE_SEARCH_ELEM_HINT(elem, arg) ((elem).hint)
+#define bps_tree_elem_t struct hinted_elem_t
+#define bps_tree_key_t type_t
+#define bps_tree_arg_t int
+#include "salad/bps_tree.h"
+#undef BPS_TREE_ELEM_HINT
+#undef BPS_TREE_KEY_HINT
+#undef BPS_TREE_SEARCH_ELEM_HINT
 
 #define bps_insert_and_check(tree_name, tree, elem, replaced) \
 {\
@@ -816,6 +889,238 @@ approximate_count()
 	footer();
 }
 
+static void
+card_check_offsets(card *tree, const bool *present, type_t range)
+{
+	size_t less = 0;
+	for (type_t i = 0; i < range; i++) {
+		size_t offset = SIZE_MAX;
+		bool exact = false;
+		card_iterator itr =
+			card_lower_bound_get_offset(tree, i, &exact, &offset);
+		if (offset != less || exact != present[i])
+			fail("lower bound offset", "true");
+		if (present[i]) {
+			type_t *v = card_iterator_get_elem(tree, &itr);
+			if (v == NULL || *v != i)
+				fail("lower bound iterator", "true");
+			itr = card_iterator_at(tree, less);
+			v = card_iterator_get_elem(tree, &itr);
+			if (v == NULL || *v != i)
+				fail("iterator at offset", "true");
+			less++;
+		}
+		itr = card_upper_bound_get_offset(tree, i, &exact, &offset);
+		if (offset != less || exact != present[i])
+			fail("upper bound offset", "true");
+	}
+	if (less != tree->size)
+		fail("tree size", "true");
+	card_iterator itr = card_iterator_at(tree, tree->size);
+	if (!card_iterator_is_invalid(&itr))
+		fail("iterator at offset out of range", "true");
+}
+
+static void
+card_check()
+{
+	header();
+	srand(0);
+
+	const type_t range = 3000;
+	bool present[range];
+	memset(present, 0, sizeof(present));
+
+	card tree;
+	card_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+	for (int i = 0; i < 30000; i++) {
+		type_t v = rand() % range;
+		/* Grow the tree first, then shrink it. */
+		bool ins = rand() % 100 < (i < 15000 ? 70 : 30);
+		if (ins) {
+			if (card_insert(&tree, v, NULL, NULL) != 0)
+				fail("insertion failed", "true");
+			present[v] = true;
+		} else {
+			card_delete(&tree, v);
+			present[v] = false;
+		}
+		if (i % 1000 == 0) {
+			if (card_debug_check(&tree))
+				fail("debug check nonzero", "true");
+			card_check_offsets(&tree, present, range);
+		}
+	}
+	if (card_debug_check(&tree))
+		fail("debug check nonzero", "true");
+	card_check_offsets(&tree, present, range);
+	card_destroy(&tree);
+
+	type_t arr[range];
+	for (type_t i = 0; i < range; i++) {
+		arr[i] = i;
+		present[i] = false;
+	}
+	for (type_t i = 0; i <= range; i += 7) {
+		card_create(&tree, 0, extent_alloc, extent_free,
+			    &extents_count);
+		if (card_build(&tree, arr, i))
+			fail("building failed", "true");
+		if (card_debug_check(&tree))
+			fail("debug check nonzero", "true");
+		for (type_t j = 0; j < range; j++)
+			present[j] = j < i;
+		card_check_offsets(&tree, present, range);
+		card_destroy(&tree);
+	}
+
+	card_debug_check_internal_functions(true);
+
+	footer();
+}
+
+static void
+hinted_check_search(hinted *tree, const bool *present, type_t range)
+{
+	for (type_t i = 0; i < range; i++) {
+		hinted_elem_t *v = hinted_find(tree, i);
+		if ((v != NULL) != present[i] || (v != NULL && v->value != i))
+			fail("find", "true");
+		bool exact;
+		hinted_iterator itr = hinted_lower_bound(tree, i, &exact);
+		v = hinted_iterator_get_elem(tree, &itr);
+		if (exact != present[i] || (v != NULL && v->value < i))
+			fail("lower bound", "true");
+		hinted_iterator_prev(tree, &itr);
+		v = hinted_iterator_get_elem(tree, &itr);
+		if (v != NULL && v->value >= i)
+			fail("lower bound", "true");
+		itr = hinted_upper_bound(tree, i, &exact);
+		v = hinted_iterator_get_elem(tree, &itr);
+		if (exact != present[i] || (v != NULL && v->value <= i))
+			fail("upper bound", "true");
+		hinted_iterator_prev(tree, &itr);
+		v = hinted_iterator_get_elem(tree, &itr);
+		if (v != NULL && v->value > i)
+			fail("upper bound", "true");
+		itr = hinted_lower_bound_elem(tree, hinted_elem(i), &exact);
+		v = hinted_iterator_get_elem(tree, &itr);
+		if (exact != present[i] || (v != NULL && v->value < i))
+			fail("lower bound elem", "true");
+		itr = hinted_upper_bound_elem(tree, hinted_elem(i), &exact);
+		v = hinted_iterator_get_elem(tree, &itr);
+		if (exact != present[i] || (v != NULL && v->value <= i))
+			fail("upper bound elem", "true");
+	}
+}
+
+static void
+hinted_check()
+{
+	header();
+	srand(0);
+
+	const type_t range = 3000;
+	bool present[range];
+	memset(present, 0, sizeof(present));
+
+	hinted tree;
+	hinted_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+	for (int i = 0; i < 30000; i++) {
+		type_t v = rand() % range;
+		/* Grow the tree first, then shrink it. */
+		bool ins = rand() % 100 < (i < 15000 ? 70 : 30);
+		if (ins) {
+			if (hinted_insert(&tree, hinted_elem(v), NULL,
+					  NULL) != 0)
+				fail("insertion failed", "true");
+			present[v] = true;
+		} else {
+			hinted_delete(&tree, hinted_elem(v));
+			present[v] = false;
+		}
+		if (i % 1000 == 0) {
+			if (hinted_debug_check(&tree))
+				fail("debug check nonzero", "true");
+			hinted_check_search(&tree, present, range);
+		}
+	}
+	if (hinted_debug_check(&tree))
+		fail("debug check nonzero", "true");
+	hinted_check_search(&tree, present, range);
+	hinted_destroy(&tree);
+
+	footer();
+}
+
+/**
+ * Checks that a tree read view is not affected by modifications of
+ * the original tree.
+ */
+static void
+view_check()
+{
+	header();
+	srand(0);
+
+	const type_t range = 3000;
+	bool present[range];
+	bool view_present[range];
+	memset(present, 0, sizeof(present));
+
+	card tree;
+	card_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+	for (type_t i = 0; i < range; i++) {
+		if (rand() % 2 == 0)
+			continue;
+		if (card_insert(&tree, i, NULL, NULL) != 0)
+			fail("insertion failed", "true");
+		present[i] = true;
+	}
+	memcpy(view_present, present, sizeof(present));
+
+	struct card_view view;
+	card_view_create(&view, &tree);
+	for (int i = 0; i < 30000; i++) {
+		type_t v = rand() % range;
+		if (rand() % 2 == 0) {
+			if (card_insert(&tree, v, NULL, NULL) != 0)
+				fail("insertion failed", "true");
+			present[v] = true;
+		} else {
+			card_delete(&tree, v);
+			present[v] = false;
+		}
+	}
+	if (card_debug_check(&tree))
+		fail("debug check nonzero", "true");
+	card_check_offsets(&tree, present, range);
+	if (card_debug_check(&view.tree))
+		fail("view debug check nonzero", "true");
+	card_check_offsets(&view.tree, view_present, range);
+
+	type_t expected = 0;
+	struct card_iterator itr = card_iterator_first(&view.tree);
+	for (type_t *v = card_iterator_get_elem(&view.tree, &itr); v != NULL;
+	     card_iterator_next(&view.tree, &itr),
+	     v = card_iterator_get_elem(&view.tree, &itr)) {
+		while (!view_present[expected])
+			expected++;
+		if (*v != expected)
+			fail("view iteration order", "true");
+		expected++;
+	}
+	while (expected < range && !view_present[expected])
+		expected++;
+	if (expected != range)
+		fail("view iteration count", "true");
+
+	card_view_destroy(&view, &tree);
+	card_destroy(&tree);
+
+	footer();
+}
+
 static void
 insert_get_iterator()
 {
@@ -913,6 +1218,9 @@ main(void)
 	printing_test();
 	white_box_test();
 	approximate_count();
+	card_check();
+	hinted_check();
+	view_check();
 	if (extents_count != 0)
 		fail("memory leak!", "true");
 	insert_get_iterator();
@@ -168,6 +168,32 @@ test_free_delayed_until_all_read_views_closed()
 	check_plan();
 }
 
+/**
+ * Checks that freeing of a tuple is not delayed by a read view that was
+ * created after the tuple was freed.
+ */
+static void
+test_free_not_delayed_by_newer_read_view()
+{
+	plan(5);
+	header();
+
+	is(alloc_tuple_count(), 0, "count before alloc");
+	struct tuple *tuple = alloc_tuple();
+	is(alloc_tuple_count(), 1, "count after alloc");
+	memtx_allocators_read_view rv1 = memtx_allocators_open_read_view({});
+	free_tuple(tuple);
+	is(alloc_tuple_count(), 1, "count after free");
+	memtx_allocators_read_view rv2 = memtx_allocators_open_read_view({});
+	is(alloc_tuple_count(), 1, "count after second read view opened");
+	memtx_allocators_close_read_view(rv1);
+	is(alloc_tuple_count(), 0, "count after first read view closed");
+	memtx_allocators_close_read_view(rv2);
+
+	footer();
+	check_plan();
+}
+
 /**
  * Checks that freeing of a tuple is not delayed if it was allocated after
  * the last read view was created.
@@ -215,12 +241,13 @@ test_free_not_delayed_if_temporary()
 static int
 test_main()
 {
-	plan(5);
+	plan(6);
 	header();
 
 	test_alloc_stats();
 	test_free_delayed_if_alloc_before_read_view();
 	test_free_delayed_until_all_read_views_closed();
+	test_free_not_delayed_by_newer_read_view();
 	test_free_not_delayed_if_alloc_after_read_view();
 	test_free_not_delayed_if_temporary();
 
@@ -23,9 +23,10 @@ write_run(struct vy_run *run, const char *dir_name,
 {
 	struct vy_run_writer writer;
 	if (vy_run_writer_create(&writer, run, dir_name,
-				 lsm->space_id, lsm->index_id,
+				 lsm->space_id, lsm->index_id, true,
 				 lsm->cmp_def, lsm->key_def,
-				 4096, 0.1, false) != 0)
+				 4096, BLOOM_TYPE_CLASSIC, 0.1, false,
+				 false) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -194,7 +195,7 @@ test_basic()
 		vy_mem_insert_template(run_mem, &tmpl_val);
 	}
 	struct vy_stmt_stream *write_stream;
-	write_stream = vy_write_iterator_new(pk->cmp_def, true, true,
+	write_stream = vy_write_iterator_new(pk->cmp_def, true, false, true,
 					     &read_views, NULL);
 	vy_write_iterator_new_mem(write_stream, run_mem);
 	struct vy_run *run = vy_run_new(&run_env, 1);
@@ -225,7 +226,7 @@ test_basic()
 		tmpl_val.upsert_value = 4;
 		vy_mem_insert_template(run_mem, &tmpl_val);
 	}
-	write_stream = vy_write_iterator_new(pk->cmp_def, true, true,
+	write_stream = vy_write_iterator_new(pk->cmp_def, true, false, true,
 					     &read_views, NULL);
 	vy_write_iterator_new_mem(write_stream, run_mem);
 	run = vy_run_new(&run_env, 2);
@@ -0,0 +1,108 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = common.default_box_cfg()})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_equals(
+            "Wrong index options: bloom_type must be either " ..
+            "'classic' or 'blocked'",
+            s.create_index, s, 'pk', {bloom_type = 'foo'})
+        t.assert_error_msg_contains(
+            "should be of type string",
+            s.create_index, s, 'pk', {bloom_type = 1})
+        s:create_index('pk')
+        t.assert_equals(s.index.pk.options.bloom_type, nil)
+    end)
+end
+
+g.test_blocked = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {bloom_type = 'blocked'})
+        s:create_index('sk', {parts = {2, 'unsigned', 3, 'unsigned'},
+                              bloom_type = 'blocked', bloom_fpr = 0.01})
+        for i = 1, 1000, 2 do
+            s:insert({i, i % 10, i})
+        end
+        box.snapshot()
+    end)
+    local function check()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.pk.options.bloom_type, 'blocked')
+        t.assert_equals(s.index.sk.options.bloom_type, 'blocked')
+        t.assert_gt(s.index.pk:stat().disk.bloom_size, 0)
+        box.stat.reset()
+        for i = 1, 1000 do
+            t.assert_equals(s:get(i), i % 2 == 1 and {i, i % 10, i} or nil)
+        end
+        local stat = s.index.pk:stat().disk.iterator.bloom
+        t.assert_ge(stat.hit, 450)
+        t.assert_le(stat.miss, 550)
+        box.stat.reset()
+        for i = 1, 1000 do
+            t.assert_equals(s.index.sk:get({i % 10, i}),
+                            i % 2 == 1 and {i, i % 10, i} or nil)
+        end
+        stat = s.index.sk:stat().disk.iterator.bloom
+        t.assert_ge(stat.hit, 480)
+        t.assert_le(stat.miss, 520)
+        -- Partial key lookups use the filter too.
+        t.assert_equals(s.index.sk:select({10}), {})
+        t.assert_equals(#s.index.sk:select({1}), 100)
+    end
+    g.server:exec(check)
+    g.server:restart()
+    g.server:exec(check)
+end
+
+g.test_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        box.snapshot()
+        s.index.pk:alter({bloom_type = 'blocked'})
+        t.assert_equals(s.index.pk.options.bloom_type, 'blocked')
+        for i = 101, 200 do
+            s:insert({i})
+        end
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        box.stat.reset()
+        for i = 1, 400 do
+            t.assert_equals(s:get(i), i <= 200 and {i} or nil)
+        end
+        t.assert_ge(s.index.pk:stat().disk.iterator.bloom.hit, 150)
+    end)
+end
@@ -0,0 +1,124 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Keep all data in one range.
+    box_cfg.vinyl_range_size = 1024 * 1024 * 1024
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_equals(
+            "Wrong index options: compaction_policy must be one of " ..
+            "'tiered', 'leveled', 'lazy'",
+            s.create_index, s, 'pk', {compaction_policy = 'foo'})
+        s:create_index('pk')
+        t.assert_equals(s.index.pk.options.compaction_policy, nil)
+        s.index.pk:alter({compaction_policy = 'leveled'})
+        t.assert_equals(s.index.pk.options.compaction_policy, 'leveled')
+    end)
+end
+
+-- Dump a few runs of the same size and return the number of runs
+-- left after compaction.
+local function dump_runs(policy, run_count)
+    return g.server:exec(function(policy, run_count)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {compaction_policy = policy,
+                              run_count_per_level = 3,
+                              run_size_ratio = 100})
+        for i = 1, run_count do
+            for j = 1, 100 do
+                s:replace({j, i})
+            end
+            box.snapshot()
+        end
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.bytes, 0)
+            t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+        end)
+        local stat = s.index.pk:stat()
+        t.assert_ge(stat.amplification.write, 1)
+        t.assert_equals(stat.amplification.read, stat.run_count)
+        t.assert_ge(stat.amplification.space, 1)
+        return stat.run_count
+    end, {policy, run_count})
+end
+
+g.test_tiered = function()
+    -- The last level holds one run, the first one up to three.
+    t.assert_equals(dump_runs('tiered', 2), 1)
+end
+
+-- Dump a run and then two runs three times smaller and return the
+-- number of runs left after compaction. With run_size_ratio = 2 the
+-- small runs are at the first level and the big run is at the last
+-- one, but the two small runs compacted together would end up at the
+-- last level.
+local function dump_sized_runs(policy)
+    return g.server:exec(function(policy)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {compaction_policy = policy,
+                              run_count_per_level = 3,
+                              run_size_ratio = 2})
+        local pad = string.rep('x', 100)
+        for _, row_count in ipairs({300, 100, 100}) do
+            for j = 1, row_count do
+                s:replace({j, pad})
+            end
+            box.snapshot()
+        end
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.bytes, 0)
+            t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+        end)
+        return s.index.pk:stat().run_count
+    end, {policy})
+end
+
+g.test_leveled = function()
+    -- Tiered keeps up to three runs at the first level.
+    t.assert_equals(dump_sized_runs('tiered'), 3)
+    g.server:exec(function() box.space.test:drop() end)
+    -- Leveled keeps one run per level, so the small runs are
+    -- compacted together with the big one.
+    t.assert_equals(dump_sized_runs('leveled'), 1)
+    t.assert_equals(g.server:exec(function()
+        return box.space.test.index.pk:stat().disk.compaction.count
+    end), 1)
+end
+
+g.test_lazy = function()
+    -- All runs are the same size, so they stay at the last level
+    -- until there are more than run_count_per_level of them.
+    t.assert_equals(dump_runs('lazy', 3), 3)
+    g.server:exec(function()
+        local t = require('luatest')
+        local stat = box.space.test.index.pk:stat()
+        t.assert_equals(stat.disk.compaction.count, 0)
+        t.assert_almost_equals(stat.amplification.space, 3, 0.1)
+    end)
+end
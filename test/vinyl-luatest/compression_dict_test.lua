@@ -0,0 +1,87 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Keep all data in one range.
+    box_cfg.vinyl_range_size = 1024 * 1024 * 1024
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+-- Return the body of the run info of the newest run of an index.
+local function last_run_info(space_id)
+    return g.server:exec(function(space_id)
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local files = fio.glob(fio.pathjoin(box.cfg.vinyl_dir, space_id,
+                                            0, '*.index'))
+        table.sort(files)
+        for _, row in xlog.pairs(files[#files]) do
+            return row.BODY
+        end
+    end, {space_id})
+end
+
+g.test_compression_dict = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s1 = box.schema.space.create('plain', {engine = 'vinyl'})
+        s1:create_index('pk', {page_size = 4096})
+        local s2 = box.schema.space.create('dict', {engine = 'vinyl'})
+        s2:create_index('pk', {page_size = 4096, compression_dict = true})
+        t.assert_equals(s1.index.pk.options.compression_dict, nil)
+        t.assert_equals(s2.index.pk.options.compression_dict, true)
+        for _, s in ipairs({s1, s2}) do
+            for i = 1, 5000 do
+                s:insert({i, 'user' .. i, 'user' .. i .. '@example.com',
+                          i % 2 == 0 and 'active' or 'inactive', i * 3})
+            end
+        end
+        -- The dictionary is trained by the dump and used by
+        -- the following compaction.
+        box.snapshot()
+        s1.index.pk:compact()
+        s2.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s1.index.pk:stat().disk.compaction.count, 1)
+            t.assert_equals(s2.index.pk:stat().disk.compaction.count, 1)
+        end)
+        local size1 = s1.index.pk:stat().disk.bytes_compressed
+        local size2 = s2.index.pk:stat().disk.bytes_compressed
+        t.assert_lt(size2, size1)
+        -- The dictionary memory is reported in box.stat.vinyl().
+        t.assert_gt(box.stat.vinyl().memory.compression_dict, 0)
+    end)
+    t.assert_equals(last_run_info(g.server:exec(function()
+        return box.space.plain.id
+    end)).compression_dict, nil)
+    t.assert_not_equals(last_run_info(g.server:exec(function()
+        return box.space.dict.id
+    end)).compression_dict, nil)
+
+    local function check()
+        local t = require('luatest')
+        local s = box.space.dict
+        t.assert_equals(s:count(), 5000)
+        t.assert_equals(s:get(1234), {1234, 'user1234',
+                                      'user1234@example.com', 'active',
+                                      3702})
+        t.assert_equals(s:select(), box.space.plain:select())
+    end
+    g.server:exec(check)
+    g.server:restart()
+    g.server:exec(check)
+    g.server:exec(function()
+        box.space.plain:drop()
+        box.space.dict:drop()
+    end)
+end
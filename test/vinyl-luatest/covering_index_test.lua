@@ -0,0 +1,124 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Disable the tuple cache so that all reads go to runs.
+    box_cfg.vinyl_cache = 0
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_covering = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, covering = true})
+        s:create_index('sk2', {parts = {2, 'unsigned'}})
+        t.assert_equals(s.index.sk.options.covering, true)
+        t.assert_equals(s.index.sk2.options.covering, nil)
+        for i = 1, 100 do
+            s:insert({i, i * 10, 'x'})
+        end
+        box.snapshot()
+        for i = 1, 100, 2 do
+            s:update(i, {{'=', 3, 'y'}})
+        end
+        s:delete(2)
+        s:replace({4, 5, 'z'})
+
+        local expected = s.index.sk2:select()
+        local pk = s.index.pk
+        local lookup = pk:stat().lookup
+        t.assert_equals(s.index.sk:select(), expected)
+        t.assert_equals(s.index.sk:get(30), {3, 30, 'y'})
+        t.assert_equals(s.index.sk:get(20), nil)
+        t.assert_equals(s.index.sk:get(5), {4, 5, 'z'})
+        t.assert_equals(pk:stat().lookup, lookup)
+
+        box.snapshot()
+        t.assert_equals(s.index.sk:select(), expected)
+        t.assert_equals(pk:stat().lookup, lookup)
+        s.index.sk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.sk:stat().disk.compaction.queue.rows, 0)
+        end)
+        t.assert_equals(s.index.sk:select(), expected)
+        t.assert_equals(pk:stat().lookup, lookup)
+
+        -- Non-covering indexes still look up tuples in the primary key.
+        s.index.sk2:select()
+        t.assert_gt(pk:stat().lookup, lookup)
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.sk:select(), s.index.sk2:select())
+        t.assert_equals(s.index.sk:get(30), {3, 30, 'y'})
+    end)
+end
+
+g.test_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        for i = 1, 10 do
+            s:insert({i, i * 10, 'x'})
+        end
+        box.snapshot()
+        s.index.sk:alter({covering = true})
+        t.assert_equals(s.index.sk.options.covering, true)
+        local lookup = s.index.pk:stat().lookup
+        t.assert_equals(s.index.sk:select(), s.index.pk:select())
+        t.assert_equals(s.index.pk:stat().lookup, lookup)
+    end)
+end
+
+g.test_errors = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "primary key can't be covering",
+            s.create_index, s, 'pk', {covering = true})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "multikey index can't be covering",
+            s.create_index, s, 'sk',
+            {parts = {{'[2][*]', 'unsigned'}}, covering = true})
+        s:create_index('sk', {parts = {2, 'unsigned'}, covering = true})
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': deferred deletes are " ..
+            "incompatible with covering indexes",
+            s.alter, s, {defer_deletes = true})
+        s.index.sk:drop()
+        s:alter({defer_deletes = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "covering index is incompatible with deferred deletes",
+            s.create_index, s, 'sk',
+            {parts = {2, 'unsigned'}, covering = true})
+    end)
+end
@@ -0,0 +1,102 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Make the tuple cache smaller than the data scanned by the test.
+    box_cfg.vinyl_cache = 64 * 1024
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_hot_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        -- Disable automatic compaction.
+        s:create_index('pk', {compaction_policy = 'lazy',
+                              run_count_per_level = 100,
+                              cache_hot_ranges = true})
+        t.assert_equals(s.index.pk.options.cache_hot_ranges, true)
+        for i = 1, 20 do
+            for j = 0, 99 do
+                s:replace({j * 20 + i, string.rep('x', 100)})
+            end
+            box.snapshot()
+        end
+        -- Split the index in several ranges.
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.bytes, 0)
+            t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+        end)
+        local stat = s.index.pk:stat()
+        t.assert_gt(stat.range_count, 1)
+        t.assert_equals(stat.hot_range_count, 0)
+
+        local function range_reads(stat)
+            local lookup, scan = 0, 0
+            for _, range in pairs(stat.ranges) do
+                lookup = lookup + range.lookup
+                scan = scan + range.scan
+            end
+            return lookup, scan
+        end
+        local function first_range(stat)
+            for bounds, range in pairs(stat.ranges) do
+                if bounds:startswith('(-inf..') then
+                    return range
+                end
+            end
+        end
+        local lookup, scan = range_reads(stat)
+
+        -- Read a few keys from the first range over and over again.
+        for i = 1, 2000 do
+            s:get(i % 10 + 1)
+        end
+        stat = s.index.pk:stat()
+        local new_lookup, new_scan = range_reads(stat)
+        t.assert_equals(new_lookup - lookup, 2000)
+        t.assert_equals(new_scan, scan)
+        t.assert_equals(stat.hot_range_count, 1)
+        t.assert_ge(first_range(stat).lookup, 2000)
+        t.assert_gt(first_range(stat).heat, 0)
+
+        -- A scan over other ranges doesn't evict hot tuples.
+        s:select({1000}, {iterator = 'ge'})
+        stat = s.index.pk:stat()
+        local _, new_scan = range_reads(stat)
+        t.assert_gt(new_scan, scan)
+        local disk_lookup = stat.disk.iterator.lookup
+        for i = 1, 10 do
+            s:get(i)
+        end
+        t.assert_equals(s.index.pk:stat().disk.iterator.lookup, disk_lookup)
+
+        -- Once the option is turned off, the cached tuples of the hot
+        -- range are treated as any other tuples so the scan evicts them.
+        s.index.pk:alter({cache_hot_ranges = false})
+        t.assert_equals(s.index.pk.options.cache_hot_ranges, nil)
+        t.assert_equals(s.index.pk:stat().hot_range_count, 1)
+        s:select({1000}, {iterator = 'ge'})
+        disk_lookup = s.index.pk:stat().disk.iterator.lookup
+        for i = 1, 10 do
+            s:get(i)
+        end
+        t.assert_gt(s.index.pk:stat().disk.iterator.lookup, disk_lookup)
+
+        -- Per-range counters are reset with other statistics.
+        box.stat.reset()
+        t.assert_equals({range_reads(s.index.pk:stat())}, {0, 0})
+        s:drop()
+    end)
+end
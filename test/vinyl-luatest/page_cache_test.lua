@@ -0,0 +1,88 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Disable the tuple cache so that all reads go to runs.
+    box_cfg.vinyl_cache = 0
+    box_cfg.vinyl_page_cache = 64 * 1024
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 10})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.before_each(function()
+    g.server:exec(function()
+        box.cfg{vinyl_page_cache = 64 * 1024}
+        box.stat.reset()
+    end)
+end)
+
+g.test_hit = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        local pages = s.index.pk:stat().disk.iterator.read.pages
+        t.assert_gt(pages, 0)
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        t.assert_equals(s.index.pk:stat().disk.iterator.read.pages, pages)
+        local stat = box.stat.vinyl()
+        t.assert_ge(stat.page_cache.hit, 1)
+        t.assert_ge(stat.page_cache.miss, 1)
+        t.assert_gt(stat.memory.page_cache, 0)
+        t.assert_le(stat.memory.page_cache, 64 * 1024)
+    end)
+end
+
+g.test_scan_resistance = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        -- The data doesn't fit in the cache.
+        t.assert_gt(s.index.pk:bsize(), 64 * 1024)
+        s:get(1)
+        s:select()
+        -- The page has been evicted by the scan and is read again,
+        -- now it's considered hot.
+        s:get(1)
+        s:select()
+        t.assert_gt(box.stat.vinyl().page_cache.evict, 0)
+        local pages = s.index.pk:stat().disk.iterator.read.pages
+        local hit = box.stat.vinyl().page_cache.hit
+        s:get(1)
+        t.assert_equals(s.index.pk:stat().disk.iterator.read.pages, pages)
+        t.assert_equals(box.stat.vinyl().page_cache.hit, hit + 1)
+    end)
+end
+
+g.test_disable = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        s:get(1)
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+        box.cfg{vinyl_page_cache = 0}
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        local pages = s.index.pk:stat().disk.iterator.read.pages
+        s:get(1)
+        t.assert_equals(s.index.pk:stat().disk.iterator.read.pages,
+                        pages + 1)
+        t.assert_equals(box.stat.vinyl().page_cache.hit, 0)
+    end)
+end
@@ -0,0 +1,100 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Disable the tuple cache so that all reads go to runs.
+    box_cfg.vinyl_cache = 0
+    box_cfg.vinyl_read_threads = 2
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.before_each(function()
+    g.server:exec(function()
+        box.cfg{vinyl_prefetch_pages = 4}
+        box.stat.reset()
+    end)
+end)
+
+g.test_forward_scan = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local pages = s.index.pk:stat().disk.pages
+        t.assert_gt(pages, 10)
+        local result = s:select({100}, {iterator = 'ge'})
+        t.assert_equals(#result, 901)
+        for i, tuple in ipairs(result) do
+            t.assert_equals(tuple[1], i + 99)
+        end
+        local stat = box.stat.vinyl().prefetch
+        t.assert_gt(stat.read, 0)
+        t.assert_gt(stat.hit, 0)
+        t.assert_le(stat.hit, stat.read)
+        -- Every page is read from disk only once.
+        t.assert_le(s.index.pk:stat().disk.iterator.read.pages, pages)
+    end)
+end
+
+g.test_reverse_scan = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local result = s:select({900}, {iterator = 'le'})
+        t.assert_equals(#result, 900)
+        for i, tuple in ipairs(result) do
+            t.assert_equals(tuple[1], 901 - i)
+        end
+        local stat = box.stat.vinyl().prefetch
+        t.assert_gt(stat.read, 0)
+        t.assert_gt(stat.hit, 0)
+    end)
+end
+
+g.test_point_lookup = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        for i = 1, 1000, 50 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 100)})
+        end
+        t.assert_equals(box.stat.vinyl().prefetch.read, 0)
+    end)
+end
+
+g.test_disable = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        box.cfg{vinyl_prefetch_pages = 0}
+        t.assert_equals(#s:select(), 1000)
+        t.assert_equals(box.stat.vinyl().prefetch, {read = 0, hit = 0})
+        local msg = "Incorrect value for option 'vinyl_prefetch_pages': " ..
+                    "must be greater than or equal to 0, " ..
+                    "less than or equal to 16"
+        t.assert_error_msg_content_equals(
+            msg, box.cfg, {vinyl_prefetch_pages = -1})
+        t.assert_error_msg_content_equals(
+            msg, box.cfg, {vinyl_prefetch_pages = 17})
+        box.cfg{vinyl_prefetch_pages = 16}
+        t.assert_equals(box.cfg.vinyl_prefetch_pages, 16)
+        box.cfg{vinyl_prefetch_pages = 0}
+    end)
+end
@@ -0,0 +1,112 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = common.default_box_cfg()})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.vinyl_regulator_mode, 'static')
+        t.assert_equals(box.stat.vinyl().regulator.mode, 'static')
+        box.cfg{vinyl_regulator_mode = 'adaptive'}
+        t.assert_equals(box.stat.vinyl().regulator.mode, 'adaptive')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_regulator_mode': " ..
+            "the value must be one of the following strings: " ..
+            "'static', 'adaptive'",
+            box.cfg, {vinyl_regulator_mode = 'foo'})
+        t.assert_equals(box.stat.vinyl().regulator.mode, 'adaptive')
+        box.cfg{vinyl_regulator_mode = 'static'}
+        t.assert_equals(box.stat.vinyl().regulator.mode, 'static')
+    end)
+end
+
+g.test_stat = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        box.cfg{vinyl_regulator_mode = 'adaptive'}
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 1})
+        local pad = string.rep('x', 1000)
+        for i = 1, 3 do
+            box.begin()
+            for j = 1, 2000 do
+                s:replace({j, i, pad})
+            end
+            box.commit()
+            box.snapshot()
+        end
+        local st = box.stat.vinyl().regulator
+        t.assert_ge(st.compaction_debt, 0)
+        t.assert_ge(st.compaction_bandwidth, 0)
+        t.assert_ge(st.compaction_utilization, 0)
+        t.assert_le(st.compaction_utilization, 1)
+        t.assert_ge(st.predicted_stall, 0)
+        t.assert_gt(st.target_rate, 0)
+        s:drop()
+        box.cfg{vinyl_regulator_mode = 'static'}
+    end)
+end
+
+local g_throttling = t.group('throttling')
+
+g_throttling.before_all(function(cg)
+    cg.server = server:new({alias = 'master',
+                            box_cfg = common.default_box_cfg()})
+    cg.server:start()
+end)
+
+g_throttling.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that the rate limit set by the regulator depends on the mode.
+g_throttling.test_throttling = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        -- There's no rate limit until the first dump followed by
+        -- compaction completes.
+        t.assert_equals(box.stat.vinyl().regulator.target_rate, math.huge)
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 1})
+        local pad = string.rep('x', 1000)
+        local i = 0
+        t.helpers.retrying({timeout = 60}, function()
+            i = i + 1
+            box.begin()
+            for j = 1, 2000 do
+                s:replace({j, i, pad})
+            end
+            box.commit()
+            box.snapshot()
+            t.assert_not_equals(box.stat.vinyl().regulator.target_rate,
+                                math.huge)
+        end)
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().regulator.compaction_debt, 0)
+        end)
+        -- No debt and idle compaction threads: the adaptive regulator
+        -- lifts the safety margin of the static rate limit.
+        local static_rate = box.stat.vinyl().regulator.target_rate
+        t.assert_gt(static_rate, 0)
+        box.cfg{vinyl_regulator_mode = 'adaptive'}
+        t.helpers.retrying({}, function()
+            t.assert_gt(box.stat.vinyl().regulator.target_rate, static_rate)
+        end)
+        box.cfg{vinyl_regulator_mode = 'static'}
+        t.assert_equals(box.stat.vinyl().regulator.target_rate, static_rate)
+        s:drop()
+    end)
+end
@@ -0,0 +1,71 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Disable the tuple cache so that all reads go to runs.
+    box_cfg.vinyl_cache = 0
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 10})
+        s:create_index('sk', {parts = {2, 'unsigned', 1, 'unsigned'},
+                              run_count_per_level = 10})
+        -- Two runs with disjoint key ranges.
+        for i = 1, 100 do
+            s:insert({i, i * 10})
+        end
+        box.snapshot()
+        for i = 101, 200 do
+            s:insert({i, i * 10})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.before_each(function()
+    g.server:exec(function() box.stat.reset() end)
+end)
+
+g.test_skip_run = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local pk = box.space.test.index.pk
+        t.assert_equals(pk:stat().run_count, 2)
+        -- Only the run containing the key is looked up.
+        t.assert_equals(pk:get(50), {50, 500})
+        t.assert_equals(pk:get(150), {150, 1500})
+        local stat = pk:stat().disk.iterator
+        t.assert_equals(stat.lookup, 2)
+        t.assert_equals(stat.bloom.hit, 0)
+        t.assert_equals(stat.bloom.miss, 0)
+        -- Keys outside all runs don't touch them at all.
+        t.assert_equals(pk:get(0), nil)
+        t.assert_equals(pk:get(1000), nil)
+        stat = pk:stat().disk.iterator
+        t.assert_equals(stat.lookup, 2)
+        t.assert_equals(stat.bloom.hit, 0)
+    end)
+end
+
+g.test_partial_key = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local sk = box.space.test.index.sk
+        t.assert_equals(sk:select({500}), {{50, 500}})
+        t.assert_equals(sk:select({2000}), {{200, 2000}})
+        t.assert_equals(sk:select({10}), {{1, 10}})
+        t.assert_equals(sk:select({5}), {})
+        t.assert_equals(sk:select({3000}), {})
+        t.assert_equals(sk:stat().disk.iterator.lookup, 3)
+    end)
+end
@@ -0,0 +1,64 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = common.default_box_cfg()})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_subcompaction = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        -- Disable automatic compaction.
+        s:create_index('pk', {compaction_policy = 'lazy',
+                              run_count_per_level = 100})
+        -- Each run spans the whole key space.
+        for i = 1, 20 do
+            for j = 0, 99 do
+                s:replace({j * 20 + i, string.rep('x', 100)})
+            end
+            box.snapshot()
+        end
+        local stat = s.index.pk:stat()
+        t.assert_equals(stat.range_count, 1)
+        t.assert_equals(stat.run_count, 20)
+        t.assert_equals(stat.disk.compaction.count, 0)
+        t.assert_ge(stat.disk.bytes, 2 * stat.range_size)
+
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.bytes, 0)
+            t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+        end)
+        -- The range was split before compaction, and the parts
+        -- were compacted separately.
+        stat = s.index.pk:stat()
+        t.assert_gt(stat.range_count, 1)
+        t.assert_equals(stat.run_count, stat.range_count)
+        t.assert_equals(stat.disk.compaction.count, stat.range_count)
+        t.assert_equals(s:count(), 2000)
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local stat = s.index.pk:stat()
+        t.assert_gt(stat.range_count, 1)
+        t.assert_equals(stat.run_count, stat.range_count)
+        local expected = {}
+        for i = 1, 2000 do
+            table.insert(expected, {i, string.rep('x', 100)})
+        end
+        t.assert_equals(s:select(), expected)
+    end)
+end
@@ -72,11 +72,17 @@ end;
 --
 -- Filter dump/compaction time as we need error injection to
 -- test them properly.
+--
+-- Amplification factors and per-range read statistics are
+-- checked by vinyl-luatest.
 function istat()
     local st = box.space.test.index.pk:stat()
     st.latency = nil
     st.disk.dump.time = nil
     st.disk.compaction.time = nil
+    st.amplification = nil
+    st.hot_range_count = nil
+    st.ranges = nil
     return st
 end;
 
@@ -90,6 +96,7 @@ end;
 function gstat()
     local st = box.stat.vinyl()
     st.regulator = nil
+    st.prefetch = nil
     st.scheduler.dump_time = nil
     st.scheduler.compaction_time = nil
     return st